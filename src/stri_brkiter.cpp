@@ -31,6 +31,7 @@
 
 #include "stri_stringi.h"
 #include "stri_brkiter.h"
+#include "stri_utf8.h"
 
 
 /** Select Break Iterator
@@ -217,9 +218,401 @@ void StriBrkIterOptions::setSkipRuleStatus(SEXP opts_brkiter) {
 }
 
 
+/** Word_Break property values (UAX #29) of ASCII characters */
+enum StriWordBreakClass {
+   STRI__WB_OT = 0, // Other
+   STRI__WB_CR,     // \r
+   STRI__WB_LF,     // \n
+   STRI__WB_NL,     // Newline: \v, \f
+   STRI__WB_AL,     // ALetter: [A-Za-z]
+   STRI__WB_NU,     // Numeric: [0-9]
+   STRI__WB_EX,     // ExtendNumLet: _
+   STRI__WB_ML,     // MidLetter: :
+   STRI__WB_MN,     // MidNum: , ;
+   STRI__WB_MB,     // MidNumLet: .
+   STRI__WB_SQ,     // Single_Quote: '
+   STRI__WB_DQ,     // Double_Quote: "
+   STRI__WB_SP      // space (WSegSpace since Unicode 11)
+};
+
+
+static const unsigned char stri__brkiter_ascii_wb[128] = {
+   STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT,  // 0x00
+   STRI__WB_OT, STRI__WB_OT, STRI__WB_LF, STRI__WB_NL, STRI__WB_NL, STRI__WB_CR, STRI__WB_OT, STRI__WB_OT,  // 0x08
+   STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT,  // 0x10
+   STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT,  // 0x18
+   STRI__WB_SP, STRI__WB_OT, STRI__WB_DQ, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_SQ,  // 0x20
+   STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_MN, STRI__WB_OT, STRI__WB_MB, STRI__WB_OT,  // 0x28
+   STRI__WB_NU, STRI__WB_NU, STRI__WB_NU, STRI__WB_NU, STRI__WB_NU, STRI__WB_NU, STRI__WB_NU, STRI__WB_NU,  // 0x30
+   STRI__WB_NU, STRI__WB_NU, STRI__WB_ML, STRI__WB_MN, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT,  // 0x38
+   STRI__WB_OT, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL,  // 0x40
+   STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL,  // 0x48
+   STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL,  // 0x50
+   STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_EX,  // 0x58
+   STRI__WB_OT, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL,  // 0x60
+   STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL,  // 0x68
+   STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_AL,  // 0x70
+   STRI__WB_AL, STRI__WB_AL, STRI__WB_AL, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT, STRI__WB_OT  // 0x78
+};
+
+
+/** Rule status values assigned by ICU's word break rules to words
+ * consisting of a single ALetter, Numeric or ExtendNumLet character
+ * (\code{[3]}) or ending with a given pair of them (\code{[3][3]});
+ * these differ between ICU versions, so they are determined
+ * by stri__brkiter_ascii_calibrate()
+ */
+static int32_t stri__brkiter_ascii_rule1[3];
+static int32_t stri__brkiter_ascii_rule2[3][3];
+
+/** Which of the STRI__WB_ML, ..., STRI__WB_DQ classes may appear between
+ * two letters and which ones between two digits (WB6, WB7, WB11, WB12)?
+ * This is also determined by stri__brkiter_ascii_calibrate(),
+ * as, e.g., the colon is not a MidLetter in recent CLDR versions.
+ */
+static bool stri__brkiter_ascii_midletter[STRI__WB_SP+1];
+static bool stri__brkiter_ascii_midnum[STRI__WB_SP+1];
+static bool stri__brkiter_ascii_calibrated = false;
+
+/** Compiled root word [0] and character [1] break rules,
+ * see stri__brkiter_ascii_supported() */
+static std::vector<uint8_t> stri__brkiter_ascii_root_rules[2];
+
+
+/** Check if stri__brkiter_ascii_next() agrees with a break iterator
+ *
+ * @param it break iterator
+ * @param type break iterator type
+ * @param str ASCII string
+ * @return logical value
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static bool stri__brkiter_ascii_check(BreakIterator* it, UBreakIteratorType type, const char* str)
+{
+   R_len_t str_n = (R_len_t)strlen(str);
+   UErrorCode status = U_ZERO_ERROR;
+   UText* str_text = utext_openUTF8(NULL, str, str_n, &status);
+   if (U_FAILURE(status)) return false;
+   it->setText(str_text, status);
+
+   bool ret = U_SUCCESS(status);
+   R_len_t pos = it->first();
+   int32_t rule;
+   while (ret) {
+      R_len_t pos_icu = it->next();
+      pos = stri__brkiter_ascii_next(type, str, str_n, pos, rule);
+      if (pos != pos_icu)
+         ret = false;
+      else if (pos == BreakIterator::DONE)
+         break;
+      else if (rule != ((RuleBasedBreakIterator*)it)->getRuleStatus())
+         ret = false;
+   }
+
+   utext_close(str_text);
+   return ret;
+}
+
+
+/** Copy the compiled rules of a break iterator
+ *
+ * @param it break iterator
+ * @param rules [out] compiled rules
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static void stri__brkiter_ascii_copy_rules(BreakIterator* it, std::vector<uint8_t>& rules)
+{
+   uint32_t rules_n = 0;
+   const uint8_t* rules_s = ((RuleBasedBreakIterator*)it)->getBinaryRules(rules_n);
+   if (rules_s) rules.assign(rules_s, rules_s+rules_n);
+   else rules.clear();
+}
+
+
+/** Determine the ICU version-dependent parameters of stri__brkiter_ascii_next()
+ *
+ * The rule status values are read from ICU's word break iterator
+ * and the results are verified on a few test strings.
+ * If this fails, stri__brkiter_ascii_supported() always returns false.
+ *
+ * Called once, in R_init_stringi(), so that the parameters may be
+ * read by many threads later on.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void stri__brkiter_ascii_calibrate()
+{
+   stri__brkiter_ascii_calibrated = false;
+   UErrorCode status = U_ZERO_ERROR;
+   BreakIterator* word = BreakIterator::createWordInstance(Locale::getRoot(), status);
+   BreakIterator* chr = BreakIterator::createCharacterInstance(Locale::getRoot(), status);
+   if (U_SUCCESS(status) && word && chr) {
+      const char* samples = "a1_";
+      const char* mids = ":,.'\"";
+      bool ok = true;
+      for (int i=0; ok && i<5; ++i) {
+         for (int j=0; ok && j<2; ++j) {
+            char str[4] = { samples[j], mids[i], samples[j], '\0' };
+            UText* str_text = utext_openUTF8(NULL, str, 3, &status);
+            word->setText(str_text, status);
+            word->first();
+            R_len_t pos = word->next();
+            ok = (U_SUCCESS(status) && (pos == 1 || pos == 3));
+            int cls = stri__brkiter_ascii_wb[(unsigned char)mids[i]];
+            if (j == 0) stri__brkiter_ascii_midletter[cls] = (pos == 3);
+            else        stri__brkiter_ascii_midnum[cls]    = (pos == 3);
+            if (str_text) utext_close(str_text);
+         }
+      }
+
+      for (int i=0; ok && i<3; ++i) {
+         for (int j=-1; ok && j<3; ++j) {
+            char str[3] = { samples[i], (j >= 0)?samples[j]:'\0', '\0' };
+            R_len_t str_n = (j >= 0)?2:1;
+            UText* str_text = utext_openUTF8(NULL, str, str_n, &status);
+            word->setText(str_text, status);
+            word->first();
+            ok = (U_SUCCESS(status) && word->next() == str_n);
+            if (ok && j < 0)
+               stri__brkiter_ascii_rule1[i] = ((RuleBasedBreakIterator*)word)->getRuleStatus();
+            else if (ok)
+               stri__brkiter_ascii_rule2[i][j] = ((RuleBasedBreakIterator*)word)->getRuleStatus();
+            if (str_text) utext_close(str_text);
+         }
+      }
+
+      const char* test = "Ab1 c.d:e'f g1.2,3;4'5 6.x y.7 __a_1_ 8__ \"h\" ij.\r\n\r\r"
+         "\n\v\f  \t\t-k..l 9,,0 m:: (n)o!";
+      if (ok && stri__brkiter_ascii_check(word, UBRK_WORD, test)
+             && stri__brkiter_ascii_check(chr, UBRK_CHARACTER, test)) {
+         stri__brkiter_ascii_copy_rules(word, stri__brkiter_ascii_root_rules[0]);
+         stri__brkiter_ascii_copy_rules(chr, stri__brkiter_ascii_root_rules[1]);
+         stri__brkiter_ascii_calibrated = (!stri__brkiter_ascii_root_rules[0].empty()
+            && !stri__brkiter_ascii_root_rules[1].empty());
+      }
+   }
+   if (word) delete word;
+   if (chr) delete chr;
+}
+
+
+/** Can word or character boundaries in ASCII strings
+ *  be determined by stri__brkiter_ascii_next()?
+ *
+ * This is the case if \code{it} uses ICU's default (root) rules,
+ * i.e., there is no locale-specific tailoring.
+ * The compiled rules are compared with the ones stored by
+ * stri__brkiter_ascii_calibrate(); no new iterator is created.
+ * The result should be stored along with \code{it}.
+ *
+ * @param it break iterator
+ * @param type break iterator type
+ * @return logical value
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool stri__brkiter_ascii_supported(BreakIterator* it, UBreakIteratorType type)
+{
+   if (!it || !stri__brkiter_ascii_calibrated
+         || (type != UBRK_WORD && type != UBRK_CHARACTER))
+      return false;
+
+   const std::vector<uint8_t>& root = stri__brkiter_ascii_root_rules[(type == UBRK_WORD)?0:1];
+   uint32_t rules_n = 0;
+   const uint8_t* rules_s = ((RuleBasedBreakIterator*)it)->getBinaryRules(rules_n);
+   return (rules_s && rules_n == (uint32_t)root.size()
+      && memcmp(rules_s, &root[0], rules_n) == 0);
+}
+
+
+/** Find the next word or character boundary in an ASCII string
+ *
+ * Gives the same results as ICU's default rules
+ * (UAX #29: Unicode Text Segmentation) restricted to ASCII,
+ * including the rule status values.
+ * Call stri__brkiter_ascii_supported() first.
+ *
+ * @param type \code{UBRK_WORD} or \code{UBRK_CHARACTER}
+ * @param str ASCII string
+ * @param str_n number of bytes in \code{str}
+ * @param pos current boundary
+ * @param rule [out] rule status of the boundary found
+ * @return next boundary or \code{BreakIterator::DONE}
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t stri__brkiter_ascii_next(UBreakIteratorType type,
+   const char* str, R_len_t str_n, R_len_t pos, int32_t& rule)
+{
+   rule = UBRK_WORD_NONE;
+   if (pos < 0 || pos >= str_n)
+      return BreakIterator::DONE;
+
+   int cur = stri__brkiter_ascii_wb[(unsigned char)str[pos]];
+   R_len_t i = pos+1;
+
+   if (cur == STRI__WB_CR) { // CR x LF
+      if (i < str_n && str[i] == '\n') ++i;
+      return i;
+   }
+
+   if (type != UBRK_WORD)
+      return i; // each other character is a separate grapheme cluster
+
+   if (cur == STRI__WB_SP) {
+#if U_ICU_VERSION_MAJOR_NUM >= 62
+      while (i < str_n && str[i] == ' ') ++i; // WB3d
+#endif
+      return i;
+   }
+
+   if (cur != STRI__WB_AL && cur != STRI__WB_NU && cur != STRI__WB_EX)
+      return i; // break around everything else (WB999)
+
+   int prev = STRI__WB_OT; // class of the character preceding cur
+   while (i < str_n) {
+      int next = stri__brkiter_ascii_wb[(unsigned char)str[i]];
+      if (next == STRI__WB_AL || next == STRI__WB_NU || next == STRI__WB_EX) {
+         // WB5, WB8, WB9, WB10, WB13a, WB13b
+         prev = cur;
+         cur = next;
+         ++i;
+         continue;
+      }
+
+      if (i+1 >= str_n || (cur != STRI__WB_AL && cur != STRI__WB_NU))
+         break;
+
+      int next2 = stri__brkiter_ascii_wb[(unsigned char)str[i+1]];
+      if (next2 != cur)
+         break;
+
+      if ((cur == STRI__WB_AL && stri__brkiter_ascii_midletter[next]) || // WB6, WB7
+          (cur == STRI__WB_NU && stri__brkiter_ascii_midnum[next])) {    // WB11, WB12
+         prev = cur;
+         i += 2;
+      }
+      else
+         break;
+   }
+
+   // the status is the one of the rule that matched the last character
+   if (prev == STRI__WB_OT)
+      rule = stri__brkiter_ascii_rule1[cur-STRI__WB_AL];
+   else
+      rule = stri__brkiter_ascii_rule2[prev-STRI__WB_AL][cur-STRI__WB_AL];
+
+   return i;
+}
+
+
+/** Does a code point always form a grapheme cluster on its own?
+ *
+ * Under the default rules (UAX #29, GB3-GB999), there is a character
+ * boundary between any two code points whose Grapheme_Cluster_Break
+ * property is one of Other, Control, CR, or LF, except for CR followed
+ * by LF. These cover most letters, digits, punctuation, CJK ideographs
+ * and emoji, but not combining marks, joiners, regional indicators,
+ * or Hangul syllables.
+ *
+ * @param c code point, negative for an invalid UTF-8 sequence
+ * @return logical value
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool stri__brkiter_char_simple(UChar32 c)
+{
+   if (c < 0x80)
+      return (c >= 0);
+
+   int gcb = u_getIntPropertyValue(c, UCHAR_GRAPHEME_CLUSTER_BREAK);
+   return (gcb == U_GCB_OTHER || gcb == U_GCB_CONTROL
+      || gcb == U_GCB_CR || gcb == U_GCB_LF);
+}
+
+
+/** Find all character boundaries in a non-ASCII string
+ *
+ * The string is split into pieces at the positions between two
+ * consecutive stri__brkiter_char_simple() code points (not being CR LF).
+ * These are boundaries regardless of the context, hence the RBBI
+ * is only used to segment the pieces that include other code points.
+ * Fills asciiBounds and asciiRules.
+ *
+ * Call stri__brkiter_ascii_supported() first.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void StriRuleBasedBreakIterator::findClusters()
+{
+   asciiBounds.clear();
+
+   R_len_t piece = 0;        // start of the current piece
+   bool piece_simple = true; // is it a single simple code point (or CR LF)?
+   bool prev_simple = false;
+   UChar32 prev_c = -1;
+   R_len_t i = 0;
+   while (i < searchLen) {
+      R_len_t pos = i;
+      UChar32 c;
+      U8_NEXT(searchStr, i, searchLen, c);
+      bool cur_simple = stri__brkiter_char_simple(c);
+      if (prev_simple && cur_simple && !(prev_c == '\r' && c == '\n')) {
+         if (piece_simple) asciiBounds.push_back(piece);
+         else findClusters(piece, pos);
+         piece = pos;
+      }
+      piece_simple = (piece == pos || piece_simple) && cur_simple;
+      prev_simple = cur_simple;
+      prev_c = c;
+   }
+
+   if (piece < searchLen) {
+      if (piece_simple) asciiBounds.push_back(piece);
+      else findClusters(piece, searchLen);
+   }
+
+   asciiBounds.push_back(searchLen);
+   asciiRules.assign(asciiBounds.size(), 0);
+}
+
+
+/** Find character boundaries in searchStr[from..to) using the RBBI
+ *
+ * @param from a boundary
+ * @param to a boundary
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void StriRuleBasedBreakIterator::findClusters(R_len_t from, R_len_t to)
+{
+   UErrorCode status = U_ZERO_ERROR;
+   this->searchText = utext_openUTF8(this->searchText,
+      searchStr+from, to-from, &status);
+   STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+
+   status = U_ZERO_ERROR;
+   this->rbiterator->setText(this->searchText, status);
+   STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+
+   asciiBounds.push_back(from);
+   R_len_t pos = rbiterator->first();
+   while ((pos = rbiterator->next()) != BreakIterator::DONE && pos < to-from)
+      asciiBounds.push_back(from+pos);
+}
+
+
 /**
  *
  * @ version 0.4-1 (Marek Gagolewski, 2014-12-03)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    ASCII strings are processed by stri__brkiter_ascii_next(), if possible
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    character boundaries in other strings are found by findClusters()
  */
 void StriRuleBasedBreakIterator::setupMatcher(const char* _searchStr, R_len_t _searchLen)
 {
@@ -229,6 +622,17 @@ void StriRuleBasedBreakIterator::setupMatcher(const char* _searchStr, R_len_t _s
    this->searchLen = _searchLen;
    this->searchPos = BreakIterator::DONE;
 
+   // fall back to the RBBI if there is a non-ASCII character
+   this->asciiMode = (asciiSupported && stri__utf8_is_ascii(_searchStr, _searchLen));
+   this->clusterMode = (asciiSupported && !asciiMode && type == UBRK_CHARACTER);
+   if (this->asciiMode)
+      return;
+
+   if (this->clusterMode) { // RBBI is only used where needed
+      findClusters();
+      return;
+   }
+
    UErrorCode status = U_ZERO_ERROR;
    this->searchText = utext_openUTF8(this->searchText,
       _searchStr, _searchLen, &status);
@@ -259,7 +663,18 @@ bool StriRuleBasedBreakIterator::ignoreBoundary() {
 
    if (skip_size <= 0) return false;
 
-   int rule = rbiterator->getRuleStatus();
+   return ignoreRule(rbiterator->getRuleStatus());
+}
+
+
+/** Should a boundary with a given rule status be ignored
+ *
+ * @param rule rule status
+ * @return logical value
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool StriRuleBasedBreakIterator::ignoreRule(int32_t rule) {
    for (int i=0; i<skip_size; i += 2) {
       // skip_size is even - that's sure
       if (rule >= skip_rules[i] && rule < skip_rules[i+1])
@@ -281,6 +696,18 @@ void StriRuleBasedBreakIterator::first()
       throw StriException("!NDEBUG: StriRuleBasedBreakIterator::first");
 #endif
 
+   if (asciiMode) {
+      this->searchPos = 0;
+      this->asciiRule = 0;
+      return;
+   }
+
+   if (clusterMode) {
+      this->asciiIndex = 0;
+      this->searchPos = 0;
+      return;
+   }
+
    this->searchPos = rbiterator->first(); // ICU man: "The offset of the beginning of the text, zero."
 
 #ifndef NDBEGUG
@@ -296,6 +723,25 @@ void StriRuleBasedBreakIterator::first()
  */
 bool StriRuleBasedBreakIterator::next()
 {
+   if (clusterMode) { // all rule statuses are 0
+      if (asciiIndex+1 >= (R_len_t)asciiBounds.size()
+            || (skip_size > 0 && ignoreRule(0))) {
+         this->searchPos = BreakIterator::DONE;
+         return false;
+      }
+      this->searchPos = asciiBounds[++asciiIndex];
+      return true;
+   }
+
+   if (asciiMode) {
+      while ((this->searchPos = stri__brkiter_ascii_next(type, searchStr,
+            searchLen, searchPos, asciiRule)) != BreakIterator::DONE) {
+         if (skip_size <= 0 || !ignoreRule(asciiRule))
+            return true;
+      }
+      return false;
+   }
+
    while ((this->searchPos = rbiterator->next()) != BreakIterator::DONE) {
       if (!ignoreBoundary())
          return true;
@@ -311,6 +757,31 @@ bool StriRuleBasedBreakIterator::next()
 bool StriRuleBasedBreakIterator::next(std::pair<R_len_t, R_len_t>& bdr)
 {
    R_len_t lastPos = searchPos;
+   if (clusterMode) { // all rule statuses are 0
+      if (asciiIndex+1 >= (R_len_t)asciiBounds.size()
+            || (skip_size > 0 && ignoreRule(0))) {
+         searchPos = BreakIterator::DONE;
+         return false;
+      }
+      bdr.first  = lastPos;
+      bdr.second = searchPos = asciiBounds[++asciiIndex];
+      return true;
+   }
+
+   if (asciiMode) {
+      while ((searchPos = stri__brkiter_ascii_next(type, searchStr,
+            searchLen, searchPos, asciiRule)) != BreakIterator::DONE) {
+         if (skip_size <= 0 || !ignoreRule(asciiRule)) {
+            bdr.first  = lastPos;
+            bdr.second = searchPos;
+            return true;
+         }
+
+         lastPos = searchPos;
+      }
+      return false;
+   }
+
    while ((searchPos = rbiterator->next()) != BreakIterator::DONE) {
       if (!ignoreBoundary()) {
          bdr.first  = lastPos;
@@ -337,6 +808,28 @@ void StriRuleBasedBreakIterator::last()
       throw StriException("!NDEBUG: StriRuleBasedBreakIterator::last");
 #endif
 
+   if (clusterMode) { // already found by setupMatcher()
+      asciiIndex = (R_len_t)asciiBounds.size()-1;
+      this->searchPos = asciiBounds[asciiIndex];
+      return;
+   }
+
+   if (asciiMode) { // find all the boundaries
+      asciiBounds.clear();
+      asciiRules.clear();
+      R_len_t pos = 0;
+      int32_t rule = 0;
+      do {
+         asciiBounds.push_back(pos);
+         asciiRules.push_back(rule);
+      } while ((pos = stri__brkiter_ascii_next(type, searchStr, searchLen, pos, rule))
+         != BreakIterator::DONE);
+
+      asciiIndex = (R_len_t)asciiBounds.size()-1;
+      this->searchPos = asciiBounds[asciiIndex];
+      return;
+   }
+
    rbiterator->first();
    this->searchPos = rbiterator->last(); // ICU man: "The text's past-the-end offset. "
 
@@ -353,6 +846,19 @@ void StriRuleBasedBreakIterator::last()
  */
 bool StriRuleBasedBreakIterator::previous(std::pair<R_len_t, R_len_t>& bdr)
 {
+   if (asciiMode || clusterMode) {
+      for (; asciiIndex > 0; --asciiIndex) {
+         if (skip_size <= 0 || !ignoreRule(asciiRules[asciiIndex])) {
+            bdr.second = asciiBounds[asciiIndex];
+            --asciiIndex;
+            bdr.first  = searchPos = asciiBounds[asciiIndex];
+            return true;
+         }
+      }
+      searchPos = BreakIterator::DONE;
+      return false;
+   }
+
    do {
       if (!ignoreBoundary()) {
          bdr.second  = searchPos;
@@ -366,3 +872,55 @@ bool StriRuleBasedBreakIterator::previous(std::pair<R_len_t, R_len_t>& bdr)
    while (searchPos != BreakIterator::DONE);
    return false;
 }
+
+
+/** Prepare the `type` argument of stri_length, stri_reverse, and stri_sub
+ *
+ * @param type R object; \code{NULL} stands for \code{"code_point"}
+ * @param argname argument name
+ * @return \code{true} for \code{"grapheme"},
+ *    \code{false} for \code{"code_point"}
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool stri__prepare_arg_grapheme(SEXP type, const char* argname)
+{
+   if (isNull(type))
+      return false;
+
+   const char* type_opts[] = {"code_point", "grapheme", NULL};
+   int type_cur = stri__match_arg(
+      stri__prepare_arg_string_1_notNA(type, argname), type_opts);
+   if (type_cur < 0)
+      Rf_error(MSG__INCORRECT_MATCH_OPTION, argname); // error() allowed here
+   return (type_cur == 1);
+}
+
+
+/** Find the boundaries of grapheme clusters
+ *
+ * @param brkiter character break iterator
+ * @param str string
+ * @param str_n number of bytes in \code{str}
+ * @param bounds [out] byte offsets of the consecutive clusters,
+ *    followed by \code{str_n}
+ * @return number of grapheme clusters
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t stri__brkiter_clusters(StriRuleBasedBreakIterator& brkiter,
+   const char* str, R_len_t str_n, std::vector<R_len_t>& bounds)
+{
+   bounds.clear();
+   bounds.push_back(0);
+   if (str_n <= 0)
+      return 0;
+
+   std::pair<R_len_t, R_len_t> bdr;
+   brkiter.setupMatcher(str, str_n);
+   brkiter.first();
+   while (brkiter.next(bdr))
+      bounds.push_back(bdr.second);
+
+   return (R_len_t)bounds.size()-1;
+}
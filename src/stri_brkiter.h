@@ -41,6 +41,13 @@
 #include <unicode/locid.h>
 
 
+void stri__brkiter_ascii_calibrate();
+bool stri__brkiter_ascii_supported(BreakIterator* it, UBreakIteratorType type);
+R_len_t stri__brkiter_ascii_next(UBreakIteratorType type,
+   const char* str, R_len_t str_n, R_len_t pos, int32_t& rule);
+bool stri__brkiter_char_simple(UChar32 c);
+
+
 /**
  * A class to manage a break iterator's options
  *
@@ -82,6 +89,10 @@ class StriBrkIterOptions {
          setSkipRuleStatus(opts_brkiter);
          setType(opts_brkiter, default_type);
       }
+
+      UBreakIteratorType getType() const {
+         return type;
+      }
 };
 
 
@@ -177,6 +188,12 @@ class StriUBreakIterator : public StriBrkIterOptions {
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-02)
  * separate class
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ * ASCII fast path for word and character boundaries
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ * character boundaries in non-ASCII strings are found by findClusters()
  */
 class StriRuleBasedBreakIterator : public StriBrkIterOptions {
    private:
@@ -187,12 +204,25 @@ class StriRuleBasedBreakIterator : public StriBrkIterOptions {
       const char* searchStr; // owned by caller
       R_len_t searchLen; // in bytes
 
+      bool asciiSupported; // stri__brkiter_ascii_supported() for rbiterator
+      bool asciiMode;      // is searchStr processed by stri__brkiter_ascii_next()?
+      int32_t asciiRule;   // rule status of the boundary at searchPos
+      bool clusterMode;    // are asciiBounds filled by findClusters()?
+      std::vector<R_len_t> asciiBounds; // all boundaries, filled by last()
+      std::vector<int32_t> asciiRules;  // their rule statuses
+      R_len_t asciiIndex;  // index of searchPos in asciiBounds
+
       void setEmptyOpts() {
          rbiterator = NULL;
          searchText = NULL;
          searchPos = BreakIterator::DONE;
          searchStr = NULL;
          searchLen = 0;
+         asciiSupported = false;
+         asciiMode = false;
+         clusterMode = false;
+         asciiRule = 0;
+         asciiIndex = 0;
       }
 
       void open() {
@@ -217,6 +247,8 @@ class StriRuleBasedBreakIterator : public StriBrkIterOptions {
          }
          STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
 
+         asciiSupported = stri__brkiter_ascii_supported(rbiterator, type);
+
 //         UnicodeString s = rbiterator->getRules();
 //         std::string s2;
 //         s.toUTF8String(s2);
@@ -224,6 +256,9 @@ class StriRuleBasedBreakIterator : public StriBrkIterOptions {
       }
 
       bool ignoreBoundary();
+      bool ignoreRule(int32_t rule);
+      void findClusters();
+      void findClusters(R_len_t from, R_len_t to);
 
    public:
 
@@ -266,4 +301,9 @@ class StriRuleBasedBreakIterator : public StriBrkIterOptions {
       bool previous(std::pair<R_len_t, R_len_t>& bdr);
 };
 
+
+bool stri__prepare_arg_grapheme(SEXP type, const char* argname);
+R_len_t stri__brkiter_clusters(StriRuleBasedBreakIterator& brkiter,
+   const char* str, R_len_t str_n, std::vector<R_len_t>& bounds);
+
 #endif
@@ -33,6 +33,7 @@
 #ifndef __stri_bytesearch_matcher_h
 #define __stri_bytesearch_matcher_h
 
+#include <unicode/uniset.h>
 
 #ifndef USEARCH_DONE
 #define USEARCH_DONE -1
@@ -77,6 +78,8 @@ class StriByteSearchMatcher {
 
       const char* getPatternStr() const { return m_patternStr; }
 
+      void setOverlap(bool optOverlap) { m_optOverlap = optOverlap; }
+
       virtual ~StriByteSearchMatcher() { }
 
       virtual void reset(const char* searchStr, R_len_t searchLen) {
@@ -136,6 +139,13 @@ class StriByteSearchMatcher {
       }
 };
 
+/**
+ * KMP search, used for longer patterns
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    the KMP table is set up again if findFirst() and findLast()
+ *    are called on the same matcher (e.g., of a compiled pattern)
+ */
 class StriByteSearchMatcherKMP : public StriByteSearchMatcher {
 
    private:
@@ -146,6 +156,7 @@ class StriByteSearchMatcherKMP : public StriByteSearchMatcher {
    protected:
 
       int* m_kmpNext;
+      int m_kmpDir; ///< 1 (table for findFirst), -1 (findLast) or 0 (none)
       int m_patternPos;
 
 
@@ -190,7 +201,7 @@ class StriByteSearchMatcherKMP : public StriByteSearchMatcher {
          int kmpMaxSize = patternLen+1; // that's sufficient
          this->m_kmpNext = new int[kmpMaxSize];
          if (!this->m_kmpNext) throw StriException(MSG__MEM_ALLOC_ERROR);
-         this->m_kmpNext[0] = -100; // magic constant for an uninitialized KMP table
+         this->m_kmpDir = 0; // KMP table not set up yet
       }
 
       virtual void reset(const char* searchStr, R_len_t searchLen) {
@@ -199,8 +210,9 @@ class StriByteSearchMatcherKMP : public StriByteSearchMatcher {
       }
 
       virtual R_len_t findFirst() {
-         if (this->m_kmpNext[0] <= -100) {
+         if (this->m_kmpDir != 1) {
             // Setup KMP table for FWD search
+            m_kmpDir = 1;
             m_kmpNext[0] = -1;
             for (R_len_t i=0; i<m_patternLen; ++i) {
                m_kmpNext[i+1] = m_kmpNext[i]+1;
@@ -214,8 +226,9 @@ class StriByteSearchMatcherKMP : public StriByteSearchMatcher {
       }
 
       virtual R_len_t findLast()  {
-         if (this->m_kmpNext[0] <= -100) {
+         if (this->m_kmpDir != -1) {
             // Setup KMP table for BACK search
+            m_kmpDir = -1;
             m_kmpNext[0] = -1;
             for (R_len_t i=0; i<m_patternLen; ++i) {
                m_kmpNext[i+1] = m_kmpNext[i]+1;
@@ -243,6 +256,25 @@ class StriByteSearchMatcherKMP : public StriByteSearchMatcher {
       }
 };
 
+/**
+ * Case-insensitive KMP search over simply case-folded code points
+ *
+ * The pattern is folded once, in the constructor; each code point
+ * of the searched string is folded on the fly, see stri__utf8_fold_case
+ * (ASCII bytes are not decoded at all). As simple case folding
+ * maps code points to code points, a match consists of the same
+ * number of code points as the pattern.
+ *
+ * Whenever there is no partial match, the search skips
+ * (with stri__utf8_find_byte3) to the next byte that may start
+ * a code point folding to the first one of the pattern's,
+ * e.g., \code{'k'}, \code{'K'} or the lead byte of the Kelvin sign.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use simple case folding instead of u_toupper;
+ *    ASCII fast path; skip to the possible match starts;
+ *    BUGFIX: findLast() used a wrong KMP table for non-ASCII patterns
+ */
 class StriByteSearchMatcherKMPci : public StriByteSearchMatcher {
 
    private:
@@ -253,9 +285,50 @@ class StriByteSearchMatcherKMPci : public StriByteSearchMatcher {
    protected:
 
       int* m_kmpNext;
+      int m_kmpDir; ///< 1 (table for findFirst), -1 (findLast) or 0 (none)
       int m_patternPos;
       R_len_t m_patternLenCaseInsensitive;
-      UChar32* m_patternStrCaseInsensitive;
+      UChar32* m_patternStrCaseInsensitive; ///< folded code points
+      int m_skipBytes; ///< 0 (do not skip) or 3
+      uint8_t m_skip[3]; ///< bytes at which a match may start
+
+
+      /** find the (at most 3) lead bytes of the code points
+       *  that fold to the first code point of the pattern
+       */
+      void setupSkip()
+      {
+         m_skipBytes = 0;
+         if (m_patternLenCaseInsensitive <= 0 || m_patternStrCaseInsensitive[0] < 0)
+            return;
+
+         UChar32 c0 = m_patternStrCaseInsensitive[0];
+         UnicodeSet set(c0, c0);
+         set.closeOver(USET_CASE_INSENSITIVE);
+         int nskip = 0;
+         for (int32_t r=0; r<set.getRangeCount(); ++r) {
+            for (UChar32 c=set.getRangeStart(r); c<=set.getRangeEnd(r); ++c) {
+               if (stri__utf8_fold_case(c) != c0) continue;
+               uint8_t buf[U8_MAX_LENGTH];
+               int32_t len = 0;
+               UBool err = FALSE;
+               U8_APPEND(buf, len, U8_MAX_LENGTH, c, err);
+               if (err) return;
+               bool found = false;
+               for (int k=0; k<nskip; ++k)
+                  if (m_skip[k] == buf[0]) found = true;
+               if (found) continue;
+               if (nskip >= 3) return; // too many, skipping is disabled
+               m_skip[nskip++] = buf[0];
+            }
+         }
+
+         if (nskip <= 0) return;
+         for (int k=nskip; k<3; ++k)
+            m_skip[k] = m_skip[0];
+         m_skipBytes = 3;
+      }
+
 
       virtual R_len_t findFromPos(R_len_t startPos) {
          int j = startPos;
@@ -263,8 +336,20 @@ class StriByteSearchMatcherKMPci : public StriByteSearchMatcher {
 
          UChar32 c = 0;
          while (j < m_searchLen) {
-            U8_NEXT(m_searchStr, j, m_searchLen, c);
-            c = u_toupper(c);
+            if (m_patternPos == 0 && m_skipBytes > 0) {
+               // no partial match - skip to where a match may start
+               j += stri__utf8_find_byte3(m_searchStr+j, m_searchLen-j,
+                  m_skip[0], m_skip[1], m_skip[2]);
+               if (j >= m_searchLen) break;
+            }
+
+            c = (uint8_t)m_searchStr[j];
+            if (c < 0x80) // ASCII fast path
+               ++j;
+            else
+               U8_NEXT(m_searchStr, j, m_searchLen, c);
+            c = stri__utf8_fold_case(c);
+
             while (m_patternPos >= 0 && m_patternStrCaseInsensitive[m_patternPos] != c)
                m_patternPos = m_kmpNext[m_patternPos];
             m_patternPos++;
@@ -302,11 +387,11 @@ class StriByteSearchMatcherKMPci : public StriByteSearchMatcher {
          int kmpMaxSize = patternLen+1; // that's sufficient
          this->m_kmpNext = new int[kmpMaxSize];
          if (!this->m_kmpNext) throw StriException(MSG__MEM_ALLOC_ERROR);
-         this->m_kmpNext[0] = -100; // magic constant for an uninitialized KMP table
+         this->m_kmpDir = 0; // KMP table not set up yet
 
          this->m_patternStrCaseInsensitive = new UChar32[kmpMaxSize];
          if (!this->m_patternStrCaseInsensitive) throw StriException(MSG__MEM_ALLOC_ERROR);
-            UChar32 c = 0;
+         UChar32 c = 0;
          R_len_t j = 0;
          m_patternLenCaseInsensitive = 0;
          while (j < patternLen) {
@@ -315,9 +400,11 @@ class StriByteSearchMatcherKMPci : public StriByteSearchMatcher {
             if (m_patternLenCaseInsensitive >= kmpMaxSize)
                throw StriException("!NDEBUG: StriByteSearchMatcherKMPci::StriByteSearchMatcherKMPci()");
 #endif
-            m_patternStrCaseInsensitive[m_patternLenCaseInsensitive++] = u_toupper(c);
+            m_patternStrCaseInsensitive[m_patternLenCaseInsensitive++] = stri__utf8_fold_case(c);
          }
          m_patternStrCaseInsensitive[m_patternLenCaseInsensitive] = 0;
+
+         setupSkip();
       }
 
       virtual void reset(const char* searchStr, R_len_t searchLen) {
@@ -326,8 +413,9 @@ class StriByteSearchMatcherKMPci : public StriByteSearchMatcher {
       }
 
       virtual R_len_t findFirst() {
-         if (this->m_kmpNext[0] <= -100) {
+         if (this->m_kmpDir != 1) {
             // Setup KMP table for FWD search
+            m_kmpDir = 1;
             m_kmpNext[0] = -1;
             for (R_len_t i=0; i<m_patternLenCaseInsensitive; ++i) {
                m_kmpNext[i+1] = m_kmpNext[i]+1;
@@ -341,13 +429,14 @@ class StriByteSearchMatcherKMPci : public StriByteSearchMatcher {
       }
 
       virtual R_len_t findLast()  {
-         if (this->m_kmpNext[0] <= -100) {
+         if (this->m_kmpDir != -1) {
             // Setup KMP table for BACK search
+            m_kmpDir = -1;
             m_kmpNext[0] = -1;
             for (R_len_t i=0; i<m_patternLenCaseInsensitive; ++i) {
                m_kmpNext[i+1] = m_kmpNext[i]+1;
                while (m_kmpNext[i+1] > 0 &&
-                     m_patternStrCaseInsensitive[m_patternLen-i-1] !=
+                     m_patternStrCaseInsensitive[m_patternLenCaseInsensitive-i-1] !=
                         m_patternStrCaseInsensitive[m_patternLenCaseInsensitive-(m_kmpNext[i+1]-1)-1])
                   m_kmpNext[i+1] = m_kmpNext[m_kmpNext[i+1]-1]+1;
             }
@@ -356,9 +445,12 @@ class StriByteSearchMatcherKMPci : public StriByteSearchMatcher {
          int j = m_searchLen;
          m_patternPos = 0;
          while (j > 0) {
-            UChar32 c;
-            U8_PREV(m_searchStr, 0, j, c);
-            c = u_toupper(c);
+            UChar32 c = (uint8_t)m_searchStr[j-1];
+            if (c < 0x80) // ASCII fast path
+               --j;
+            else
+               U8_PREV(m_searchStr, 0, j, c);
+            c = stri__utf8_fold_case(c);
             while (m_patternPos >= 0 &&
                   m_patternStrCaseInsensitive[m_patternLenCaseInsensitive-1-m_patternPos] != c)
                m_patternPos = m_kmpNext[m_patternPos];
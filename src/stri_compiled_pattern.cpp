@@ -0,0 +1,242 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include "stri_stringi.h"
+#include "stri_compiled_pattern.h"
+#include "stri_container_regex.h"
+#include "stri_container_bytesearch.h"
+#include "stri_container_usearch.h"
+
+
+/** Delete the object an external pointer refers to
+ *
+ * @param ptr external pointer
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void StriCompiledPattern::finalizer(SEXP ptr)
+{
+   StriCompiledPattern* obj = (StriCompiledPattern*)R_ExternalPtrAddr(ptr);
+   if (obj) {
+      delete obj;
+      R_ClearExternalPtr(ptr);
+   }
+}
+
+
+/** Get the compiled pattern attached to a character vector
+ *
+ * Throws StriException if the external pointer is no longer valid,
+ * e.g., if the object was serialized and loaded again.
+ *
+ * @param x character vector
+ * @param cls class name, \code{"stri_regex"}, \code{"stri_fixed"},
+ *    or \code{"stri_coll"}
+ * @return object of the class corresponding to \code{cls} or NULL
+ *    if \code{x} is not a compiled pattern of this kind
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriCompiledPattern* StriCompiledPattern::get(SEXP x, const char* cls)
+{
+   if (!isString(x) || !Rf_inherits(x, "stri_pattern"))
+      return NULL;
+
+   SEXP ptr = Rf_getAttrib(x, Rf_install(STRI__COMPILED_PATTERN_ATTR));
+   if (TYPEOF(ptr) != EXTPTRSXP || R_ExternalPtrTag(ptr) != Rf_install(cls))
+      return NULL;
+
+   StriCompiledPattern* obj = (StriCompiledPattern*)R_ExternalPtrAddr(ptr);
+   if (!obj)
+      throw StriException(MSG__COMPILED_PATTERN_INVALID);
+   return obj;
+}
+
+
+/** Create a compiled pattern object, to be filled with set()
+ *
+ * @param x character vector
+ * @param cls class name, see get()
+ * @return a copy of \code{x} of class \code{c(cls, "stri_pattern")}
+ *    with a (yet empty) external pointer attached
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP StriCompiledPattern::alloc(SEXP x, const char* cls)
+{
+   R_len_t n = LENGTH(x);
+   SEXP ret, strs, ptr, ret_cls;
+   PROTECT(ret = Rf_allocVector(STRSXP, n));
+   PROTECT(strs = Rf_allocVector(STRSXP, n));
+   for (R_len_t j=0; j<n; ++j) {
+      SET_STRING_ELT(ret, j, STRING_ELT(x, j));
+      SET_STRING_ELT(strs, j, STRING_ELT(x, j));
+   }
+   Rf_setAttrib(ret, R_NamesSymbol, Rf_getAttrib(x, R_NamesSymbol));
+
+   PROTECT(ptr = R_MakeExternalPtr(NULL, Rf_install(cls), strs));
+   R_RegisterCFinalizerEx(ptr, StriCompiledPattern::finalizer, TRUE);
+   Rf_setAttrib(ret, Rf_install(STRI__COMPILED_PATTERN_ATTR), ptr);
+
+   PROTECT(ret_cls = Rf_allocVector(STRSXP, 2));
+   SET_STRING_ELT(ret_cls, 0, Rf_mkChar(cls));
+   SET_STRING_ELT(ret_cls, 1, Rf_mkChar("stri_pattern"));
+   Rf_setAttrib(ret, R_ClassSymbol, ret_cls);
+
+   UNPROTECT(4);
+   return ret;
+}
+
+
+/** Get the private copy of the patterns
+ *
+ * @param x object created by alloc()
+ * @return character vector
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP StriCompiledPattern::getStrings(SEXP x)
+{
+   return R_ExternalPtrProtected(Rf_getAttrib(x, Rf_install(STRI__COMPILED_PATTERN_ATTR)));
+}
+
+
+/** Attach a compiled pattern to an object created by alloc()
+ *
+ * @param x object created by alloc()
+ * @param obj compiled pattern, the ownership is taken over
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void StriCompiledPattern::set(SEXP x, StriCompiledPattern* obj)
+{
+   R_SetExternalPtrAddr(Rf_getAttrib(x, Rf_install(STRI__COMPILED_PATTERN_ATTR)), obj);
+}
+
+
+/**
+ * Compile regex patterns
+ *
+ * @param pattern character vector
+ * @param opts_regex list
+ * @return character vector of class \code{c("stri_regex", "stri_pattern")}
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri_regex_compile(SEXP pattern, SEXP opts_regex)
+{
+   PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
+
+   StriRegexCompiledPattern* compiled = NULL;
+   STRI__ERROR_HANDLER_BEGIN(1)
+   SEXP ret;
+   STRI__PROTECT(ret = StriCompiledPattern::alloc(pattern, "stri_regex"));
+   compiled = new StriRegexCompiledPattern(StriCompiledPattern::getStrings(ret), pattern_opts);
+   compiled->compile(); // syntax errors are reported here
+   StriCompiledPattern::set(ret, compiled);
+   compiled = NULL; // now owned by ret
+
+   STRI__UNPROTECT_ALL
+   return ret;
+   STRI__ERROR_HANDLER_END(
+      if (compiled) delete compiled;
+   )
+}
+
+
+/**
+ * Compile fixed patterns
+ *
+ * @param pattern character vector
+ * @param opts_fixed list
+ * @return character vector of class \code{c("stri_fixed", "stri_pattern")}
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri_fixed_compile(SEXP pattern, SEXP opts_fixed)
+{
+   PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
+   uint32_t pattern_flags = StriContainerByteSearch::getByteSearchFlags(opts_fixed);
+
+   StriByteSearchCompiledPattern* compiled = NULL;
+   STRI__ERROR_HANDLER_BEGIN(1)
+   SEXP ret;
+   STRI__PROTECT(ret = StriCompiledPattern::alloc(pattern, "stri_fixed"));
+   compiled = new StriByteSearchCompiledPattern(StriCompiledPattern::getStrings(ret), pattern_flags);
+   compiled->compile();
+   StriCompiledPattern::set(ret, compiled);
+   compiled = NULL; // now owned by ret
+
+   STRI__UNPROTECT_ALL
+   return ret;
+   STRI__ERROR_HANDLER_END(
+      if (compiled) delete compiled;
+   )
+}
+
+
+/**
+ * Compile collation-based patterns
+ *
+ * @param pattern character vector
+ * @param opts_collator list
+ * @return character vector of class \code{c("stri_coll", "stri_pattern")}
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri_coll_compile(SEXP pattern, SEXP opts_collator)
+{
+   PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
+
+   // call stri__ucol_open after prepare_arg:
+   // if prepare_arg had failed, we would have a mem leak
+   UCollator* collator = NULL;
+   collator = stri__ucol_open(opts_collator);
+
+   StriUStringSearchCompiledPattern* compiled = NULL;
+   STRI__ERROR_HANDLER_BEGIN(1)
+   SEXP ret;
+   STRI__PROTECT(ret = StriCompiledPattern::alloc(pattern, "stri_coll"));
+   compiled = new StriUStringSearchCompiledPattern(StriCompiledPattern::getStrings(ret), collator);
+   collator = NULL; // now owned by compiled
+   StriCompiledPattern::set(ret, compiled);
+   compiled = NULL; // now owned by ret
+
+   STRI__UNPROTECT_ALL
+   return ret;
+   STRI__ERROR_HANDLER_END(
+      if (collator) ucol_close(collator);
+      if (compiled) delete compiled;
+   )
+}
@@ -0,0 +1,99 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef __stri_compiled_pattern_h
+#define __stri_compiled_pattern_h
+
+#include "stri_stringi.h"
+
+
+/** Name of the attribute holding the external pointer
+ *  to a StriCompiledPattern, see StriCompiledPattern::alloc() and set()
+ */
+#define STRI__COMPILED_PATTERN_ATTR "stri_compiled"
+
+
+/**
+ * Base class for search patterns compiled once and reused
+ * by many calls to the search functions,
+ * see \code{stri_regex_compile} etc.
+ *
+ * A compiled pattern is a character vector of class
+ * \code{c("stri_xxx", "stri_pattern")} with an attribute holding an
+ * external pointer to an object of a class derived from this one.
+ * The pointer's tag (the class name) identifies the derived class,
+ * so that changing the R class attribute does no harm.
+ * Its protected value is a private copy of the character vector,
+ * so that the pattern containers may check (by comparing
+ * the \code{CHARSXP}s) if the vector has not been modified
+ * since it was compiled, see isCompiled().
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriCompiledPattern {
+
+   private:
+
+      StriCompiledPattern(const StriCompiledPattern&); /* no copy-able */
+      StriCompiledPattern& operator=(const StriCompiledPattern&);
+
+      static void finalizer(SEXP ptr);
+
+
+   protected:
+
+      SEXP strs; ///< the patterns; protected by the external pointer
+
+
+   public:
+
+      StriCompiledPattern(SEXP _strs) : strs(_strs) { }
+      virtual ~StriCompiledPattern() { }
+
+      static StriCompiledPattern* get(SEXP x, const char* cls);
+      static SEXP alloc(SEXP x, const char* cls);
+      static SEXP getStrings(SEXP x);
+      static void set(SEXP x, StriCompiledPattern* obj);
+
+      /** Check if the jth pattern is the one compiled
+       *
+       * @param x character vector passed to a search function
+       * @param j index, \code{0 <= j < LENGTH(x)}
+       * @return bool
+       */
+      inline bool isCompiled(SEXP x, R_len_t j) const {
+         return j < LENGTH(strs) && STRING_ELT(x, j) == STRING_ELT(strs, j);
+      }
+};
+
+#endif
@@ -32,6 +32,7 @@
 
 #include "stri_stringi.h"
 #include "stri_container_base.h"
+#include "stri_ucnv.h"
 
 
 /**
@@ -43,6 +44,7 @@ StriContainerBase::StriContainerBase()
    this->n = 0;
    this->nrecycle = 0;
    this->sexp = (SEXP)NULL;
+   this->nativeUTF8 = NA_LOGICAL;
 #ifndef NDEBUG
    this->isShallow = true;
 #endif
@@ -79,3 +81,43 @@ void StriContainerBase::init_Base(R_len_t _n, R_len_t _nrecycle, bool _shallowre
 #endif
    }
 }
+
+
+/**
+ * Get the source CHARSXP of the vectorized ith element if it may be
+ * returned to R as-is by a function that has not altered the string
+ *
+ * This is the case if it is NA or it is in ASCII or in valid, BOM-free UTF-8
+ * (marked as such or in a native encoding which is UTF-8).
+ * Strings in other encodings would have to be re-encoded anyway.
+ *
+ * @param i index
+ * @return a CHARSXP or NULL (if the string must be rebuilt
+ *    or the container has not been created from an R vector)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP StriContainerBase::getUnchanged(R_len_t i) const
+{
+   if (!sexp || n <= 0) return (SEXP)NULL;
+   // n may be greater than LENGTH(sexp) if the container is not shallow
+   SEXP curs = STRING_ELT(sexp, i%LENGTH(sexp));
+   if (curs == NA_STRING || IS_ASCII(curs))
+      return curs;
+   if (IS_BYTES(curs) || IS_LATIN1(curs))
+      return (SEXP)NULL;
+
+   if (!IS_UTF8(curs)) { // native encoding
+      if (nativeUTF8 == NA_LOGICAL) {
+         StriUcnv ucnvNative(NULL);
+         nativeUTF8 = (int)ucnvNative.isUTF8();
+      }
+      if (!nativeUTF8) return (SEXP)NULL;
+   }
+
+   const char* s = CHAR(curs);
+   R_len_t sn = LENGTH(curs);
+   if (STRI__ENC_HAS_BOM_UTF8(s, sn) || !stri__utf8_is_valid(s, sn))
+      return (SEXP)NULL; // BOMs are removed and invalid sequences are replaced
+   return curs;
+}
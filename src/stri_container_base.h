@@ -47,6 +47,9 @@
  *
  * @version 0.2-1 (Marek Gagolewski, 2014-03-22)
  *          added sexp field
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *          new method: getUnchanged (identity pass-through)
  */
 class StriContainerBase {
 
@@ -54,7 +57,8 @@ class StriContainerBase {
 
       R_len_t n;                 ///< number of strings (size of \code{str})
       R_len_t nrecycle;          ///< number of strings for the recycle rule (can be > \code{n})
-      SEXP sexp;                 ///<
+      SEXP sexp;                 ///< source R character vector (may be NULL)
+      mutable int nativeUTF8;    ///< is the native encoding UTF-8? (NA_LOGICAL if not yet known)
 
 #ifndef NDEBUG
       bool isShallow;            ///< have we made only shallow copy of the strings? (=> read only)
@@ -66,6 +70,8 @@ class StriContainerBase {
 
       void init_Base(R_len_t n, R_len_t nrecycle, bool shallowrecycle, SEXP sexp=NULL);
 
+      SEXP getUnchanged(R_len_t i) const;
+
 
    public:
       //StriContainerBase& operator=(StriContainerBase& container); // use default (shallow)
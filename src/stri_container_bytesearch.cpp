@@ -44,18 +44,27 @@ StriContainerByteSearch::StriContainerByteSearch()
 {
    this->matcher = NULL;
    this->flags = 0;
+   this->compiled = NULL;
 }
 
 
 /**
  * Construct String Container from R character vector
+ *
+ * If \code{rstr} was generated by \code{stri_fixed_compile},
+ * the settings given at compile time are used instead of \code{flags}
+ * (except for the \code{overlap} option).
+ *
  * @param rstr R character vector
  * @param _nrecycle extend length [vectorization]
+ * @param _flags ByteSearch flags
  */
 StriContainerByteSearch::StriContainerByteSearch(SEXP rstr, R_len_t _nrecycle, uint32_t _flags)
    : StriContainerUTF8(rstr, _nrecycle, true)
 {
-   this->flags = _flags;
+   this->compiled = (StriByteSearchCompiledPattern*)StriCompiledPattern::get(rstr, "stri_fixed");
+   this->flags = (this->compiled)?
+      ((this->compiled->getFlags() & ~BYTESEARCH_OVERLAP) | (_flags & BYTESEARCH_OVERLAP)):_flags;
    this->matcher = NULL;
 }
 
@@ -68,6 +77,7 @@ StriContainerByteSearch::StriContainerByteSearch(StriContainerByteSearch& contai
 {
    this->matcher = NULL;
    this->flags = container.flags;
+   this->compiled = container.compiled;
 }
 
 
@@ -79,6 +89,8 @@ StriContainerByteSearch& StriContainerByteSearch::operator=(StriContainerByteSea
 {
    this->~StriContainerByteSearch();
    (StriContainerUTF8&) (*this) = (StriContainerUTF8&)container;
+   this->flags = container.flags;
+   this->compiled = container.compiled;
    return *this;
 }
 
@@ -97,8 +109,16 @@ StriContainerByteSearch::~StriContainerByteSearch()
 
 /**
  * @version 0.5-1 (Marek Gagolewski, 2015-02-14)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use the matchers of a compiled pattern
  */
 StriByteSearchMatcher* StriContainerByteSearch::getMatcher(R_len_t i) {
+   if (compiled && compiled->isCompiled(sexp, i % n)) {
+      StriByteSearchMatcher* compiled_matcher = compiled->getMatcher(i % n, isOverlap());
+      if (compiled_matcher) return compiled_matcher; // owned by compiled
+   }
+
    if (i >= n && matcher && matcher->getPatternStr() == get(i).c_str()) {
       // matcher reuse
    }
@@ -108,20 +128,39 @@ StriByteSearchMatcher* StriContainerByteSearch::getMatcher(R_len_t i) {
          matcher = NULL;
       }
 
-      if (isCaseInsensitive())
-         matcher = new StriByteSearchMatcherKMPci(get(i).c_str(), get(i).length(), isOverlap());
-      else if (get(i).length() == 1)
-         matcher = new StriByteSearchMatcher1(get(i).c_str(), get(i).length(), isOverlap());
-      else if (get(i).length() < 16)
-         matcher = new StriByteSearchMatcherShort(get(i).c_str(), get(i).length(), isOverlap());
-      else
-         matcher = new StriByteSearchMatcherKMP(get(i).c_str(), get(i).length(), isOverlap());
+      matcher = newMatcher(get(i), flags);
    }
 
    return matcher;
 }
 
 
+/** Create a matcher suitable for a given pattern
+ *
+ * @param pattern non-empty UTF-8 string (must stay valid while
+ *    the matcher is in use)
+ * @param flags ByteSearch flags
+ * @return a new matcher, to be deleted by the caller
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriByteSearchMatcher* StriContainerByteSearch::newMatcher(const String8& pattern, uint32_t flags)
+{
+   bool overlap = (bool)(flags&BYTESEARCH_OVERLAP);
+   StriByteSearchMatcher* matcher;
+   if (flags&BYTESEARCH_CASE_INSENSITIVE)
+      matcher = new StriByteSearchMatcherKMPci(pattern.c_str(), pattern.length(), overlap);
+   else if (pattern.length() == 1)
+      matcher = new StriByteSearchMatcher1(pattern.c_str(), pattern.length(), overlap);
+   else if (pattern.length() < 16)
+      matcher = new StriByteSearchMatcherShort(pattern.c_str(), pattern.length(), overlap);
+   else
+      matcher = new StriByteSearchMatcherKMP(pattern.c_str(), pattern.length(), overlap);
+   if (!matcher) throw StriException(MSG__MEM_ALLOC_ERROR);
+   return matcher;
+}
+
+
 /** find first match - case of short pattern
  *
  * @param startPos where to start
@@ -420,3 +459,59 @@ uint32_t StriContainerByteSearch::getByteSearchFlags(SEXP opts_fixed, bool allow
 
    return flags;
 }
+
+
+/** Construct an object to be filled by compile()
+ *
+ * @param strs patterns (must stay protected while this object exists)
+ * @param flags ByteSearch flags
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriByteSearchCompiledPattern::StriByteSearchCompiledPattern(SEXP _strs, uint32_t _flags)
+   : StriCompiledPattern(_strs), flags(_flags), strs_cont(_strs, LENGTH(_strs))
+{
+}
+
+
+/** Destructor
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriByteSearchCompiledPattern::~StriByteSearchCompiledPattern()
+{
+   for (size_t j=0; j<matchers.size(); ++j)
+      if (matchers[j]) delete matchers[j];
+}
+
+
+/** Create the matchers for all the patterns
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void StriByteSearchCompiledPattern::compile()
+{
+   R_len_t n = strs_cont.get_n();
+   matchers.resize(n, NULL);
+   for (R_len_t j=0; j<n; ++j) {
+      if (strs_cont.isNA(j) || strs_cont.get(j).length() <= 0)
+         continue; // never searched for
+      matchers[j] = StriContainerByteSearch::newMatcher(strs_cont.get(j), flags);
+   }
+}
+
+
+/** Get the matcher for the jth pattern
+ *
+ * @param j index
+ * @param overlap the \code{overlap} option
+ * @return matcher, owned by this object, or NULL for an NA or empty pattern
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriByteSearchMatcher* StriByteSearchCompiledPattern::getMatcher(R_len_t j, bool overlap)
+{
+   if (!matchers[j]) return NULL;
+   matchers[j]->setOverlap(overlap);
+   return matchers[j];
+}
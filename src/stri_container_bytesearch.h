@@ -35,6 +35,8 @@
 
 #include "stri_container_utf8.h"
 #include "stri_bytesearch_matcher.h"
+#include "stri_compiled_pattern.h"
+#include <vector>
 
 // #define STRI__BYTESEARCH_DISABLE_SHORTPAT
 
@@ -64,7 +66,12 @@
  *
  * @version 0.5-1 (Marek Gagolewski, 2015-02-14)
  *          use StriByteSearchMatcher
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *          accept patterns compiled by stri_fixed_compile;
+ *          new static method: newMatcher
  */
+class StriByteSearchCompiledPattern;
 class StriContainerByteSearch : public StriContainerUTF8 {
 
    private:
@@ -76,11 +83,13 @@ class StriContainerByteSearch : public StriContainerUTF8 {
 
       StriByteSearchMatcher* matcher;
       uint32_t flags; ///< ByteSearch flags
+      StriByteSearchCompiledPattern* compiled; ///< precompiled patterns or NULL, not owned
 
 
    public:
 
       static uint32_t getByteSearchFlags(SEXP opts_fixed, bool allow_overlap=false);
+      static StriByteSearchMatcher* newMatcher(const String8& pattern, uint32_t flags);
 
       StriContainerByteSearch();
       StriContainerByteSearch(SEXP rstr, R_len_t nrecycle, uint32_t flags);
@@ -99,4 +108,35 @@ class StriContainerByteSearch : public StriContainerUTF8 {
       }
 };
 
+
+/**
+ * Fixed patterns compiled by \code{stri_fixed_compile}
+ *
+ * The searchers (and their KMP tables) are created once for all the calls.
+ * The \code{overlap} option is not a part of a compiled pattern:
+ * each search function passes its own one to the matchers.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriByteSearchCompiledPattern : public StriCompiledPattern {
+
+   private:
+
+      uint32_t flags; ///< ByteSearch flags
+      StriContainerUTF8 strs_cont; ///< UTF-8 patterns the matchers refer to
+      std::vector<StriByteSearchMatcher*> matchers; ///< NULL for NA and empty patterns
+
+
+   public:
+
+      StriByteSearchCompiledPattern(SEXP strs, uint32_t flags);
+      ~StriByteSearchCompiledPattern();
+      void compile();
+      StriByteSearchMatcher* getMatcher(R_len_t j, bool overlap);
+
+      inline uint32_t getFlags() const {
+         return flags;
+      }
+};
+
 #endif
@@ -38,6 +38,127 @@
 #include <unicode/uniset.h>
 
 
+/**
+ * A character class: a frozen UnicodeSet plus a bitmap of its ASCII members
+ *
+ * Searching is done by means of spans (maximal runs of code points
+ * that all are or are not members of the set): ASCII bytes are
+ * looked up in the bitmap, everything else is delegated to
+ * UnicodeSet::spanUTF8/spanBackUTF8 (which, for a frozen set,
+ * use ICU's fast BMPSet lookup tables).
+ *
+ * The span functions assume that the input is valid UTF-8, see validate().
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriCharClass {
+
+   private:
+
+      UnicodeSet m_set;
+      uint32_t m_ascii[4]; // 128-bit bitmap
+
+   public:
+
+      StriCharClass()
+      {
+         m_ascii[0] = m_ascii[1] = m_ascii[2] = m_ascii[3] = 0;
+      }
+
+      /** Set a charclass from its pattern
+       *
+       * @param pattern e.g. \code{"\\p{L}"}
+       * @param status ICU error code
+       */
+      void applyPattern(const UnicodeString& pattern, UErrorCode& status)
+      {
+         m_set.applyPattern(pattern, status);
+         if (U_FAILURE(status)) return;
+         m_set.removeAllStrings(); // we match single code points only
+         m_set.freeze();
+
+         m_ascii[0] = m_ascii[1] = m_ascii[2] = m_ascii[3] = 0;
+         for (UChar32 c=0; c<128; ++c)
+            if (m_set.contains(c))
+               m_ascii[c>>5] |= ((uint32_t)1)<<(c&31);
+      }
+
+      inline bool isBogus() const { return m_set.isBogus(); }
+
+      inline void setToBogus() { m_set.setToBogus(); }
+
+      inline const UnicodeSet& getSet() const { return m_set; }
+
+      /** is a given code point a member of this charclass? */
+      inline bool contains(UChar32 c) const
+      {
+         if (c >= 0 && c < 128)
+            return (bool)((m_ascii[c>>5]>>(c&31))&1);
+         return m_set.contains(c);
+      }
+
+      /** Get the end of a run of code points
+       *
+       * @param s string (valid UTF-8)
+       * @param from starting byte index
+       * @param n number of bytes in \code{s}
+       * @param in do we span over members (true) or nonmembers (false)?
+       * @return index of the first byte >= from which begins a code point
+       * that is not (in==true) or is (in==false) a member of this charclass;
+       * \code{n} if there is no such code point
+       */
+      inline R_len_t span(const char* s, R_len_t from, R_len_t n, bool in) const
+      {
+         R_len_t j = from;
+         while (j < n) {
+            uint8_t c = (uint8_t)s[j];
+            if (c >= 0x80)
+               return j+(R_len_t)m_set.spanUTF8(s+j, (int32_t)(n-j),
+                  in?USET_SPAN_SIMPLE:USET_SPAN_NOT_CONTAINED);
+            if ((bool)((m_ascii[c>>5]>>(c&31))&1) != in)
+               return j;
+            ++j;
+         }
+         return n;
+      }
+
+      /** Get the start of a run of code points, going backwards
+       *
+       * @param s string (valid UTF-8)
+       * @param to byte index right after the run
+       * @param in do we span over members (true) or nonmembers (false)?
+       * @return index of the first byte of the maximal run
+       * of members (in==true) or nonmembers (in==false) ending at \code{to}
+       */
+      inline R_len_t spanBack(const char* s, R_len_t to, bool in) const
+      {
+         R_len_t j = to;
+         while (j > 0) {
+            uint8_t c = (uint8_t)s[j-1];
+            if (c >= 0x80)
+               return (R_len_t)m_set.spanBackUTF8(s, (int32_t)j,
+                  in?USET_SPAN_SIMPLE:USET_SPAN_NOT_CONTAINED);
+            if ((bool)((m_ascii[c>>5]>>(c&31))&1) != in)
+               return j;
+            --j;
+         }
+         return 0;
+      }
+
+      /** Throw an error if a string is not valid UTF-8
+       *
+       * @param s string
+       * @param n number of bytes in \code{s}
+       * @param isASCII is \code{s} known to be ASCII?
+       */
+      static inline void validate(const char* s, R_len_t n, bool isASCII)
+      {
+         if (!isASCII && !stri__utf8_is_valid(s, n))
+            throw StriException(MSG__INVALID_UTF8);
+      }
+};
+
+
 /**
  * A container handling charclass searches
  *
@@ -49,12 +170,15 @@
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-02)
  *          New method: locateAll
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *          Store StriCharClass objects (span-based engine)
  */
 class StriContainerCharClass : public StriContainerBase {
 
    private:
 
-      UnicodeSet* data; // array
+      StriCharClass* data; // array
 
    public:
 
@@ -75,7 +199,7 @@ class StriContainerCharClass : public StriContainerBase {
          this->data = NULL;
          if (_n > 0) {
             StriContainerUTF8 rvec_cont(rvec, _n, true);
-            this->data = new UnicodeSet[_n];
+            this->data = new StriCharClass[_n];
             for (int i=0; i<_n; ++i) {
                if (rvec_cont.isNA(i))
                   this->data[i].setToBogus();
@@ -84,7 +208,6 @@ class StriContainerCharClass : public StriContainerBase {
                   this->data[i].applyPattern(
                      UnicodeString::fromUTF8(rvec_cont.get(i).c_str()), status);
                   STRI__CHECKICUSTATUS_THROW(status, {delete [] data; data = NULL;})
-                  this->data[i].freeze();
                }
             }
          }
@@ -94,7 +217,7 @@ class StriContainerCharClass : public StriContainerBase {
          :StriContainerBase((StriContainerBase&)container)
       {
          if (container.data) {
-            this->data = new UnicodeSet[container.n];
+            this->data = new StriCharClass[container.n];
             for (int i=0; i<container.n; ++i)
                this->data[i] = container.data[i];
          }
@@ -111,7 +234,7 @@ class StriContainerCharClass : public StriContainerBase {
          this->~StriContainerCharClass();
          (StriContainerBase&) (*this) = (StriContainerBase&)container;
          if (container.data) {
-            this->data = new UnicodeSet[container.n];
+            this->data = new StriCharClass[container.n];
             for (int i=0; i<container.n; ++i)
                this->data[i] = container.data[i];
          }
@@ -138,7 +261,7 @@ class StriContainerCharClass : public StriContainerBase {
        * @param i index
        * @return integer
        */
-      inline const UnicodeSet& get(R_len_t i) const {
+      inline const StriCharClass& get(R_len_t i) const {
 #ifndef NDEBUG
          if (i < 0 || i >= nrecycle)
             throw StriException("StriContainerCharClass::get(): INDEX OUT OF BOUNDS");
@@ -153,52 +276,50 @@ class StriContainerCharClass : public StriContainerBase {
        *
        * @return total number of bytes @ pattern matches (idx_codepoint==false)
        * or total number of codepoints matched (idx_codepoint==true)
+       *
+       * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+       *    use StriCharClass::span
+       *
+       * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+       *    use StriOccurrences
        */
-      static R_len_t locateAll(deque< pair<R_len_t, R_len_t> >& occurrences,
-            const UnicodeSet* pattern_cur,
+      static R_len_t locateAll(StriOccurrences& occurrences,
+            const StriCharClass* pattern_cur,
             const char* str_cur_s, R_len_t str_cur_n,
             bool merge_cur, bool idx_codepoint)
       {
-         if (idx_codepoint) {
-            R_len_t j, k;
-            UChar32 chr;
-            R_len_t sumcodepoints = 0;
-            for (k=j=0; j<str_cur_n; ) {
-               ++k;
-               U8_NEXT(str_cur_s, j, str_cur_n, chr);
-               if (chr < 0) // invalid utf-8 sequence
-                  throw StriException(MSG__INVALID_UTF8);
-               if (pattern_cur->contains(chr)) {
-                  if (merge_cur && occurrences.size() > 0 &&
-                        occurrences.back().second == k-1)
-                     occurrences.back().second = k;
-                  else
-                     occurrences.push_back(pair<R_len_t, R_len_t>(k-1, k));
-                  ++sumcodepoints;
-               }
+         R_len_t sum = 0;
+         R_len_t k = 0; // code point index of j (if idx_codepoint)
+         for (R_len_t j=0; j<str_cur_n; ) {
+            R_len_t from = pattern_cur->span(str_cur_s, j, str_cur_n, false);
+            if (from >= str_cur_n) break;
+            R_len_t to = pattern_cur->span(str_cur_s, from, str_cur_n, true);
+
+            R_len_t from_idx = from, to_idx = to;
+            if (idx_codepoint) {
+               from_idx = k+stri__utf8_count_codepoints(str_cur_s+j, from-j);
+               to_idx   = from_idx+stri__utf8_count_codepoints(str_cur_s+from, to-from);
+               k = to_idx;
             }
-            return sumcodepoints;
-         }
-         else {
-            R_len_t j, jlast;
-            UChar32 chr;
-            R_len_t sumbytes = 0;
-            for (jlast=j=0; j<str_cur_n; ) {
-               U8_NEXT(str_cur_s, j, str_cur_n, chr);
-               if (chr < 0) // invalid utf-8 sequence
-                  throw StriException(MSG__INVALID_UTF8);
-               if (pattern_cur->contains(chr)) {
-                  if (merge_cur && occurrences.size() > 0 &&
-                        occurrences.back().second == jlast)
-                     occurrences.back().second = j;
-                  else
-                     occurrences.push_back(pair<R_len_t, R_len_t>(jlast, j));
-                  sumbytes += j-jlast;
+            sum += to_idx-from_idx;
+
+            if (merge_cur)
+               occurrences.push_back(pair<R_len_t, R_len_t>(from_idx, to_idx));
+            else if (idx_codepoint) {
+               for (R_len_t c=from_idx; c<to_idx; ++c)
+                  occurrences.push_back(pair<R_len_t, R_len_t>(c, c+1));
+            }
+            else {
+               for (R_len_t c=from; c<to; ) {
+                  R_len_t clast = c;
+                  U8_FWD_1(str_cur_s, c, to);
+                  occurrences.push_back(pair<R_len_t, R_len_t>(clast, c));
                }
-               jlast = j;
             }
-            return sumbytes;
+
+            j = to;
          }
+         return sum;
       }
 };
 
@@ -34,6 +34,12 @@
 #include "stri_container_regex.h"
 
 
+/** Initial size (in code units) of the window at the end of a string
+ *  in which the last match of a regex is looked for, see findLast()
+ */
+#define STRI__REGEX_LAST_WINDOW 256
+
+
 /**
  * Default constructor
  *
@@ -43,22 +49,44 @@ StriContainerRegexPattern::StriContainerRegexPattern()
 {
    this->lastMatcherIndex = -1;
    this->lastMatcher = NULL;
-   this->flags =0;
+   this->lastMatcherBackward = false;
+   this->lastDFA = NULL;
+   this->lastDFAIndex = -1;
+   this->prefilterIndex = -1;
+   this->anchorIndex = -1;
+   this->anchorType = 0;
+   this->anchorMaxLength = -1;
+   this->anchorText = NULL;
+   this->opts = StriRegexMatcherOptions();
+   this->compiled = NULL;
 }
 
 
 /**
  * Construct String Container from R character vector
+ *
+ * If \code{rstr} was generated by \code{stri_regex_compile},
+ * the settings given at compile time are used instead of \code{opts}.
+ *
  * @param rstr R character vector
  * @param nrecycle extend length [vectorization]
- * @param flags regexp flags
+ * @param opts regexp flags and limits
  */
-StriContainerRegexPattern::StriContainerRegexPattern(SEXP rstr, R_len_t _nrecycle, uint32_t _flags)
+StriContainerRegexPattern::StriContainerRegexPattern(SEXP rstr, R_len_t _nrecycle, StriRegexMatcherOptions _opts)
    : StriContainerUTF16(rstr, _nrecycle, true)
 {
    this->lastMatcherIndex = -1;
    this->lastMatcher = NULL;
-   this->flags = _flags;
+   this->lastMatcherBackward = false;
+   this->lastDFA = NULL;
+   this->lastDFAIndex = -1;
+   this->prefilterIndex = -1;
+   this->anchorIndex = -1;
+   this->anchorType = 0;
+   this->anchorMaxLength = -1;
+   this->anchorText = NULL;
+   this->compiled = (StriRegexCompiledPattern*)StriCompiledPattern::get(rstr, "stri_regex");
+   this->opts = (this->compiled)?this->compiled->getOptions():_opts;
 }
 
 
@@ -70,17 +98,47 @@ StriContainerRegexPattern::StriContainerRegexPattern(StriContainerRegexPattern&
 {
    this->lastMatcherIndex = -1;
    this->lastMatcher = NULL;
-   this->flags = container.flags;
+   this->lastMatcherBackward = false;
+   this->lastDFA = NULL;
+   this->lastDFAIndex = -1;
+   this->prefilterIndex = -1;
+   this->anchorIndex = -1;
+   this->anchorType = 0;
+   this->anchorMaxLength = -1;
+   this->anchorText = NULL;
+   this->opts = container.opts;
+   this->compiled = container.compiled;
 }
 
 
 StriContainerRegexPattern& StriContainerRegexPattern::operator=(StriContainerRegexPattern& container)
 {
-   this->~StriContainerRegexPattern();
+   if (lastMatcher) {
+      delete lastMatcher;
+      lastMatcher = NULL;
+   }
+   if (lastDFA) {
+      delete lastDFA;
+      lastDFA = NULL;
+   }
+   if (anchorText) {
+      utext_close(anchorText);
+      anchorText = NULL;
+   }
+   clearPrefilter();
    (StriContainerUTF16&) (*this) = (StriContainerUTF16&)container;
    this->lastMatcherIndex = -1;
    this->lastMatcher = NULL;
-   this->flags = container.flags;
+   this->lastMatcherBackward = false;
+   this->lastDFA = NULL;
+   this->lastDFAIndex = -1;
+   this->prefilterIndex = -1;
+   this->anchorIndex = -1;
+   this->anchorType = 0;
+   this->anchorMaxLength = -1;
+   this->anchorText = NULL;
+   this->opts = container.opts;
+   this->compiled = container.compiled;
    return *this;
 }
 
@@ -94,6 +152,29 @@ StriContainerRegexPattern::~StriContainerRegexPattern()
       delete lastMatcher;
       lastMatcher = NULL;
    }
+   if (lastDFA) {
+      delete lastDFA;
+      lastDFA = NULL;
+   }
+   if (anchorText) {
+      utext_close(anchorText);
+      anchorText = NULL;
+   }
+   clearPrefilter();
+}
+
+
+/** Free the prefilter's searchers
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void StriContainerRegexPattern::clearPrefilter()
+{
+   for (size_t j=0; j<prefilterMatchers.size(); ++j)
+      delete prefilterMatchers[j];
+   prefilterMatchers.clear();
+   prefilterLiterals.clear();
+   prefilterIndex = -1;
 }
 
 
@@ -117,21 +198,283 @@ RegexMatcher* StriContainerRegexPattern::getMatcher(R_len_t i)
    }
 
    UErrorCode status = U_ZERO_ERROR;
-   lastMatcher = new RegexMatcher(this->get(i), flags, status);
-   STRI__CHECKICUSTATUS_THROW(status, {if (lastMatcher) delete lastMatcher; lastMatcher = NULL;})
-   if (!lastMatcher) throw StriException(MSG__MEM_ALLOC_ERROR);
+   if (compiled && compiled->isCompiled(sexp, i % n))
+      lastMatcher = compiled->getMatcher(i % n); // no need to parse the pattern again
+   else {
+      lastMatcher = new RegexMatcher(this->get(i), opts.flags & ~STRI__REGEX_NO_DFA, status);
+      STRI__CHECKICUSTATUS_THROW(status, {if (lastMatcher) delete lastMatcher; lastMatcher = NULL;})
+      if (!lastMatcher) throw StriException(MSG__MEM_ALLOC_ERROR);
+   }
+
+   if (opts.time_limit >= 0)
+      lastMatcher->setTimeLimit(opts.time_limit, status);
+   if (opts.stack_limit >= 0)
+      lastMatcher->setStackLimit(opts.stack_limit, status);
+   STRI__CHECKICUSTATUS_THROW(status, {delete lastMatcher; lastMatcher = NULL;})
+
    this->lastMatcherIndex = (i % n);
+   this->lastMatcherBackward = isBackwardSearchable(this->get(i), opts.flags);
 
    return lastMatcher;
 }
 
 
-/** Read regex flags from a list
+/** Get the matcher for the ith pattern, reset with a UTF-8 string
+ *
+ * The string is converted to UTF-16 into an internal buffer, which stays
+ * valid until the next call to this method; invalid byte sequences
+ * are replaced with U+FFFD, as in \code{StriContainerUTF16}.
+ * The returned matcher shall not be deleted by the user.
+ *
+ * @param i index
+ * @param str haystack
+ * @param str_n number of bytes in \code{str}
+ * @return matcher
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+RegexMatcher* StriContainerRegexPattern::getMatcher(R_len_t i, const char* str, R_len_t str_n)
+{
+   RegexMatcher* matcher = getMatcher(i);
+
+   // a UTF-16 string has at most as many code units as its UTF-8 counterpart
+   UErrorCode status = U_ZERO_ERROR;
+   int32_t len16 = 0;
+   UChar* buf16 = lastInput.getBuffer(str_n+1);
+   if (!buf16) throw StriException(MSG__MEM_ALLOC_ERROR);
+   u_strFromUTF8WithSub(buf16, str_n+1, &len16, str, str_n, 0xfffd, NULL, &status);
+   lastInput.releaseBuffer(U_SUCCESS(status)?len16:0);
+   STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+
+   matcher->reset(lastInput);
+   return matcher;
+}
+
+
+/** Quickly check if the ith pattern may match a UTF-8 string
+ *
+ * A false result means that the string contains none of the literals
+ * one of which must occur in every match (see getRequiredLiterals()),
+ * so there is no need to run the regex engine.
+ * These literals are looked for with \code{StriByteSearchMatcher}s.
+ *
+ * @param i index
+ * @param str haystack
+ * @param str_n number of bytes in \code{str}
+ * @return bool
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool StriContainerRegexPattern::mayMatch(R_len_t i, const char* str, R_len_t str_n)
+{
+   if (prefilterIndex != (i % n)) {
+      clearPrefilter();
+      getRequiredLiterals(this->get(i), opts.flags, prefilterLiterals);
+      for (size_t j=0; j<prefilterLiterals.size(); ++j) {
+         const char* lit = prefilterLiterals[j].c_str();
+         R_len_t lit_n = (R_len_t)prefilterLiterals[j].length();
+         StriByteSearchMatcher* matcher;
+         if (lit_n == 1)
+            matcher = new StriByteSearchMatcher1(lit, lit_n, false);
+         else if (lit_n < 16)
+            matcher = new StriByteSearchMatcherShort(lit, lit_n, false);
+         else
+            matcher = new StriByteSearchMatcherKMP(lit, lit_n, false);
+         if (!matcher) throw StriException(MSG__MEM_ALLOC_ERROR);
+         prefilterMatchers.push_back(matcher);
+      }
+      prefilterIndex = (i % n);
+   }
+
+   if (prefilterMatchers.empty())
+      return true; // nothing known
+
+   for (size_t j=0; j<prefilterMatchers.size(); ++j) {
+      prefilterMatchers[j]->reset(str, str_n);
+      if (prefilterMatchers[j]->findFirst() != USEARCH_DONE)
+         return true;
+   }
+   return false;
+}
+
+
+/** Get the automaton for the ith pattern (not reset)
+ *
+ * @param i index
+ * @return automaton or NULL if the pattern is not supported
+ *    or the \code{dfa} option is off
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriRegexDFA* StriContainerRegexPattern::getDFA(R_len_t i)
+{
+   if (opts.flags & STRI__REGEX_NO_DFA)
+      return NULL;
+
+   if (compiled && compiled->isCompiled(sexp, i % n))
+      return compiled->getDFA(i % n); // owned by compiled
+
+   if (lastDFAIndex != (i % n)) {
+      if (lastDFA) {
+         delete lastDFA;
+         lastDFA = NULL;
+      }
+      getMatcher(i); // syntax errors are reported by ICU
+      lastDFA = StriRegexDFA::compile(this->get(i), opts.flags);
+      lastDFAIndex = (i % n);
+   }
+
+   return lastDFA;
+}
+
+
+/** Get the automaton for the ith pattern, reset with a UTF-8 string
+ *
+ * StriRegexDFA gives the same results as ICU's \code{RegexMatcher}
+ * in linear time, but supports only a subset of the regex syntax.
+ * The automaton is not used if the string is not valid UTF-8
+ * (for \code{RegexMatcher} sees U+FFFD in place of invalid bytes)
+ * or if the \code{dfa} option is off.
+ * The returned object shall not be deleted by the user.
+ *
+ * @param i index
+ * @param str haystack (must stay valid while the automaton is in use)
+ * @param str_n number of bytes in \code{str}
+ * @return automaton or NULL if ICU should be used instead
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriRegexDFA* StriContainerRegexPattern::getDFA(R_len_t i, const char* str, R_len_t str_n)
+{
+   StriRegexDFA* dfa = getDFA(i);
+   if (!dfa || !stri__utf8_is_valid(str, str_n))
+      return NULL;
+
+   dfa->reset(str, str_n);
+   return dfa;
+}
+
+
+/** Search for the ith pattern in a region of a UTF-8 string [internal]
+ *
+ * The region's bounds are transparent (look-around assertions
+ * see the whole string) and non-anchoring (\code{^} and \code{$}
+ * match only at the start and the end of the string).
+ * The string is accessed via a UTF-8 \code{UText},
+ * so it is not converted as a whole.
+ *
+ * @param i index
+ * @param str haystack
+ * @param str_n number of bytes in \code{str}
+ * @param from region start (byte index)
+ * @param to region end (byte index)
+ * @return true if found
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool StriContainerRegexPattern::findInRegion(R_len_t i, const char* str, R_len_t str_n, R_len_t from, R_len_t to)
+{
+   RegexMatcher* matcher = getMatcher(i);
+   UErrorCode status = U_ZERO_ERROR;
+   anchorText = utext_openUTF8(anchorText, str, str_n, &status);
+   STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+   matcher->reset(anchorText);
+   matcher->region(from, to, status);
+   STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+   matcher->useTransparentBounds(TRUE);
+   matcher->useAnchoringBounds(FALSE);
+   bool found = find(matcher);
+   matcher->useTransparentBounds(FALSE); // restore the defaults
+   matcher->useAnchoringBounds(TRUE);
+   return found;
+}
+
+
+/** Check quickly if the ith pattern matches a UTF-8 string, if it is anchored
+ *
+ * For patterns like \code{^lit}, \code{lit$} or \code{^lit$}, where
+ * \code{lit} is a literal string, the bytes at the start or the end of
+ * \code{str} are compared directly (as in \code{stri_startswith_fixed}
+ * and \code{stri_endswith_fixed}). Otherwise, if the length of matches
+ * is bounded (see getAnchors()), only a prefix or a suffix of \code{str}
+ * is searched (with the automaton or via findInRegion()).
+ * A pattern anchored at the start, whose matches' length is unbounded,
+ * is looked for via findInRegion() (unless the automaton can be used).
+ * This way, the time needed does not depend on the length of \code{str}.
+ *
+ * @param i index
+ * @param str haystack
+ * @param str_n number of bytes in \code{str}
+ * @return \code{TRUE}, \code{FALSE} or -1 if the general search routine
+ *    should be used instead (e.g., the pattern is not anchored)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+int StriContainerRegexPattern::matchAnchored(R_len_t i, const char* str, R_len_t str_n)
+{
+   if (anchorIndex != (i % n)) {
+      anchorType = getAnchors(this->get(i), opts.flags, anchorLiteral, anchorMaxLength);
+      anchorIndex = (i % n);
+   }
+
+   if (!anchorType || str_n <= 0)
+      return -1;
+
+   bool start = (anchorType & STRI__REGEX_ANCHOR_START) != 0;
+   bool end = (anchorType & (STRI__REGEX_ANCHOR_END|STRI__REGEX_ANCHOR_END_Z)) != 0;
+
+   if (!anchorLiteral.empty()) {
+      const char* lit = anchorLiteral.data();
+      R_len_t lit_n = (R_len_t)anchorLiteral.size();
+      // $ matches at the end and before a line terminator at the end
+      R_len_t end1 = (anchorType & STRI__REGEX_ANCHOR_END)?
+         stri__regex_dfa_end_pos1(str, str_n, (opts.flags & UREGEX_UNIX_LINES) != 0):-1;
+      if (start && end)
+         return (int)((str_n == lit_n || end1 == lit_n) && memcmp(str, lit, lit_n) == 0);
+      else if (start)
+         return (int)(str_n >= lit_n && memcmp(str, lit, lit_n) == 0);
+      else
+         return (int)((str_n >= lit_n && memcmp(str+str_n-lit_n, lit, lit_n) == 0) ||
+            (end1 >= lit_n && memcmp(str+end1-lit_n, lit, lit_n) == 0));
+   }
+
+   // a code point takes at most 4 bytes (U+FFFD in place of an invalid
+   // sequence: at most 3); +2 code points for a line terminator at the end
+   R_len_t window = (anchorMaxLength >= 0)?(4*(anchorMaxLength+2)+4):-1;
+
+   if (start && end && window >= 0)
+      return (str_n > window)?FALSE:-1; // a match would span the whole string
+
+   if (start) {
+      if (window < 0)
+         return getDFA(i)?-1:(int)findInRegion(i, str, str_n, 0, str_n);
+      if (str_n <= window)
+         return -1;
+      R_len_t to = window;
+      for (int k=0; k<3 && to < str_n && U8_IS_TRAIL(str[to]); ++k)
+         ++to; // do not split a UTF-8 sequence
+      if (StriRegexDFA* dfa = getDFA(i, str, to))
+         return (int)dfa->findAny();
+      return (int)findInRegion(i, str, str_n, 0, to);
+   }
+
+   if (window < 0 || str_n <= window)
+      return -1;
+   R_len_t from = str_n-window;
+   for (int k=0; k<3 && from > 0 && U8_IS_TRAIL(str[from]); ++k)
+      --from;
+   if (StriRegexDFA* dfa = getDFA(i, str+from, str_n-from))
+      return (int)dfa->findAny();
+   return (int)findInRegion(i, str, str_n, from, str_n);
+}
+
+
+/** Read regex flags and limits from a list
  *
  * may call Rf_error
  *
  * @param opts_regex list
- * @return flags
+ * @return flags and limits
  *
  * @version 0.1-?? (Marek Gagolewski)
  *
@@ -140,10 +483,18 @@ RegexMatcher* StriContainerRegexPattern::getMatcher(R_len_t i)
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-05)
  *    Disallow NA options
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    `dfa` option
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    `time_limit` and `stack_limit` options; renamed from getRegexFlags
  */
-uint32_t StriContainerRegexPattern::getRegexFlags(SEXP opts_regex)
+StriRegexMatcherOptions StriContainerRegexPattern::getRegexOptions(SEXP opts_regex)
 {
    uint32_t flags = 0;
+   int32_t time_limit = -1;
+   int32_t stack_limit = -1;
    if (!isNull(opts_regex) && !Rf_isVectorList(opts_regex))
       Rf_error(MSG__ARG_EXPECTED_LIST, "opts_regex"); // error() call allowed here
 
@@ -185,11 +536,879 @@ uint32_t StriContainerRegexPattern::getRegexFlags(SEXP opts_regex)
          } else if  (!strcmp(curname, "error_on_unknown_escapes")) {
             bool val = stri__prepare_arg_logical_1_notNA(VECTOR_ELT(opts_regex, i), "error_on_unknown_escapes");
             if (val) flags |= UREGEX_ERROR_ON_UNKNOWN_ESCAPES;
+         } else if  (!strcmp(curname, "dfa")) {
+            bool val = stri__prepare_arg_logical_1_notNA(VECTOR_ELT(opts_regex, i), "dfa");
+            if (!val) flags |= STRI__REGEX_NO_DFA;
+         } else if  (!strcmp(curname, "time_limit")) {
+            time_limit = stri__prepare_arg_integer_1_notNA(VECTOR_ELT(opts_regex, i), "time_limit");
+            if (time_limit < 0)
+               Rf_error(MSG__EXPECTED_NONNEGATIVE, "time_limit"); // error() call allowed here
+         } else if  (!strcmp(curname, "stack_limit")) {
+            stack_limit = stri__prepare_arg_integer_1_notNA(VECTOR_ELT(opts_regex, i), "stack_limit");
+            if (stack_limit < 0)
+               Rf_error(MSG__EXPECTED_NONNEGATIVE, "stack_limit"); // error() call allowed here
          } else {
             Rf_warning(MSG__INCORRECT_REGEX_OPTION, curname);
          }
       }
    }
 
-   return flags;
+   return StriRegexMatcherOptions(flags, time_limit, stack_limit);
+}
+
+
+/** Is a character special in a regex (outside of a set)?
+ *
+ * @param c a code unit
+ * @return bool
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static inline bool stri__regex_is_special(UChar c)
+{
+   return (c < 128 && strchr("\\^$.|?*+()[]{}", (char)c) != NULL && c != 0);
+}
+
+
+/** Get the length of a regex atom matching exactly one code point
+ *
+ * Recognized are: a set (\code{[...]}), \code{\\p{...}}, \code{\\P{...}},
+ * \code{\\d}, \code{\\w}, \code{\\s}, \code{\\h} (and their negations),
+ * \code{.} (if not in dotall mode, where it may match CR+LF),
+ * a (possibly escaped) literal character.
+ *
+ * @param p pattern
+ * @param n length of \code{p}
+ * @param flags regex flags
+ * @return number of code units consumed or -1 if \code{p} does not start
+ *    with such an atom
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static int32_t stri__regex_atom_length(const UChar* p, int32_t n, uint32_t flags)
+{
+   if (n <= 0) return -1;
+
+   if (p[0] == (UChar)'.')
+      return (flags & UREGEX_DOTALL)?-1:1;
+
+   if (p[0] == (UChar)'[') {
+      int32_t depth = 0;
+      for (int32_t j=0; j<n; ) {
+         if (p[j] == (UChar)'\\') {
+            if (j+1 >= n) return -1;
+            UChar d = p[j+1];
+            j += 2;
+            if ((d == (UChar)'p' || d == (UChar)'P' || d == (UChar)'N') && j < n && p[j] == (UChar)'{') {
+               while (j < n && p[j] != (UChar)'}') ++j;
+               if (j >= n) return -1;
+               ++j;
+            }
+         }
+         else if (p[j] == (UChar)'[') {
+            ++depth;
+            ++j;
+         }
+         else if (p[j] == (UChar)']') {
+            --depth;
+            ++j;
+            if (depth == 0) return j;
+         }
+         else if (p[j] == (UChar)'{')
+            return -1; // a string, may match many code points
+         else
+            ++j;
+      }
+      return -1;
+   }
+
+   if (p[0] == (UChar)'\\') {
+      if (n < 2) return -1;
+      UChar d = p[1];
+      if (d < 128 && strchr("dDwWsShH", (char)d) && d != 0)
+         return 2;
+      if (d == (UChar)'p' || d == (UChar)'P') {
+         if (n > 2 && p[2] == (UChar)'{') {
+            for (int32_t j=3; j<n; ++j)
+               if (p[j] == (UChar)'}') return j+1;
+            return -1;
+         }
+         if (n > 2 && p[2] < 128 && isalpha((int)p[2]))
+            return 3;
+         return -1;
+      }
+      if (d < 128 && !isalnum((int)d))
+         return 2; // escaped literal
+      return -1;
+   }
+
+   if (stri__regex_is_special(p[0]))
+      return -1;
+
+   if (U16_IS_LEAD(p[0]) && n > 1 && U16_IS_TRAIL(p[1]))
+      return 2;
+   return 1;
+}
+
+
+/** Check if no proper prefix of a string is also its suffix
+ *
+ * If so, occurrences of the string cannot overlap.
+ *
+ * @param p string
+ * @param n length of \code{p}
+ * @return bool
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static bool stri__regex_is_border_free(const UChar* p, int32_t n)
+{
+   if (n <= 0) return false;
+   // KMP failure function; the longest proper border of p is fail[n]
+   std::vector<int32_t> fail(n+1, 0);
+   fail[0] = -1;
+   for (int32_t j=1, k=-1; j<=n; ++j) {
+      while (k >= 0 && p[k] != p[j-1]) k = fail[k];
+      fail[j] = ++k;
+   }
+   return fail[n] == 0;
+}
+
+
+/** Can the last match of a regex pattern be found by searching
+ *  backwards, in growing windows at the end of a string?
+ *
+ * This is the case if all matches are of the following forms,
+ * which guarantees that searching from within a string yields
+ * (eventually) the same matches as searching from its beginning:
+ * a single code point (e.g., a set), a maximal run of such code points
+ * (an atom followed by a greedy or possessive \code{+}),
+ * or a literal string whose occurrences cannot overlap.
+ * Case-insensitive matching and the comments mode are not supported.
+ *
+ * @param pattern regex pattern
+ * @param flags regex flags
+ * @return bool
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool StriContainerRegexPattern::isBackwardSearchable(const UnicodeString& pattern, uint32_t flags)
+{
+   if (flags & (UREGEX_CASE_INSENSITIVE|UREGEX_COMMENTS))
+      return false;
+
+   const UChar* p = pattern.getBuffer();
+   int32_t n = pattern.length();
+   if (!p || n <= 0)
+      return false;
+
+   if (flags & UREGEX_LITERAL)
+      return stri__regex_is_border_free(p, n);
+
+   int32_t j = stri__regex_atom_length(p, n, flags);
+   if (j > 0) {
+      if (j == n) return true; // single atom
+      if (p[j] == (UChar)'+' &&
+            (j+1 == n || (j+2 == n && p[j+1] == (UChar)'+')))
+         return true; // atom+ or atom++
+   }
+
+   // is this a literal string?
+   UnicodeString literal;
+   for (j=0; j<n; ) {
+      if (p[j] == (UChar)'\\') {
+         if (j+1 >= n || p[j+1] >= 128 || isalnum((int)p[j+1]))
+            return false;
+         literal.append(p[j+1]);
+         j += 2;
+      }
+      else if (stri__regex_is_special(p[j]))
+         return false;
+      else
+         literal.append(p[j++]);
+   }
+   return stri__regex_is_border_free(literal.getBuffer(), literal.length());
+}
+
+
+/** Get the length of a regex quantifier
+ *
+ * Recognized are \code{?}, \code{*}, \code{+}, \code{\{n\}}, \code{\{n,\}},
+ * \code{\{n,m\}}, possibly followed by \code{?} (lazy) or \code{+} (possessive).
+ *
+ * @param p pattern
+ * @param n length of \code{p}
+ * @param optional [out] whether the quantified atom may occur 0 times
+ * @return number of code units consumed, 0 if \code{p} does not start
+ *    with a quantifier, or -1 on a malformed interval
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static int32_t stri__regex_quantifier_length(const UChar* p, int32_t n, bool& optional)
+{
+   optional = false;
+   if (n <= 0) return 0;
+
+   int32_t j;
+   if (p[0] == (UChar)'?' || p[0] == (UChar)'*') {
+      optional = true;
+      j = 1;
+   }
+   else if (p[0] == (UChar)'+')
+      j = 1;
+   else if (p[0] == (UChar)'{') {
+      bool nonzero = false;
+      for (j=1; j<n && p[j] >= (UChar)'0' && p[j] <= (UChar)'9'; ++j)
+         if (p[j] != (UChar)'0') nonzero = true;
+      if (j == 1) return -1;
+      while (j < n && p[j] != (UChar)'}') ++j;
+      if (j >= n) return -1;
+      ++j;
+      optional = !nonzero;
+   }
+   else
+      return 0;
+
+   if (j < n && (p[j] == (UChar)'?' || p[j] == (UChar)'+'))
+      ++j;
+   return j;
+}
+
+
+/** Can a string be looked for in UTF-8 haystacks instead of a regex engine?
+ *
+ * This is not the case for empty strings, unpaired surrogates,
+ * and U+FFFD, which may stand for an invalid byte sequence in the haystack.
+ *
+ * @param lit string
+ * @return bool
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static bool stri__regex_is_safe_literal(const UnicodeString& lit)
+{
+   int32_t m = lit.length();
+   if (m <= 0) return false;
+   for (int32_t l=0; l<m; ++l) {
+      if (lit[l] == (UChar)0xfffd)
+         return false;
+      if (U16_IS_LEAD(lit[l]) && l+1 < m && U16_IS_TRAIL(lit[l+1]))
+         ++l;
+      else if (U16_IS_SURROGATE(lit[l]))
+         return false;
+   }
+   return true;
+}
+
+
+/** Get literal strings, one of which must occur in every match of a regex
+ *
+ * The pattern is split at top-level alternations (\code{|}); in each
+ * alternative, the longest run of literal characters that are neither
+ * inside a group nor optional is taken. If there is an alternative
+ * with no such run, nothing is known about the matches.
+ *
+ * The analysis is conservative: case-insensitive matching, the comments mode,
+ * inline flags, back-references and rarely used escape sequences
+ * make it give up.
+ *
+ * @param pattern regex pattern
+ * @param flags regex flags
+ * @param literals [out] UTF-8-encoded literals (nonempty strings) or an empty
+ *    vector if nothing is known
+ * @return whether \code{literals} is nonempty
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool StriContainerRegexPattern::getRequiredLiterals(const UnicodeString& pattern,
+   uint32_t flags, std::vector<std::string>& literals)
+{
+   literals.clear();
+   if (flags & (UREGEX_CASE_INSENSITIVE|UREGEX_COMMENTS))
+      return false;
+
+   const UChar* p = pattern.getBuffer();
+   int32_t n = pattern.length();
+   if (!p || n <= 0)
+      return false;
+
+   std::vector<UnicodeString> found;
+   if (flags & UREGEX_LITERAL) {
+      if (!stri__regex_is_safe_literal(pattern)) return false;
+      found.push_back(pattern);
+   }
+   else {
+      UnicodeString best, cur;
+      int32_t depth = 0;
+      for (int32_t j=0; j<n; ) {
+         UChar c = p[j];
+         UnicodeString lit; // a literal (quantifiers apply to its last code point)
+         int32_t k;         // number of code units consumed
+
+         if (c == (UChar)'(') {
+            if (j+1 < n && p[j+1] == (UChar)'?') {
+               // (?:, (?=, (?!, (?<=, (?<!, (?>, (?<name>; inline flags are not supported
+               UChar d = (j+2 < n)?p[j+2]:0;
+               if (d == (UChar)'<' && j+3 < n && (p[j+3] == (UChar)'=' || p[j+3] == (UChar)'!' ||
+                     (p[j+3] < 128 && isalpha((int)p[j+3]))))
+                  ;
+               else if (d != (UChar)':' && d != (UChar)'=' && d != (UChar)'!' && d != (UChar)'>')
+                  return false;
+            }
+            ++depth;
+            k = 1;
+         }
+         else if (c == (UChar)')') {
+            if (depth <= 0) return false;
+            --depth;
+            k = 1;
+         }
+         else if (c == (UChar)'|') {
+            if (depth == 0) {
+               if (cur.length() > best.length()) best = cur;
+               if (best.length() <= 0) return false;
+               found.push_back(best);
+               best.remove();
+            }
+            cur.remove();
+            ++j;
+            continue;
+         }
+         else if (c == (UChar)'[') {
+            if (j+1 < n && (p[j+1] == (UChar)']' ||
+                  (p[j+1] == (UChar)'^' && j+2 < n && p[j+2] == (UChar)']')))
+               return false;
+            k = stri__regex_atom_length(p+j, n-j, flags);
+            if (k <= 0) return false;
+            for (int32_t l=j; l+1<j+k; ++l)
+               if (p[l] == (UChar)'\\' && p[l+1] == (UChar)'Q') return false;
+         }
+         else if (c == (UChar)'\\') {
+            if (j+1 >= n) return false;
+            UChar d = p[j+1];
+            if (d == (UChar)'Q') {
+               int32_t e = j+2;
+               while (e < n && !(p[e] == (UChar)'\\' && e+1 < n && p[e+1] == (UChar)'E')) ++e;
+               if (e == j+2) return false; // an empty \Q\E is transparent to quantifiers
+               lit.setTo(pattern, j+2, e-(j+2));
+               k = (e < n)?(e+2-j):(n-j);
+            }
+            else if (d >= 128 || !isalnum((int)d)) {
+               lit.setTo(d);
+               k = 2;
+            }
+            else if (d < 128 && strchr("tnrfae", (char)d)) {
+               const char* from = "tnrfae";
+               const char* to = "\t\n\r\f\a\x1b";
+               lit.setTo((UChar)to[strchr(from, (char)d)-from]);
+               k = 2;
+            }
+            else if (d < 128 && strchr("dDwWsShHvVRXbBAzZG", (char)d))
+               k = 2;
+            else if (d == (UChar)'p' || d == (UChar)'P') {
+               k = stri__regex_atom_length(p+j, n-j, flags);
+               if (k <= 0) return false;
+            }
+            else if (d == (UChar)'N' || d == (UChar)'x') {
+               if (j+2 < n && p[j+2] == (UChar)'{') {
+                  for (k=3; j+k < n && p[j+k] != (UChar)'}'; ++k)
+                     ;
+                  if (j+k >= n) return false;
+                  ++k;
+               }
+               else if (d == (UChar)'x')
+                  k = 4; // \xhh
+               else
+                  return false;
+            }
+            else if (d == (UChar)'u')
+               k = 6; // \uhhhh
+            else if (d == (UChar)'U')
+               k = 10; // \Uhhhhhhhh
+            else
+               return false; // back-references, octal escapes, \E, \cX, ...
+            if (j+k > n) return false;
+         }
+         else if (c == (UChar)'.' || c == (UChar)'^' || c == (UChar)'$')
+            k = 1;
+         else if (c == (UChar)'?' || c == (UChar)'*' || c == (UChar)'+' || c == (UChar)'{')
+            return false; // a dangling quantifier
+         else {
+            k = (U16_IS_LEAD(c) && j+1 < n && U16_IS_TRAIL(p[j+1]))?2:1;
+            lit.setTo(pattern, j, k);
+         }
+
+         bool optional = false;
+         int32_t q = (c == (UChar)'(')?0:stri__regex_quantifier_length(p+j+k, n-j-k, optional);
+         if (q < 0) return false;
+         j += k+q;
+
+         if (depth > 0 || c == (UChar)')')
+            lit.remove(); // only top-level literals are taken into account
+
+         bool valid = stri__regex_is_safe_literal(lit);
+
+         if (valid) {
+            if (q == 0)
+               cur.append(lit);
+            else {
+               int32_t m = lit.length();
+               if (optional)
+                  m -= (m >= 2 && U16_IS_TRAIL(lit[m-1]) && U16_IS_LEAD(lit[m-2]))?2:1;
+               cur.append(lit, 0, m);
+            }
+         }
+
+         if (!valid || q > 0) {
+            if (cur.length() > best.length()) best = cur;
+            cur.remove();
+         }
+      }
+
+      if (depth != 0) return false;
+      if (cur.length() > best.length()) best = cur;
+      if (best.length() <= 0) return false;
+      found.push_back(best);
+   }
+
+   for (size_t j=0; j<found.size(); ++j) {
+      std::string lit;
+      found[j].toUTF8String(lit);
+      literals.push_back(lit);
+   }
+   return true;
+}
+
+
+/** Does a regex contain an alternation (\code{|}) outside of groups?
+ *
+ * @param p pattern
+ * @param n length of \code{p}
+ * @return bool; true if unsure (e.g., if \code{\\Q} is used)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static bool stri__regex_has_toplevel_alternation(const UChar* p, int32_t n)
+{
+   int32_t depth = 0;
+   for (int32_t j=0; j<n; ++j) {
+      if (p[j] == (UChar)'\\') {
+         if (j+1 < n && p[j+1] == (UChar)'Q') return true;
+         ++j;
+      }
+      else if (p[j] == (UChar)'[') {
+         int32_t k = stri__regex_atom_length(p+j, n-j, 0);
+         if (k <= 0) return true;
+         j += k-1;
+      }
+      else if (p[j] == (UChar)'(')
+         ++depth;
+      else if (p[j] == (UChar)')')
+         --depth;
+      else if (p[j] == (UChar)'|' && depth == 0)
+         return true;
+   }
+   return false;
+}
+
+
+/** Get the maximal number of code points matched by a regex
+ *
+ * Recognized are alternations and sequences of atoms
+ * (see stri__regex_atom_length()), groups, look-around assertions
+ * and zero-width anchors, with \code{?} and bounded interval quantifiers.
+ * Anything else (\code{*}, \code{+}, back-references, inline flags, ...)
+ * makes the function give up.
+ *
+ * @param p pattern
+ * @param n length of \code{p}
+ * @param j [in/out] current position; on return, that of the unmatched
+ *    closing parenthesis or \code{n}
+ * @param flags regex flags
+ * @param depth group nesting level, at most 256 (then we give up)
+ * @return number of code points (case-sensitive matching)
+ *    or -1 if unknown or unbounded
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static int32_t stri__regex_max_length(const UChar* p, int32_t n, int32_t& j, uint32_t flags,
+   int32_t depth=0)
+{
+   const int64_t max_length = 1<<20;
+   const int32_t max_depth = 256;
+   int64_t best = 0, cur = 0;
+   while (j < n && p[j] != (UChar)')') {
+      UChar c = p[j];
+      int64_t len;
+      if (c == (UChar)'|') {
+         if (cur > best) best = cur;
+         cur = 0;
+         ++j;
+         continue;
+      }
+      else if (c == (UChar)'(') {
+         if (depth >= max_depth) return -1;
+         bool lookaround = false;
+         if (j+1 < n && p[j+1] == (UChar)'?') {
+            UChar d = (j+2 < n)?p[j+2]:0;
+            if (d == (UChar)':' || d == (UChar)'>')
+               j += 3;
+            else if (d == (UChar)'=' || d == (UChar)'!') {
+               j += 3;
+               lookaround = true;
+            }
+            else if (d == (UChar)'<' && j+3 < n && (p[j+3] == (UChar)'=' || p[j+3] == (UChar)'!')) {
+               j += 4;
+               lookaround = true;
+            }
+            else if (d == (UChar)'<') { // (?<name>
+               for (j += 3; j < n && p[j] != (UChar)'>'; ++j)
+                  ;
+               if (j >= n) return -1;
+               ++j;
+            }
+            else
+               return -1; // inline flags etc.
+         }
+         else
+            ++j;
+         len = stri__regex_max_length(p, n, j, flags, depth+1);
+         if (len < 0 || j >= n) return -1;
+         ++j; // )
+         if (lookaround) len = 0;
+      }
+      else if (c == (UChar)'^' || c == (UChar)'$') {
+         len = 0;
+         ++j;
+      }
+      else if (c == (UChar)'\\' && j+1 < n && p[j+1] < 128 && p[j+1] != 0 && strchr("bBAzZG", (char)p[j+1])) {
+         len = 0;
+         j += 2;
+      }
+      else {
+         int32_t k = stri__regex_atom_length(p+j, n-j, flags);
+         if (k <= 0) return -1;
+         len = 1;
+         j += k;
+      }
+
+      bool optional;
+      int32_t q = stri__regex_quantifier_length(p+j, n-j, optional);
+      if (q < 0) return -1;
+      if (q > 0) {
+         if (p[j] == (UChar)'{') {
+            // {n}, {n,m}; {n,} is unbounded
+            int64_t times = 0;
+            int32_t l;
+            for (l=j+1; p[l] >= (UChar)'0' && p[l] <= (UChar)'9' && times <= max_length; ++l)
+               times = times*10+(p[l]-(UChar)'0');
+            if (p[l] == (UChar)',') {
+               if (p[l+1] < (UChar)'0' || p[l+1] > (UChar)'9') return -1;
+               times = 0;
+               for (l=l+1; p[l] >= (UChar)'0' && p[l] <= (UChar)'9' && times <= max_length; ++l)
+                  times = times*10+(p[l]-(UChar)'0');
+            }
+            if (times > max_length) return -1;
+            len *= times;
+         }
+         else if (p[j] != (UChar)'?')
+            return -1; // * or +
+         j += q;
+      }
+
+      cur += len;
+      if (cur > max_length) return -1;
+   }
+   return (int32_t)((cur > best)?cur:best);
+}
+
+
+/** Determine if a regex may only match at the start or the end of a string
+ *
+ * A pattern is anchored if it begins with \code{^} or \code{\\A}
+ * and/or ends with \code{$} or \code{\\z} and it has no top-level
+ * alternation. In the multiline mode, \code{^} and \code{$}
+ * match at line boundaries, so no pattern is considered anchored.
+ * Patterns with \code{\\b} or \code{\\B} are not considered either.
+ *
+ * @param pattern regex pattern
+ * @param flags regex flags
+ * @param literal [out] if the pattern apart from the anchors is
+ *    a literal string (case-sensitive matching), its UTF-8 representation;
+ *    otherwise, an empty string
+ * @param max_length [out] maximal number of code points
+ *    matched by the pattern apart from the anchors (see stri__regex_max_length())
+ *    or -1 if unknown
+ * @return a combination of \code{STRI__REGEX_ANCHOR_*} flags or 0
+ *    if the pattern is not anchored
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+int StriContainerRegexPattern::getAnchors(const UnicodeString& pattern, uint32_t flags,
+   std::string& literal, int32_t& max_length)
+{
+   literal.clear();
+   max_length = -1;
+   if (flags & (UREGEX_LITERAL|UREGEX_MULTILINE|UREGEX_COMMENTS))
+      return 0;
+
+   const UChar* p = pattern.getBuffer();
+   int32_t n = pattern.length();
+   if (!p || n <= 0)
+      return 0;
+
+   int type = 0;
+   int32_t from = 0, to = n;
+   if (p[0] == (UChar)'^') {
+      type |= STRI__REGEX_ANCHOR_START;
+      from = 1;
+   }
+   else if (n >= 2 && p[0] == (UChar)'\\' && p[1] == (UChar)'A') {
+      type |= STRI__REGEX_ANCHOR_START;
+      from = 2;
+   }
+
+   int32_t nbackslashes = 0; // preceding the last code unit
+   while (nbackslashes < n-1 && p[n-2-nbackslashes] == (UChar)'\\')
+      ++nbackslashes;
+   if (p[n-1] == (UChar)'$' && nbackslashes%2 == 0 && n-1 >= from) {
+      type |= STRI__REGEX_ANCHOR_END;
+      to = n-1;
+   }
+   else if (p[n-1] == (UChar)'z' && nbackslashes%2 == 1 && n-2 >= from) {
+      type |= STRI__REGEX_ANCHOR_END_Z;
+      to = n-2;
+   }
+
+   if (!type || stri__regex_has_toplevel_alternation(p+from, to-from))
+      return 0;
+
+   for (int32_t j=0; j+1<n; ++j) {
+      if (p[j] == (UChar)'\\') {
+         if (p[j+1] == (UChar)'b' || p[j+1] == (UChar)'B')
+            return 0; // ICU 55 evaluates \b at the end of a UTF-8 UText incorrectly
+         ++j;
+      }
+   }
+
+   if (!(flags & UREGEX_CASE_INSENSITIVE)) {
+      UnicodeString lit;
+      int32_t j = from;
+      while (j < to) {
+         if (p[j] == (UChar)'\\') {
+            if (j+1 >= to || p[j+1] >= 128 || isalnum((int)p[j+1]))
+               break;
+            lit.append(p[j+1]);
+            j += 2;
+         }
+         else if (stri__regex_is_special(p[j]))
+            break;
+         else
+            lit.append(p[j++]);
+      }
+      if (j == to && stri__regex_is_safe_literal(lit))
+         lit.toUTF8String(literal);
+   }
+
+   int32_t j = 0;
+   max_length = stri__regex_max_length(p+from, to-from, j, flags);
+   if (j != to-from)
+      max_length = -1; // an unmatched parenthesis
+   else if (max_length >= 0 && (flags & UREGEX_CASE_INSENSITIVE))
+      max_length *= 3; // a code point's full case folding has at most 3 code points
+
+   return type;
+}
+
+
+/** Find the last match of a regex [internal]
+ *
+ * @param matcher a matcher reset with the haystack
+ * @param n haystack length (native units)
+ * @param str16 UTF-16 haystack or NULL
+ * @param str8 UTF-8 haystack or NULL
+ * @param start [out] native index of the match start
+ * @param end [out] native index of the match end
+ * @return true if found
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool StriContainerRegexPattern::findLast(RegexMatcher* matcher, int64_t n,
+   const UChar* str16, const char* str8, int64_t& start, int64_t& end)
+{
+   UErrorCode status = U_ZERO_ERROR;
+   bool found = false;
+
+   if (!lastMatcherBackward || n <= STRI__REGEX_LAST_WINDOW) {
+      // enumerate all matches
+      while (find(matcher)) {
+         found = true;
+         start = matcher->start64(status);
+         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+         end = matcher->end64(status);
+         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+      }
+      return found;
+   }
+
+   // search in windows [k, n) of sizes 256, 512, 1024, ...
+   // the last match in a window is the true last match if it starts
+   // after k (then it cannot be a suffix of an earlier match
+   // nor be preceded by an overlapping one) or if k == 0
+   for (int64_t w = STRI__REGEX_LAST_WINDOW; ; w *= 2) {
+      int64_t k = (n > w)?(n-w):0;
+      if (str16) { // do not split a surrogate pair
+         if (k > 0 && U16_IS_TRAIL(str16[k]) && U16_IS_LEAD(str16[k-1])) --k;
+      }
+      else if (str8) { // do not start in the middle of a UTF-8 sequence
+         while (k > 0 && U8_IS_TRAIL(str8[k])) --k;
+      }
+
+      matcher->region(k, n, status);
+      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+      found = false;
+      while (find(matcher)) {
+         found = true;
+         start = matcher->start64(status);
+         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+         end = matcher->end64(status);
+         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+      }
+
+      if ((found && start > k) || k == 0) {
+         matcher->reset(); // restore the full region
+         return found;
+      }
+   }
+}
+
+
+/** Find the last match of the ith regex pattern in a UTF-16 string
+ *
+ * The matcher (see getMatcher()) must have been reset with \code{str}.
+ *
+ * @param i index
+ * @param str haystack
+ * @param start [out] UTF-16 index of the match start
+ * @param end [out] UTF-16 index of the match end
+ * @return true if found
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool StriContainerRegexPattern::findLast(R_len_t i, const UnicodeString& str, int64_t& start, int64_t& end)
+{
+   RegexMatcher* matcher = getMatcher(i);
+   return findLast(matcher, str.length(), str.getBuffer(), NULL, start, end);
+}
+
+
+/** Find the last match of the ith regex pattern in a UTF-8 string
+ *
+ * The matcher (see getMatcher()) must have been reset with a UTF-8 UText
+ * opened on \code{str}.
+ *
+ * @param i index
+ * @param str haystack
+ * @param str_n number of bytes in \code{str}
+ * @param start [out] byte index of the match start
+ * @param end [out] byte index of the match end
+ * @return true if found
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool StriContainerRegexPattern::findLast(R_len_t i, const char* str, R_len_t str_n, int64_t& start, int64_t& end)
+{
+   RegexMatcher* matcher = getMatcher(i);
+   return findLast(matcher, str_n, NULL, str, start, end);
+}
+
+
+/** Construct an object to be filled by compile()
+ *
+ * @param strs patterns (must stay protected while this object exists)
+ * @param opts regexp flags and limits
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriRegexCompiledPattern::StriRegexCompiledPattern(SEXP _strs, StriRegexMatcherOptions _opts)
+   : StriCompiledPattern(_strs), opts(_opts)
+{
+}
+
+
+/** Destructor
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriRegexCompiledPattern::~StriRegexCompiledPattern()
+{
+   for (size_t j=0; j<patterns.size(); ++j)
+      if (patterns[j]) delete patterns[j];
+   for (size_t j=0; j<dfas.size(); ++j)
+      if (dfas[j]) delete dfas[j];
+}
+
+
+/** Parse all the patterns
+ *
+ * Throws StriException on syntax errors.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void StriRegexCompiledPattern::compile()
+{
+   R_len_t n = LENGTH(strs);
+   StriContainerUTF16 strs_cont(strs, n);
+   patterns.resize(n, NULL);
+   dfas.resize(n, NULL);
+   dfaCompiled.resize(n, false);
+   for (R_len_t j=0; j<n; ++j) {
+      if (strs_cont.isNA(j))
+         continue; // never searched for
+
+      UErrorCode status = U_ZERO_ERROR;
+      UParseError parse_error;
+      patterns[j] = RegexPattern::compile(strs_cont.get(j),
+         opts.flags & ~STRI__REGEX_NO_DFA, parse_error, status);
+      STRI__CHECKICUSTATUS_THROW(status, {/* patterns[j] is deleted by the destructor */})
+      if (!patterns[j]) throw StriException(MSG__MEM_ALLOC_ERROR);
+   }
+}
+
+
+/** Create a matcher for the jth pattern
+ *
+ * @param j index
+ * @return a new matcher, to be deleted by the caller
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+RegexMatcher* StriRegexCompiledPattern::getMatcher(R_len_t j)
+{
+   if (!patterns[j]) throw StriException(MSG__INTERNAL_ERROR);
+   UErrorCode status = U_ZERO_ERROR;
+   RegexMatcher* matcher = patterns[j]->matcher(status);
+   STRI__CHECKICUSTATUS_THROW(status, {if (matcher) delete matcher;})
+   if (!matcher) throw StriException(MSG__MEM_ALLOC_ERROR);
+   return matcher;
+}
+
+
+/** Get the automaton for the jth pattern (not reset)
+ *
+ * The automaton is compiled on first use and owned by this object.
+ *
+ * @param j index
+ * @return automaton or NULL if the pattern is not supported
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriRegexDFA* StriRegexCompiledPattern::getDFA(R_len_t j)
+{
+   if (!dfaCompiled[j]) {
+      if (!patterns[j]) throw StriException(MSG__INTERNAL_ERROR);
+      dfas[j] = StriRegexDFA::compile(patterns[j]->pattern(), opts.flags);
+      dfaCompiled[j] = true;
+   }
+   return dfas[j];
 }
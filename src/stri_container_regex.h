@@ -37,6 +37,71 @@
 #include <unicode/regex.h>
 
 #include "stri_container_utf16.h"
+#include "stri_bytesearch_matcher.h"
+#include "stri_regex_dfa.h"
+#include "stri_compiled_pattern.h"
+#include <vector>
+#include <string>
+
+
+/** A stringi-specific regex flag (not passed to ICU):
+ *  do not use StriRegexDFA, see StriContainerRegexPattern::getDFA()
+ */
+#define STRI__REGEX_NO_DFA ((uint32_t)1<<30)
+
+
+/** Anchors of a regex pattern, see StriContainerRegexPattern::getAnchors() */
+#define STRI__REGEX_ANCHOR_START 1 ///< \code{^} or \code{\\A} at the beginning
+#define STRI__REGEX_ANCHOR_END   2 ///< \code{$} at the end
+#define STRI__REGEX_ANCHOR_END_Z 4 ///< \code{\\z} at the end
+
+
+/**
+ * Regex matcher settings, see StriContainerRegexPattern::getRegexOptions()
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+struct StriRegexMatcherOptions {
+   uint32_t flags;      ///< RegexMatcher flags (+ STRI__REGEX_NO_DFA)
+   int32_t time_limit;  ///< RegexMatcher::setTimeLimit() or -1 for ICU's default
+   int32_t stack_limit; ///< RegexMatcher::setStackLimit() or -1 for ICU's default
+
+   StriRegexMatcherOptions(uint32_t _flags=0, int32_t _time_limit=-1, int32_t _stack_limit=-1)
+      : flags(_flags), time_limit(_time_limit), stack_limit(_stack_limit) { }
+};
+
+
+/**
+ * Regex patterns compiled by \code{stri_regex_compile}
+ *
+ * Each pattern is parsed once; matchers are created from the frozen
+ * \code{RegexPattern}s and the automata (see StriRegexDFA) are kept
+ * together with their state caches between the calls.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriRegexCompiledPattern : public StriCompiledPattern {
+
+   private:
+
+      StriRegexMatcherOptions opts;
+      std::vector<RegexPattern*> patterns; ///< NULL for NA
+      std::vector<StriRegexDFA*> dfas;     ///< NULL if not supported or not compiled yet
+      std::vector<bool> dfaCompiled;       ///< has StriRegexDFA::compile been called?
+
+
+   public:
+
+      StriRegexCompiledPattern(SEXP strs, StriRegexMatcherOptions opts);
+      ~StriRegexCompiledPattern();
+      void compile();
+      RegexMatcher* getMatcher(R_len_t j);
+      StriRegexDFA* getDFA(R_len_t j);
+
+      inline const StriRegexMatcherOptions& getOptions() const {
+         return opts;
+      }
+};
 
 
 /**
@@ -49,26 +114,88 @@
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-05-27)
  *          BUGFIX: invalid matcher reuse on empty search string
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *          new methods: findLast, isBackwardSearchable
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *          new methods: mayMatch, getRequiredLiterals,
+ *          getMatcher for UTF-8 strings;
+ *          new method: getDFA;
+ *          time and stack limits (StriRegexMatcherOptions), new method: find;
+ *          new methods: getAnchors, matchAnchored;
+ *          accept patterns compiled by stri_regex_compile
  */
 class StriContainerRegexPattern : public StriContainerUTF16 {
 
    private:
 
-      uint32_t flags; ///< RegexMatcher flags
+      StriRegexMatcherOptions opts; ///< RegexMatcher flags and limits
+      StriRegexCompiledPattern* compiled; ///< precompiled patterns or NULL, not owned
       RegexMatcher* lastMatcher; ///< recently used \code{RegexMatcher}
       R_len_t lastMatcherIndex;  ///< used by vectorize_getMatcher
+      bool lastMatcherBackward;  ///< isBackwardSearchable() for lastMatcher
+      UnicodeString lastInput;   ///< UTF-16 copy of the string lastMatcher was reset with
+      StriRegexDFA* lastDFA;     ///< automaton for the pattern no. lastDFAIndex or NULL
+      R_len_t lastDFAIndex;      ///< pattern index lastDFA refers to
+
+      R_len_t prefilterIndex;    ///< pattern index prefilterMatchers refer to
+      std::vector<std::string> prefilterLiterals; ///< see getRequiredLiterals()
+      std::vector<StriByteSearchMatcher*> prefilterMatchers; ///< searchers for prefilterLiterals
+
+      R_len_t anchorIndex;       ///< pattern index the anchor* fields refer to
+      int anchorType;            ///< see getAnchors()
+      std::string anchorLiteral; ///< UTF-8 literal of an anchored pattern or empty
+      int32_t anchorMaxLength;   ///< max match length in code points or -1
+      UText* anchorText;         ///< UTF-8 haystack for matchAnchored()
+
+      void clearPrefilter();
+      StriRegexDFA* getDFA(R_len_t i);
+      bool findInRegion(R_len_t i, const char* str, R_len_t str_n, R_len_t from, R_len_t to);
+
+      bool findLast(RegexMatcher* matcher, int64_t n,
+         const UChar* str16, const char* str8, int64_t& start, int64_t& end);
 
 
    public:
 
-      static uint32_t getRegexFlags(SEXP opts_regex);
+      static StriRegexMatcherOptions getRegexOptions(SEXP opts_regex);
+      static bool isBackwardSearchable(const UnicodeString& pattern, uint32_t flags);
+      static bool getRequiredLiterals(const UnicodeString& pattern, uint32_t flags,
+         std::vector<std::string>& literals);
+      static int getAnchors(const UnicodeString& pattern, uint32_t flags,
+         std::string& literal, int32_t& max_length);
 
       StriContainerRegexPattern();
-      StriContainerRegexPattern(SEXP rstr, R_len_t nrecycle, uint32_t flags);
+      StriContainerRegexPattern(SEXP rstr, R_len_t nrecycle, StriRegexMatcherOptions opts);
       StriContainerRegexPattern(StriContainerRegexPattern& container);
       ~StriContainerRegexPattern();
       StriContainerRegexPattern& operator=(StriContainerRegexPattern& container);
       RegexMatcher* getMatcher(R_len_t i);
+      inline const StriRegexMatcherOptions& getOptions() const { return opts; }
+      RegexMatcher* getMatcher(R_len_t i, const char* str, R_len_t str_n);
+      /** the UTF-16 copy made by \code{getMatcher(i, str, str_n)} */
+      inline const UnicodeString& getLastInput() const { return lastInput; }
+      bool mayMatch(R_len_t i, const char* str, R_len_t str_n);
+      StriRegexDFA* getDFA(R_len_t i, const char* str, R_len_t str_n);
+      int matchAnchored(R_len_t i, const char* str, R_len_t str_n);
+      bool findLast(R_len_t i, const UnicodeString& str, int64_t& start, int64_t& end);
+      bool findLast(R_len_t i, const char* str, R_len_t str_n, int64_t& start, int64_t& end);
+
+      /** Find the next match with a matcher from getMatcher()
+       *
+       * Unlike \code{RegexMatcher::find()}, which just returns false,
+       * this fails with an error if the time or stack limit is exceeded
+       *
+       * @param matcher matcher
+       * @return true if found
+       */
+      static inline bool find(RegexMatcher* matcher) {
+         UErrorCode status = U_ZERO_ERROR;
+         bool found = (bool)matcher->find(status);
+         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+         return found;
+      }
 };
 
 #endif
@@ -44,11 +44,16 @@ StriContainerUStringSearch::StriContainerUStringSearch()
    this->lastMatcherIndex = -1;
    this->str = NULL;
    this->col = NULL;
+   this->compiled = NULL;
 }
 
 
 /**
  * Construct String Container from R character vector
+ *
+ * If \code{rstr} was generated by \code{stri_coll_compile},
+ * its own collator is used instead of \code{col}.
+ *
  * @param rstr R character vector
  * @param nrecycle extend length [vectorization]
  * @param col Collator; owned by external caller
@@ -58,7 +63,8 @@ StriContainerUStringSearch::StriContainerUStringSearch(SEXP rstr, R_len_t _nrecy
 {
    this->lastMatcherIndex = -1;
    this->lastMatcher = NULL;
-   this->col = _col;
+   this->compiled = (StriUStringSearchCompiledPattern*)StriCompiledPattern::get(rstr, "stri_coll");
+   this->col = (this->compiled)?this->compiled->getCollator():_col;
 }
 
 
@@ -71,6 +77,7 @@ StriContainerUStringSearch::StriContainerUStringSearch(StriContainerUStringSearc
    this->lastMatcherIndex = -1;
    this->lastMatcher = NULL;
    this->col = container.col;
+   this->compiled = container.compiled;
 }
 
 
@@ -81,6 +88,7 @@ StriContainerUStringSearch& StriContainerUStringSearch::operator=(StriContainerU
    this->lastMatcherIndex = -1;
    this->lastMatcher = NULL;
    this->col = container.col;
+   this->compiled = container.compiled;
    return *this;
 }
 
@@ -123,9 +131,15 @@ UStringSearch* StriContainerUStringSearch::getMatcher(R_len_t i, const UnicodeSt
  * @param i index
  * @param searchStr string to search in
  * @param searchStr_len string length in UChars
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use the matchers of a compiled pattern
  */
 UStringSearch* StriContainerUStringSearch::getMatcher(R_len_t i, const UChar* searchStr, int32_t searchStr_len)
 {
+   if (compiled && compiled->isCompiled(sexp, i % n))
+      return compiled->getMatcher(i % n, searchStr, searchStr_len); // owned by compiled
+
    if (!lastMatcher) {
       this->lastMatcherIndex = (i % n);
       UErrorCode status = U_ZERO_ERROR;
@@ -151,3 +165,57 @@ UStringSearch* StriContainerUStringSearch::getMatcher(R_len_t i, const UChar* se
 
    return lastMatcher;
 }
+
+
+/** Construct an object holding a collator
+ *
+ * @param strs patterns (must stay protected while this object exists)
+ * @param col collator, the ownership is taken over
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriUStringSearchCompiledPattern::StriUStringSearchCompiledPattern(SEXP _strs, UCollator* _col)
+   : StriCompiledPattern(_strs), col(_col), strs_cont(_strs, LENGTH(_strs)),
+     matchers(LENGTH(_strs), (UStringSearch*)NULL)
+{
+}
+
+
+/** Destructor
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriUStringSearchCompiledPattern::~StriUStringSearchCompiledPattern()
+{
+   for (size_t j=0; j<matchers.size(); ++j)
+      if (matchers[j]) usearch_close(matchers[j]);
+   if (col) {
+      ucol_close(col);
+      col = NULL;
+   }
+}
+
+
+/** Get the matcher for the jth pattern, set to search in a given string
+ *
+ * @param j index
+ * @param searchStr string to search in
+ * @param searchStr_len string length in UChars
+ * @return matcher, owned by this object
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+UStringSearch* StriUStringSearchCompiledPattern::getMatcher(R_len_t j, const UChar* searchStr, int32_t searchStr_len)
+{
+   UErrorCode status = U_ZERO_ERROR;
+   if (!matchers[j]) {
+      matchers[j] = usearch_openFromCollator(strs_cont.get(j).getBuffer(), strs_cont.get(j).length(),
+            searchStr, searchStr_len, col, NULL, &status);
+      STRI__CHECKICUSTATUS_THROW(status, {usearch_close(matchers[j]); matchers[j] = NULL;})
+   }
+   else {
+      usearch_setText(matchers[j], searchStr, searchStr_len, &status);
+      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+   }
+   return matchers[j];
+}
@@ -34,6 +34,8 @@
 #define __stri_container_usearch_h
 
 #include "stri_container_utf16.h"
+#include "stri_compiled_pattern.h"
+#include <vector>
 #include <unicode/coll.h>
 #include <unicode/ucol.h>
 #include <unicode/stsearch.h>
@@ -52,12 +54,17 @@
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-01)
  *          getMatcher() now also accepts UChar*
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *          accept patterns compiled by stri_coll_compile
  */
+class StriUStringSearchCompiledPattern;
 class StriContainerUStringSearch : public StriContainerUTF16 {
 
    private:
 
-      UCollator* col; ///< collator, owned by creator
+      UCollator* col; ///< collator, owned by creator (or by compiled)
+      StriUStringSearchCompiledPattern* compiled; ///< precompiled patterns or NULL, not owned
       UStringSearch* lastMatcher; ///< recently used \code{UStringSearch}
       R_len_t lastMatcherIndex;  ///< used by vectorize_getMatcher
 
@@ -73,4 +80,35 @@ class StriContainerUStringSearch : public StriContainerUTF16 {
       UStringSearch* getMatcher(R_len_t i, const UChar* searchStr, int32_t searchStr_len);
 };
 
+
+/**
+ * Collation-based patterns compiled by \code{stri_coll_compile}
+ *
+ * The collator is opened once and each pattern gets its own
+ * \code{UStringSearch} (opened on first use, as it needs a text
+ * to search in), so its collation elements are not recomputed
+ * on each call.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriUStringSearchCompiledPattern : public StriCompiledPattern {
+
+   private:
+
+      UCollator* col; ///< owned
+      StriContainerUTF16 strs_cont; ///< UTF-16 patterns the matchers refer to
+      std::vector<UStringSearch*> matchers; ///< NULL if not used yet
+
+
+   public:
+
+      StriUStringSearchCompiledPattern(SEXP strs, UCollator* col);
+      ~StriUStringSearchCompiledPattern();
+      UStringSearch* getMatcher(R_len_t j, const UChar* searchStr, int32_t searchStr_len);
+
+      inline UCollator* getCollator() const {
+         return col;
+      }
+};
+
 #endif
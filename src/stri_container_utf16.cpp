@@ -79,7 +79,7 @@ StriContainerUTF16::StriContainerUTF16(SEXP rstr, R_len_t _nrecycle, bool _shall
       throw StriException("DEBUG: !isString in StriContainerUTF16::StriContainerUTF16(SEXP rstr)");
 #endif
    R_len_t nrstr = LENGTH(rstr);
-   this->init_Base(nrstr, _nrecycle, _shallowrecycle); // calling LENGTH(rstr) fails on constructor call
+   this->init_Base(nrstr, _nrecycle, _shallowrecycle, rstr); // calling LENGTH(rstr) fails on constructor call
 
    if (this->n == 0)
       return; /* nothing more to do */
@@ -301,6 +301,30 @@ SEXP StriContainerUTF16::toR(R_len_t i) const
 }
 
 
+/** Export the ith string, known to be unaltered, to R
+ *
+ * The source CHARSXP is reused if possible (no UTF-16 to UTF-8
+ * conversion and no global CHARSXP cache lookup is needed),
+ * see StriContainerBase::getUnchanged.
+ *
+ * @param i index
+ * @return CHARSXP
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP StriContainerUTF16::toRUnchanged(R_len_t i) const
+{
+#ifndef NDEBUG
+   if (i < 0 || i >= nrecycle)
+      throw StriException("StriContainerUTF16::toRUnchanged(): INDEX OUT OF BOUNDS");
+#endif
+
+   SEXP curs = getUnchanged(i);
+   if (curs) return curs;
+   return toR(i);
+}
+
+
 /** Convert Unicode16-Char indices to Unicode32 (code points)
  *
  * \code{i1} and \code{i2} must be sorted increasingly
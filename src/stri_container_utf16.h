@@ -55,6 +55,9 @@
  *          UnicodeString::fromUTF8 (for speedup);
  *          str now is UnicodeString*, and not UnicodeString**;
  *          using UnicodeString::isBogus to represent NA
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *          remember the source vector, new method: toRUnchanged
  */
 class StriContainerUTF16 : public StriContainerBase {
 
@@ -73,6 +76,7 @@ class StriContainerUTF16 : public StriContainerBase {
       StriContainerUTF16& operator=(StriContainerUTF16& container);
       SEXP toR(R_len_t i) const;
       SEXP toR() const;
+      SEXP toRUnchanged(R_len_t i) const;
 
 
       /** check if the vectorized ith element is NA
@@ -52,6 +52,9 @@ StriContainerUTF8::StriContainerUTF8()
  * @param rstr R character vector
  * @param nrecycle extend length [vectorization]
  * @param shallowrecycle will \code{this->str} be ever modified?
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    convert from single-byte encodings via StriUcnv's lookup tables
  */
 StriContainerUTF8::StriContainerUTF8(SEXP rstr, R_len_t _nrecycle, bool _shallowrecycle)
 {
@@ -108,9 +111,9 @@ StriContainerUTF8::StriContainerUTF8(SEXP rstr, R_len_t _nrecycle, bool _shallow
       else {
 //             LATIN1 ------- OR ------ Native encoding
 
-         UConverter* ucnvCurrent;
+         StriUcnv* ucnvCurrentObj;
          if (IS_LATIN1(curs)) {
-            ucnvCurrent = ucnvLatin1.getConverter();
+            ucnvCurrentObj = &ucnvLatin1;
          }
          else { // "unknown" (native) encoding
             // an "unknown" (native) encoding may be set to UTF-8 (speedup)
@@ -122,7 +125,7 @@ StriContainerUTF8::StriContainerUTF8(SEXP rstr, R_len_t _nrecycle, bool _shallow
                continue;
             }
 
-            ucnvCurrent = ucnvNative.getConverter();
+            ucnvCurrentObj = &ucnvNative;
          }
 
          if (outbufsize < 0) {
@@ -159,8 +162,21 @@ StriContainerUTF8::StriContainerUTF8(SEXP rstr, R_len_t _nrecycle, bool _shallow
          // @TODO: test ucnv_convertEx
 
 
+         // version 4: single-byte encodings - direct table lookup,
+         // no UTF-16 pivot; falls back to ICU on unmapped bytes
+         const StriUcnv8bitTables* tab8bit = ucnvCurrentObj->get8bitTables();
+         if (tab8bit) {
+            R_len_t outrealsize = StriUcnv::convert8bitToUTF8(tab8bit,
+               CHAR(curs), LENGTH(curs), outbuf.data(), outbuf.size());
+            if (outrealsize >= 0) {
+               this->str[i].initialize(outbuf.data(), outrealsize, true/*memalloc*/, false/*killbom*/, false/*isASCII*/);
+               continue;
+            }
+         }
+
          // version 2: use u_strToUTF8 (faster than v1 and v2)
          // latin1/native -> UTF16
+         UConverter* ucnvCurrent = ucnvCurrentObj->getConverter();
          UErrorCode status = U_ZERO_ERROR;
          UnicodeString tmp(CHAR(curs), LENGTH(curs), ucnvCurrent, status);
          STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
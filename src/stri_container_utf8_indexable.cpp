@@ -45,6 +45,9 @@ StriContainerUTF8_indexable::StriContainerUTF8_indexable()
 {
    last_ind_back_str = NULL;
    last_ind_fwd_str = NULL;
+   metadata = R_NilValue;
+   metadata_length = NULL;
+   metadata_checkpoints = R_NilValue;
 }
 
 
@@ -62,6 +65,9 @@ StriContainerUTF8_indexable::StriContainerUTF8_indexable(SEXP rstr, R_len_t _nre
 {
    last_ind_back_str = NULL;
    last_ind_fwd_str = NULL;
+   metadata = R_NilValue;
+   metadata_length = NULL;
+   metadata_checkpoints = R_NilValue;
 }
 
 
@@ -75,6 +81,9 @@ StriContainerUTF8_indexable::StriContainerUTF8_indexable(StriContainerUTF8_index
 {
    last_ind_back_str = NULL;
    last_ind_fwd_str = NULL;
+   metadata = container.metadata;
+   metadata_length = container.metadata_length;
+   metadata_checkpoints = container.metadata_checkpoints;
 }
 
 
@@ -90,11 +99,55 @@ StriContainerUTF8_indexable& StriContainerUTF8_indexable::operator=(StriContaine
 
    last_ind_back_str = NULL;
    last_ind_fwd_str = NULL;
+   metadata = container.metadata;
+   metadata_length = container.metadata_length;
+   metadata_checkpoints = container.metadata_checkpoints;
 
    return *this;
 }
 
 
+/** Use the code point checkpoints from a stri_metadata object
+ *
+ * The object must outlive the container.
+ *
+ * @param metadata an R object; ignored if not generated
+ *    by \code{stri_metadata(..., checkpoints=TRUE)}
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void StriContainerUTF8_indexable::setMetadata(SEXP metadata)
+{
+   SEXP length = stri__metadata_get(metadata, "length", INTSXP);
+   SEXP checkpoints = stri__metadata_get(metadata, "checkpoints", VECSXP);
+   if (isNull(length) || isNull(checkpoints) || LENGTH(length) != n)
+      return;
+
+   this->metadata = metadata;
+   metadata_length = INTEGER(length);
+   metadata_checkpoints = checkpoints;
+}
+
+
+/** Get the code point checkpoints for a string
+ *
+ * @param i string index (in container)
+ * @return integer vector or \code{R_NilValue} if not available
+ *    or if the string has been modified since stri_metadata was called
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP StriContainerUTF8_indexable::getCheckpoints(R_len_t i)
+{
+   if (!metadata_length || !stri__metadata_unchanged(metadata, i%n))
+      return R_NilValue;
+   SEXP cur_checkpoints = VECTOR_ELT(metadata_checkpoints, i%n);
+   if (TYPEOF(cur_checkpoints) != INTSXP)
+      return R_NilValue;
+   return cur_checkpoints;
+}
+
+
 /** Convert BACKWARD UChar32-based index to UTF-8 based
  *
  * @param i string index (in container)
@@ -117,12 +170,23 @@ StriContainerUTF8_indexable& StriContainerUTF8_indexable::operator=(StriContaine
  *
  * @version 0.5-1 (Marek Gagolewski, 2015-02-14)
  *          use String8::isASCII
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *          use stri_metadata checkpoints
  */
 R_len_t StriContainerUTF8_indexable::UChar32_to_UTF8_index_back(R_len_t i, R_len_t wh)
 {
    R_len_t cur_n = get(i).length();
    if (wh <= 0) return cur_n;
    if (get(i).isASCII()) return std::max(cur_n-wh, 0);
+   if (!isNull(getCheckpoints(i))) {
+      // the number of code points is known, count from the start
+      R_len_t cur_len = metadata_length[i%n];
+      if (cur_len >= 0 && cur_len <= cur_n) {
+         if (wh >= cur_len) return 0;
+         return UChar32_to_UTF8_index_fwd(i, cur_len-wh);
+      }
+   }
    const char* cur_s = get(i).c_str();
 
 #ifndef NDEBUG
@@ -201,6 +265,9 @@ R_len_t StriContainerUTF8_indexable::UChar32_to_UTF8_index_back(R_len_t i, R_len
  *
  * @version 0.5-1 (Marek Gagolewski, 2015-02-14)
  *          use String8::isASCII
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *          use stri_metadata checkpoints
  */
 R_len_t StriContainerUTF8_indexable::UChar32_to_UTF8_index_fwd(R_len_t i, R_len_t wh)
 {
@@ -251,6 +318,22 @@ R_len_t StriContainerUTF8_indexable::UChar32_to_UTF8_index_fwd(R_len_t i, R_len_
       }
    }
 
+   if (metadata_length && wh-j >= STRI__METADATA_CHECKPOINT_INTERVAL) {
+      // jump to the nearest preceding checkpoint
+      // (one that lies within the string, at a code point boundary)
+      SEXP cur_checkpoints = getCheckpoints(i);
+      if (!isNull(cur_checkpoints)) {
+         R_len_t k = std::min(wh/STRI__METADATA_CHECKPOINT_INTERVAL,
+            (R_len_t)LENGTH(cur_checkpoints));
+         R_len_t cur_jres = (k > 0)?INTEGER(cur_checkpoints)[k-1]:0;
+         if (k*STRI__METADATA_CHECKPOINT_INTERVAL > j && cur_jres > jres && cur_jres <= cur_n
+               && (cur_jres == cur_n || !U8_IS_TRAIL(cur_s[cur_jres]))) {
+            j    = k*STRI__METADATA_CHECKPOINT_INTERVAL;
+            jres = cur_jres;
+         }
+      }
+   }
+
    // go forward
    while (j < wh && jres < cur_n) {
       U8_FWD_1((const uint8_t*)cur_s, jres, cur_n);
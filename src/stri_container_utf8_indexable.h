@@ -36,6 +36,12 @@
 #include "stri_container_utf8.h"
 
 
+/** code point checkpoints in stri_metadata objects are stored
+ *  for every STRI__METADATA_CHECKPOINT_INTERVAL-th code point
+ */
+#define STRI__METADATA_CHECKPOINT_INTERVAL 128
+
+
 /**
  * A class to handle conversion between R character
  * vectors and UTF-8 string vectors,
@@ -47,6 +53,8 @@
  *
  * @version 0.5-1 (Marek Gagolewski, 2015-02-14)
  *          use String8::isASCII
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *          use code point checkpoints from stri_metadata
  */
 class StriContainerUTF8_indexable : public StriContainerUTF8 {
 
@@ -62,6 +70,13 @@ class StriContainerUTF8_indexable : public StriContainerUTF8 {
       R_len_t last_ind_back_utf8;
       const char* last_ind_back_str;
 
+      // precomputed by stri_metadata (optional)
+      SEXP metadata;
+      const int* metadata_length;
+      SEXP metadata_checkpoints;
+
+      SEXP getCheckpoints(R_len_t i);
+
    public:
 
       StriContainerUTF8_indexable();
@@ -69,6 +84,8 @@ class StriContainerUTF8_indexable : public StriContainerUTF8 {
       StriContainerUTF8_indexable(StriContainerUTF8_indexable& container);
       StriContainerUTF8_indexable& operator=(StriContainerUTF8_indexable& container);
 
+      void setMetadata(SEXP metadata);
+
       void UTF8_to_UChar32_index(R_len_t i, int* i1, int* i2, const int ni, int adj1, int adj2);
       R_len_t UChar32_to_UTF8_index_back(R_len_t i, R_len_t wh);
       R_len_t UChar32_to_UTF8_index_fwd(R_len_t i, R_len_t wh);
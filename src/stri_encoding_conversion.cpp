@@ -213,6 +213,9 @@ SEXP stri_enc_toutf32(SEXP str)
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    validate: use the bulk validation kernel, copy valid chunks as-is
  */
 SEXP stri_enc_toutf8(SEXP str, SEXP is_unknown_8bit, SEXP validate)
 {
@@ -295,13 +298,9 @@ SEXP stri_enc_toutf8(SEXP str, SEXP is_unknown_8bit, SEXP validate)
 
          const char* s = CHAR(curs);
          R_len_t sn = LENGTH(curs);
-         R_len_t j = 0;
-         UChar32 c = 0;
-         while (c >= 0 && j < sn) {
-            U8_NEXT(s, j, sn, c);
-         }
+         R_len_t j = stri__utf8_invalid_pos(s, sn);
 
-         if (c >= 0) continue; // valid, nothing to do
+         if (j >= sn) continue; // valid, nothing to do
 
          if (LOGICAL(validate)[0] == NA_LOGICAL) {
             Rf_warning(MSG__INVALID_CODE_POINT_REPLNA);
@@ -312,22 +311,24 @@ SEXP stri_enc_toutf8(SEXP str, SEXP is_unknown_8bit, SEXP validate)
             String8buf buf(bufsize); // maximum: 1 byte -> U+FFFD (3 bytes)
             char* bufdata = buf.data();
 
-            j = 0;
-            R_len_t k = 0;
-            UBool err = FALSE;
-            while (!err && j < sn) {
+            // s[0..j) is valid, copy it as-is
+            R_len_t k = j;
+            memcpy(bufdata, s, (size_t)j);
+            while (j < sn) {
+               // s[j] starts an ill-formed sequence: skip it as U8_NEXT does
+               UChar32 c;
                U8_NEXT(s, j, sn, c);
-               if (c >= 0) {
-                  U8_APPEND((uint8_t*)bufdata, k, bufsize, c, err);
-               } else {
-                  Rf_warning(MSG__INVALID_CODE_POINT_FIXING);
-                  bufdata[k++] = (char)UCHAR_REPLACEMENT_UTF8_BYTE1;
-                  bufdata[k++] = (char)UCHAR_REPLACEMENT_UTF8_BYTE2;
-                  bufdata[k++] = (char)UCHAR_REPLACEMENT_UTF8_BYTE3;
-               }
-            }
+               Rf_warning(MSG__INVALID_CODE_POINT_FIXING);
+               bufdata[k++] = (char)UCHAR_REPLACEMENT_UTF8_BYTE1;
+               bufdata[k++] = (char)UCHAR_REPLACEMENT_UTF8_BYTE2;
+               bufdata[k++] = (char)UCHAR_REPLACEMENT_UTF8_BYTE3;
 
-            if (err) throw StriException(MSG__INTERNAL_ERROR);
+               // copy the next valid chunk
+               R_len_t jnext = j+stri__utf8_invalid_pos(s+j, sn-j);
+               memcpy(bufdata+k, s+j, (size_t)(jnext-j));
+               k += jnext-j;
+               j = jnext;
+            }
             SET_STRING_ELT(ret, i, Rf_mkCharLenCE(bufdata, k, CE_UTF8));
          }
       }
@@ -430,6 +431,131 @@ SEXP stri_enc_toascii(SEXP str)
 
 // ------------------------------------------------------------------------
 
+/** Convert a UTF-16 string with ICU, growing the output buffer if needed
+ *
+ * @param uconv_to target converter
+ * @param buf output buffer
+ * @param curs_tmp input string
+ * @param curn_tmp number of code units in \code{curs_tmp}
+ * @return number of bytes written
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    separated from stri_encode and stri_encode_from_marked
+ */
+R_len_t stri__encode_fromUChars(UConverter* uconv_to, String8buf& buf,
+   const UChar* curs_tmp, R_len_t curn_tmp)
+{
+   R_len_t bufneed = UCNV_GET_MAX_BYTES_FOR_STRING(curn_tmp, ucnv_getMaxCharSize(uconv_to));
+   // "The calculated size is guaranteed to be sufficient for this conversion."
+   buf.resize(bufneed, false/*destroy contents*/); // grows or stays as it was
+
+   UErrorCode status = U_ZERO_ERROR;
+   ucnv_resetFromUnicode(uconv_to);
+   bufneed = ucnv_fromUChars(uconv_to, buf.data(), buf.size(), curs_tmp,
+      curn_tmp, &status);
+   if (bufneed <= buf.size()) {
+      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+   }
+   else {// larger buffer needed [this shouldn't happen?]
+      buf.resize(bufneed, false/*destroy contents*/);
+      status = U_ZERO_ERROR;
+      bufneed = ucnv_fromUChars(uconv_to, buf.data(), buf.size(), curs_tmp,
+         curn_tmp, &status);
+      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+   }
+   return bufneed;
+}
+
+
+/** Input chunk size (in bytes) for streaming conversions */
+#define STRI__ENCODE_CHUNK_SIZE 65536
+
+/** Size (in UChars) of the UTF-16 pivot buffer used by ucnv_convertEx */
+#define STRI__ENCODE_PIVOT_SIZE 1024
+
+
+/** Convert a string between two encodings in a streaming manner
+ *
+ * The input is fed to \code{ucnv_convertEx} in fixed-size chunks
+ * (the converters' state is carried across chunk boundaries)
+ * so that no UTF-16 copy of the whole string is ever created;
+ * the output buffer grows geometrically as needed.
+ *
+ * @param uconv_from source converter
+ * @param uconv_to target converter
+ * @param curs input string
+ * @param curn number of bytes in \code{curs}
+ * @param buf output buffer
+ * @return number of bytes written
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t stri__encode_convertEx(UConverter* uconv_from, UConverter* uconv_to,
+   const char* curs, R_len_t curn, String8buf& buf)
+{
+   UChar pivot[STRI__ENCODE_PIVOT_SIZE];
+   UChar* pivot_source = pivot;
+   UChar* pivot_target = pivot;
+
+   const char* src     = curs;
+   const char* src_end = curs+curn;
+   R_len_t buf_used = 0;
+   UBool reset = TRUE;
+
+   for (;;) {
+      const char* src_limit = (src_end-src > STRI__ENCODE_CHUNK_SIZE)
+         ? src+STRI__ENCODE_CHUNK_SIZE : src_end;
+      UBool flush = (src_limit == src_end);
+
+      char* target = buf.data()+buf_used;
+      UErrorCode status = U_ZERO_ERROR;
+      ucnv_convertEx(uconv_to, uconv_from,
+         &target, buf.data()+buf.size(), &src, src_limit,
+         pivot, &pivot_source, &pivot_target, pivot+STRI__ENCODE_PIVOT_SIZE,
+         reset, flush, &status);
+      reset = FALSE;
+      buf_used = (R_len_t)(target-buf.data());
+
+      if (status == U_BUFFER_OVERFLOW_ERROR) {
+         if (buf.size() >= R_LEN_T_MAX/2)
+            throw StriException(MSG__BUF_SIZE_EXCEEDED);
+         buf.resize(2*buf.size(), true/*retain contents*/);
+         continue; // resume conversion from where we stopped
+      }
+
+      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+      if (flush)
+         return buf_used;
+   }
+}
+
+
+/** Store a converted string as the i-th element of the result
+ *
+ * @param ret character vector or list
+ * @param i index
+ * @param buf converted string
+ * @param bufneed number of bytes in \code{buf}
+ * @param to_raw should a raw vector be created?
+ * @param encmark_to encoding mark of the resulting CHARSXP
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    separated from stri_encode and stri_encode_from_marked
+ */
+void stri__encode_set_elt(SEXP ret, R_len_t i, const char* buf, R_len_t bufneed,
+   bool to_raw, cetype_t encmark_to)
+{
+   if (to_raw) {
+      SEXP outobj = Rf_allocVector(RAWSXP, bufneed);
+      memcpy(RAW(outobj), buf, (size_t)bufneed);
+      SET_VECTOR_ELT(ret, i, outobj); // no allocation in-between: no PROTECT
+   }
+   else {
+      SET_STRING_ELT(ret, i, Rf_mkCharLenCE(buf, bufneed, encmark_to));
+   }
+}
+
+
 /**
  * Convert character vector between marked encodings and the encoding provided
  *
@@ -448,6 +574,10 @@ SEXP stri_enc_toascii(SEXP str)
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    single-byte target encodings: convert directly from UTF-8
+ *    via StriUcnv's lookup tables
  */
 SEXP stri_encode_from_marked(SEXP str, SEXP to, SEXP to_raw)
 {
@@ -457,14 +587,17 @@ SEXP stri_encode_from_marked(SEXP str, SEXP to, SEXP to_raw)
 
    STRI__ERROR_HANDLER_BEGIN(1)
    R_len_t str_n = LENGTH(str);
-   StriContainerUTF16 str_cont(str, str_n);
 
    // get the number of strings to convert; if == 0, then you know what's the result
-   if (str_n <= 0) return Rf_allocVector(to_raw_logical?VECSXP:STRSXP, 0);
+   if (str_n <= 0) {
+      STRI__UNPROTECT_ALL
+      return Rf_allocVector(to_raw_logical?VECSXP:STRSXP, 0);
+   }
 
    // Open converters
    StriUcnv ucnv(selected_to);
    UConverter* uconv_to = ucnv.getConverter(true /*register_callbacks*/);
+   const StriUcnv8bitTables* tab_to = ucnv.get8bitTables();
 
    // Get target encoding mark
    cetype_t encmark_to = to_raw_logical?CE_BYTES:ucnv.getCE();
@@ -473,6 +606,43 @@ SEXP stri_encode_from_marked(SEXP str, SEXP to, SEXP to_raw)
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocVector(to_raw_logical?VECSXP:STRSXP, str_n));
 
+   if (tab_to) {
+      // single-byte target: UTF-8 -> TO directly, no UTF-16 pivot
+      StriContainerUTF8 str_cont(str, str_n);
+
+      R_len_t bufsize = 0;
+      for (R_len_t i=0; i<str_n; ++i) {
+         if (!str_cont.isNA(i) && str_cont.get(i).length() > bufsize)
+            bufsize = str_cont.get(i).length();
+      }
+      String8buf buf(bufsize); // each code point gives exactly one byte
+
+      for (R_len_t i=0; i<str_n; ++i) {
+         if (str_cont.isNA(i)) {
+            if (to_raw_logical) SET_VECTOR_ELT(ret, i, R_NilValue);
+            else                SET_STRING_ELT(ret, i, NA_STRING);
+            continue;
+         }
+
+         const char* curs = str_cont.get(i).c_str();
+         R_len_t curn     = str_cont.get(i).length();
+         buf.resize(curn, false/*destroy contents*/);
+         R_len_t bufneed = StriUcnv::convertUTF8To8bit(tab_to, curs, curn, buf.data());
+         if (bufneed < 0) {
+            // unmappable code points - let ICU substitute & warn
+            UnicodeString tmp = UnicodeString::fromUTF8(StringPiece(curs, curn));
+            bufneed = stri__encode_fromUChars(uconv_to, buf, tmp.getBuffer(), tmp.length());
+         }
+
+         stri__encode_set_elt(ret, i, buf.data(), bufneed, to_raw_logical, encmark_to);
+      }
+
+      STRI__UNPROTECT_ALL
+      return ret;
+   }
+
+   StriContainerUTF16 str_cont(str, str_n);
+
    // calculate required buf size
    R_len_t bufsize = 0;
    for (R_len_t i=0; i<str_n; ++i) {
@@ -495,32 +665,8 @@ SEXP stri_encode_from_marked(SEXP str, SEXP to, SEXP to_raw)
       if (!curs_tmp)
          throw StriException(MSG__INTERNAL_ERROR);
 
-      UErrorCode status = U_ZERO_ERROR;
-      ucnv_resetFromUnicode(uconv_to);
-      R_len_t bufneed = ucnv_fromUChars(uconv_to, buf.data(), buf.size(),
-            curs_tmp, curn_tmp, &status);
-      if (bufneed <= buf.size()) {
-         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-      }
-      else {// larger buffer needed [this shouldn't happen?]
-         buf.resize(bufneed, false/*destroy contents*/);
-         status = U_ZERO_ERROR;
-         bufneed = ucnv_fromUChars(uconv_to, buf.data(), buf.size(),
-               curs_tmp, curn_tmp, &status);
-         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-      }
-
-      if (to_raw_logical) {
-         SEXP outobj;
-         STRI__PROTECT(outobj = Rf_allocVector(RAWSXP, bufneed));
-         memcpy(RAW(outobj), buf.data(), (size_t)bufneed);
-         SET_VECTOR_ELT(ret, i, outobj);
-         STRI__UNPROTECT(1);
-      }
-      else {
-         SET_STRING_ELT(ret, i,
-            Rf_mkCharLenCE(buf.data(), bufneed, encmark_to));
-      }
+      R_len_t bufneed = stri__encode_fromUChars(uconv_to, buf, curs_tmp, curn_tmp);
+      stri__encode_set_elt(ret, i, buf.data(), bufneed, to_raw_logical, encmark_to);
    }
 
    STRI__UNPROTECT_ALL
@@ -561,6 +707,14 @@ SEXP stri_encode_from_marked(SEXP str, SEXP to, SEXP to_raw)
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    8-bit -> UTF-8 and UTF-8 -> 8-bit conversions
+ *    skip the UTF-16 pivot (use StriUcnv's lookup tables)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    other conversions are done in chunks with ucnv_convertEx,
+ *    the output buffer is no longer preallocated as 4*max input length
  */
 SEXP stri_encode(SEXP str, SEXP from, SEXP to, SEXP to_raw)
 {
@@ -590,6 +744,10 @@ SEXP stri_encode(SEXP str, SEXP from, SEXP to, SEXP to_raw)
    UConverter* uconv_from = ucnv1.getConverter(true /*register_callbacks*/);
    UConverter* uconv_to   = ucnv2.getConverter(true /*register_callbacks*/);
 
+   // direct single-byte <-> UTF-8 conversion available?
+   const StriUcnv8bitTables* tab_from = ucnv2.isUTF8() ? ucnv1.get8bitTables() : NULL;
+   const StriUcnv8bitTables* tab_to   = ucnv1.isUTF8() ? ucnv2.get8bitTables() : NULL;
+
    // Get target encoding mark
    cetype_t encmark_to = to_raw_logical?CE_BYTES:ucnv2.getCE();
 
@@ -597,14 +755,8 @@ SEXP stri_encode(SEXP str, SEXP from, SEXP to, SEXP to_raw)
    STRI__PROTECT(ret = Rf_allocVector(to_raw_logical?VECSXP:STRSXP, str_n));
 
 
-   // estimate required buf size
-   R_len_t bufsize = 0;
-   for (R_len_t i=0; i<str_n; ++i) {
-      if (!str_cont.isNA(i) && str_cont.get(i).length() > bufsize)
-         bufsize = str_cont.get(i).length();
-   }
-   bufsize = bufsize*4; // this is just an estimate (for 8bit->utf8 conversions)
-   String8buf buf(bufsize);
+   // the buffer grows as needed (by stri__encode_convertEx)
+   String8buf buf(STRI__ENCODE_CHUNK_SIZE);
 
    for (R_len_t i=0; i<str_n; ++i) {
       if (str_cont.isNA(i)) {
@@ -616,47 +768,25 @@ SEXP stri_encode(SEXP str, SEXP from, SEXP to, SEXP to_raw)
       const char* curs = str_cont.get(i).c_str();
       R_len_t curn     = str_cont.get(i).length();
 
-      UErrorCode status = U_ZERO_ERROR;
-      UnicodeString encs(curs, curn, uconv_from, status); // FROM -> UTF-16 [this is the slow part]
-      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-
-      R_len_t curn_tmp = encs.length();
-      const UChar* curs_tmp = encs.getBuffer(); // The buffer contents is (probably) not NUL-terminated.
-      if (!curs_tmp) {
-         throw StriException(MSG__INTERNAL_ERROR);
+      R_len_t bufneed = -1;
+      if (tab_from && curn <= R_LEN_T_MAX/3) {
+         // a single-byte charset maps to the BMP, i.e., at most 3 UTF-8 bytes
+         // per input byte; longer strings are converted in chunks below
+         buf.resize(3*curn, false/*destroy contents*/);
+         bufneed = StriUcnv::convert8bitToUTF8(tab_from, curs, curn, buf.data(), buf.size());
       }
-
-      R_len_t bufneed = UCNV_GET_MAX_BYTES_FOR_STRING(curn_tmp, ucnv_getMaxCharSize(uconv_to));
-      // "The calculated size is guaranteed to be sufficient for this conversion."
-      buf.resize(bufneed, false/*destroy contents*/); // grows or stays as it was
-
-      status = U_ZERO_ERROR;
-//      bufneed = encs.extract(buf.data(), buf.size(), uconv_to, status); // UTF-16 -> TO
-      ucnv_resetFromUnicode(uconv_to);
-      bufneed = ucnv_fromUChars(uconv_to, buf.data(), buf.size(), curs_tmp,
-         curn_tmp, &status);
-      if (bufneed <= buf.size()) {
-         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-      }
-      else {// larger buffer needed [this shouldn't happen?]
-//         warning("buf extending");
-         buf.resize(bufneed, false/*destroy contents*/);
-         status = U_ZERO_ERROR;
-         bufneed = ucnv_fromUChars(uconv_to, buf.data(), buf.size(), curs_tmp,
-            curn_tmp, &status);
-         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+      else if (tab_to) {
+         buf.resize(curn, false/*destroy contents*/);
+         bufneed = StriUcnv::convertUTF8To8bit(tab_to, curs, curn, buf.data());
       }
 
-      if (to_raw_logical) {
-         SEXP outobj;
-         STRI__PROTECT(outobj = Rf_allocVector(RAWSXP, bufneed));
-         memcpy(RAW(outobj), buf.data(), (size_t)bufneed);
-         SET_VECTOR_ELT(ret, i, outobj);
-         STRI__UNPROTECT(1);
-      }
-      else {
-         SET_STRING_ELT(ret, i, Rf_mkCharLenCE(buf.data(), bufneed, encmark_to));
+      if (bufneed < 0) {
+         // general case or unmappable chars (ICU substitutes & warns)
+         // FROM -> TO in chunks, via a small UTF-16 pivot buffer
+         bufneed = stri__encode_convertEx(uconv_from, uconv_to, curs, curn, buf);
       }
+
+      stri__encode_set_elt(ret, i, buf.data(), bufneed, to_raw_logical, encmark_to);
    }
 
    STRI__UNPROTECT_ALL
@@ -664,3 +794,104 @@ SEXP stri_encode(SEXP str, SEXP from, SEXP to, SEXP to_raw)
 
    STRI__ERROR_HANDLER_END({/* no special action on error */})
 }
+
+
+/**
+ * Convert a file between given encodings in bounded memory
+ *
+ * The input file is read in chunks, each of which is fed to
+ * \code{ucnv_convertEx} (the converters' state is carried
+ * across chunk boundaries); the output is written to \code{fname_out}
+ * as soon as it is available.
+ *
+ * @param fname_in input file name
+ * @param fname_out output file name
+ * @param from  source encoding, \code{NULL} or \code{""} for default enc
+ * @param to    target encoding, \code{NULL} or \code{""} for default enc
+ * @param chunk_size single integer, input chunk size in bytes
+ * @return number of bytes written (a double, as this may exceed INT_MAX)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri_encode_file(SEXP fname_in, SEXP fname_out, SEXP from, SEXP to, SEXP chunk_size)
+{
+   const char* fname_in_s  = stri__prepare_arg_string_1_notNA(fname_in, "fname_in");
+   const char* fname_out_s = stri__prepare_arg_string_1_notNA(fname_out, "fname_out");
+   const char* selected_from = stri__prepare_arg_enc(from, "from", true); /* this is R_alloc'ed */
+   const char* selected_to   = stri__prepare_arg_enc(to, "to", true); /* this is R_alloc'ed */
+   int chunk_size_val = stri__prepare_arg_integer_1_notNA(chunk_size, "chunk_size");
+   if (chunk_size_val <= 0)
+      Rf_error(MSG__EXPECTED_POSITIVE, "chunk_size");
+
+   // R_ExpandFileName may return a static buffer, overwritten by the next call
+   const char* fname_in_exp = R_ExpandFileName(fname_in_s);
+   char* fname_in_copy = R_alloc(strlen(fname_in_exp)+1, (int)sizeof(char));
+   strcpy(fname_in_copy, fname_in_exp);
+   fname_in_s  = fname_in_copy;
+   FILE* f_in = fopen(fname_in_s, "rb");
+   if (!f_in)
+      Rf_error(MSG__FILE_OPEN_ERROR, fname_in_s);
+   fname_out_s = R_ExpandFileName(fname_out_s);
+   FILE* f_out = fopen(fname_out_s, "wb");
+   if (!f_out) {
+      fclose(f_in);
+      Rf_error(MSG__FILE_OPEN_ERROR, fname_out_s);
+   }
+
+   STRI__ERROR_HANDLER_BEGIN(0)
+   StriUcnv ucnv1(selected_from);
+   StriUcnv ucnv2(selected_to);
+   UConverter* uconv_from = ucnv1.getConverter(true /*register_callbacks*/);
+   UConverter* uconv_to   = ucnv2.getConverter(true /*register_callbacks*/);
+
+   String8buf inbuf(chunk_size_val);
+   String8buf outbuf(UCNV_GET_MAX_BYTES_FOR_STRING(STRI__ENCODE_PIVOT_SIZE,
+      ucnv_getMaxCharSize(uconv_to)));
+
+   UChar pivot[STRI__ENCODE_PIVOT_SIZE];
+   UChar* pivot_source = pivot;
+   UChar* pivot_target = pivot;
+   UBool reset = TRUE;
+   UBool flush = FALSE;
+   double nwritten = 0.0;
+
+   while (!flush) {
+      size_t inbuf_n = fread(inbuf.data(), 1, (size_t)chunk_size_val, f_in);
+      if (ferror(f_in))
+         throw StriException(MSG__FILE_IO_ERROR, fname_in_s);
+      flush = (inbuf_n < (size_t)chunk_size_val && feof(f_in));
+
+      const char* src = inbuf.data();
+      const char* src_limit = inbuf.data()+inbuf_n;
+      UErrorCode status;
+      do {
+         char* target = outbuf.data();
+         status = U_ZERO_ERROR;
+         ucnv_convertEx(uconv_to, uconv_from,
+            &target, outbuf.data()+outbuf.size(), &src, src_limit,
+            pivot, &pivot_source, &pivot_target, pivot+STRI__ENCODE_PIVOT_SIZE,
+            reset, flush, &status);
+         reset = FALSE;
+
+         size_t outbuf_n = (size_t)(target-outbuf.data());
+         if (outbuf_n > 0 && fwrite(outbuf.data(), 1, outbuf_n, f_out) != outbuf_n)
+            throw StriException(MSG__FILE_IO_ERROR, fname_out_s);
+         nwritten += (double)outbuf_n;
+      } while (status == U_BUFFER_OVERFLOW_ERROR); // output buffer full
+      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+   }
+
+   fclose(f_in);
+   f_in = NULL;
+   int ret_close = fclose(f_out);
+   f_out = NULL;
+   if (ret_close != 0)
+      throw StriException(MSG__FILE_IO_ERROR, fname_out_s);
+
+   return Rf_ScalarReal(nwritten);
+
+   STRI__ERROR_HANDLER_END({
+      if (f_in)  fclose(f_in);
+      if (f_out) fclose(f_out);
+   })
+}
@@ -43,6 +43,9 @@
 #include "stri_container_listraw.h"
 #include "stri_container_logical.h"
 #include "stri_ucnv.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 using namespace std;
 
 
@@ -128,7 +131,7 @@ double stri__enc_check_ascii(const char* str_cur_s, R_len_t str_cur_n, bool get_
 /** Check if a string is valid UTF-8
  *
  * checks if a string is probably UTF-8-encoded;
- * simple check with U8_NEXT
+ * exact check with stri__utf8_invalid_pos
  *
  *
  * @param str_cur_s character vector
@@ -144,19 +147,18 @@ double stri__enc_check_ascii(const char* str_cur_s, R_len_t str_cur_n, bool get_
  *
  * @version 0.1-?? (Marek Gagolewski, 2013-08-13)
  *          confidence calculation basing on ICU's i18n/csrutf8.cpp
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *          exact check: use the bulk validation kernel
  */
 double stri__enc_check_utf8(const char* str_cur_s, R_len_t str_cur_n, bool get_confidence)
 {
    if (!get_confidence) {
-      UChar32 c;
-      for (R_len_t j=0; j < str_cur_n; ) {
-         if (str_cur_s[j] == 0)
-            return 0.0; // definitely not valid UTF-8
-
-         U8_NEXT(str_cur_s, j, str_cur_n, c);
-         if (c < 0) // ICU utf8.h doc for U8_NEXT: c -> output UChar32 variable, set to <0 in case of an error
-            return 0.0; // definitely not valid UTF-8
-      }
+      // a NUL byte is never a part of a multibyte sequence
+      if (memchr(str_cur_s, 0, (size_t)str_cur_n))
+         return 0.0; // definitely not valid UTF-8
+      if (!stri__utf8_is_valid(str_cur_s, str_cur_n))
+         return 0.0; // definitely not valid UTF-8
       return 1.0;
    }
    else {
@@ -558,10 +560,168 @@ SEXP stri_enc_isutf32le(SEXP str) {
 }
 
 
+/** ICU confidence (0..100) of the best guess which we consider
+ *  conclusive in the sampling mode of stri_enc_detect
+ */
+#define STRI__ENC_DETECT_CONFIDENT 80
+
+/** Max number of bytes skipped when aligning sample windows
+ *  to ASCII bytes (character boundaries in most encodings)
+ */
+#define STRI__ENC_DETECT_ALIGN 16
+
+
+/** A single guess of ICU's charset detector
+ *
+ * Names and languages are static strings owned by ICU.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+struct StriEncDetectMatch {
+   const char* name;
+   const char* lang;
+   int32_t conf;
+};
+
+
+/** Run ICU's charset detector on a given text
+ *
+ * No R API functions are called here, so this may be run in parallel
+ * (each thread must use its own detector).
+ *
+ * @param ucsdet charset detector
+ * @param str_cur_s text
+ * @param str_cur_n number of bytes in \code{str_cur_s}
+ * @param filter enable angle brackets filter?
+ * @param matches [out] guesses (by nonincreasing confidence)
+ * @return false on failure
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static bool stri__enc_detect_run(UCharsetDetector* ucsdet,
+   const char* str_cur_s, R_len_t str_cur_n, bool filter,
+   std::vector<StriEncDetectMatch>& matches)
+{
+   matches.clear();
+
+   UErrorCode status = U_ZERO_ERROR;
+   ucsdet_setText(ucsdet, str_cur_s, str_cur_n, &status);
+   if (U_FAILURE(status)) return false;
+   ucsdet_enableInputFilter(ucsdet, filter);
+
+   status = U_ZERO_ERROR;
+   int matchesFound;
+   const UCharsetMatch** match = ucsdet_detectAll(ucsdet, &matchesFound, &status);
+   if (U_FAILURE(status) || !match || matchesFound <= 0)
+      return false;
+
+   matches.resize(matchesFound);
+   for (R_len_t j=0; j<matchesFound; ++j) {
+      status = U_ZERO_ERROR;
+      matches[j].name = ucsdet_getName(match[j], &status);
+      if (U_FAILURE(status)) matches[j].name = NULL;
+
+      status = U_ZERO_ERROR;
+      matches[j].conf = ucsdet_getConfidence(match[j], &status);
+      if (U_FAILURE(status)) matches[j].conf = -1;
+
+      status = U_ZERO_ERROR;
+      matches[j].lang = ucsdet_getLanguage(match[j], &status);
+      if (U_FAILURE(status)) matches[j].lang = NULL;
+   }
+   return true;
+}
+
+
+/** Copy evenly spaced windows of a text to a buffer
+ *
+ * The first window is a prefix of the text and the last one is its suffix,
+ * so BOMs (UTF-16/32 are recognized by the first few bytes only) are retained.
+ * Inner window boundaries are moved to ASCII bytes if possible
+ * so that multibyte characters are not cut in the middle.
+ *
+ * @param str_cur_s text
+ * @param str_cur_n number of bytes in \code{str_cur_s}
+ * @param window_size number of bytes in each window
+ * @param nwindows number of windows, \code{nwindows*window_size < str_cur_n}
+ * @param buf [out] sample
+ * @return number of bytes copied to \code{buf}
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static R_len_t stri__enc_detect_sample(const char* str_cur_s, R_len_t str_cur_n,
+   R_len_t window_size, R_len_t nwindows, std::vector<char>& buf)
+{
+   buf.resize((size_t)window_size*nwindows);
+   R_len_t buf_n = 0;
+   for (R_len_t k=0; k<nwindows; ++k) {
+      R_len_t from = (nwindows == 1) ? 0 :
+         (R_len_t)(((double)(str_cur_n-window_size)*k)/(nwindows-1));
+      R_len_t to = from+window_size;
+
+      if (k > 0) {
+         R_len_t from_max = min(to, from+STRI__ENC_DETECT_ALIGN);
+         R_len_t j = from;
+         while (j < from_max && (uint8_t)str_cur_s[j] >= 0x80) ++j;
+         if (j < from_max) from = j;
+      }
+
+      if (to < str_cur_n) {
+         R_len_t to_min = max(from, to-STRI__ENC_DETECT_ALIGN);
+         R_len_t j = to;
+         while (j > to_min && (uint8_t)str_cur_s[j-1] >= 0x80) --j;
+         if (j > to_min) to = j;
+      }
+
+      memcpy(&buf[0]+buf_n, str_cur_s+from, (size_t)(to-from));
+      buf_n += to-from;
+   }
+   return buf_n;
+}
+
+
+/** Detect encoding and language, possibly examining only a sample of the text
+ *
+ * If \code{sample_size} is positive and the text is longer, then
+ * only its prefix of \code{sample_size} bytes is examined first.
+ * If the best guess is not conclusive, 2, 4, 8, ... evenly spaced windows
+ * are examined, until the guess is conclusive or the windows would cover
+ * more than a half of the text (then the whole text is analyzed).
+ *
+ * @param ucsdet charset detector
+ * @param str_cur_s text
+ * @param str_cur_n number of bytes in \code{str_cur_s}
+ * @param filter enable angle brackets filter?
+ * @param sample_size number of bytes per sample window, <= 0 to use whole text
+ * @param buf sample buffer
+ * @param matches [out] guesses
+ * @return false on failure
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static bool stri__enc_detect_sampled(UCharsetDetector* ucsdet,
+   const char* str_cur_s, R_len_t str_cur_n, bool filter, R_len_t sample_size,
+   std::vector<char>& buf, std::vector<StriEncDetectMatch>& matches)
+{
+   if (sample_size > 0) {
+      for (R_len_t nwindows=1; (double)nwindows*sample_size*2.0 <= (double)str_cur_n; nwindows *= 2) {
+         R_len_t buf_n = stri__enc_detect_sample(str_cur_s, str_cur_n,
+            sample_size, nwindows, buf);
+         if (stri__enc_detect_run(ucsdet, &buf[0], buf_n, filter, matches)
+               && matches[0].conf >= STRI__ENC_DETECT_CONFIDENT)
+            return true;
+      }
+   }
+
+   return stri__enc_detect_run(ucsdet, str_cur_s, str_cur_n, filter, matches);
+}
+
+
 /** Detect encoding and language
  *
  * @param str character vector
  * @param filter_angle_brackets logical vector
+ * @param sample_size single integer, \code{NA} to examine whole strings
  *
  * @return list
  *
@@ -572,20 +732,23 @@ SEXP stri_enc_isutf32le(SEXP str) {
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    new arg sample_size; detection is done in parallel (OpenMP,
+ *    one UCharsetDetector per thread), R objects are created afterwards
  */
-SEXP stri_enc_detect(SEXP str, SEXP filter_angle_brackets)
+SEXP stri_enc_detect(SEXP str, SEXP filter_angle_brackets, SEXP sample_size)
 {
    PROTECT(str = stri_prepare_arg_list_raw(str, "str"));
    PROTECT(filter_angle_brackets = stri_prepare_arg_logical(filter_angle_brackets, "filter_angle_brackets"));
+   PROTECT(sample_size = stri_prepare_arg_integer_1(sample_size, "sample_size"));
+   int sample_size_val = INTEGER(sample_size)[0];
+   if (sample_size_val != NA_INTEGER && sample_size_val <= 0)
+      Rf_error(MSG__EXPECTED_POSITIVE, "sample_size");
+   if (sample_size_val == NA_INTEGER)
+      sample_size_val = 0;
 
-   UCharsetDetector* ucsdet = NULL;
-
-
-   STRI__ERROR_HANDLER_BEGIN(2)
-
-   UErrorCode status = U_ZERO_ERROR;
-   ucsdet = ucsdet_open(&status);
-   STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+   STRI__ERROR_HANDLER_BEGIN(3)
 
    StriContainerListRaw str_cont(str);
    R_len_t str_n = str_cont.get_n();
@@ -607,56 +770,94 @@ SEXP stri_enc_detect(SEXP str, SEXP filter_angle_brackets)
    SET_VECTOR_ELT(wrong, 2, stri__vector_NA_integers(1));
    Rf_setAttrib(wrong, R_NamesSymbol, names);
 
+   // gather inputs first, the detection phase below makes no R API calls
    StriContainerLogical filter(filter_angle_brackets, vectorize_length);
+   std::vector<const char*> str_s(vectorize_length, (const char*)NULL);
+   std::vector<R_len_t> str_len(vectorize_length, 0);
+   std::vector<char> str_filter(vectorize_length, 0);
    for (R_len_t i=0; i<vectorize_length; ++i) {
-      if (str_cont.isNA(i) || filter.isNA(i)) {
-         SET_VECTOR_ELT(ret, i, wrong);
+      if (str_cont.isNA(i) || filter.isNA(i))
          continue;
+      str_s[i]      = str_cont.get(i).c_str();
+      str_len[i]    = str_cont.get(i).length();
+      str_filter[i] = (char)filter.get(i);
+   }
+
+   std::vector< std::vector<StriEncDetectMatch> > results(vectorize_length);
+   std::vector<char> ok(vectorize_length, 0); // 1 - success, -1 - exception
+   bool open_failed = false;
+   bool alloc_failed = false;
+
+#ifdef _OPENMP
+   #pragma omp parallel if(vectorize_length > 1)
+#endif
+   {
+      UErrorCode status = U_ZERO_ERROR;
+      UCharsetDetector* ucsdet = ucsdet_open(&status); // one per thread
+      if (U_FAILURE(status)) {
+         if (ucsdet) ucsdet_close(ucsdet);
+         ucsdet = NULL;
+#ifdef _OPENMP
+         #pragma omp critical
+#endif
+         open_failed = true;
       }
 
-      const char* str_cur_s = str_cont.get(i).c_str();
-      R_len_t str_cur_n     = str_cont.get(i).length();
+      std::vector<char> buf;
+#ifdef _OPENMP
+      #pragma omp for schedule(dynamic, 1)
+#endif
+      for (R_len_t i=0; i<vectorize_length; ++i) {
+         if (!ucsdet || !str_s[i]) continue;
+         // exceptions (bad_alloc from the buffers) must not leave the region
+         try {
+            ok[i] = (char)stri__enc_detect_sampled(ucsdet, str_s[i], str_len[i],
+               (bool)str_filter[i], sample_size_val, buf, results[i]);
+         }
+         catch (...) {
+            ok[i] = -1;
+         }
+      }
 
-      status = U_ZERO_ERROR;
-      ucsdet_setText(ucsdet, str_cur_s, str_cur_n, &status);
-   	STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-      ucsdet_enableInputFilter(ucsdet, filter.get(i));
+      if (ucsdet) ucsdet_close(ucsdet);
+   }
 
-      status = U_ZERO_ERROR;
-      int matchesFound;
-      const UCharsetMatch** match = ucsdet_detectAll(ucsdet, &matchesFound, &status);
-   	if (U_FAILURE(status) || !match || matchesFound <= 0) {
+   if (open_failed)
+      throw StriException(MSG__INTERNAL_ERROR);
+
+   for (R_len_t i=0; i<vectorize_length; ++i)
+      if (ok[i] < 0) alloc_failed = true;
+   if (alloc_failed)
+      throw StriException(MSG__MEM_ALLOC_ERROR);
+
+   for (R_len_t i=0; i<vectorize_length; ++i) {
+      if (ok[i] <= 0) {
          SET_VECTOR_ELT(ret, i, wrong);
          continue;
-   	}
-
+      }
 
+      R_len_t matchesFound = (R_len_t)results[i].size();
       SEXP val_enc, val_lang, val_conf;
       STRI__PROTECT(val_enc  = Rf_allocVector(STRSXP, matchesFound));
       STRI__PROTECT(val_lang = Rf_allocVector(STRSXP, matchesFound));
       STRI__PROTECT(val_conf = Rf_allocVector(REALSXP, matchesFound));
 
       for (R_len_t j=0; j<matchesFound; ++j) {
-         status = U_ZERO_ERROR;
-         const char* name = ucsdet_getName(match[j], &status);
-         if (U_FAILURE(status) || !name)
+         const StriEncDetectMatch& match = results[i][j];
+         if (!match.name)
             SET_STRING_ELT(val_enc, j, NA_STRING);
          else
-            SET_STRING_ELT(val_enc, j, Rf_mkChar(name));
+            SET_STRING_ELT(val_enc, j, Rf_mkChar(match.name));
 
-         status = U_ZERO_ERROR;
-    	   int32_t conf = ucsdet_getConfidence(match[j], &status);
-         if (U_FAILURE(status))
+         if (match.conf < 0)
             REAL(val_conf)[j] = NA_REAL;
          else
-            REAL(val_conf)[j] = (double)(conf)/100.0;
+            REAL(val_conf)[j] = (double)(match.conf)/100.0;
 
-         status = U_ZERO_ERROR;
-    	   const char* lang = ucsdet_getLanguage(match[j], &status);
-         if (U_FAILURE(status) || !lang)
+         if (!match.lang)
             SET_STRING_ELT(val_lang, j, NA_STRING);
          else
-            SET_STRING_ELT(val_lang, j, Rf_mkChar(lang));
+            SET_STRING_ELT(val_lang, j, Rf_mkChar(match.lang));
       }
 
       SEXP val;
@@ -669,18 +870,10 @@ SEXP stri_enc_detect(SEXP str, SEXP filter_angle_brackets)
       STRI__UNPROTECT(4);
    }
 
-   if (ucsdet) {
-      ucsdet_close(ucsdet);
-      ucsdet = NULL;
-   }
    STRI__UNPROTECT_ALL
    return ret;
 
-   STRI__ERROR_HANDLER_END(
-      if (ucsdet) {
-         ucsdet_close(ucsdet);
-         ucsdet = NULL;
-      })
+   STRI__ERROR_HANDLER_END({ /* no-op on error */ })
 }
 
 
@@ -893,12 +1086,25 @@ struct EncGuess {
       }
    }
 
-   static void do_8bit_locale(vector<EncGuess>& guesses, const char* str_cur_s,
-      R_len_t str_cur_n, const char* qloc)
+   /** Get all 8-bit converters that may be used in a given locale
+    *
+    * Building the byte tables requires opening each available converter,
+    * so the results are cached (per locale) for the whole session.
+    *
+    * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+    *    separated from do_8bit_locale, cache the results
+    */
+   static const vector<Converter8bit>& get_converters(const char* qloc)
    {
-      vector<Converter8bit> converters;
+      static std::map< std::string, vector<Converter8bit> > cache;
+
       if (!qloc) throw StriException(MSG__INTERNAL_ERROR); // just to be sure
 
+      std::map< std::string, vector<Converter8bit> >::iterator it = cache.find(qloc);
+      if (it != cache.end())
+         return it->second;
+
+      vector<Converter8bit> converters;
       UErrorCode status = U_ZERO_ERROR;
       ULocaleData* uld = ulocdata_open(qloc, &status);
    	STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
@@ -919,6 +1125,15 @@ struct EncGuess {
       uset_close(exset_tmp); exset = NULL;
       ulocdata_close(uld);
 
+      vector<Converter8bit>& ret = cache[qloc];
+      ret.swap(converters);
+      return ret;
+   }
+
+   static void do_8bit_locale(vector<EncGuess>& guesses, const char* str_cur_s,
+      R_len_t str_cur_n, const char* qloc)
+   {
+      const vector<Converter8bit>& converters = get_converters(qloc);
       if (converters.size() <= 0)
          return;
 
@@ -990,6 +1205,9 @@ struct EncGuess {
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    8-bit converter tables are built once per locale (and cached)
  */
 SEXP stri_enc_detect2(SEXP str, SEXP loc)
 {
@@ -78,16 +78,19 @@ SEXP stri_dup(SEXP str, SEXP times);
 
 // length.cpp
 SEXP stri_numbytes(SEXP str);
-SEXP stri_length(SEXP str);
+SEXP stri_length(SEXP str, SEXP type=R_NilValue);
 SEXP stri_isempty(SEXP str);
 SEXP stri_width(SEXP str);
 
+// metadata.cpp
+SEXP stri_metadata(SEXP str, SEXP checkpoints=Rf_ScalarLogical(FALSE));
+
 // reverse.cpp
-SEXP stri_reverse(SEXP s);
+SEXP stri_reverse(SEXP s, SEXP type=R_NilValue);
 
 // sub.cpp
-SEXP stri_sub(SEXP str, SEXP from, SEXP to, SEXP length);
-SEXP stri_sub_replacement(SEXP str, SEXP from, SEXP to, SEXP length, SEXP omit_na, SEXP value);
+SEXP stri_sub(SEXP str, SEXP from, SEXP to, SEXP length, SEXP type=R_NilValue);
+SEXP stri_sub_replacement(SEXP str, SEXP from, SEXP to, SEXP length, SEXP omit_na, SEXP value, SEXP type=R_NilValue);
 
 // encoding_management.cpp:
 SEXP stri_enc_list();
@@ -120,11 +123,15 @@ SEXP stri_trans_general(SEXP str, SEXP id);
 // utils.cpp
 SEXP stri_list2matrix(SEXP x, SEXP byrow=Rf_ScalarLogical(FALSE),
    SEXP fill=Rf_ScalarString(NA_STRING), SEXP n_min=Rf_ScalarInteger(0));
+SEXP stri_list2columns(SEXP x, SEXP fill=Rf_ScalarString(NA_STRING),
+   SEXP n_min=Rf_ScalarInteger(0));
 
 
 // encoding_conversion.cpp:
 SEXP stri_encode(SEXP str, SEXP from=R_NilValue, SEXP to=R_NilValue,
    SEXP to_raw=Rf_ScalarLogical(FALSE));
+SEXP stri_encode_file(SEXP fname_in, SEXP fname_out, SEXP from=R_NilValue,
+   SEXP to=R_NilValue, SEXP chunk_size=Rf_ScalarInteger(65536));
 SEXP stri_enc_fromutf32(SEXP str);
 SEXP stri_enc_toutf32(SEXP str);
 SEXP stri_enc_toutf8(SEXP str, SEXP is_unknown_8bit=Rf_ScalarLogical(FALSE),
@@ -134,7 +141,8 @@ SEXP stri_enc_toascii(SEXP str);
 
 // encoding_detection.cpp:
 SEXP stri_enc_detect2(SEXP str, SEXP loc=R_NilValue);
-SEXP stri_enc_detect(SEXP str, SEXP filter_angle_brackets=Rf_ScalarLogical(FALSE));
+SEXP stri_enc_detect(SEXP str, SEXP filter_angle_brackets=Rf_ScalarLogical(FALSE),
+   SEXP sample_size=Rf_ScalarInteger(NA_INTEGER));
 SEXP stri_enc_isascii(SEXP str);
 SEXP stri_enc_isutf8(SEXP str);
 SEXP stri_enc_isutf16le(SEXP str);
@@ -182,14 +190,16 @@ SEXP stri_replace_na(SEXP str, SEXP replacement=Rf_mkString("NA"));
 SEXP stri_detect_coll(SEXP str, SEXP pattern, SEXP negate=Rf_ScalarLogical(FALSE), SEXP opts_collator=R_NilValue);
 SEXP stri_count_coll(SEXP str, SEXP pattern, SEXP opts_collator=R_NilValue);
 SEXP stri_locate_all_coll(SEXP str, SEXP pattern,
-   SEXP omit_no_match=Rf_ScalarLogical(FALSE), SEXP opts_collator=R_NilValue);
+   SEXP omit_no_match=Rf_ScalarLogical(FALSE), SEXP flat=Rf_ScalarLogical(FALSE),
+   SEXP opts_collator=R_NilValue);
 SEXP stri_locate_first_coll(SEXP str, SEXP pattern, SEXP opts_collator=R_NilValue);
 SEXP stri_locate_last_coll(SEXP str, SEXP pattern, SEXP opts_collator=R_NilValue);
 SEXP stri_extract_first_coll(SEXP str, SEXP pattern, SEXP opts_collator=R_NilValue);
 SEXP stri_extract_last_coll(SEXP str, SEXP pattern, SEXP opts_collator=R_NilValue);
 SEXP stri_extract_all_coll(SEXP str, SEXP pattern,
    SEXP simplify=Rf_ScalarLogical(FALSE),
-   SEXP omit_no_match=Rf_ScalarLogical(FALSE), SEXP opts_collator=R_NilValue);
+   SEXP omit_no_match=Rf_ScalarLogical(FALSE), SEXP flat=Rf_ScalarLogical(FALSE),
+   SEXP opts_collator=R_NilValue);
 SEXP stri_replace_all_coll(SEXP str, SEXP pattern, SEXP replacement,
    SEXP vectorize_all=Rf_ScalarLogical(TRUE), SEXP opts_collator=R_NilValue);
 SEXP stri_replace_first_coll(SEXP str, SEXP pattern, SEXP replacement,
@@ -210,14 +220,16 @@ SEXP stri_subset_coll_replacement(SEXP str, SEXP pattern, SEXP negate, SEXP opts
 SEXP stri_detect_fixed(SEXP str, SEXP pattern, SEXP negate=Rf_ScalarLogical(FALSE), SEXP opts_fixed=R_NilValue);
 SEXP stri_count_fixed(SEXP str, SEXP pattern, SEXP opts_fixed=R_NilValue);
 SEXP stri_locate_all_fixed(SEXP str, SEXP pattern,
-   SEXP omit_no_match=Rf_ScalarLogical(FALSE), SEXP opts_fixed=R_NilValue);
+   SEXP omit_no_match=Rf_ScalarLogical(FALSE), SEXP flat=Rf_ScalarLogical(FALSE),
+   SEXP opts_fixed=R_NilValue);
 SEXP stri_locate_first_fixed(SEXP str, SEXP pattern, SEXP opts_fixed=R_NilValue);
 SEXP stri_locate_last_fixed(SEXP str, SEXP pattern, SEXP opts_fixed=R_NilValue);
 SEXP stri_extract_first_fixed(SEXP str, SEXP pattern, SEXP opts_fixed=R_NilValue);
 SEXP stri_extract_last_fixed(SEXP str, SEXP pattern, SEXP opts_fixed=R_NilValue);
 SEXP stri_extract_all_fixed(SEXP str, SEXP pattern,
    SEXP simplify=Rf_ScalarLogical(FALSE),
-   SEXP omit_no_match=Rf_ScalarLogical(FALSE), SEXP opts_fixed=R_NilValue);
+   SEXP omit_no_match=Rf_ScalarLogical(FALSE), SEXP flat=Rf_ScalarLogical(FALSE),
+   SEXP opts_fixed=R_NilValue);
 SEXP stri_replace_all_fixed(SEXP str, SEXP pattern, SEXP replacement,
    SEXP vectorize_all=Rf_ScalarLogical(TRUE), SEXP opts_fixed=R_NilValue);
 SEXP stri_replace_first_fixed(SEXP str, SEXP pattern, SEXP replacement,
@@ -238,7 +250,8 @@ SEXP stri_subset_fixed_replacement(SEXP str, SEXP pattern, SEXP negate, SEXP opt
 SEXP stri_detect_regex(SEXP str, SEXP pattern, SEXP negate=Rf_ScalarLogical(FALSE), SEXP opts_regex=R_NilValue);
 SEXP stri_count_regex(SEXP str, SEXP pattern, SEXP opts_regex=R_NilValue);
 SEXP stri_locate_all_regex(SEXP str, SEXP pattern,
-   SEXP omit_no_match=Rf_ScalarLogical(FALSE), SEXP opts_regex=R_NilValue);
+   SEXP omit_no_match=Rf_ScalarLogical(FALSE), SEXP flat=Rf_ScalarLogical(FALSE),
+   SEXP opts_regex=R_NilValue);
 SEXP stri_locate_first_regex(SEXP str, SEXP pattern, SEXP opts_regex=R_NilValue);
 SEXP stri_locate_last_regex(SEXP str, SEXP pattern, SEXP opts_regex=R_NilValue);
 SEXP stri_replace_all_regex(SEXP str, SEXP pattern, SEXP replacement,
@@ -256,15 +269,21 @@ SEXP stri_extract_first_regex(SEXP str, SEXP pattern, SEXP opts_regex=R_NilValue
 SEXP stri_extract_last_regex(SEXP str, SEXP pattern, SEXP opts_regex=R_NilValue);
 SEXP stri_extract_all_regex(SEXP str, SEXP pattern,
    SEXP simplify=Rf_ScalarLogical(FALSE), SEXP omit_no_match=Rf_ScalarLogical(FALSE),
-   SEXP opts_regex=R_NilValue);
+   SEXP flat=Rf_ScalarLogical(FALSE), SEXP opts_regex=R_NilValue);
 SEXP stri_match_first_regex(SEXP str, SEXP pattern,
    SEXP cg_missing=Rf_ScalarString(NA_STRING), SEXP opts_regex=R_NilValue);
 SEXP stri_match_last_regex(SEXP str, SEXP pattern,
    SEXP cg_missing=Rf_ScalarString(NA_STRING), SEXP opts_regex=R_NilValue);
 SEXP stri_match_all_regex(SEXP str, SEXP pattern,
-   SEXP omit_no_match=Rf_ScalarLogical(FALSE),
+   SEXP omit_no_match=Rf_ScalarLogical(FALSE), SEXP flat=Rf_ScalarLogical(FALSE),
    SEXP cg_missing=Rf_ScalarString(NA_STRING), SEXP opts_regex=R_NilValue);
 SEXP stri_subset_regex_replacement(SEXP str, SEXP pattern, SEXP negate, SEXP opts_regex, SEXP value);
+SEXP stri_detect_regex_set(SEXP str, SEXP pattern, SEXP opts_regex=R_NilValue);
+SEXP stri_which_regex(SEXP str, SEXP pattern, SEXP opts_regex=R_NilValue);
+
+SEXP stri_regex_compile(SEXP pattern, SEXP opts_regex=R_NilValue);
+SEXP stri_fixed_compile(SEXP pattern, SEXP opts_fixed=R_NilValue);
+SEXP stri_coll_compile(SEXP pattern, SEXP opts_collator=R_NilValue);
 
 SEXP stri_count_charclass(SEXP str, SEXP pattern);
 SEXP stri_detect_charclass(SEXP str, SEXP pattern, SEXP negate=Rf_ScalarLogical(FALSE));
@@ -272,11 +291,12 @@ SEXP stri_extract_first_charclass(SEXP str, SEXP pattern);
 SEXP stri_extract_last_charclass(SEXP str, SEXP pattern);
 SEXP stri_extract_all_charclass(SEXP str, SEXP pattern,
    SEXP merge=Rf_ScalarLogical(TRUE), SEXP simplify=Rf_ScalarLogical(FALSE),
-   SEXP omit_no_match=Rf_ScalarLogical(FALSE));
+   SEXP omit_no_match=Rf_ScalarLogical(FALSE), SEXP flat=Rf_ScalarLogical(FALSE));
 SEXP stri_locate_first_charclass(SEXP str, SEXP pattern);
 SEXP stri_locate_last_charclass(SEXP str, SEXP pattern);
 SEXP stri_locate_all_charclass(SEXP str, SEXP pattern,
-   SEXP merge=Rf_ScalarLogical(TRUE), SEXP omit_no_match=Rf_ScalarLogical(FALSE));
+   SEXP merge=Rf_ScalarLogical(TRUE), SEXP omit_no_match=Rf_ScalarLogical(FALSE),
+   SEXP flat=Rf_ScalarLogical(FALSE));
 SEXP stri_replace_last_charclass(SEXP str, SEXP pattern, SEXP replacement);
 SEXP stri_replace_first_charclass(SEXP str, SEXP pattern, SEXP replacement);
 SEXP stri_replace_all_charclass(SEXP str, SEXP pattern, SEXP replacement,
@@ -300,6 +320,8 @@ SEXP stri_locate_last_boundaries(SEXP str, SEXP opts_brkiter=R_NilValue);
 SEXP stri_split_boundaries(SEXP str, SEXP n=Rf_ScalarInteger(-1),
    SEXP tokens_only=Rf_ScalarLogical(FALSE),
    SEXP simplify=Rf_ScalarLogical(FALSE), SEXP opts_brkiter=R_NilValue);
+SEXP stri_split_boundaries_ids(SEXP str, SEXP vocabulary=R_NilValue,
+   SEXP grow=Rf_ScalarLogical(TRUE), SEXP opts_brkiter=R_NilValue);
 SEXP stri_count_boundaries(SEXP str, SEXP opts_brkiter=R_NilValue);
 
 
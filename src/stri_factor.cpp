@@ -0,0 +1,330 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "stri_stringi.h"
+#include <map>
+#include <string>
+
+
+/**
+ * Get the levels of a factor
+ *
+ * @param f a factor
+ * @return character vector or \code{R_NilValue} if \code{f} is not
+ *    a well-formed factor
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static SEXP stri__factor_levels(SEXP f)
+{
+   if (!Rf_isFactor(f) || TYPEOF(f) != INTSXP)
+      return R_NilValue;
+
+   SEXP levels = Rf_getAttrib(f, R_LevelsSymbol);
+   if (!isString(levels))
+      return R_NilValue;
+
+   return levels;
+}
+
+
+/**
+ * Convert a factor to a character vector
+ *
+ * Gives the same result as \code{as.character(f)},
+ * but does not call R.
+ *
+ * @param f a factor
+ * @return character vector or \code{R_NilValue}
+ *    if \code{f} is not a well-formed factor
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri__factor_expand(SEXP f)
+{
+   SEXP levels = stri__factor_levels(f);
+   if (isNull(levels))
+      return R_NilValue;
+
+   R_len_t n = LENGTH(f);
+   R_len_t nlevels = LENGTH(levels);
+   const int* codes = INTEGER(f);
+
+   SEXP ret;
+   PROTECT(ret = Rf_allocVector(STRSXP, n));
+   for (R_len_t i=0; i<n; ++i) {
+      int code = codes[i];
+      if (code == NA_INTEGER || code < 1 || code > nlevels)
+         SET_STRING_ELT(ret, i, NA_STRING);
+      else
+         SET_STRING_ELT(ret, i, STRING_ELT(levels, code-1));
+   }
+   UNPROTECT(1);
+   return ret;
+}
+
+
+/**
+ * Can a function be applied on a factor's levels only?
+ *
+ * This is the case if the function is vectorized over \code{f}
+ * and all its other vectorized arguments are of length 1.
+ *
+ * @param f an R object
+ * @param arg1 other vectorized argument or a \code{NULL} pointer (not given)
+ * @param arg2 other vectorized argument or a \code{NULL} pointer (not given)
+ * @return logical value
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool stri__factor_by_levels(SEXP f, SEXP arg1, SEXP arg2)
+{
+   if (isNull(stri__factor_levels(f)))
+      return false;
+
+   return (!arg1 || Rf_length(arg1) == 1)
+      && (!arg2 || Rf_length(arg2) == 1);
+}
+
+
+/**
+ * Get the levels that actually occur in a factor
+ *
+ * This is the vector a function is called on
+ * before the results are expanded with \code{stri__factor_gather}.
+ *
+ * @param f a factor, see \code{stri__factor_by_levels}
+ * @return character vector
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri__factor_used_levels(SEXP f)
+{
+   SEXP levels = stri__factor_levels(f);
+   R_len_t n = LENGTH(f);
+   R_len_t nlevels = LENGTH(levels);
+   const int* codes = INTEGER(f);
+
+   std::vector<bool> used(nlevels, false);
+   R_len_t nused = 0;
+   for (R_len_t i=0; i<n && nused<nlevels; ++i) {
+      int code = codes[i];
+      if (code != NA_INTEGER && code >= 1 && code <= nlevels && !used[code-1]) {
+         used[code-1] = true;
+         ++nused;
+      }
+   }
+
+   if (nused == nlevels)
+      return levels;
+
+   SEXP ret;
+   PROTECT(ret = Rf_allocVector(STRSXP, nused));
+   for (R_len_t j=0, k=0; j<nlevels; ++j) {
+      if (used[j])
+         SET_STRING_ELT(ret, k++, STRING_ELT(levels, j));
+   }
+   UNPROTECT(1);
+   return ret;
+}
+
+
+/**
+ * Expand the results computed for a factor's levels
+ *
+ * If \code{getOption("stringi.factor_output")} is \code{TRUE},
+ * a character vector is returned as a factor, see \code{stri__factor_output}.
+ *
+ * @param res logical, integer, or character vector,
+ *    the results for \code{stri__factor_used_levels(f)}
+ * @param f a factor
+ * @return vector of the same type as \code{res} and
+ *    of the same length as \code{f}; \code{R_NilValue} if \code{res}
+ *    is not of the expected length or type
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri__factor_gather(SEXP res, SEXP f)
+{
+   SEXP levels = stri__factor_levels(f);
+   R_len_t n = LENGTH(f);
+   R_len_t nlevels = LENGTH(levels);
+   const int* codes = INTEGER(f);
+
+   // level code -> index in res, -1 if unused
+   std::vector<R_len_t> where(nlevels, -1);
+   R_len_t nused = 0;
+   for (R_len_t i=0; i<n && nused<nlevels; ++i) {
+      int code = codes[i];
+      if (code != NA_INTEGER && code >= 1 && code <= nlevels && where[code-1] < 0) {
+         where[code-1] = 0;
+         ++nused;
+      }
+   }
+   for (R_len_t j=0, k=0; j<nlevels; ++j) {
+      if (where[j] >= 0) where[j] = k++;
+   }
+
+   if (LENGTH(res) != nused || (TYPEOF(res) != STRSXP
+         && TYPEOF(res) != LGLSXP && TYPEOF(res) != INTSXP))
+      return R_NilValue; // e.g., the recycling rule was applied
+
+   SEXP ret;
+   if (isString(res)) {
+      PROTECT(ret = Rf_allocVector(STRSXP, n));
+      for (R_len_t i=0; i<n; ++i) {
+         int code = codes[i];
+         if (code == NA_INTEGER || code < 1 || code > nlevels)
+            SET_STRING_ELT(ret, i, NA_STRING);
+         else
+            SET_STRING_ELT(ret, i, STRING_ELT(res, where[code-1]));
+      }
+      ret = stri__factor_output(ret, f);
+      UNPROTECT(1);
+      return ret;
+   }
+
+   int na_value = (TYPEOF(res) == LGLSXP) ? NA_LOGICAL : NA_INTEGER;
+   const int* res_tab = (TYPEOF(res) == LGLSXP) ? LOGICAL(res) : INTEGER(res);
+   PROTECT(ret = Rf_allocVector(TYPEOF(res), n));
+   int* ret_tab = (TYPEOF(res) == LGLSXP) ? LOGICAL(ret) : INTEGER(ret);
+   for (R_len_t i=0; i<n; ++i) {
+      int code = codes[i];
+      if (code == NA_INTEGER || code < 1 || code > nlevels)
+         ret_tab[i] = na_value;
+      else
+         ret_tab[i] = res_tab[where[code-1]];
+   }
+   UNPROTECT(1);
+   return ret;
+}
+
+
+/**
+ * Should the functions called on a factor return factors?
+ *
+ * @param f an R object
+ * @return \code{TRUE} if \code{f} is a well-formed factor and
+ *    \code{getOption("stringi.factor_output")} is \code{TRUE}
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool stri__factor_output_enabled(SEXP f)
+{
+   if (isNull(stri__factor_levels(f)))
+      return false;
+
+   SEXP opt = Rf_GetOption1(Rf_install("stringi.factor_output"));
+   return (TYPEOF(opt) == LGLSXP && LENGTH(opt) == 1 && LOGICAL(opt)[0] == TRUE);
+}
+
+
+/**
+ * Convert a character vector computed for a factor to a factor
+ *
+ * The unique non-missing strings become the new levels.
+ * They are ordered by the codes of the elements of \code{f}
+ * they were computed from (and then by position), so that the result
+ * is the same regardless of whether \code{f} was processed by levels.
+ *
+ * @param res the result of a function called on \code{f}
+ *    or on \code{stri__factor_expand(f)}
+ * @param f a factor
+ * @return a factor if \code{res} is a character vector and
+ *    \code{stri__factor_output_enabled(f)}; \code{res} otherwise
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri__factor_output(SEXP res, SEXP f)
+{
+   if (!isString(res) || !stri__factor_output_enabled(f))
+      return res;
+
+   R_len_t n = LENGTH(res);
+   R_len_t f_n = LENGTH(f);
+   R_len_t nlevels = LENGTH(stri__factor_levels(f));
+   const int* codes = INTEGER(f);
+
+   // counting sort by the codes of f[i % f_n], missing ones last
+   std::vector<R_len_t> order(n);
+   std::vector<R_len_t> start(nlevels+2, 0);
+   for (int pass=0; pass<2; ++pass) {
+      for (R_len_t i=0; i<n; ++i) {
+         int code = (f_n > 0) ? codes[i%f_n] : NA_INTEGER;
+         R_len_t key = (code == NA_INTEGER || code < 1 || code > nlevels) ? nlevels : code-1;
+         if (pass == 0) ++start[key+1];
+         else           order[start[key]++] = i;
+      }
+      if (pass == 0) {
+         for (R_len_t j=0; j<=nlevels; ++j)
+            start[j+1] += start[j];
+      }
+   }
+
+   // CHARSXPs are mostly shared, look them up by address first
+   std::map<SEXP, int> ids_ptr;
+   std::map<std::string, int> ids_str;
+   std::vector<R_len_t> res_first;
+   SEXP ret;
+   PROTECT(ret = Rf_allocVector(INTSXP, n));
+   int* ret_tab = INTEGER(ret);
+   for (R_len_t k=0; k<n; ++k) {
+      R_len_t i = order[k];
+      SEXP cur = STRING_ELT(res, i);
+      if (cur == NA_STRING) {
+         ret_tab[i] = NA_INTEGER;
+         continue;
+      }
+
+      std::map<SEXP, int>::iterator it = ids_ptr.find(cur);
+      if (it != ids_ptr.end()) {
+         ret_tab[i] = it->second;
+         continue;
+      }
+
+      std::pair<std::map<std::string, int>::iterator, bool> ins =
+         ids_str.insert(std::make_pair(std::string(Rf_translateCharUTF8(cur)),
+            (int)res_first.size()+1));
+      if (ins.second) res_first.push_back(i);
+      ids_ptr[cur] = ins.first->second;
+      ret_tab[i] = ins.first->second;
+   }
+
+   SEXP new_levels, cls;
+   PROTECT(new_levels = Rf_allocVector(STRSXP, (R_len_t)res_first.size()));
+   for (R_len_t k=0; k<(R_len_t)res_first.size(); ++k)
+      SET_STRING_ELT(new_levels, k, STRING_ELT(res, res_first[k]));
+   PROTECT(cls = Rf_mkString("factor"));
+   Rf_setAttrib(ret, R_LevelsSymbol, new_levels);
+   Rf_setAttrib(ret, R_ClassSymbol, cls);
+   UNPROTECT(3);
+   return ret;
+}
@@ -0,0 +1,179 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include "stri_stringi.h"
+#include "stri_flat_occurrences.h"
+#include <cstring>
+#include <cstdio>
+
+
+/**
+ * Create a named list of columns: str_id, match_id, and some more
+ *
+ * @param str_id
+ * @param match_id
+ * @param ncols number of further columns
+ * @return list, its first 2 elements set
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static SEXP stri__flat_occurrences_alloc(const std::vector<int>& str_id,
+   const std::vector<int>& match_id, R_len_t ncols)
+{
+   R_len_t n = (R_len_t)str_id.size();
+   SEXP ret, names, col;
+   PROTECT(ret = Rf_allocVector(VECSXP, ncols+2));
+   PROTECT(names = Rf_allocVector(STRSXP, ncols+2));
+
+   SET_STRING_ELT(names, 0, Rf_mkChar("str_id"));
+   SET_VECTOR_ELT(ret, 0, col = Rf_allocVector(INTSXP, n));
+   if (n > 0) memcpy(INTEGER(col), &str_id[0], sizeof(int)*n);
+
+   SET_STRING_ELT(names, 1, Rf_mkChar("match_id"));
+   SET_VECTOR_ELT(ret, 1, col = Rf_allocVector(INTSXP, n));
+   if (n > 0) memcpy(INTEGER(col), &match_id[0], sizeof(int)*n);
+
+   Rf_setAttrib(ret, R_NamesSymbol, names);
+   UNPROTECT(2);
+   return ret;
+}
+
+
+/**
+ * Get the flat result of \code{stri_locate_all_*}
+ *
+ * The indices should already have been converted to 1-based
+ * code point indices.
+ *
+ * @return list with 4 integer vectors: str_id, match_id, start, end
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP StriFlatOccurrences::toR()
+{
+   R_len_t n = size();
+   SEXP ret, col;
+   PROTECT(ret = stri__flat_occurrences_alloc(str_id, match_id, 2));
+   SEXP names = Rf_getAttrib(ret, R_NamesSymbol);
+
+   SET_STRING_ELT(names, 2, Rf_mkChar(MSG__LOCATE_DIM_START));
+   SET_VECTOR_ELT(ret, 2, col = Rf_allocVector(INTSXP, n));
+   if (n > 0) memcpy(INTEGER(col), &starts[0], sizeof(int)*n);
+
+   SET_STRING_ELT(names, 3, Rf_mkChar(MSG__LOCATE_DIM_END));
+   SET_VECTOR_ELT(ret, 3, col = Rf_allocVector(INTSXP, n));
+   if (n > 0) memcpy(INTEGER(col), &ends[0], sizeof(int)*n);
+
+   UNPROTECT(1);
+   return ret;
+}
+
+
+/**
+ * Get the flat result of \code{stri_extract_all_*}
+ * or \code{stri_match_all_regex}
+ *
+ * @param str_cont strings whose UTF-8 byte indices were stored
+ * @param cg_missing CHARSXP used for unmatched capture groups
+ * @return list with str_id, match_id and nbounds character vectors:
+ *    value, group1, group2, ...
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP StriFlatOccurrences::toR(const StriContainerUTF8& str_cont, SEXP cg_missing)
+{
+   R_len_t n = size();
+   SEXP ret, col;
+   PROTECT(ret = stri__flat_occurrences_alloc(str_id, match_id, nbounds));
+   SEXP names = Rf_getAttrib(ret, R_NamesSymbol);
+
+   for (R_len_t k=0; k<nbounds; ++k) {
+      if (k == 0)
+         SET_STRING_ELT(names, 2, Rf_mkChar("value"));
+      else {
+         char buf[32];
+         sprintf(buf, "group%d", (int)k);
+         SET_STRING_ELT(names, k+2, Rf_mkChar(buf));
+      }
+
+      SET_VECTOR_ELT(ret, k+2, col = Rf_allocVector(STRSXP, n));
+      for (R_len_t j=0; j<n; ++j) {
+         size_t idx = (size_t)j*nbounds+k;
+         if (starts[idx] == NA_INTEGER)
+            SET_STRING_ELT(col, j, NA_STRING);
+         else if (starts[idx] < 0)
+            SET_STRING_ELT(col, j, cg_missing);
+         else
+            SET_STRING_ELT(col, j, Rf_mkCharLenCE(
+               str_cont.get(str_id[j]-1).c_str()+starts[idx],
+               ends[idx]-starts[idx], CE_UTF8));
+      }
+   }
+
+   UNPROTECT(1);
+   return ret;
+}
+
+
+/**
+ * Get the flat result of \code{stri_extract_all_*}
+ *
+ * @param str_cont strings whose UTF-16 indices were stored
+ * @return list with 3 vectors: str_id, match_id, value
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP StriFlatOccurrences::toR(const StriContainerUTF16& str_cont)
+{
+   R_len_t n = size();
+   SEXP ret, col;
+   PROTECT(ret = stri__flat_occurrences_alloc(str_id, match_id, 1));
+   SEXP names = Rf_getAttrib(ret, R_NamesSymbol);
+
+   SET_STRING_ELT(names, 2, Rf_mkChar("value"));
+   SET_VECTOR_ELT(ret, 2, col = Rf_allocVector(STRSXP, n));
+   std::string buf;
+   for (R_len_t j=0; j<n; ++j) {
+      size_t idx = (size_t)j*nbounds;
+      if (starts[idx] < 0) {
+         SET_STRING_ELT(col, j, NA_STRING);
+         continue;
+      }
+      buf.clear();
+      str_cont.get(str_id[j]-1).tempSubStringBetween(starts[idx], ends[idx]).toUTF8String(buf);
+      SET_STRING_ELT(col, j, Rf_mkCharLenCE(buf.c_str(), (int)buf.size(), CE_UTF8));
+   }
+
+   UNPROTECT(1);
+   return ret;
+}
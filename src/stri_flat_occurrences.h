@@ -0,0 +1,152 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef __stri_flat_occurrences_h
+#define __stri_flat_occurrences_h
+
+#include "stri_stringi.h"
+#include <vector>
+#include <utility>
+
+
+/**
+ * Growable column buffers for the flat (long-format) results
+ * of \code{stri_locate_all_*}, \code{stri_extract_all_*}
+ * and \code{stri_match_all_regex}
+ *
+ * Each row corresponds to a match (or to a missing value
+ * for NA inputs or no matches): we store the index of the string,
+ * the index of the match (NA for missing rows)
+ * and \code{nbounds} (start, end) pairs of indices
+ * (the whole match and its capture groups).
+ * Rows of a single string are stored consecutively.
+ *
+ * The results are created with a fixed number of R vectors,
+ * no matter how many strings there are.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriFlatOccurrences {
+
+   private:
+
+      R_len_t nbounds; ///< number of (start, end) pairs per row
+      std::vector<int> str_id;   ///< 1-based
+      std::vector<int> match_id; ///< 1-based or NA_INTEGER
+      std::vector<int> starts;   ///< nbounds per row; NA_INTEGER or -1 (no group match)
+      std::vector<int> ends;
+
+   public:
+
+      StriFlatOccurrences(R_len_t _nbounds=1)
+         : nbounds(_nbounds) { }
+
+
+      /** get the number of rows
+       *
+       * @return row count
+       */
+      inline R_len_t size() const {
+         return (R_len_t)str_id.size();
+      }
+
+
+      /** add a row of missing values
+       *
+       * @param i 0-based string index
+       */
+      void addNA(R_len_t i)
+      {
+         str_id.push_back(i+1);
+         match_id.push_back(NA_INTEGER);
+         starts.insert(starts.end(), nbounds, NA_INTEGER);
+         ends.insert(ends.end(), nbounds, NA_INTEGER);
+      }
+
+
+      /** add all the matches in a string
+       *
+       * @param i 0-based string index
+       * @param occurrences cur_nbounds (start, end) pairs for each match;
+       *    negative indices denote an unmatched capture group
+       * @param cur_nbounds at most nbounds; the remaining
+       *    pairs are filled with NAs
+       * @return index of the first row added; the starts and ends
+       *    of consecutive rows may be modified via getStarts() and getEnds()
+       */
+      R_len_t add(R_len_t i, const StriOccurrences& occurrences,
+         R_len_t cur_nbounds=1)
+      {
+         R_len_t k0 = size();
+         R_len_t noccurrences = (R_len_t)occurrences.size()/cur_nbounds;
+         StriOccurrences::const_iterator iter = occurrences.begin();
+         for (R_len_t j=0; j<noccurrences; ++j) {
+            str_id.push_back(i+1);
+            match_id.push_back(j+1);
+            for (R_len_t k=0; k<cur_nbounds; ++k, ++iter) {
+               starts.push_back((*iter).first  < 0 ? -1 : (*iter).first);
+               ends.push_back(  (*iter).second < 0 ? -1 : (*iter).second);
+            }
+            starts.insert(starts.end(), nbounds-cur_nbounds, NA_INTEGER);
+            ends.insert(ends.end(), nbounds-cur_nbounds, NA_INTEGER);
+         }
+         return k0;
+      }
+
+
+      /** get the start indices
+       *
+       * @param k row index
+       * @return pointer to nbounds*(number of rows following) integers
+       */
+      inline int* getStarts(R_len_t k) {
+         return &starts[(size_t)k*nbounds];
+      }
+
+
+      /** get the end indices
+       *
+       * @param k row index
+       * @return pointer to nbounds*(number of rows following) integers
+       */
+      inline int* getEnds(R_len_t k) {
+         return &ends[(size_t)k*nbounds];
+      }
+
+
+      SEXP toR();
+      SEXP toR(const StriContainerUTF8& str_cont, SEXP cg_missing);
+      SEXP toR(const StriContainerUTF16& str_cont);
+};
+
+#endif
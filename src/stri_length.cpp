@@ -32,6 +32,9 @@
 #include "stri_stringi.h"
 #include "stri_ucnv.h"
 #include "stri_container_utf8.h"
+#include "stri_brkiter.h"
+#include <vector>
+#include <cstring>
 
 
 /**
@@ -65,6 +68,57 @@ R_len_t stri__numbytes_max(SEXP str)
 }
 
 
+/**
+ * Count the number of grapheme clusters in each string
+ *
+ * @param str character vector
+ * @return integer vector
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static SEXP stri__length_grapheme(SEXP str)
+{
+   PROTECT(str = stri_prepare_arg_string(str, "str"));
+
+   STRI__ERROR_HANDLER_BEGIN(1)
+   R_len_t str_n = LENGTH(str);
+   StriContainerUTF8 str_cont(str, str_n);
+   StriRuleBasedBreakIterator brkiter(StriBrkIterOptions(R_NilValue, "character"));
+   std::vector<R_len_t> bounds;
+
+   SEXP ret;
+   STRI__PROTECT(ret = Rf_allocVector(INTSXP, str_n));
+   int* retint = INTEGER(ret);
+
+   for (R_len_t i = str_cont.vectorize_init();
+         i != str_cont.vectorize_end();
+         i = str_cont.vectorize_next(i))
+   {
+      if (str_cont.isNA(i)) {
+         retint[i] = NA_INTEGER;
+         continue;
+      }
+
+      const char* str_cur_s = str_cont.get(i).c_str();
+      R_len_t     str_cur_n = str_cont.get(i).length();
+      if (stri__utf8_is_ascii(str_cur_s, str_cur_n) &&
+            !memchr(str_cur_s, '\r', (size_t)str_cur_n)) {
+         retint[i] = str_cur_n; // each character is a separate cluster
+      }
+      else if (!stri__utf8_is_valid(str_cur_s, str_cur_n)) {
+         Rf_warning(MSG__INVALID_UTF8);
+         retint[i] = NA_INTEGER;
+      }
+      else
+         retint[i] = stri__brkiter_clusters(brkiter, str_cur_s, str_cur_n, bounds);
+   }
+
+   STRI__UNPROTECT_ALL
+   return ret;
+   STRI__ERROR_HANDLER_END({ /* no special action on error */ })
+}
+
+
 /**
  * Count the number of characters in a string
  *
@@ -86,9 +140,38 @@ R_len_t stri__numbytes_max(SEXP str)
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    validate and count code points in a single pass
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use cached stri_metadata
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    new arg: `type`
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
-SEXP stri_length(SEXP str)
+SEXP stri_length(SEXP str, SEXP type)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str),
+      stri_length(str, type))
+
+   if (stri__prepare_arg_grapheme(type, "type"))
+      return stri__length_grapheme(str);
+
+   SEXP cached = stri__metadata_get(str, "length", INTSXP);
+   if (!isNull(cached) && stri__metadata_unchanged(str, -1)) {
+      SEXP utf8 = stri__metadata_get(str, "utf8", LGLSXP);
+      R_len_t n = LENGTH(utf8);
+      for (R_len_t i=0; i<n; ++i) {
+         if (LOGICAL(utf8)[i] == FALSE)
+            Rf_warning(MSG__INVALID_UTF8);
+      }
+      return Rf_duplicate(cached);
+   }
+
    PROTECT(str = stri_prepare_arg_string(str, "str"));
 
    STRI__ERROR_HANDLER_BEGIN(1)
@@ -115,21 +198,14 @@ SEXP stri_length(SEXP str)
          throw StriException(MSG__BYTESENC);
       }
       else if (IS_UTF8(curs) || ucnvNative.isUTF8()) { // utf8 or native-utf8
-         UChar32 c = 0;
          const char* curs_s = CHAR(curs);
-         R_len_t j = 0;
-         R_len_t i = 0;
-         while (c >= 0 && j < curs_n) {
-            U8_NEXT(curs_s, j, curs_n, c); // faster that U8_FWD_1 & gives bad UChar32s
-            i++;
-         }
-
-         if (c < 0) { // invalid utf-8 sequence
+         R_len_t ncodepoints = stri__utf8_count_codepoints_valid(curs_s, curs_n);
+         if (ncodepoints < 0) { // invalid utf-8 sequence
             Rf_warning(MSG__INVALID_UTF8);
             retint[k] = NA_INTEGER;
          }
          else
-            retint[k] = i;
+            retint[k] = ncodepoints;
       }
       else if (ucnvNative.is8bit()) { // native-8bit
          retint[k] = curs_n;
@@ -174,9 +250,22 @@ SEXP stri_length(SEXP str)
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use cached stri_metadata
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_numbytes(SEXP str)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str),
+      stri_numbytes(str))
+
+   SEXP cached = stri__metadata_get(str, "numbytes", INTSXP);
+   if (!isNull(cached) && stri__metadata_unchanged(str, -1))
+      return Rf_duplicate(cached);
+
    PROTECT(str = stri_prepare_arg_string(str, "str")); // prepare string argument
    R_len_t str_n = LENGTH(str);
 
@@ -231,14 +320,17 @@ SEXP stri_isempty(SEXP str)
 }
 
 
-/** Get width of a single character
+/** Get width of a single character, as determined by ICU's properties
  *
  * inspired by http://www.cl.cam.ac.uk/~mgk25/ucs/wcwidth.c
  *
  * @param c code point
  * @return 0, 1, or 2
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    renamed from stri__width_char, see stri__width_char for the cached version
  */
-int stri__width_char(UChar32 c) {
+static int stri__width_char_icu(UChar32 c) {
    if (c == (UChar32)0x00AD) return 1; /* SOFT HYPHEN  */
    if (c == (UChar32)0x200B) return 0; /* ZERO WIDTH SPACE */
 
@@ -263,11 +355,91 @@ int stri__width_char(UChar32 c) {
 }
 
 
+#define STRI__WIDTH_BLOCK_SHIFT 8
+#define STRI__WIDTH_BLOCK_SIZE  (1<<STRI__WIDTH_BLOCK_SHIFT)
+#define STRI__WIDTH_NBLOCKS     ((UCHAR_MAX_VALUE+1)>>STRI__WIDTH_BLOCK_SHIFT)
+
+/* A two-stage lookup table for character widths:
+ * stri__width_blocks[(stri__width_index[c>>8]<<8)+(c&0xFF)]
+ * is the width of c. The first three blocks consist solely of 0s, 1s,
+ * and 2s, respectively, and are shared by all the code point ranges
+ * of uniform width (the vast majority of them),
+ * hence the table is very compact.
+ * The table is filled by stri__width_table_init() when the library is loaded
+ * and is read-only afterwards (e.g., it may be used in parallel in stri_wrap).
+ */
+static unsigned short stri__width_index[STRI__WIDTH_NBLOCKS];
+static std::vector<unsigned char> stri__width_blocks; // empty = not available
+
+
+/** Compute the character width table
+ *
+ * Called once, in R_init_stringi().
+ * On failure, the table remains empty and stri__width_char()
+ * queries ICU directly.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void stri__width_table_init() {
+   try {
+      std::vector<unsigned char> blocks(3*STRI__WIDTH_BLOCK_SIZE);
+      for (int w=0; w<=2; ++w)
+         memset(&blocks[w*STRI__WIDTH_BLOCK_SIZE], w, STRI__WIDTH_BLOCK_SIZE);
+
+      unsigned char cur[STRI__WIDTH_BLOCK_SIZE];
+      for (int block=0; block<STRI__WIDTH_NBLOCKS; ++block) {
+         bool uniform = true;
+         for (int k=0; k<STRI__WIDTH_BLOCK_SIZE; ++k) {
+            cur[k] = (unsigned char)stri__width_char_icu(
+               (UChar32)((block<<STRI__WIDTH_BLOCK_SHIFT)+k));
+            if (cur[k] != cur[0]) uniform = false;
+         }
+
+         if (uniform)
+            stri__width_index[block] = (unsigned short)cur[0];
+         else {
+            stri__width_index[block] = (unsigned short)(blocks.size()>>STRI__WIDTH_BLOCK_SHIFT);
+            blocks.insert(blocks.end(), cur, cur+STRI__WIDTH_BLOCK_SIZE);
+         }
+      }
+
+      stri__width_blocks.swap(blocks);
+   }
+   catch (...) {
+      stri__width_blocks.clear();
+   }
+}
+
+
+/** Get width of a single character
+ *
+ * @param c code point
+ * @return 0, 1, or 2
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use a two-stage lookup table
+ */
+int stri__width_char(UChar32 c) {
+   if (c < 0 || c > UCHAR_MAX_VALUE || stri__width_blocks.empty())
+      return stri__width_char_icu(c);
+
+   if (c < 0x80) /* ASCII: control characters have width 0 */
+      return (c >= 0x20 && c != 0x7F)?1:0;
+
+   return (int)stri__width_blocks[
+      ((size_t)stri__width_index[c>>STRI__WIDTH_BLOCK_SHIFT]<<STRI__WIDTH_BLOCK_SHIFT)
+      +(c&(STRI__WIDTH_BLOCK_SIZE-1))];
+}
+
+
 /** Get width of a single UTF-8 string
  *
  * @param str_cur_s string
  * @param str_cur_n number of bytes in str_cur_s
  * @return width
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    ASCII characters are not decoded
  */
 int stri__width_string(const char* str_cur_s, int str_cur_n) {
    int cur_width = 0;
@@ -275,6 +447,14 @@ int stri__width_string(const char* str_cur_s, int str_cur_n) {
    UChar32 c;
    R_len_t j = 0;
    while (j < str_cur_n) {
+      unsigned char b = (unsigned char)str_cur_s[j];
+      if (b < 0x80) {
+         // width = number of bytes minus the number of control characters
+         cur_width += (b >= 0x20 && b != 0x7F);
+         ++j;
+         continue;
+      }
+
       U8_NEXT(str_cur_s, j, str_cur_n, c);
       if (c < 0)
          throw StriException(MSG__INVALID_UTF8);
@@ -292,9 +472,29 @@ int stri__width_string(const char* str_cur_s, int str_cur_n) {
   * @return integer vector
   *
   * @version 0.5-1 (Marek Gagolewski, 2015-04-22)
+  *
+  * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+  *    use cached stri_metadata
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
   */
 SEXP stri_width(SEXP str)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str),
+      stri_width(str))
+
+   SEXP cached = stri__metadata_get(str, "width", INTSXP);
+   SEXP utf8 = stri__metadata_get(str, "utf8", LGLSXP);
+   if (!isNull(cached) && !isNull(utf8) && stri__metadata_unchanged(str, -1)) {
+      bool valid = true;
+      R_len_t n = LENGTH(utf8);
+      for (R_len_t i=0; valid && i<n; ++i)
+         valid = (LOGICAL(utf8)[i] != FALSE);
+      if (valid) return Rf_duplicate(cached);
+      // otherwise, the usual error will be generated below
+   }
+
    PROTECT(str = stri_prepare_arg_string(str, "str")); // prepare string argument
 
    STRI__ERROR_HANDLER_BEGIN(1)
@@ -63,6 +63,33 @@
       }                                                                                          \
 
 
+/* To be used at the beginning of a function vectorized over `str`:
+   if `cond` holds (see stri__factor_by_levels), `call` (which refers to `str`)
+   is evaluated only on the levels of the factor `str`
+   and the results are expanded through the factor's codes.
+   Otherwise (or if this is not possible), the function continues as usual,
+   unless options(stringi.factor_output=TRUE) is set: then `call` is evaluated
+   on the whole factor and a character result is converted to a factor. */
+#define STRI__FACTOR_BY_LEVELS(str, cond, call)                                 \
+   if (cond) {                                                                  \
+      SEXP stri__factor = (str);                                                \
+      PROTECT(str = stri__factor_used_levels(stri__factor));                    \
+      PROTECT(str = (call));                                                    \
+      str = stri__factor_gather(str, stri__factor);                             \
+      UNPROTECT(2);                                                             \
+      if (!isNull(str)) return str;                                             \
+      str = stri__factor;                                                       \
+   }                                                                            \
+   if (stri__factor_output_enabled(str)) {                                      \
+      SEXP stri__factor = (str);                                                \
+      PROTECT(str = stri__factor_expand(stri__factor));                         \
+      PROTECT(str = (call));                                                    \
+      str = stri__factor_output(str, stri__factor);                             \
+      UNPROTECT(2);                                                             \
+      return str;                                                               \
+   }                                                                            \
+
+
 #define STRI__GET_INT32_BE(input, index) \
    uint32_t(((uint8_t*)input)[index+0] << 24 | ((uint8_t*)input)[index+1] << 16 | ((uint8_t*)input)[index+2] << 8 | ((uint8_t*)input)[index+3])
 
@@ -277,7 +277,19 @@
 #define MSG__OVERLAPPING_PATTERN_UNSUPPORTED \
    "overlapping pattern matches are not supported"
 
+#define MSG__COMPILED_PATTERN_INVALID \
+   "compiled pattern is no longer valid (e.g., it has been loaded from a file); please compile it again"
+
 #define MSG__MEM_ALLOC_ERROR \
    "memory allocation error"
 
+#define MSG__BUF_SIZE_EXCEEDED \
+   "the resulting string would be too long"
+
+#define MSG__FILE_OPEN_ERROR \
+   "cannot open file `%s`"
+
+#define MSG__FILE_IO_ERROR \
+   "input/output error on file `%s`"
+
 #endif
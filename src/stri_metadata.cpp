@@ -0,0 +1,221 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "stri_stringi.h"
+#include "stri_container_utf8_indexable.h"
+
+
+/* components of a stri_metadata object, in this order */
+static const char* stri__metadata_names[] = {
+   "str", "length", "width", "numbytes", "ascii", "utf8", "checkpoints", NULL
+};
+
+
+/* attribute holding an external pointer whose protected value is
+   a private copy of the strings the metadata were computed for */
+#define STRI__METADATA_ATTR "stri_metadata"
+
+
+/**
+ * Get the private copy of the strings a metadata object was generated for
+ *
+ * @param x a list of class \code{stri_metadata}
+ * @return character vector or \code{R_NilValue} if not available
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static SEXP stri__metadata_strings(SEXP x)
+{
+   SEXP ptr = Rf_getAttrib(x, Rf_install(STRI__METADATA_ATTR));
+   if (TYPEOF(ptr) != EXTPTRSXP || R_ExternalPtrTag(ptr) != Rf_install(STRI__METADATA_ATTR))
+      return R_NilValue;
+   SEXP strs = R_ExternalPtrProtected(ptr);
+   if (!isString(strs) || LENGTH(strs) != LENGTH(VECTOR_ELT(x, 0)))
+      return R_NilValue;
+   return strs;
+}
+
+
+/**
+ * Get a component of a metadata object
+ *
+ * @param x an R object, possibly generated by \code{stri_metadata}
+ * @param name component name
+ * @param type expected SEXPTYPE of the component
+ * @return the component or \code{R_NilValue}
+ *    if \code{x} is not a valid metadata object or the component is
+ *    not available
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri__metadata_get(SEXP x, const char* name, SEXPTYPE type)
+{
+   if (!Rf_isVectorList(x) || !Rf_inherits(x, "stri_metadata")
+         || LENGTH(x) != 7 || !isString(VECTOR_ELT(x, 0))
+         || isNull(stri__metadata_strings(x)))
+      return R_NilValue;
+
+   for (R_len_t k = 0; stri__metadata_names[k]; ++k) {
+      if (strcmp(stri__metadata_names[k], name)) continue;
+      SEXP comp = VECTOR_ELT(x, k);
+      if (TYPEOF(comp) != (int)type || LENGTH(comp) != LENGTH(VECTOR_ELT(x, 0)))
+         return R_NilValue;
+      return comp;
+   }
+   return R_NilValue;
+}
+
+
+/**
+ * Check if the strings in a metadata object are still those
+ * the metadata were computed for
+ *
+ * The object's components may be modified by the user,
+ * e.g., \code{m$str[1] <- "a"} keeps the class and the cached values.
+ *
+ * @param x an object for which \code{stri__metadata_get} is not \code{NULL}
+ * @param i string index or -1 to check all the strings
+ * @return whether the cached values may be used for the i-th string
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool stri__metadata_unchanged(SEXP x, R_len_t i)
+{
+   SEXP str  = VECTOR_ELT(x, 0);
+   SEXP strs = stri__metadata_strings(x);
+   if (isNull(strs))
+      return false;
+   if (i >= 0)
+      return STRING_ELT(str, i) == STRING_ELT(strs, i);
+
+   R_len_t n = LENGTH(str);
+   for (R_len_t j=0; j<n; ++j) {
+      if (STRING_ELT(str, j) != STRING_ELT(strs, j))
+         return false;
+   }
+   return true;
+}
+
+
+/**
+ * Precompute strings' metadata
+ *
+ * @param str character vector
+ * @param checkpoints single logical value
+ * @return a list of class \code{stri_metadata}
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri_metadata(SEXP str, SEXP checkpoints)
+{
+   bool checkpoints1 = stri__prepare_arg_logical_1_notNA(checkpoints, "checkpoints");
+   PROTECT(str = stri_prepare_arg_string(str, "str"));
+
+   STRI__ERROR_HANDLER_BEGIN(1)
+   R_len_t str_n = LENGTH(str);
+   StriContainerUTF8 str_cont(str, str_n);
+
+   SEXP ret, ret_length, ret_width, ret_numbytes, ret_ascii, ret_utf8, ret_cp, strs, ptr;
+   STRI__PROTECT(ret = Rf_allocVector(VECSXP, 7));
+   SET_VECTOR_ELT(ret, 0, str);
+   SET_VECTOR_ELT(ret, 1, ret_length   = Rf_allocVector(INTSXP, str_n));
+   SET_VECTOR_ELT(ret, 2, ret_width    = Rf_allocVector(INTSXP, str_n));
+   SET_VECTOR_ELT(ret, 3, ret_numbytes = Rf_allocVector(INTSXP, str_n));
+   SET_VECTOR_ELT(ret, 4, ret_ascii    = Rf_allocVector(LGLSXP, str_n));
+   SET_VECTOR_ELT(ret, 5, ret_utf8     = Rf_allocVector(LGLSXP, str_n));
+   if (checkpoints1)
+      SET_VECTOR_ELT(ret, 6, ret_cp    = Rf_allocVector(VECSXP, str_n));
+   int* length_tab   = INTEGER(ret_length);
+   int* width_tab    = INTEGER(ret_width);
+   int* numbytes_tab = INTEGER(ret_numbytes);
+   int* ascii_tab    = LOGICAL(ret_ascii);
+   int* utf8_tab     = LOGICAL(ret_utf8);
+
+   for (R_len_t i = 0; i < str_n; ++i) {
+      if (str_cont.isNA(i)) {
+         length_tab[i] = width_tab[i] = numbytes_tab[i] = NA_INTEGER;
+         ascii_tab[i] = utf8_tab[i] = NA_LOGICAL;
+         continue;
+      }
+
+      /* INPUT ENCODING CHECK: as in stri_numbytes */
+      numbytes_tab[i] = LENGTH(STRING_ELT(str, i));
+
+      const char* str_cur_s = str_cont.get(i).c_str();
+      R_len_t     str_cur_n = str_cont.get(i).length();
+      if (!str_cont.get(i).isASCII() && !stri__utf8_is_valid(str_cur_s, str_cur_n)) {
+         length_tab[i] = width_tab[i] = NA_INTEGER;
+         ascii_tab[i] = FALSE;
+         utf8_tab[i] = FALSE;
+         continue;
+      }
+
+      utf8_tab[i]   = TRUE;
+      length_tab[i] = str_cont.get(i).countCodePoints();
+      width_tab[i]  = stri__width_string(str_cur_s, str_cur_n);
+      ascii_tab[i]  = (length_tab[i] == str_cur_n);
+
+      // byte offsets of every STRI__METADATA_CHECKPOINT_INTERVAL-th code point,
+      // not needed for ASCII strings
+      R_len_t ncp = length_tab[i]/STRI__METADATA_CHECKPOINT_INTERVAL;
+      if (!checkpoints1 || ascii_tab[i] || ncp <= 0)
+         continue;
+
+      SEXP cur_cp;
+      SET_VECTOR_ELT(ret_cp, i, cur_cp = Rf_allocVector(INTSXP, ncp));
+      int* cp_tab = INTEGER(cur_cp);
+      R_len_t j = 0, k = 0;
+      for (R_len_t c = 1; c <= ncp*STRI__METADATA_CHECKPOINT_INTERVAL; ++c) {
+         U8_FWD_1((const uint8_t*)str_cur_s, j, str_cur_n);
+         if (c % STRI__METADATA_CHECKPOINT_INTERVAL == 0)
+            cp_tab[k++] = j;
+      }
+   }
+
+   SEXP names, cls;
+   STRI__PROTECT(names = Rf_allocVector(STRSXP, 7));
+   for (R_len_t k = 0; k < 7; ++k)
+      SET_STRING_ELT(names, k, Rf_mkChar(stri__metadata_names[k]));
+   Rf_setAttrib(ret, R_NamesSymbol, names);
+   STRI__PROTECT(cls = Rf_mkString("stri_metadata"));
+   Rf_setAttrib(ret, R_ClassSymbol, cls);
+
+   // a copy of the strings, not modifiable at the R level
+   STRI__PROTECT(strs = Rf_allocVector(STRSXP, str_n));
+   for (R_len_t i = 0; i < str_n; ++i)
+      SET_STRING_ELT(strs, i, STRING_ELT(str, i));
+   STRI__PROTECT(ptr = R_MakeExternalPtr(NULL, Rf_install(STRI__METADATA_ATTR), strs));
+   Rf_setAttrib(ret, Rf_install(STRI__METADATA_ATTR), ptr);
+
+   STRI__UNPROTECT_ALL
+   return ret;
+   STRI__ERROR_HANDLER_END({ /* no special action on error */ })
+}
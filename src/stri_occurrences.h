@@ -0,0 +1,158 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef __stri_occurrences_h
+#define __stri_occurrences_h
+
+#include <utility>
+#include <cstdlib>
+
+
+/** Number of (start, end) pairs stored without a heap allocation
+ *  in a StriOccurrences buffer
+ */
+#define STRI__OCCURRENCES_INLINE 4
+
+
+/**
+ * A contiguous buffer of (start, end) pairs of indices,
+ * e.g., matches of a pattern or fields to split a string into
+ *
+ * Replaces \code{std::deque}, which allocates and frees its blocks
+ * for each string searched. A single buffer is created per call
+ * and reused across the elements of a character vector: clear()
+ * does not release the memory. Up to \code{STRI__OCCURRENCES_INLINE}
+ * pairs (the most common case) are stored within the object itself.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriOccurrences {
+
+   public:
+
+      typedef std::pair<R_len_t, R_len_t> value_type;
+      typedef value_type* iterator;
+      typedef const value_type* const_iterator;
+
+   private:
+
+      StriOccurrences(const StriOccurrences&); /* no copy-able */
+      StriOccurrences& operator=(const StriOccurrences&);
+
+      value_type m_inline[STRI__OCCURRENCES_INLINE];
+      value_type* m_data;   ///< m_inline or malloc'd
+      R_len_t m_size;
+      R_len_t m_capacity;
+
+      void grow()
+      {
+         R_len_t new_capacity = 2*m_capacity;
+         value_type* new_data = (value_type*)malloc(sizeof(value_type)*(size_t)new_capacity);
+         if (!new_data) throw StriException(MSG__MEM_ALLOC_ERROR);
+         for (R_len_t i=0; i<m_size; ++i)
+            new_data[i] = m_data[i];
+         if (m_data != m_inline)
+            free(m_data);
+         m_data = new_data;
+         m_capacity = new_capacity;
+      }
+
+   public:
+
+      StriOccurrences()
+         : m_data(m_inline), m_size(0), m_capacity(STRI__OCCURRENCES_INLINE) { }
+
+      ~StriOccurrences()
+      {
+         if (m_data != m_inline) {
+            free(m_data);
+            m_data = NULL;
+         }
+      }
+
+      /** remove all the elements, but keep the allocated memory */
+      inline void clear() {
+         m_size = 0;
+      }
+
+      inline R_len_t size() const {
+         return m_size;
+      }
+
+      inline bool empty() const {
+         return m_size == 0;
+      }
+
+      inline void push_back(const value_type& x) {
+         if (m_size == m_capacity) grow();
+         m_data[m_size++] = x;
+      }
+
+      inline void pop_back() {
+         --m_size;
+      }
+
+      inline value_type& back() {
+         return m_data[m_size-1];
+      }
+
+      inline const value_type& back() const {
+         return m_data[m_size-1];
+      }
+
+      inline value_type& operator[](R_len_t i) {
+         return m_data[i];
+      }
+
+      inline const value_type& operator[](R_len_t i) const {
+         return m_data[i];
+      }
+
+      inline iterator begin() {
+         return m_data;
+      }
+
+      inline iterator end() {
+         return m_data+m_size;
+      }
+
+      inline const_iterator begin() const {
+         return m_data;
+      }
+
+      inline const_iterator end() const {
+         return m_data+m_size;
+      }
+};
+
+#endif
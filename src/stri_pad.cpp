@@ -62,6 +62,9 @@
  * @version 0.5-1 (Marek Gagolewski, 2015-04-22)
  *    `use_length` arg added,
  *    second argument renamed `width`
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use widths/lengths cached in a stri_metadata object
 */
 SEXP stri_pad(SEXP str, SEXP width, SEXP side, SEXP pad, SEXP use_length)
 {
@@ -73,6 +76,9 @@ SEXP stri_pad(SEXP str, SEXP width, SEXP side, SEXP pad, SEXP use_length)
       Rf_error(MSG__INCORRECT_INTERNAL_ARG);
 
    bool use_length_val = stri__prepare_arg_logical_1_notNA(use_length, "use_length");
+   SEXP metadata = str;
+   SEXP str_width_cached = stri__metadata_get(str,
+      use_length_val?"length":"width", INTSXP); // NULL if not available
    PROTECT(str         = stri_prepare_arg_string(str, "str"));
    PROTECT(width       = stri_prepare_arg_integer(width, "width"));
    PROTECT(pad         = stri_prepare_arg_string(pad, "pad"));
@@ -114,9 +120,16 @@ SEXP stri_pad(SEXP str, SEXP width, SEXP side, SEXP pad, SEXP use_length)
       R_len_t pad_cur_n = pad_cont.get(i).length();
       const char* pad_cur_s = pad_cont.get(i).c_str();
       R_len_t pad_cur_width;
+      if (!isNull(str_width_cached) && stri__metadata_unchanged(metadata, i % str_length)
+            && INTEGER(str_width_cached)[i % str_length] >= 0)
+         str_cur_width = INTEGER(str_width_cached)[i % str_length];
+      else
+         str_cur_width = NA_INTEGER;
+
       if (use_length_val) {
          pad_cur_width = 1;
-         str_cur_width = str_cont.get(i).countCodePoints();
+         if (str_cur_width == NA_INTEGER)
+            str_cur_width = str_cont.get(i).countCodePoints();
          R_len_t k = 0;
          UChar32 pad_cur = 0;
          U8_NEXT(pad_cur_s, k, pad_cur_n, pad_cur);
@@ -125,7 +138,8 @@ SEXP stri_pad(SEXP str, SEXP width, SEXP side, SEXP pad, SEXP use_length)
       }
       else {
          pad_cur_width = stri__width_string(pad_cur_s, pad_cur_n);
-         str_cur_width = stri__width_string(str_cur_s, str_cur_n);
+         if (str_cur_width == NA_INTEGER) // not cached or invalid UTF-8
+            str_cur_width = stri__width_string(str_cur_s, str_cur_n);
          if (pad_cur_width != 1)
             throw StriException(MSG__NOT_EQ_N_WIDTH, "pad", 1);
       }
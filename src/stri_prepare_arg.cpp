@@ -206,14 +206,34 @@ SEXP stri_prepare_arg_list_string(SEXP x, const char* argname)
  *
  * @version 0.5-1 (Marek Gagolewski, 2015-05-01)
  *        #154 - the class attribute set fires up an as.xxxx call
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *        accept stri_metadata objects
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *        factors are expanded without calling as.character
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *        compiled patterns (stri_pattern objects) are returned as-is
  */
 SEXP stri_prepare_arg_string(SEXP x, const char* argname)
 {
    if ((SEXP*)argname == (SEXP*)R_NilValue)
       argname = "<noname>";
 
+   SEXP metadata_str = stri__metadata_get(x, "str", STRSXP);
+   if (!isNull(metadata_str))
+      return metadata_str; // already prepared by stri_metadata
+
+   if ((bool)isString(x) && Rf_inherits(x, "stri_pattern"))
+      return x; // keep the compiled pattern attached, see StriCompiledPattern
+
    if (Rf_isFactor(x))
    {
+      SEXP expanded = stri__factor_expand(x);
+      if (!isNull(expanded))
+         return expanded;
+
       SEXP call;
       PROTECT(call = Rf_lang2(Rf_install("as.character"), x));
       PROTECT(x = Rf_eval(call, R_GlobalEnv)); // this will mark it's encoding manually
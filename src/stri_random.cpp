@@ -197,7 +197,7 @@ SEXP stri_rand_strings(SEXP n, SEXP length, SEXP pattern)
       int length_cur = length_cont.get(i);
       if (length_cur < 0) length_cur = 0;
 
-      const UnicodeSet* uset = &(pattern_cont.get(i));
+      const UnicodeSet* uset = &(pattern_cont.get(i).getSet());
       int32_t uset_size = uset->size();
 
       // generate string:
@@ -0,0 +1,1448 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "stri_stringi.h"
+#include "stri_regex_dfa.h"
+#include <unicode/uniset.h>
+#include <unicode/uregex.h>
+#include <algorithm>
+
+
+/** A sequence of byte ranges matching some UTF-8-encoded code points */
+typedef std::vector< std::pair<uint8_t, uint8_t> > StriRegexByteSeq;
+
+
+/** Convert a range of code points to sequences of UTF-8 byte ranges
+ *
+ * Each code point in \code{[lo, hi]} (except surrogates)
+ * is matched by exactly one of the resulting sequences.
+ * This is the algorithm used in RE2 and Go.
+ *
+ * @param lo first code point
+ * @param hi last code point
+ * @param seqs [out] sequences are appended here
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static void stri__regex_dfa_utf8_ranges(UChar32 lo, UChar32 hi, std::vector<StriRegexByteSeq>& seqs)
+{
+   if (lo > hi)
+      return;
+
+   if (lo < 0xE000 && hi > 0xD7FF) { // surrogates do not occur in valid UTF-8
+      stri__regex_dfa_utf8_ranges(lo, 0xD7FF, seqs);
+      stri__regex_dfa_utf8_ranges(0xE000, hi, seqs);
+      return;
+   }
+
+   static const UChar32 len_max[] = {0x7F, 0x7FF, 0xFFFF};
+   for (int k=0; k<3; ++k) {
+      if (lo <= len_max[k] && hi > len_max[k]) { // different encoded lengths
+         stri__regex_dfa_utf8_ranges(lo, len_max[k], seqs);
+         stri__regex_dfa_utf8_ranges(len_max[k]+1, hi, seqs);
+         return;
+      }
+   }
+
+   for (int k=1; k<4; ++k) { // all continuation bytes must span full ranges
+      UChar32 m = (1 << (6*k)) - 1;
+      if ((lo & ~m) != (hi & ~m)) {
+         if ((lo & m) != 0) {
+            stri__regex_dfa_utf8_ranges(lo, lo|m, seqs);
+            stri__regex_dfa_utf8_ranges((lo|m)+1, hi, seqs);
+            return;
+         }
+         if ((hi & m) != m) {
+            stri__regex_dfa_utf8_ranges(lo, (hi&~m)-1, seqs);
+            stri__regex_dfa_utf8_ranges(hi&~m, hi, seqs);
+            return;
+         }
+      }
+   }
+
+   uint8_t lo8[4], hi8[4];
+   int32_t lo_n = 0, hi_n = 0;
+   UBool err = FALSE;
+   U8_APPEND(lo8, lo_n, 4, lo, err);
+   U8_APPEND(hi8, hi_n, 4, hi, err);
+   StriRegexByteSeq seq;
+   for (int32_t k=0; k<lo_n; ++k)
+      seq.push_back(std::pair<uint8_t, uint8_t>(lo8[k], hi8[k]));
+   seqs.push_back(seq);
+}
+
+
+/** Get the position before a line terminator at the end of a string
+ *
+ * This is where \code{$} matches (in the non-multiline mode)
+ * in addition to the end of input, as in ICU.
+ *
+ * @param str valid UTF-8 string
+ * @param n number of bytes
+ * @param unixLines only \code{\\n} is a line terminator
+ * @return byte index or -1
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t stri__regex_dfa_end_pos1(const char* str, R_len_t n, bool unixLines)
+{
+   const uint8_t* s = (const uint8_t*)str;
+   if (n <= 0)
+      return -1;
+   else if (unixLines)
+      return (s[n-1] == 0x0a)?(n-1):-1;
+   else if (n >= 2 && s[n-2] == 0x0d && s[n-1] == 0x0a)
+      return n-2; // CR+LF is a single line terminator
+   else if (s[n-1] >= 0x0a && s[n-1] <= 0x0d)
+      return n-1;
+   else if (n >= 2 && s[n-2] == 0xc2 && s[n-1] == 0x85)
+      return n-2; // U+0085
+   else if (n >= 3 && s[n-3] == 0xe2 && s[n-2] == 0x80 && (s[n-1] == 0xa8 || s[n-1] == 0xa9))
+      return n-3; // U+2028, U+2029
+   else
+      return -1;
+}
+
+
+/**
+ * A node of a regex syntax tree
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+struct StriRegexNode {
+   enum { EMPTY, SET, CONCAT, ALTERNATE, REPEAT };
+
+   int type;
+   std::vector<UChar32> ranges;  ///< SET: lo0, hi0, lo1, hi1, ...
+   std::vector<int32_t> child;   ///< indices of child nodes
+   int32_t min;                  ///< REPEAT: min number of repetitions
+   int32_t max;                  ///< REPEAT: max number or -1 (unbounded)
+   bool greedy;                  ///< REPEAT
+   bool nullable;                ///< may match an empty string
+
+   StriRegexNode(int _type)
+      : type(_type), min(0), max(0), greedy(true), nullable(_type == EMPTY) { }
+};
+
+
+/**
+ * A parser for the subset of the ICU regex syntax supported by StriRegexDFA
+ *
+ * All parse*() methods return -1 if the pattern is not supported
+ * (or is invalid, which is left for ICU to report).
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriRegexParser {
+
+   private:
+
+      const UChar* p;
+      int32_t n;
+      int32_t j;       ///< current position in p
+      int32_t depth;   ///< group nesting level
+      uint32_t flags;
+
+      static const int32_t ANCHOR = -2; ///< parseAtom(): an anchor was consumed
+
+      int32_t addNode(const StriRegexNode& node) {
+         nodes.push_back(node);
+         return (int32_t)nodes.size()-1;
+      }
+
+      int32_t addSet(const UnicodeSet& set) {
+         StriRegexNode node(StriRegexNode::SET);
+         for (int32_t k=0; k<set.getRangeCount(); ++k) {
+            node.ranges.push_back(set.getRangeStart(k));
+            node.ranges.push_back(set.getRangeEnd(k));
+         }
+         return addNode(node);
+      }
+
+      int32_t addChar(UChar32 c) {
+         StriRegexNode node(StriRegexNode::SET);
+         node.ranges.push_back(c);
+         node.ranges.push_back(c);
+         return addNode(node);
+      }
+
+      static int32_t hexValue(UChar c) {
+         if (c >= (UChar)'0' && c <= (UChar)'9') return (int32_t)(c-(UChar)'0');
+         if (c >= (UChar)'a' && c <= (UChar)'f') return (int32_t)(c-(UChar)'a')+10;
+         if (c >= (UChar)'A' && c <= (UChar)'F') return (int32_t)(c-(UChar)'A')+10;
+         return -1;
+      }
+
+      bool readChar(UChar32& c);
+      bool readHex(int32_t ndigits, UChar32& c);
+      int readClassEscape(UnicodeSet& set);
+      bool readCharEscape(UChar32& c);
+      bool parseSet(UnicodeSet& set);
+      int32_t parseQuantifier(int32_t atom);
+      int32_t parseAtom();
+      int32_t parseConcat();
+      int32_t parseAlt();
+
+   public:
+
+      std::vector<StriRegexNode> nodes;
+      bool anchorStart;
+      int32_t anchorEnd;
+
+      StriRegexParser(const UnicodeString& pattern, uint32_t _flags)
+         : p(pattern.getBuffer()), n(pattern.length()), j(0), depth(0),
+           flags(_flags), anchorStart(false), anchorEnd(0) { }
+
+      int32_t parse();
+};
+
+
+/** Read a literal code point
+ *
+ * @param c [out] code point
+ * @return false on an unpaired surrogate
+ */
+bool StriRegexParser::readChar(UChar32& c)
+{
+   c = p[j++];
+   if (U16_IS_LEAD(c) && j < n && U16_IS_TRAIL(p[j]))
+      c = U16_GET_SUPPLEMENTARY(c, p[j++]);
+   return !U16_IS_SURROGATE(c);
+}
+
+
+/** Read a given number of hex digits (or any number in braces if ndigits < 0)
+ *
+ * @param ndigits number of digits
+ * @param c [out] code point
+ * @return false if this is not a valid non-surrogate code point
+ */
+bool StriRegexParser::readHex(int32_t ndigits, UChar32& c)
+{
+   c = 0;
+   if (ndigits < 0) {
+      if (j >= n || p[j] != (UChar)'{') return false;
+      ++j;
+      int32_t k;
+      for (k=0; j < n && p[j] != (UChar)'}'; ++k, ++j) {
+         int32_t v = hexValue(p[j]);
+         if (v < 0 || k >= 6) return false;
+         c = c*16+v;
+      }
+      if (j >= n || k == 0) return false;
+      ++j;
+   }
+   else {
+      for (int32_t k=0; k<ndigits; ++k, ++j) {
+         int32_t v = (j < n)?hexValue(p[j]):-1;
+         if (v < 0) return false;
+         c = c*16+v;
+      }
+   }
+   return (c >= 0 && c <= 0x10FFFF && !U_IS_SURROGATE(c));
+}
+
+
+/** Read \\d, \\D, \\w, \\W, \\s, \\S, \\p{...}, \\P{...}
+ *
+ * The sets are defined in the same way as in ICU's regex compiler.
+ *
+ * @param set [out]
+ * @return 1 on success, 0 if this is not a class escape (nothing is consumed),
+ *    -1 on error
+ */
+int StriRegexParser::readClassEscape(UnicodeSet& set)
+{
+   if (j+1 >= n || p[j] != (UChar)'\\') return 0;
+   UChar d = p[j+1];
+   UErrorCode status = U_ZERO_ERROR;
+   switch (d) {
+      case (UChar)'d': case (UChar)'D':
+         set.applyPattern(UNICODE_STRING_SIMPLE("[\\p{Nd}]"), status);
+         break;
+      case (UChar)'w': case (UChar)'W':
+         set.applyPattern(UNICODE_STRING_SIMPLE("[\\p{Alphabetic}\\p{M}\\p{Nd}\\p{Pc}\\u200c\\u200d]"), status);
+         break;
+      case (UChar)'s': case (UChar)'S':
+         set.applyPattern(UNICODE_STRING_SIMPLE("[\\p{WhiteSpace}]"), status);
+         break;
+      case (UChar)'p': case (UChar)'P': {
+         UnicodeString expr((d == (UChar)'p')?"[\\p{":"[\\P{", -1, US_INV);
+         if (j+2 < n && p[j+2] == (UChar)'{') {
+            int32_t k;
+            for (k=j+3; k < n && p[k] != (UChar)'}'; ++k)
+               ;
+            if (k >= n || k == j+3) return -1;
+            expr.append(p+j+3, k-(j+3));
+            j = k+1;
+         }
+         else if (j+2 < n && p[j+2] < 128 && isalpha((int)p[j+2])) {
+            expr.append(p[j+2]);
+            j += 3;
+         }
+         else
+            return -1;
+         expr.append(UNICODE_STRING_SIMPLE("}]"));
+         set.applyPattern(expr, 0, NULL, status);
+         return U_SUCCESS(status)?1:-1;
+      }
+      default:
+         return 0;
+   }
+
+   if (U_FAILURE(status)) return -1;
+   if (d == (UChar)'D' || d == (UChar)'W' || d == (UChar)'S')
+      set.complement();
+   j += 2;
+   return 1;
+}
+
+
+/** Read an escaped literal character
+ *
+ * Supported are: escaped ASCII punctuation, \\t, \\n, \\r, \\f, \\a, \\e,
+ * \\xhh, \\x{h...}, \\uhhhh, \\Uhhhhhhhh.
+ *
+ * @param c [out] code point
+ * @return false if not supported
+ */
+bool StriRegexParser::readCharEscape(UChar32& c)
+{
+   if (j+1 >= n || p[j] != (UChar)'\\') return false;
+   UChar d = p[j+1];
+   j += 2;
+   if (d < 128 && !isalnum((int)d)) { c = d; return true; }
+   switch (d) {
+      case (UChar)'t': c = 0x09; return true;
+      case (UChar)'n': c = 0x0a; return true;
+      case (UChar)'r': c = 0x0d; return true;
+      case (UChar)'f': c = 0x0c; return true;
+      case (UChar)'a': c = 0x07; return true;
+      case (UChar)'e': c = 0x1b; return true;
+      case (UChar)'x': return readHex((j < n && p[j] == (UChar)'{')?-1:2, c);
+      case (UChar)'u': return readHex(4, c);
+      case (UChar)'U': return readHex(8, c);
+      default: return false;
+   }
+}
+
+
+/** Parse a set, \code{[...]}
+ *
+ * Nested sets, set operations, POSIX-like classes, strings etc.
+ * are not supported.
+ *
+ * @param set [out]
+ * @return false if not supported
+ */
+bool StriRegexParser::parseSet(UnicodeSet& set)
+{
+   ++j; // '['
+   if (j < n && p[j] == (UChar)':') return false; // [:alpha:], [:^digit:] (POSIX-like)
+   bool negated = false;
+   if (j < n && p[j] == (UChar)'^') {
+      negated = true;
+      ++j;
+   }
+   if (j >= n || p[j] == (UChar)']') return false;
+
+   while (true) {
+      if (j >= n) return false;
+      UChar c = p[j];
+      if (c == (UChar)']') {
+         ++j;
+         break;
+      }
+      if (c == (UChar)'[' || c == (UChar)'{' || c == (UChar)'}' || c == (UChar)'$' ||
+            c == (UChar)'&' || c == (UChar)'-')
+         return false;
+
+      UChar32 lo;
+      if (c == (UChar)'\\') {
+         UnicodeSet cls;
+         int ret = readClassEscape(cls);
+         if (ret < 0) return false;
+         if (ret > 0) {
+            set.addAll(cls);
+            continue;
+         }
+         if (!readCharEscape(lo)) return false;
+      }
+      else if (!readChar(lo))
+         return false;
+
+      if (j+1 < n && p[j] == (UChar)'-' && p[j+1] != (UChar)']') { // a range
+         ++j;
+         UChar32 hi;
+         c = p[j];
+         if (c == (UChar)'\\') {
+            if (!readCharEscape(hi)) return false;
+         }
+         else if (c == (UChar)'[' || c == (UChar)'{' || c == (UChar)'}' || c == (UChar)'$' ||
+               c == (UChar)'&' || c == (UChar)'-')
+            return false;
+         else if (!readChar(hi))
+            return false;
+         if (hi < lo) return false;
+         set.add(lo, hi);
+      }
+      else
+         set.add(lo);
+   }
+
+   if (negated) set.complement();
+   return true;
+}
+
+
+/** Parse an optional quantifier following an atom
+ *
+ * @param atom node index
+ * @return node index
+ */
+int32_t StriRegexParser::parseQuantifier(int32_t atom)
+{
+   if (j >= n) return atom;
+
+   int32_t min, max;
+   UChar c = p[j];
+   if (c == (UChar)'?')      { min = 0; max = 1;  ++j; }
+   else if (c == (UChar)'*') { min = 0; max = -1; ++j; }
+   else if (c == (UChar)'+') { min = 1; max = -1; ++j; }
+   else if (c == (UChar)'{') {
+      ++j;
+      int32_t k = j;
+      for (min = 0; j < n && p[j] >= (UChar)'0' && p[j] <= (UChar)'9' && j-k < 4; ++j)
+         min = min*10+(int32_t)(p[j]-(UChar)'0');
+      if (j == k || j >= n) return -1;
+      if (p[j] == (UChar)'}')
+         max = min;
+      else if (p[j] == (UChar)',') {
+         ++j;
+         k = j;
+         for (max = 0; j < n && p[j] >= (UChar)'0' && p[j] <= (UChar)'9' && j-k < 4; ++j)
+            max = max*10+(int32_t)(p[j]-(UChar)'0');
+         if (j == k) max = -1;
+         if (j >= n || p[j] != (UChar)'}') return -1;
+      }
+      else
+         return -1;
+      ++j;
+      if (min > 1000 || max > 1000 || (max >= 0 && max < min)) return -1;
+   }
+   else
+      return atom;
+
+   bool greedy = true;
+   if (j < n && p[j] == (UChar)'?') {
+      greedy = false;
+      ++j;
+   }
+   else if (j < n && p[j] == (UChar)'+')
+      return -1; // possessive
+
+   if (j < n && (p[j] == (UChar)'?' || p[j] == (UChar)'*' || p[j] == (UChar)'+' || p[j] == (UChar)'{'))
+      return -1; // stacked quantifiers
+
+   // repeating something that may match an empty string:
+   // ICU's special treatment of empty iterations is not emulated
+   if (nodes[atom].nullable && (max < 0 || max > 1))
+      return -1;
+
+   if (max == 0)
+      return addNode(StriRegexNode(StriRegexNode::EMPTY));
+
+   StriRegexNode node(StriRegexNode::REPEAT);
+   node.child.push_back(atom);
+   node.min = min;
+   node.max = max;
+   node.greedy = greedy;
+   node.nullable = (min == 0 || nodes[atom].nullable);
+   return addNode(node);
+}
+
+
+/** Parse an atom: a group, a set, a character, or an anchor
+ *
+ * @return node index, ANCHOR, or -1
+ */
+int32_t StriRegexParser::parseAtom()
+{
+   UChar c = p[j];
+   switch (c) {
+      case (UChar)'(': {
+         ++j;
+         if (j < n && p[j] == (UChar)'?') {
+            // (?:...) and (?<name>...) only
+            if (j+1 < n && p[j+1] == (UChar)':')
+               j += 2;
+            else if (j+2 < n && p[j+1] == (UChar)'<' && p[j+2] < 128 && isalpha((int)p[j+2])) {
+               for (j += 2; j < n && p[j] < 128 && isalnum((int)p[j]); ++j)
+                  ;
+               if (j >= n || p[j] != (UChar)'>') return -1;
+               ++j;
+            }
+            else
+               return -1;
+         }
+         if (depth >= STRI__REGEX_DFA_MAX_DEPTH) return -1;
+         ++depth;
+         int32_t atom = parseAlt();
+         --depth;
+         if (atom < 0 || j >= n || p[j] != (UChar)')') return -1;
+         ++j;
+         return atom;
+      }
+
+      case (UChar)'[': {
+         UnicodeSet set;
+         if (!parseSet(set)) return -1;
+         return addSet(set);
+      }
+
+      case (UChar)'.': {
+         if (flags & UREGEX_DOTALL) return -1; // matches CR+LF as a whole
+         ++j;
+         UnicodeSet set(0, 0x10FFFF);
+         if (flags & UREGEX_UNIX_LINES)
+            set.remove(0x0a);
+         else {
+            set.remove(0x0a, 0x0d);
+            set.remove(0x85);
+            set.remove(0x2028, 0x2029);
+         }
+         return addSet(set);
+      }
+
+      case (UChar)'^':
+         if (j != 0 || (flags & UREGEX_MULTILINE)) return -1;
+         ++j;
+         anchorStart = true;
+         return ANCHOR;
+
+      case (UChar)'$':
+         if (j != n-1 || depth != 0 || (flags & UREGEX_MULTILINE)) return -1;
+         ++j;
+         anchorEnd = (int32_t)'$';
+         return ANCHOR;
+
+      case (UChar)'\\': {
+         if (j+1 >= n) return -1;
+         if (p[j+1] == (UChar)'A') {
+            if (j != 0) return -1;
+            j += 2;
+            anchorStart = true;
+            return ANCHOR;
+         }
+         if (p[j+1] == (UChar)'z') {
+            if (j != n-2 || depth != 0) return -1;
+            j += 2;
+            anchorEnd = (int32_t)'z';
+            return ANCHOR;
+         }
+         if (p[j+1] == (UChar)'Q') { // quoted literal
+            StriRegexNode node(StriRegexNode::CONCAT);
+            for (j += 2; j < n && !(p[j] == (UChar)'\\' && j+1 < n && p[j+1] == (UChar)'E'); ) {
+               UChar32 cp;
+               if (!readChar(cp)) return -1;
+               node.child.push_back(addChar(cp));
+            }
+            if (j < n) j += 2; // \E
+            if (node.child.size() == 0) return -1; // an empty \Q\E is transparent to quantifiers
+            if (j < n && (p[j] == (UChar)'?' || p[j] == (UChar)'*' || p[j] == (UChar)'+' || p[j] == (UChar)'{'))
+               return -1; // a quantifier would apply to the last character only
+            return addNode(node);
+         }
+
+         UnicodeSet set;
+         int ret = readClassEscape(set);
+         if (ret < 0) return -1;
+         if (ret > 0) return addSet(set);
+
+         UChar32 cp;
+         if (!readCharEscape(cp)) return -1;
+         return addChar(cp);
+      }
+
+      case (UChar)'*': case (UChar)'+': case (UChar)'?': case (UChar)'{':
+      case (UChar)'}': case (UChar)']':
+         return -1;
+
+      default: {
+         UChar32 cp;
+         if (!readChar(cp)) return -1;
+         return addChar(cp);
+      }
+   }
+}
+
+
+/** Parse a concatenation of quantified atoms
+ *
+ * @return node index or -1
+ */
+int32_t StriRegexParser::parseConcat()
+{
+   StriRegexNode node(StriRegexNode::CONCAT);
+   node.nullable = true;
+   while (j < n && p[j] != (UChar)'|' && p[j] != (UChar)')') {
+      int32_t atom = parseAtom();
+      if (atom == ANCHOR) {
+         if (j < n && (p[j] == (UChar)'?' || p[j] == (UChar)'*' || p[j] == (UChar)'+' || p[j] == (UChar)'{'))
+            return -1;
+         continue;
+      }
+      if (atom < 0) return -1;
+      atom = parseQuantifier(atom);
+      if (atom < 0) return -1;
+      node.child.push_back(atom);
+      node.nullable = node.nullable && nodes[atom].nullable;
+   }
+
+   if (node.child.size() == 0)
+      return addNode(StriRegexNode(StriRegexNode::EMPTY));
+   else if (node.child.size() == 1)
+      return node.child[0];
+   else
+      return addNode(node);
+}
+
+
+/** Parse an alternation
+ *
+ * @return node index or -1
+ */
+int32_t StriRegexParser::parseAlt()
+{
+   StriRegexNode node(StriRegexNode::ALTERNATE);
+   while (true) {
+      int32_t alt = parseConcat();
+      if (alt < 0) return -1;
+      node.child.push_back(alt);
+      node.nullable = node.nullable || nodes[alt].nullable;
+      if (j < n && p[j] == (UChar)'|')
+         ++j;
+      else
+         break;
+   }
+
+   if (node.child.size() == 1)
+      return node.child[0];
+   else
+      return addNode(node);
+}
+
+
+/** Parse the whole pattern
+ *
+ * @return root node index or -1
+ */
+int32_t StriRegexParser::parse()
+{
+   if (!p || n <= 0) return -1;
+
+   if (flags & UREGEX_LITERAL) {
+      StriRegexNode node(StriRegexNode::CONCAT);
+      while (j < n) {
+         UChar32 cp;
+         if (!readChar(cp)) return -1;
+         node.child.push_back(addChar(cp));
+      }
+      return addNode(node);
+   }
+
+   int32_t root = parseAlt();
+   if (root < 0 || j < n) return -1; // e.g., unbalanced parentheses
+   if ((anchorStart || anchorEnd) && nodes[root].type == StriRegexNode::ALTERNATE)
+      return -1; // ^a|b
+   return root;
+}
+
+
+/**
+ * Compiles a syntax tree to a StriRegexInst program
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriRegexCompiler {
+
+   private:
+
+      const std::vector<StriRegexNode>& nodes;
+      std::vector<StriRegexInst>& prog;
+      bool reverse; ///< compile the reversed pattern
+      size_t depth; ///< recursion depth of compile()
+
+      int32_t compileNode(int32_t node, int32_t next);
+      int32_t compileSeqs(const std::vector<StriRegexByteSeq>& seqs,
+         size_t from, size_t to, size_t depth, int32_t next);
+      int32_t compileSet(const StriRegexNode& node, int32_t next);
+
+   public:
+
+      bool ok; ///< false if the program got too large
+
+      StriRegexCompiler(const std::vector<StriRegexNode>& _nodes,
+            std::vector<StriRegexInst>& _prog, bool _reverse)
+         : nodes(_nodes), prog(_prog), reverse(_reverse), depth(0), ok(true) { }
+
+      int32_t emit(const StriRegexInst& inst) {
+         if (prog.size() >= STRI__REGEX_DFA_MAX_INSTS) {
+            ok = false;
+            return 0;
+         }
+         prog.push_back(inst);
+         return (int32_t)prog.size()-1;
+      }
+
+      int32_t compile(int32_t node, int32_t next);
+};
+
+
+/** Compile sorted byte sequences which share their first \code{depth} ranges
+ *  to a trie
+ *
+ * @param seqs byte sequences
+ * @param from first sequence
+ * @param to past the last sequence
+ * @param depth number of common ranges
+ * @param next instruction to go to after a sequence is matched
+ * @return entry instruction
+ */
+int32_t StriRegexCompiler::compileSeqs(const std::vector<StriRegexByteSeq>& seqs,
+   size_t from, size_t to, size_t depth, int32_t next)
+{
+   std::vector<int32_t> entries;
+   for (size_t k=from; k<to && ok; ) {
+      if (seqs[k].size() == depth) {
+         entries.push_back(next);
+         ++k;
+         continue;
+      }
+      size_t l = k+1;
+      while (l < to && seqs[l].size() > depth && seqs[l][depth] == seqs[k][depth])
+         ++l;
+      int32_t target = compileSeqs(seqs, k, l, depth+1, next);
+      entries.push_back(emit(StriRegexInst(StriRegexInst::BYTE,
+         seqs[k][depth].first, seqs[k][depth].second, target)));
+      k = l;
+   }
+
+   if (entries.size() == 0) return next; // not reached
+   int32_t entry = entries.back();
+   for (size_t k=entries.size()-1; k>0; --k)
+      entry = emit(StriRegexInst(StriRegexInst::SPLIT, 0, 0, entries[k-1], entry));
+   return entry;
+}
+
+
+/** Compile a set of code points
+ *
+ * @param node set node
+ * @param next instruction to go to after a code point is matched
+ * @return entry instruction
+ */
+int32_t StriRegexCompiler::compileSet(const StriRegexNode& node, int32_t next)
+{
+   std::vector<StriRegexByteSeq> seqs;
+   for (size_t k=0; k+1<node.ranges.size(); k+=2)
+      stri__regex_dfa_utf8_ranges(node.ranges[k], node.ranges[k+1], seqs);
+
+   if (seqs.size() == 0) { // an empty set never matches
+      return emit(StriRegexInst(StriRegexInst::SPLIT, 0, 0, -1, -1));
+   }
+
+   if (reverse) {
+      for (size_t k=0; k<seqs.size(); ++k)
+         std::reverse(seqs[k].begin(), seqs[k].end());
+   }
+   std::sort(seqs.begin(), seqs.end());
+   return compileSeqs(seqs, 0, seqs.size(), 0, next);
+}
+
+
+/** Compile a node
+ *
+ * Each group nesting level adds at most 3 levels to the syntax tree
+ * (alternation, concatenation, repetition); deeper trees are not compiled.
+ *
+ * @param node node index
+ * @param next instruction to go to after the node is matched
+ * @return entry instruction
+ */
+int32_t StriRegexCompiler::compile(int32_t node, int32_t next)
+{
+   if (!ok) return 0;
+   if (depth >= 4*STRI__REGEX_DFA_MAX_DEPTH) {
+      ok = false;
+      return 0;
+   }
+   ++depth;
+   int32_t entry = compileNode(node, next);
+   --depth;
+   return entry;
+}
+
+
+/** Compile a node, see compile()
+ *
+ * @param node node index
+ * @param next instruction to go to after the node is matched
+ * @return entry instruction
+ */
+int32_t StriRegexCompiler::compileNode(int32_t node, int32_t next)
+{
+   const StriRegexNode& cur = nodes[node];
+   switch (cur.type) {
+      case StriRegexNode::EMPTY:
+         return next;
+
+      case StriRegexNode::SET:
+         return compileSet(cur, next);
+
+      case StriRegexNode::CONCAT:
+         if (reverse) {
+            for (size_t k=0; k<cur.child.size(); ++k)
+               next = compile(cur.child[k], next);
+         }
+         else {
+            for (size_t k=cur.child.size(); k>0; --k)
+               next = compile(cur.child[k-1], next);
+         }
+         return next;
+
+      case StriRegexNode::ALTERNATE: {
+         std::vector<int32_t> entries;
+         for (size_t k=0; k<cur.child.size(); ++k)
+            entries.push_back(compile(cur.child[k], next));
+         int32_t entry = entries.back();
+         for (size_t k=entries.size()-1; k>0; --k)
+            entry = emit(StriRegexInst(StriRegexInst::SPLIT, 0, 0, entries[k-1], entry));
+         return entry;
+      }
+
+      case StriRegexNode::REPEAT: {
+         int32_t entry = next;
+         if (cur.max < 0) {
+            int32_t loop = emit(StriRegexInst(StriRegexInst::SPLIT));
+            int32_t body = compile(cur.child[0], loop);
+            if (!ok) return 0;
+            prog[loop].out  = cur.greedy?body:next;
+            prog[loop].out1 = cur.greedy?next:body;
+            entry = loop;
+         }
+         else {
+            // x{0,3} == (x(x(x)?)?)?
+            for (int32_t k=0; k<cur.max-cur.min && ok; ++k) {
+               int32_t body = compile(cur.child[0], entry);
+               entry = emit(cur.greedy?
+                  StriRegexInst(StriRegexInst::SPLIT, 0, 0, body, next):
+                  StriRegexInst(StriRegexInst::SPLIT, 0, 0, next, body));
+            }
+         }
+         for (int32_t k=0; k<cur.min && ok; ++k)
+            entry = compile(cur.child[0], entry);
+         return entry;
+      }
+
+      default:
+         ok = false;
+         return 0;
+   }
+}
+
+
+/** Constructor
+ *
+ * @param _prog program (not owned)
+ * @param _progStart entry instruction
+ * @param _longest longest match mode (no priorities)?
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriRegexAutomaton::StriRegexAutomaton(const std::vector<StriRegexInst>* _prog,
+      int32_t _progStart, bool _longest)
+   : prog(_prog), progStart(_progStart), longest(_longest),
+     startState(UNKNOWN), visited(_prog->size(), 0), visitedGen(0)
+{
+
+}
+
+
+/** Drop all the states
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void StriRegexAutomaton::flush()
+{
+   states.clear();
+   stateFlags.clear();
+   stateMatches.clear();
+   stateIds.clear();
+   trans.clear();
+   startState = UNKNOWN;
+}
+
+
+/** Add a thread and all the threads reachable from it via SPLITs
+ *
+ * Threads are added in priority order; in the leftmost-first mode,
+ * nothing is added after a MATCH.
+ *
+ * @param inst instruction
+ * @param list [in/out] thread list
+ * @return true if the remaining threads should be cut off
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool StriRegexAutomaton::addThread(int32_t inst, std::vector<int32_t>& list)
+{
+   stack.clear();
+   stack.push_back(inst);
+   while (!stack.empty()) {
+      int32_t k = stack.back();
+      stack.pop_back();
+      if (k < 0 || visited[k] == visitedGen)
+         continue;
+      visited[k] = visitedGen;
+
+      const StriRegexInst& cur = (*prog)[k];
+      switch (cur.op) {
+         case StriRegexInst::BYTE:
+         case StriRegexInst::MATCH_END:
+            list.push_back(k);
+            break;
+
+         case StriRegexInst::MATCH:
+            list.push_back(k);
+            if (!longest) {
+               stack.clear();
+               return true;
+            }
+            break;
+
+         case StriRegexInst::SPLIT:
+            stack.push_back(cur.out1);
+            stack.push_back(cur.out);
+            break;
+      }
+   }
+   return false;
+}
+
+
+/** Get the id of a state with a given thread list (a new one if needed)
+ *
+ * @param list thread list; sorted in the longest mode
+ * @return state id or DEAD
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+int32_t StriRegexAutomaton::getState(std::vector<int32_t>& list)
+{
+   if (list.empty())
+      return DEAD;
+   if (longest)
+      std::sort(list.begin(), list.end());
+
+   std::map< std::vector<int32_t>, int32_t >::iterator it = stateIds.find(list);
+   if (it != stateIds.end())
+      return it->second;
+
+   if (states.size() >= STRI__REGEX_DFA_MAX_STATES)
+      flush();
+
+   uint8_t flags = 0;
+   std::vector<int32_t> matches;
+   for (size_t k=0; k<list.size(); ++k) {
+      if ((*prog)[list[k]].op == StriRegexInst::MATCH) {
+         flags |= FLAG_MATCH;
+         matches.push_back(list[k]);
+      }
+      else if ((*prog)[list[k]].op == StriRegexInst::MATCH_END) {
+         flags |= FLAG_MATCH_END;
+         matches.push_back(list[k]);
+      }
+   }
+
+   int32_t s = (int32_t)states.size();
+   states.push_back(list);
+   stateFlags.push_back(flags);
+   stateMatches.push_back(matches);
+   stateIds[list] = s;
+   trans.resize(trans.size()+256, UNKNOWN);
+   return s;
+}
+
+
+/** Get the start state
+ *
+ * @return state id or DEAD
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+int32_t StriRegexAutomaton::getStart()
+{
+   if (startState == UNKNOWN) {
+      std::vector<int32_t> list;
+      nextGen();
+      addThread(progStart, list);
+      int32_t s = getState(list);
+      startState = s;
+   }
+   return startState;
+}
+
+
+/** Compute a transition
+ *
+ * @param s state
+ * @param b byte
+ * @return state id or DEAD
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+int32_t StriRegexAutomaton::computeNext(int32_t s, uint8_t b)
+{
+   std::vector<int32_t> list;
+   const std::vector<int32_t>& cur = states[s];
+   nextGen();
+   for (size_t k=0; k<cur.size(); ++k) {
+      const StriRegexInst& inst = (*prog)[cur[k]];
+      if (inst.op == StriRegexInst::BYTE && inst.lo <= b && b <= inst.hi) {
+         if (addThread(inst.out, list))
+            break;
+      }
+   }
+
+   size_t nstates = states.size();
+   int32_t t = getState(list);
+   if (states.size() >= nstates) // the cache has not been flushed
+      trans[(size_t)s*256+b] = t;
+   return t;
+}
+
+
+/** Drop the MATCH_END thread and all the threads of lower priority
+ *
+ * To be called at the end of input, where MATCH_END denotes a match.
+ *
+ * @param s state
+ * @return state id or DEAD
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+int32_t StriRegexAutomaton::cutAtMatchEnd(int32_t s)
+{
+   std::vector<int32_t> list;
+   const std::vector<int32_t>& cur = states[s];
+   for (size_t k=0; k<cur.size() && (*prog)[cur[k]].op != StriRegexInst::MATCH_END; ++k)
+      list.push_back(cur[k]);
+   return getState(list);
+}
+
+
+/** Default constructor [private]
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriRegexDFA::StriRegexDFA()
+{
+   fwd = NULL;
+   rev = NULL;
+   anchorStart = false;
+   anchorEnd = 0;
+   unixLines = false;
+   nullable = false;
+   searchStr = NULL;
+   searchLen = 0;
+   searchFrom = 0;
+   matchStart = -1;
+   matchEnd = -1;
+   exhausted = false;
+   endPos1 = -1;
+}
+
+
+/** Destructor
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriRegexDFA::~StriRegexDFA()
+{
+   if (fwd) {
+      delete fwd;
+      fwd = NULL;
+   }
+   if (rev) {
+      delete rev;
+      rev = NULL;
+   }
+}
+
+
+/** Compile a regex
+ *
+ * @param pattern regex pattern
+ * @param flags regex flags
+ * @return a new object (to be deleted by the caller) or NULL
+ *    if the pattern or the flags are not supported
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriRegexDFA* StriRegexDFA::compile(const UnicodeString& pattern, uint32_t flags)
+{
+   if (flags & (UREGEX_CASE_INSENSITIVE|UREGEX_COMMENTS|UREGEX_CANON_EQ))
+      return NULL;
+
+   StriRegexParser parser(pattern, flags);
+   int32_t root = parser.parse();
+   if (root < 0)
+      return NULL;
+
+   StriRegexDFA* dfa = new StriRegexDFA();
+   if (!dfa) throw StriException(MSG__MEM_ALLOC_ERROR);
+   dfa->anchorStart = parser.anchorStart;
+   dfa->anchorEnd = parser.anchorEnd;
+   dfa->unixLines = (bool)(flags & UREGEX_UNIX_LINES);
+   dfa->nullable = parser.nodes[root].nullable;
+
+   // forward program: [.*?] pattern MATCH
+   StriRegexCompiler fwd_compiler(parser.nodes, dfa->fwdProg, false);
+   int32_t fwd_match = fwd_compiler.emit(StriRegexInst(
+      dfa->anchorEnd?StriRegexInst::MATCH_END:StriRegexInst::MATCH,
+      (dfa->anchorEnd == (int32_t)'$'), 0, 0));
+   int32_t fwd_start = fwd_compiler.compile(root, fwd_match);
+   if (!dfa->anchorStart) {
+      // unanchored search: a lowest-priority loop over any byte
+      int32_t loop = fwd_compiler.emit(StriRegexInst(StriRegexInst::SPLIT, 0, 0, fwd_start, -1));
+      int32_t any = fwd_compiler.emit(StriRegexInst(StriRegexInst::BYTE, 0x00, 0xFF, loop));
+      if (fwd_compiler.ok) dfa->fwdProg[loop].out1 = any;
+      fwd_start = loop;
+   }
+
+   // reverse program: reversed pattern MATCH, run from a match end
+   StriRegexCompiler rev_compiler(parser.nodes, dfa->revProg, true);
+   int32_t rev_match = rev_compiler.emit(StriRegexInst(StriRegexInst::MATCH));
+   int32_t rev_start = rev_compiler.compile(root, rev_match);
+
+   if (!fwd_compiler.ok || !rev_compiler.ok) {
+      delete dfa;
+      return NULL;
+   }
+
+   dfa->fwd = new StriRegexAutomaton(&dfa->fwdProg, fwd_start, false);
+   dfa->rev = new StriRegexAutomaton(&dfa->revProg, rev_start, true);
+   if (!dfa->fwd || !dfa->rev) {
+      delete dfa;
+      throw StriException(MSG__MEM_ALLOC_ERROR);
+   }
+   return dfa;
+}
+
+
+/** Set the string to search in
+ *
+ * @param str valid UTF-8 string (not owned)
+ * @param str_n number of bytes
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void StriRegexDFA::reset(const char* str, R_len_t str_n)
+{
+   searchStr = str;
+   searchLen = str_n;
+   searchFrom = 0;
+   matchStart = -1;
+   matchEnd = -1;
+   exhausted = false;
+
+   endPos1 = (anchorEnd == (int32_t)'$')?stri__regex_dfa_end_pos1(str, str_n, unixLines):-1;
+}
+
+
+/** Find the end of the leftmost-first match starting at or after a given position
+ *
+ * @param from byte index
+ * @param earliest stop at the first match end found (enough to detect a match)
+ * @return byte index or -1 if there is no match
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t StriRegexDFA::findEnd(R_len_t from, bool earliest)
+{
+   R_len_t last = -1;
+   int32_t s = fwd->getStart();
+   R_len_t q = from;
+   while (s != StriRegexAutomaton::DEAD) {
+      uint8_t f = fwd->getFlags(s);
+      if (f & StriRegexAutomaton::FLAG_MATCH) {
+         last = q;
+         if (earliest) break;
+      }
+      else if ((f & StriRegexAutomaton::FLAG_MATCH_END) && (q == searchLen || q == endPos1)) {
+         last = q;
+         if (earliest) break;
+         s = fwd->cutAtMatchEnd(s);
+         if (s == StriRegexAutomaton::DEAD) break;
+      }
+
+      if (q >= searchLen) break;
+      s = fwd->next(s, (uint8_t)searchStr[q++]);
+   }
+   return last;
+}
+
+
+/** Find the next match
+ *
+ * Matches are found in the same way as in ICU's \code{RegexMatcher::find()};
+ * in particular, after an empty match, the search resumes
+ * at the next code point. If there are no more matches,
+ * start() and end() still refer to the last match found (if any).
+ *
+ * @return true if found
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool StriRegexDFA::find()
+{
+   if (exhausted)
+      return false;
+
+   R_len_t from = 0;
+   if (matchEnd >= 0) {
+      from = matchEnd;
+      if (nullable && start() == matchEnd) { // an empty match
+         if (from >= searchLen) {
+            exhausted = true;
+            return false;
+         }
+         U8_FWD_1((const uint8_t*)searchStr, from, searchLen);
+      }
+   }
+
+   R_len_t end = (anchorStart && from > 0)?-1:findEnd(from, false);
+   if (end < 0) {
+      exhausted = true;
+      return false;
+   }
+
+   searchFrom = from;
+   matchStart = -1; // determined on demand
+   matchEnd = end;
+   return true;
+}
+
+
+/** Check if there is any match in the string
+ *
+ * This is faster than find() as the search stops as soon as it is
+ * known that some match exists.
+ *
+ * @return bool
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool StriRegexDFA::findAny()
+{
+   return findEnd(0, true) >= 0;
+}
+
+
+/** Get the start of the last match
+ *
+ * This is the smallest index, not less than the position the search
+ * started at, for which the (reversed) pattern matches the string up to
+ * the match end.
+ *
+ * @return byte index in the string
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t StriRegexDFA::start()
+{
+   if (matchStart >= 0 || matchEnd < 0)
+      return matchStart;
+
+   if (anchorStart)
+      return (matchStart = 0);
+
+   R_len_t best = -1;
+   int32_t s = rev->getStart();
+   R_len_t q = matchEnd;
+   while (s != StriRegexAutomaton::DEAD) {
+      if (rev->getFlags(s) & StriRegexAutomaton::FLAG_MATCH)
+         best = q;
+      if (q <= searchFrom) break;
+      s = rev->next(s, (uint8_t)searchStr[--q]);
+   }
+
+   if (best < 0)
+      throw StriException("StriRegexDFA: no match start! This is a BUG.");
+   return (matchStart = best);
+}
+
+
+/** Constructor
+ *
+ * @param _flags regex flags, common to all the patterns
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriRegexDFASet::StriRegexDFASet(uint32_t _flags)
+   : flags(_flags), dfa(NULL), npatterns(0), seenGen(0)
+{
+
+}
+
+
+/** Destructor
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+StriRegexDFASet::~StriRegexDFASet()
+{
+   if (dfa) {
+      delete dfa;
+      dfa = NULL;
+   }
+}
+
+
+/** Add a pattern to the set
+ *
+ * Must not be called after find().
+ *
+ * @param pattern regex pattern
+ * @param id pattern identifier (a small non-negative integer)
+ * @return false if the pattern is not supported by the automaton
+ *    (it has not been added then)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool StriRegexDFASet::add(const UnicodeString& pattern, int32_t id)
+{
+   if (dfa)
+      throw StriException("StriRegexDFASet: already in use. This is a BUG.");
+
+   if (flags & (UREGEX_CASE_INSENSITIVE|UREGEX_COMMENTS|UREGEX_CANON_EQ))
+      return false;
+
+   StriRegexParser parser(pattern, flags);
+   int32_t root = parser.parse();
+   if (root < 0)
+      return false;
+
+   size_t prog_size = prog.size();
+   StriRegexCompiler compiler(parser.nodes, prog, false);
+   int32_t match = compiler.emit(StriRegexInst(
+      parser.anchorEnd?StriRegexInst::MATCH_END:StriRegexInst::MATCH,
+      (parser.anchorEnd == (int32_t)'$'), 0, id));
+   int32_t entry = compiler.compile(root, match);
+   if (!compiler.ok) {
+      prog.erase(prog.begin()+prog_size, prog.end()); // the set is too large
+      return false;
+   }
+
+   if (parser.anchorStart)
+      anchoredEntries.push_back(entry);
+   else
+      unanchoredEntries.push_back(entry);
+   if ((size_t)id >= seen.size())
+      seen.resize(id+1, 0);
+   ++npatterns;
+   return true;
+}
+
+
+/** Find the patterns that match a string
+ *
+ * @param str valid UTF-8 string
+ * @param str_n number of bytes
+ * @param ids [out] identifiers of the matching patterns, in no particular order
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void StriRegexDFASet::find(const char* str, R_len_t str_n, std::vector<int32_t>& ids)
+{
+   ids.clear();
+   if (npatterns <= 0)
+      return;
+
+   if (!dfa) {
+      // start: ^-anchored patterns, then L0: other patterns, any byte -> L0
+      int32_t loop = (int32_t)prog.size();
+      for (size_t k=0; k<unanchoredEntries.size(); ++k)
+         prog.push_back(StriRegexInst(StriRegexInst::SPLIT, 0, 0, unanchoredEntries[k], (int32_t)prog.size()+1));
+      prog.push_back(StriRegexInst(StriRegexInst::BYTE, 0x00, 0xFF, loop));
+      int32_t start = (int32_t)prog.size();
+      for (size_t k=0; k<anchoredEntries.size(); ++k)
+         prog.push_back(StriRegexInst(StriRegexInst::SPLIT, 0, 0, anchoredEntries[k], (int32_t)prog.size()+1));
+      if (unanchoredEntries.empty()) // do not scan further than needed
+         prog.push_back(StriRegexInst(StriRegexInst::SPLIT, 0, 0, -1, -1));
+      else
+         prog.push_back(StriRegexInst(StriRegexInst::SPLIT, 0, 0, loop, -1));
+
+      dfa = new StriRegexAutomaton(&prog, start, true);
+      if (!dfa) throw StriException(MSG__MEM_ALLOC_ERROR);
+   }
+
+   if (seenGen == INT_MAX) {
+      std::fill(seen.begin(), seen.end(), 0);
+      seenGen = 0;
+   }
+   ++seenGen;
+
+   R_len_t endPos1 = stri__regex_dfa_end_pos1(str, str_n, (bool)(flags & UREGEX_UNIX_LINES));
+   int32_t s = dfa->getStart();
+   R_len_t q = 0;
+   while (s != StriRegexAutomaton::DEAD) {
+      if (dfa->getFlags(s)) {
+         const std::vector<int32_t>& matches = dfa->getMatches(s);
+         for (size_t k=0; k<matches.size(); ++k) {
+            const StriRegexInst& inst = prog[matches[k]];
+            if (inst.op == StriRegexInst::MATCH_END && !(q == str_n || (inst.lo && q == endPos1)))
+               continue;
+            if (seen[inst.out] != seenGen) {
+               seen[inst.out] = seenGen;
+               ids.push_back(inst.out);
+            }
+         }
+         if ((R_len_t)ids.size() >= npatterns)
+            break; // all found
+      }
+
+      if (q >= str_n) break;
+      s = dfa->next(s, (uint8_t)str[q++]);
+   }
+}
@@ -0,0 +1,299 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __stri_regex_dfa_h
+#define __stri_regex_dfa_h
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <climits>
+#include <unicode/unistr.h>
+
+
+/** Max number of states kept in a StriRegexAutomaton's cache;
+ *  the cache is flushed when this is exceeded (each state takes
+ *  256 transitions, i.e., 1 KB)
+ */
+#define STRI__REGEX_DFA_MAX_STATES 4096
+
+/** Max number of NFA instructions a pattern may compile to */
+#define STRI__REGEX_DFA_MAX_INSTS 65536
+
+/** Max group nesting level of a pattern (deeper ones are left for ICU),
+ *  bounds the recursion depth of the parser and the compiler
+ */
+#define STRI__REGEX_DFA_MAX_DEPTH 256
+
+
+R_len_t stri__regex_dfa_end_pos1(const char* str, R_len_t n, bool unixLines);
+
+
+/**
+ * An instruction of a Thompson NFA over UTF-8 bytes
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+struct StriRegexInst {
+   enum {
+      BYTE,      ///< consume a byte in [lo, hi], go to out
+      SPLIT,     ///< go to out (preferred) and out1
+      MATCH,     ///< a match of pattern no. out ends here
+      MATCH_END  ///< as above, but only at the end of input
+                 ///< (or before a final line terminator if lo != 0, see $)
+   };
+
+   uint8_t op;
+   uint8_t lo;
+   uint8_t hi;
+   int32_t out;
+   int32_t out1;
+
+   StriRegexInst(uint8_t _op, uint8_t _lo=0, uint8_t _hi=0, int32_t _out=-1, int32_t _out1=-1)
+      : op(_op), lo(_lo), hi(_hi), out(_out), out1(_out1) { }
+};
+
+
+/**
+ * A lazily built DFA simulating a StriRegexInst program
+ *
+ * A DFA state is an ordered list of NFA threads (BYTE, MATCH and MATCH_END
+ * instructions). In the leftmost-first mode, threads following a MATCH
+ * (i.e., of lower priority) are cut off, which yields the same match
+ * ends as a backtracking engine. In the longest mode,
+ * the threads are sorted and nothing is cut off.
+ *
+ * States and their transitions are created on demand; if there are
+ * too many of them, the cache is flushed. This way, each byte of input
+ * is processed in time bounded by the size of the program.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriRegexAutomaton {
+
+   private:
+
+      StriRegexAutomaton(const StriRegexAutomaton&); /* no copy-able */
+      StriRegexAutomaton& operator=(const StriRegexAutomaton&);
+
+      const std::vector<StriRegexInst>* prog;
+      int32_t progStart;
+      bool longest;
+
+      std::vector< std::vector<int32_t> > states; ///< thread lists
+      std::vector<uint8_t> stateFlags; ///< FLAG_* bits
+      std::vector< std::vector<int32_t> > stateMatches; ///< MATCH and MATCH_END threads
+      std::map< std::vector<int32_t>, int32_t > stateIds;
+      std::vector<int32_t> trans; ///< states.size()*256 transitions
+      int32_t startState;
+
+      std::vector<int32_t> visited; ///< generation number for each instruction
+      int32_t visitedGen;
+      std::vector<int32_t> stack;
+
+      /** start a new thread list: all instructions become unvisited */
+      inline void nextGen() {
+         if (visitedGen == INT_MAX) {
+            std::fill(visited.begin(), visited.end(), 0);
+            visitedGen = 0;
+         }
+         ++visitedGen;
+      }
+
+      bool addThread(int32_t inst, std::vector<int32_t>& list);
+      int32_t getState(std::vector<int32_t>& list);
+      int32_t computeNext(int32_t s, uint8_t b);
+      void flush();
+
+   public:
+
+      enum {
+         FLAG_MATCH     = 1, ///< the state contains a MATCH thread
+         FLAG_MATCH_END = 2  ///< the state contains a MATCH_END thread
+      };
+
+      enum {
+         DEAD    = -1, ///< no threads left
+         UNKNOWN = -2  ///< a transition not computed yet
+      };
+
+      StriRegexAutomaton(const std::vector<StriRegexInst>* _prog, int32_t _progStart, bool _longest);
+
+      int32_t getStart();
+
+      /** Get the state reached after consuming a byte
+       *
+       * @param s current state
+       * @param b byte
+       * @return state id or DEAD
+       */
+      inline int32_t next(int32_t s, uint8_t b) {
+         int32_t t = trans[(size_t)s*256+b];
+         if (t == UNKNOWN) t = computeNext(s, b);
+         return t;
+      }
+
+      inline uint8_t getFlags(int32_t s) const {
+         return stateFlags[s];
+      }
+
+      /** Get the MATCH and MATCH_END threads of a state
+       *
+       * @param s state
+       * @return instruction indices, valid until the next call to next()
+       */
+      inline const std::vector<int32_t>& getMatches(int32_t s) const {
+         return stateMatches[s];
+      }
+
+      int32_t cutAtMatchEnd(int32_t s);
+};
+
+
+/**
+ * A matcher for the non-backtracking subset of ICU regexes
+ *
+ * Supported are: literal characters and escapes, \code{.} (except in
+ * the dotall mode), sets (\code{[...]} without nested sets,
+ * set operations or strings), \code{\\d}, \code{\\w}, \code{\\s},
+ * \code{\\p{...}} and their negations, alternations, groups
+ * (captures are ignored), greedy and lazy quantifiers,
+ * \code{^} at the beginning and \code{$} or \code{\\z} at the end
+ * of a pattern.
+ * Case-insensitive matching, the comments and multiline modes,
+ * back-references, look-around, atomic groups, possessive quantifiers,
+ * word boundaries etc. are not supported, see compile().
+ *
+ * The pattern is compiled to a Thompson NFA over UTF-8 bytes
+ * (Unicode sets via \code{UnicodeSet}). The end of the leftmost-first
+ * match is determined with a forward lazy DFA and its start
+ * with a DFA for the reversed pattern (which finds the longest match
+ * ending at a given position), see (Cox, 2010) and RE2.
+ * The results are exactly the same as those of ICU's \code{RegexMatcher}
+ * for valid UTF-8 strings, and the time complexity is linear.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriRegexDFA {
+
+   private:
+
+      StriRegexDFA(const StriRegexDFA&); /* no copy-able */
+      StriRegexDFA& operator=(const StriRegexDFA&);
+
+      std::vector<StriRegexInst> fwdProg;
+      std::vector<StriRegexInst> revProg;
+      StriRegexAutomaton* fwd;
+      StriRegexAutomaton* rev;
+
+      bool anchorStart;  ///< ^ or \A
+      int32_t anchorEnd; ///< 0 (none), '$' or 'z'
+      bool unixLines;
+      bool nullable;     ///< may match an empty string
+
+      const char* searchStr; // owned by caller
+      R_len_t searchLen;
+      R_len_t searchFrom; // where the search for the last match started
+      R_len_t matchStart; // -1 if not determined yet
+      R_len_t matchEnd;   // -1 before the first match
+      bool exhausted;     // no more matches
+      R_len_t endPos1;    // another position where $ matches or -1
+
+      StriRegexDFA();
+      R_len_t findEnd(R_len_t from, bool earliest);
+
+   public:
+
+      static StriRegexDFA* compile(const UnicodeString& pattern, uint32_t flags);
+      ~StriRegexDFA();
+
+      void reset(const char* str, R_len_t str_n);
+      bool find();
+      bool findAny();
+      R_len_t start();
+
+      /** get the end of the last match
+       *
+       * @return byte index in the string
+       */
+      inline R_len_t end() const {
+         return matchEnd;
+      }
+};
+
+
+
+/**
+ * Finds which of many regexes match a string, in a single pass
+ *
+ * Patterns supported by StriRegexDFA are compiled into one
+ * automaton (the union of the patterns, each with its own
+ * MATCH instructions), which is run in the longest mode,
+ * i.e., all the threads are kept.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriRegexDFASet {
+
+   private:
+
+      StriRegexDFASet(const StriRegexDFASet&); /* no copy-able */
+      StriRegexDFASet& operator=(const StriRegexDFASet&);
+
+      uint32_t flags;
+      std::vector<StriRegexInst> prog;
+      std::vector<int32_t> anchoredEntries;   ///< patterns starting with ^
+      std::vector<int32_t> unanchoredEntries; ///< other patterns
+      StriRegexAutomaton* dfa; ///< NULL until the first search
+      R_len_t npatterns;
+
+      std::vector<int32_t> seen; ///< generation number for each pattern id
+      int32_t seenGen;
+
+   public:
+
+      StriRegexDFASet(uint32_t flags);
+      ~StriRegexDFASet();
+
+      bool add(const UnicodeString& pattern, int32_t id);
+      void find(const char* str, R_len_t str_n, std::vector<int32_t>& ids);
+
+      /** get the number of patterns added
+       *
+       * @return count
+       */
+      inline R_len_t size() const {
+         return npatterns;
+      }
+};
+
+#endif
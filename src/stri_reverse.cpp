@@ -33,6 +33,7 @@
 #include "stri_stringi.h"
 #include "stri_container_utf8.h"
 #include "stri_string8buf.h"
+#include "stri_brkiter.h"
 
 
 /**
@@ -54,9 +55,13 @@
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    new arg: `type`; reverse grapheme clusters
  */
-SEXP stri_reverse(SEXP str)
+SEXP stri_reverse(SEXP str, SEXP type)
 {
+   bool grapheme = stri__prepare_arg_grapheme(type, "type");
    PROTECT(str = stri_prepare_arg_string(str, "str"));    // prepare string argument
 
    STRI__ERROR_HANDLER_BEGIN(1)
@@ -81,6 +86,9 @@ SEXP stri_reverse(SEXP str)
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocVector(STRSXP, str_len));
 
+   StriRuleBasedBreakIterator brkiter(StriBrkIterOptions(R_NilValue, "character"));
+   std::vector<R_len_t> bounds;
+
    for (R_len_t i = str_cont.vectorize_init();
          i != str_cont.vectorize_end();
          i = str_cont.vectorize_next(i))
@@ -93,6 +101,25 @@ SEXP stri_reverse(SEXP str)
       R_len_t str_cur_n = str_cont.get(i).length();
       const char* str_cur_s = str_cont.get(i).c_str();
 
+      if (grapheme && (!stri__utf8_is_ascii(str_cur_s, str_cur_n) ||
+            memchr(str_cur_s, '\r', (size_t)str_cur_n))) {
+         // CR LF and multi-code point clusters are kept as-is
+         if (!stri__utf8_is_valid(str_cur_s, str_cur_n))
+            throw StriException(MSG__INVALID_UTF8);
+
+         R_len_t nclusters = stri__brkiter_clusters(brkiter,
+            str_cur_s, str_cur_n, bounds);
+         char* buf_cur = buf.data()+str_cur_n;
+         for (R_len_t j=0; j<nclusters; ++j) {
+            R_len_t cur_n = bounds[j+1]-bounds[j];
+            buf_cur -= cur_n;
+            memcpy(buf_cur, str_cur_s+bounds[j], (size_t)cur_n);
+         }
+
+         SET_STRING_ELT(ret, i, Rf_mkCharLenCE(buf.data(), str_cur_n, CE_UTF8));
+         continue;
+      }
+
       R_len_t j, k;
       UChar32 chr;
       UBool isError = FALSE;
@@ -49,9 +49,15 @@
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-02)
  *          use StriRuleBasedBreakIterator
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_count_boundaries(SEXP str, SEXP opts_brkiter)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str),
+      stri_count_boundaries(str, opts_brkiter))
+
    PROTECT(str = stri_prepare_arg_string(str, "str"));
    StriBrkIterOptions opts_brkiter2(opts_brkiter, "line_break");
 
@@ -125,6 +125,9 @@ SEXP stri_extract_last_boundaries(SEXP str, SEXP opts_brkiter)
  * @return list or matrix
  *
  * @version 0.5-1 (Marek Gagolewski, 2014-12-19)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri_extract_all_boundaries(SEXP str, SEXP simplify, SEXP omit_no_match, SEXP opts_brkiter)
 {
@@ -141,6 +144,7 @@ SEXP stri_extract_all_boundaries(SEXP str, SEXP simplify, SEXP omit_no_match, SE
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocVector(VECSXP, str_length));
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = 0; i < str_length; ++i)
    {
       if (str_cont.isNA(i)) {
@@ -151,7 +155,7 @@ SEXP stri_extract_all_boundaries(SEXP str, SEXP simplify, SEXP omit_no_match, SE
       brkiter.setupMatcher(str_cont.get(i).c_str(), str_cont.get(i).length());
       brkiter.first();
 
-      deque< pair<R_len_t,R_len_t> > occurrences;
+      occurrences.clear();
       pair<R_len_t,R_len_t> curpair;
       while (brkiter.next(curpair))
          occurrences.push_back(curpair);
@@ -165,7 +169,7 @@ SEXP stri_extract_all_boundaries(SEXP str, SEXP simplify, SEXP omit_no_match, SE
       const char* str_cur_s = str_cont.get(i).c_str();
       SEXP cur_res;
       STRI__PROTECT(cur_res = Rf_allocVector(STRSXP, noccurrences));
-      deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+      StriOccurrences::iterator iter = occurrences.begin();
       for (R_len_t j = 0; iter != occurrences.end(); ++iter, ++j) {
          pair<R_len_t, R_len_t> curo = *iter;
          SET_STRING_ELT(cur_res, j,
@@ -151,6 +151,9 @@ SEXP stri_locate_last_boundaries(SEXP str, SEXP opts_brkiter)
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-02)
  *          use StriRuleBasedBreakIterator
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri_locate_all_boundaries(SEXP str, SEXP omit_no_match, SEXP opts_brkiter)
 {
@@ -166,6 +169,7 @@ SEXP stri_locate_all_boundaries(SEXP str, SEXP omit_no_match, SEXP opts_brkiter)
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocVector(VECSXP, str_length));
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = 0; i < str_length; ++i)
    {
       if (str_cont.isNA(i)) {
@@ -176,7 +180,7 @@ SEXP stri_locate_all_boundaries(SEXP str, SEXP omit_no_match, SEXP opts_brkiter)
       brkiter.setupMatcher(str_cont.get(i).c_str(), str_cont.get(i).length());
       brkiter.first();
 
-      deque< pair<R_len_t,R_len_t> > occurrences;
+      occurrences.clear();
       pair<R_len_t,R_len_t> curpair;
       while (brkiter.next(curpair))
          occurrences.push_back(curpair);
@@ -190,7 +194,7 @@ SEXP stri_locate_all_boundaries(SEXP str, SEXP omit_no_match, SEXP opts_brkiter)
       SEXP ans;
       STRI__PROTECT(ans = Rf_allocMatrix(INTSXP, noccurrences, 2));
       int* ans_tab = INTEGER(ans);
-      deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+      StriOccurrences::iterator iter = occurrences.begin();
       for (R_len_t j = 0; iter != occurrences.end(); ++iter, ++j) {
          pair<R_len_t, R_len_t> cur_match = *iter;
          ans_tab[j]             = cur_match.first;
@@ -34,6 +34,8 @@
 #include "stri_container_utf8_indexable.h"
 #include "stri_container_integer.h"
 #include "stri_brkiter.h"
+#include "stri_tokentable.h"
+#include "stri_vocabulary.h"
 
 
 /** Split a string at BreakIterator boundaries
@@ -65,6 +67,12 @@
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-04)
  *    allow `simplify=NA`; FR #126: pass n to stri_list2matrix
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriTokenTable: simplify=TRUE writes directly to a matrix
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri_split_boundaries(SEXP str, SEXP n, SEXP tokens_only, SEXP simplify, SEXP opts_brkiter)
 {
@@ -81,19 +89,19 @@ SEXP stri_split_boundaries(SEXP str, SEXP n, SEXP tokens_only, SEXP simplify, SE
    StriContainerInteger n_cont(n, vectorize_length);
    StriRuleBasedBreakIterator brkiter(opts_brkiter2);
 
-   SEXP ret;
-   STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
+   StriTokenTable tokens(vectorize_length);
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = 0; i < vectorize_length; ++i)
    {
       if (n_cont.isNA(i)) {
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));
+         tokens.addNA(i);
          continue;
       }
       int  n_cur = n_cont.get(i);
 
       if (str_cont.isNA(i)) {
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));
+         tokens.addNA(i);
          continue;
       }
 
@@ -101,14 +109,12 @@ SEXP stri_split_boundaries(SEXP str, SEXP n, SEXP tokens_only, SEXP simplify, SE
          throw StriException(MSG__EXPECTED_SMALLER, "n");
       else if (n_cur < 0)
          n_cur = INT_MAX;
-      else if (n_cur == 0) {
-         SET_VECTOR_ELT(ret, i, Rf_allocVector(STRSXP, 0));
-         continue;
-      }
+      else if (n_cur == 0)
+         continue; // no tokens at all
 
       R_len_t str_cur_n = str_cont.get(i).length();
       const char* str_cur_s = str_cont.get(i).c_str();
-      deque< pair<R_len_t,R_len_t> > occurrences;
+      occurrences.clear();
       brkiter.setupMatcher(str_cur_s, str_cur_n);
       brkiter.first();
 
@@ -121,24 +127,17 @@ SEXP stri_split_boundaries(SEXP str, SEXP n, SEXP tokens_only, SEXP simplify, SE
 
 
       R_len_t noccurrences = (R_len_t)occurrences.size();
-      if (noccurrences <= 0) {
-         SET_VECTOR_ELT(ret, i, stri__vector_empty_strings(0)); // @TODO: Should it be a NA? Hard to say...
-         continue;
-      }
+      if (noccurrences <= 0)
+         continue; // @TODO: Should it be a NA? Hard to say...
       if (k == n_cur && !tokens_only1)
          occurrences.back().second = str_cur_n;
 
-      SEXP ans;
-      STRI__PROTECT(ans = Rf_allocVector(STRSXP, noccurrences));
-      deque< pair<R_len_t,R_len_t> >::iterator iter = occurrences.begin();
-      for (R_len_t j = 0; iter != occurrences.end(); ++iter, ++j) {
-         SET_STRING_ELT(ans, j, Rf_mkCharLenCE(str_cur_s+(*iter).first,
-            (*iter).second-(*iter).first, CE_UTF8));
-      }
-      SET_VECTOR_ELT(ret, i, ans);
-      STRI__UNPROTECT(1);
+      StriOccurrences::iterator iter = occurrences.begin();
+      for (; iter != occurrences.end(); ++iter)
+         tokens.add(i, str_cur_s+(*iter).first, (*iter).second-(*iter).first);
    }
 
+   SEXP ret;
    if (LOGICAL(simplify)[0] == NA_LOGICAL || LOGICAL(simplify)[0]) {
       R_len_t n_min = 0;
       R_len_t n_length = LENGTH(n);
@@ -147,11 +146,110 @@ SEXP stri_split_boundaries(SEXP str, SEXP n, SEXP tokens_only, SEXP simplify, SE
          if (n_tab[i] != NA_INTEGER && n_min < n_tab[i])
             n_min = n_tab[i];
       }
-      STRI__PROTECT(ret = stri_list2matrix(ret, Rf_ScalarLogical(TRUE),
-         (LOGICAL(simplify)[0] == NA_LOGICAL)?stri__vector_NA_strings(1)
-                                             :stri__vector_empty_strings(1),
-         Rf_ScalarInteger(n_min)))
+      // write directly to a matrix, no intermediate list
+      STRI__PROTECT(ret = tokens.toMatrix(
+         (LOGICAL(simplify)[0] == NA_LOGICAL)?NA_STRING:R_BlankString, n_min))
    }
+   else
+      STRI__PROTECT(ret = tokens.toList())
+
+   STRI__UNPROTECT_ALL
+   return ret;
+   STRI__ERROR_HANDLER_END({ /* no action */ })
+}
+
+
+/** Split a string at BreakIterator boundaries and map the tokens
+ *  to integer ids
+ *
+ * Tokens are looked up in a hash-based vocabulary, so no CHARSXP
+ * is created for a token unless it is new and the vocabulary may grow.
+ *
+ * @param str character vector
+ * @param vocabulary character vector
+ * @param grow logical
+ * @param opts_brkiter named list
+ * @return list with two components: \code{ids}, a list of integer vectors,
+ *    and \code{vocabulary}, a character vector
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri_split_boundaries_ids(SEXP str, SEXP vocabulary, SEXP grow, SEXP opts_brkiter)
+{
+   bool grow1 = stri__prepare_arg_logical_1_notNA(grow, "grow");
+   PROTECT(str = stri_prepare_arg_string(str, "str"));
+   PROTECT(vocabulary = stri_prepare_arg_string(vocabulary, "vocabulary"));
+   StriBrkIterOptions opts_brkiter2(opts_brkiter, "word");
+
+   STRI__ERROR_HANDLER_BEGIN(2)
+   R_len_t str_length = LENGTH(str);
+   R_len_t vocabulary_length = LENGTH(vocabulary);
+   StriContainerUTF8 str_cont(str, str_length);
+   StriContainerUTF8 vocabulary_cont(vocabulary, vocabulary_length);
+   StriRuleBasedBreakIterator brkiter(opts_brkiter2);
+
+   // id -> 1-based index in the resulting vocabulary;
+   // if there are duplicates, the first occurrence wins, NAs are ignored
+   StriVocabulary voc(vocabulary_length);
+   std::vector<int> voc_index;
+   voc_index.reserve(vocabulary_length);
+   for (R_len_t j = 0; j < vocabulary_length; ++j) {
+      if (vocabulary_cont.isNA(j)) continue;
+      R_len_t id = voc.lookup(vocabulary_cont.get(j).c_str(),
+         vocabulary_cont.get(j).length(), true);
+      if (id == (R_len_t)voc_index.size())
+         voc_index.push_back(j+1);
+   }
+   R_len_t voc_known = voc.size();
+
+   SEXP ret, ids, ret_voc;
+   STRI__PROTECT(ret = Rf_allocVector(VECSXP, 2));
+   STRI__PROTECT(ids = Rf_allocVector(VECSXP, str_length));
+   SET_VECTOR_ELT(ret, 0, ids);
+
+   std::vector<int> buf;
+   pair<R_len_t,R_len_t> curpair;
+   for (R_len_t i = 0; i < str_length; ++i)
+   {
+      if (str_cont.isNA(i)) {
+         SET_VECTOR_ELT(ids, i, Rf_ScalarInteger(NA_INTEGER));
+         continue;
+      }
+
+      const char* str_cur_s = str_cont.get(i).c_str();
+      brkiter.setupMatcher(str_cur_s, str_cont.get(i).length());
+      brkiter.first();
+
+      buf.clear();
+      while (brkiter.next(curpair)) {
+         R_len_t id = voc.lookup(str_cur_s+curpair.first,
+            curpair.second-curpair.first, grow1);
+         if (id < 0)
+            buf.push_back(NA_INTEGER);
+         else {
+            if (id == (R_len_t)voc_index.size()) // a new token
+               voc_index.push_back(vocabulary_length+(id-voc_known)+1);
+            buf.push_back(voc_index[id]);
+         }
+      }
+
+      SEXP cur;
+      SET_VECTOR_ELT(ids, i, cur = Rf_allocVector(INTSXP, (R_len_t)buf.size()));
+      if (!buf.empty())
+         memcpy(INTEGER(cur), &buf[0], buf.size()*sizeof(int));
+   }
+
+   // existing entries are passed as-is, only new tokens get a CHARSXP
+   R_len_t voc_new = voc.size()-voc_known;
+   STRI__PROTECT(ret_voc = Rf_allocVector(STRSXP, vocabulary_length+voc_new));
+   SET_VECTOR_ELT(ret, 1, ret_voc);
+   for (R_len_t j = 0; j < vocabulary_length; ++j)
+      SET_STRING_ELT(ret_voc, j, STRING_ELT(vocabulary, j));
+   for (R_len_t j = 0; j < voc_new; ++j)
+      SET_STRING_ELT(ret_voc, vocabulary_length+j, Rf_mkCharLenCE(
+         voc.getStr(voc_known+j), voc.getLen(voc_known+j), CE_UTF8));
+
+   stri__set_names(ret, 2, "ids", "vocabulary");
 
    STRI__UNPROTECT_ALL
    return ret;
@@ -58,9 +58,18 @@
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriCharClass::span (ASCII bitmap + UnicodeSet::spanUTF8)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_count_charclass(SEXP str, SEXP pattern)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str, pattern),
+      stri_count_charclass(str, pattern))
+
    PROTECT(str = stri_prepare_arg_string(str, "str"));
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
    R_len_t vectorize_length =
@@ -83,18 +92,17 @@ SEXP stri_count_charclass(SEXP str, SEXP pattern)
          continue;
       }
 
-      const UnicodeSet* pattern_cur = &pattern_cont.get(i);
+      const StriCharClass* pattern_cur = &pattern_cont.get(i);
       R_len_t     str_cur_n = str_cont.get(i).length();
       const char* str_cur_s = str_cont.get(i).c_str();
+      StriCharClass::validate(str_cur_s, str_cur_n, str_cont.get(i).isASCII());
 
-      UChar32 chr   = 0;
       R_len_t count = 0;
       for (R_len_t j=0; j<str_cur_n; ) {
-         U8_NEXT(str_cur_s, j, str_cur_n, chr);
-         if (chr < 0) // invalid utf-8 sequence
-            throw StriException(MSG__INVALID_UTF8);
-         if (pattern_cur->contains(chr))
-            ++count;
+         R_len_t from = pattern_cur->span(str_cur_s, j, str_cur_n, false);
+         if (from >= str_cur_n) break;
+         j = pattern_cur->span(str_cur_s, from, str_cur_n, true);
+         count += stri__utf8_count_codepoints(str_cur_s+from, j-from);
       }
       ret_tab[i] = count;
    }
@@ -64,9 +64,18 @@
  *
  * @version 1.0-3 (Marek Gagolewski, 2016-02-03)
  *    FR #216: `negate` arg added
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriCharClass::span (ASCII bitmap + UnicodeSet::spanUTF8)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_detect_charclass(SEXP str, SEXP pattern, SEXP negate)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str, pattern),
+      stri_detect_charclass(str, pattern, negate))
+
    bool negate_1 = stri__prepare_arg_logical_1_notNA(negate, "negate");
    PROTECT(str = stri_prepare_arg_string(str, "str"));
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
@@ -90,21 +99,12 @@ SEXP stri_detect_charclass(SEXP str, SEXP pattern, SEXP negate)
          continue;
       }
 
-      const UnicodeSet* pattern_cur = &pattern_cont.get(i);
+      const StriCharClass* pattern_cur = &pattern_cont.get(i);
       R_len_t     str_cur_n = str_cont.get(i).length();
       const char* str_cur_s = str_cont.get(i).c_str();
+      StriCharClass::validate(str_cur_s, str_cur_n, str_cont.get(i).isASCII());
 
-      UChar32 chr = 0;
-      ret_tab[i] = FALSE;
-      for (R_len_t j=0; j<str_cur_n; ) {
-         U8_NEXT(str_cur_s, j, str_cur_n, chr);
-         if (chr < 0) // invalid utf-8 sequence
-            throw StriException(MSG__INVALID_UTF8);
-         if (pattern_cur->contains(chr)) {
-            ret_tab[i] = TRUE;
-            break;
-         }
-      }
+      ret_tab[i] = (pattern_cur->span(str_cur_s, 0, str_cur_n, false) < str_cur_n);
       if (negate_1) ret_tab[i] = !ret_tab[i];
    }
 
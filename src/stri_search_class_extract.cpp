@@ -32,8 +32,8 @@
 #include "stri_stringi.h"
 #include "stri_container_utf8.h"
 #include "stri_container_charclass.h"
+#include "stri_flat_occurrences.h"
 #include "stri_container_logical.h"
-#include <deque>
 #include <utility>
 using namespace std;
 
@@ -61,6 +61,9 @@ using namespace std;
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriCharClass::span (ASCII bitmap + UnicodeSet::spanUTF8)
  */
 SEXP stri__extract_firstlast_charclass(SEXP str, SEXP pattern, bool first)
 {
@@ -84,36 +87,26 @@ SEXP stri__extract_firstlast_charclass(SEXP str, SEXP pattern, bool first)
       if (str_cont.isNA(i) || pattern_cont.isNA(i))
          continue;
 
-      const UnicodeSet* pattern_cur = &pattern_cont.get(i);
+      const StriCharClass* pattern_cur = &pattern_cont.get(i);
       R_len_t     str_cur_n = str_cont.get(i).length();
       const char* str_cur_s = str_cont.get(i).c_str();
+      StriCharClass::validate(str_cur_s, str_cur_n, str_cont.get(i).isASCII());
       R_len_t j, jlast;
-      UChar32 chr;
 
       if (first) {
-         for (jlast=j=0; j<str_cur_n; ) {
-            U8_NEXT(str_cur_s, j, str_cur_n, chr);
-            if (chr < 0) // invalid utf-8 sequence
-               throw StriException(MSG__INVALID_UTF8);
-            if (pattern_cur->contains(chr)) {
-               SET_STRING_ELT(ret, i,
-                  Rf_mkCharLenCE(str_cur_s+jlast, j-jlast, CE_UTF8));
-               break; // that's enough for first
-            }
-            jlast = j;
+         jlast = j = pattern_cur->span(str_cur_s, 0, str_cur_n, false);
+         if (jlast < str_cur_n) {
+            U8_FWD_1(str_cur_s, j, str_cur_n);
+            SET_STRING_ELT(ret, i,
+               Rf_mkCharLenCE(str_cur_s+jlast, j-jlast, CE_UTF8));
          }
       }
       else {
-         for (jlast=j=str_cur_n; j>0; ) {
-            U8_PREV(str_cur_s, 0, j, chr); // go backwards
-            if (chr < 0) // invalid utf-8 sequence
-               throw StriException(MSG__INVALID_UTF8);
-            if (pattern_cur->contains(chr)) {
-               SET_STRING_ELT(ret, i,
-                  Rf_mkCharLenCE(str_cur_s+j, jlast-j, CE_UTF8));
-               break; // that's enough for last
-            }
-            jlast = j;
+         jlast = j = pattern_cur->spanBack(str_cur_s, str_cur_n, false);
+         if (jlast > 0) {
+            U8_BACK_1((const uint8_t*)str_cur_s, 0, j);
+            SET_STRING_ELT(ret, i,
+               Rf_mkCharLenCE(str_cur_s+j, jlast-j, CE_UTF8));
          }
       }
    }
@@ -159,9 +152,13 @@ SEXP stri_extract_last_charclass(SEXP str, SEXP pattern)
  *
  * @param str character vector
  * @param pattern character vector
+ * @param merge single logical value
  * @param simplify single logical value
+ * @param omit_no_match single logical value
+ * @param flat single logical value
  *
  * @return list of character vectors  or character matrix
+ *    or a list of 3 columns if \code{flat} is \code{TRUE}
  *
  * @version 0.1-?? (Marek Gagolewski, 2013-06-08)
  *
@@ -192,11 +189,21 @@ SEXP stri_extract_last_charclass(SEXP str, SEXP pattern)
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-04)
  *    allow `simplify=NA`
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriCharClass::span (ASCII bitmap + UnicodeSet::spanUTF8)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    new arg: flat
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
-SEXP stri_extract_all_charclass(SEXP str, SEXP pattern, SEXP merge, SEXP simplify, SEXP omit_no_match)
+SEXP stri_extract_all_charclass(SEXP str, SEXP pattern, SEXP merge, SEXP simplify, SEXP omit_no_match, SEXP flat)
 {
    bool merge_cur = stri__prepare_arg_logical_1_notNA(merge, "merge");
    bool omit_no_match1 = stri__prepare_arg_logical_1_notNA(omit_no_match, "omit_no_match");
+   bool flat1 = stri__prepare_arg_logical_1_notNA(flat, "flat");
    PROTECT(simplify = stri_prepare_arg_logical_1(simplify, "simplify"));
    PROTECT(str = stri_prepare_arg_string(str, "str"));
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
@@ -208,20 +215,24 @@ SEXP stri_extract_all_charclass(SEXP str, SEXP pattern, SEXP merge, SEXP simplif
    StriContainerCharClass pattern_cont(pattern, vectorize_length);
 
    SEXP ret;
-   STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
+   STRI__PROTECT(ret = Rf_allocVector(VECSXP, flat1?0:vectorize_length));
+   StriFlatOccurrences flat_occurrences;
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
    {
       if (pattern_cont.isNA(i) || str_cont.isNA(i)) {
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));
+         if (flat1) flat_occurrences.addNA(i);
+         else SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));
          continue;
       }
 
       R_len_t str_cur_n     = str_cont.get(i).length();
       const char* str_cur_s = str_cont.get(i).c_str();
-      deque< pair<R_len_t, R_len_t> > occurrences;
+      StriCharClass::validate(str_cur_s, str_cur_n, str_cont.get(i).isASCII());
+      occurrences.clear();
       StriContainerCharClass::locateAll(
          occurrences, &pattern_cont.get(i),
          str_cur_s, str_cur_n, merge_cur,
@@ -230,13 +241,21 @@ SEXP stri_extract_all_charclass(SEXP str, SEXP pattern, SEXP merge, SEXP simplif
 
       R_len_t noccurrences = (R_len_t)occurrences.size();
       if (noccurrences == 0) {
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(omit_no_match1?0:1));
+         if (!flat1)
+            SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(omit_no_match1?0:1));
+         else if (!omit_no_match1)
+            flat_occurrences.addNA(i);
+         continue;
+      }
+
+      if (flat1) {
+         flat_occurrences.add(i, occurrences);
          continue;
       }
 
       SEXP cur_res;
       STRI__PROTECT(cur_res = Rf_allocVector(STRSXP, noccurrences));
-      deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+      StriOccurrences::iterator iter = occurrences.begin();
       for (R_len_t f = 0; iter != occurrences.end(); ++iter, ++f) {
          pair<R_len_t, R_len_t> curo = *iter;
          SET_STRING_ELT(cur_res, f,
@@ -246,7 +265,10 @@ SEXP stri_extract_all_charclass(SEXP str, SEXP pattern, SEXP merge, SEXP simplif
       STRI__UNPROTECT(1)
    }
 
-   if (LOGICAL(simplify)[0] == NA_LOGICAL) {
+   if (flat1) {
+      STRI__PROTECT(ret = flat_occurrences.toR(str_cont, NA_STRING));
+   }
+   else if (LOGICAL(simplify)[0] == NA_LOGICAL) {
       STRI__PROTECT(ret = stri_list2matrix(ret, Rf_ScalarLogical(TRUE),
          stri__vector_NA_strings(1), Rf_ScalarInteger(0)))
    }
@@ -33,8 +33,8 @@
 #include "stri_stringi.h"
 #include "stri_container_utf8.h"
 #include "stri_container_charclass.h"
+#include "stri_flat_occurrences.h"
 #include "stri_container_logical.h"
-#include <deque>
 #include <utility>
 using namespace std;
 
@@ -62,6 +62,9 @@ using namespace std;
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriCharClass::span (ASCII bitmap + UnicodeSet::spanUTF8)
  */
 SEXP stri__locate_firstlast_charclass(SEXP str, SEXP pattern, bool first)
 {
@@ -89,23 +92,22 @@ SEXP stri__locate_firstlast_charclass(SEXP str, SEXP pattern, bool first)
       if (str_cont.isNA(i) || pattern_cont.isNA(i))
          continue;
 
-      const UnicodeSet* pattern_cur = &pattern_cont.get(i);
+      const StriCharClass* pattern_cur = &pattern_cont.get(i);
       R_len_t     str_cur_n = str_cont.get(i).length();
       const char* str_cur_s = str_cont.get(i).c_str();
-      R_len_t j;
-      R_len_t k = 0;
-      UChar32 chr;
-
-      for (j=0; j<str_cur_n; ) {
-         U8_NEXT(str_cur_s, j, str_cur_n, chr);
-         if (chr < 0) // invalid utf-8 sequence
-            throw StriException(MSG__INVALID_UTF8);
-         k++; // 1-based index
-         if (pattern_cur->contains(chr)) {
-            ret_tab[i]      = k;
-            if (first) break; // that's enough for first
-            // note that for last, we can't go backwards from the end, as we need a proper index!
-         }
+      StriCharClass::validate(str_cur_s, str_cur_n, str_cont.get(i).isASCII());
+
+      if (first) {
+         R_len_t a = pattern_cur->span(str_cur_s, 0, str_cur_n, false);
+         if (a < str_cur_n) // 1-based index
+            ret_tab[i] = stri__utf8_count_codepoints(str_cur_s, a)+1;
+      }
+      else {
+         // the match ends at b, so there are exactly as many code points
+         // up to b as the 1-based index of the match
+         R_len_t b = pattern_cur->spanBack(str_cur_s, str_cur_n, false);
+         if (b > 0)
+            ret_tab[i] = stri__utf8_count_codepoints(str_cur_s, b);
       }
       ret_tab[i+vectorize_length] = ret_tab[i];
    }
@@ -151,7 +153,11 @@ SEXP stri_locate_last_charclass(SEXP str, SEXP pattern)
  *
  * @param str character vector
  * @param pattern character vector
+ * @param merge single logical value
+ * @param omit_no_match single logical value
+ * @param flat single logical value
  * @return list of matrices with 2 columns
+ *    or a list of 4 columns if \code{flat} is \code{TRUE}
  *
  * @version 0.1-?? (Marek Gagolewski, 2013-06-04)
  *
@@ -180,10 +186,20 @@ SEXP stri_locate_last_charclass(SEXP str, SEXP pattern)
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-11-27)
  *    FR #117: omit_no_match arg added
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriCharClass::span (ASCII bitmap + UnicodeSet::spanUTF8)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    new arg: flat
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
-SEXP stri_locate_all_charclass(SEXP str, SEXP pattern, SEXP merge, SEXP omit_no_match)
+SEXP stri_locate_all_charclass(SEXP str, SEXP pattern, SEXP merge, SEXP omit_no_match, SEXP flat)
 {
    bool omit_no_match1 = stri__prepare_arg_logical_1_notNA(omit_no_match, "omit_no_match");
+   bool flat1 = stri__prepare_arg_logical_1_notNA(flat, "flat");
       bool merge_cur = stri__prepare_arg_logical_1_notNA(merge, "merge");
    PROTECT(str     = stri_prepare_arg_string(str, "str"));
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
@@ -195,18 +211,23 @@ SEXP stri_locate_all_charclass(SEXP str, SEXP pattern, SEXP merge, SEXP omit_no_
    StriContainerCharClass pattern_cont(pattern, vectorize_length);
 
    SEXP ret;
-   STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
+   STRI__PROTECT(ret = Rf_allocVector(VECSXP, flat1?0:vectorize_length));
+   StriFlatOccurrences flat_occurrences;
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
    {
       if (pattern_cont.isNA(i) || str_cont.isNA(i)) {
-         SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(1, 2));
+         if (flat1) flat_occurrences.addNA(i);
+         else SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(1, 2));
          continue;
       }
 
-      deque< pair<R_len_t, R_len_t> > occurrences;
+      StriCharClass::validate(str_cont.get(i).c_str(),
+         str_cont.get(i).length(), str_cont.get(i).isASCII());
+      occurrences.clear();
       StriContainerCharClass::locateAll(
          occurrences, &pattern_cont.get(i),
          str_cont.get(i).c_str(), str_cont.get(i).length(), merge_cur,
@@ -215,14 +236,24 @@ SEXP stri_locate_all_charclass(SEXP str, SEXP pattern, SEXP merge, SEXP omit_no_
 
       R_len_t noccurrences = (R_len_t)occurrences.size();
       if (noccurrences == 0) {
-         SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(omit_no_match1?0:1, 2));
+         if (!flat1)
+            SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(omit_no_match1?0:1, 2));
+         else if (!omit_no_match1)
+            flat_occurrences.addNA(i);
+         continue;
+      }
+
+      if (flat1) {
+         int* starts = flat_occurrences.getStarts(flat_occurrences.add(i, occurrences));
+         for (R_len_t f = 0; f < noccurrences; ++f)
+            ++starts[f]; // 0-based => 1-based
          continue;
       }
 
       SEXP cur_res;
       STRI__PROTECT(cur_res = Rf_allocMatrix(INTSXP, noccurrences, 2));
       int* cur_res_int = INTEGER(cur_res);
-      deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+      StriOccurrences::iterator iter = occurrences.begin();
       for (R_len_t f = 0; iter != occurrences.end(); ++iter, ++f) {
          pair<R_len_t, R_len_t> curoccur = *iter;
          cur_res_int[f] = curoccur.first+1; // 0-based => 1-based
@@ -232,7 +263,11 @@ SEXP stri_locate_all_charclass(SEXP str, SEXP pattern, SEXP merge, SEXP omit_no_
       STRI__UNPROTECT(1)
    }
 
-   stri__locate_set_dimnames_list(ret);
+   if (flat1) {
+      STRI__PROTECT(ret = flat_occurrences.toR());
+   }
+   else
+      stri__locate_set_dimnames_list(ret);
    STRI__UNPROTECT_ALL
    return ret;
    STRI__ERROR_HANDLER_END(;/* nothing special to be done on error */)
@@ -35,7 +35,6 @@
 #include "stri_container_charclass.h"
 #include "stri_container_logical.h"
 #include "stri_string8buf.h"
-#include <deque>
 #include <utility>
 using namespace std;
 
@@ -74,6 +73,12 @@ using namespace std;
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-30)
  *    Issue #210: Allow NA replacement
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriCharClass::span (ASCII bitmap + UnicodeSet::spanUTF8)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri__replace_all_charclass_yes_vectorize_all(SEXP str, SEXP pattern, SEXP replacement, SEXP merge)
 {
@@ -94,6 +99,7 @@ SEXP stri__replace_all_charclass_yes_vectorize_all(SEXP str, SEXP pattern, SEXP
 
    String8buf buf(0); // @TODO: calculate buf len a priori?
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
@@ -105,7 +111,8 @@ SEXP stri__replace_all_charclass_yes_vectorize_all(SEXP str, SEXP pattern, SEXP
 
       R_len_t str_cur_n     = str_cont.get(i).length();
       const char* str_cur_s = str_cont.get(i).c_str();
-      deque< pair<R_len_t, R_len_t> > occurrences;
+      StriCharClass::validate(str_cur_s, str_cur_n, str_cont.get(i).isASCII());
+      occurrences.clear();
       R_len_t sumbytes = StriContainerCharClass::locateAll(
          occurrences, &pattern_cont.get(i),
          str_cur_s, str_cur_n, merge_cur,
@@ -161,6 +168,12 @@ SEXP stri__replace_all_charclass_yes_vectorize_all(SEXP str, SEXP pattern, SEXP
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-30)
  *    Issue #210: Allow NA replacement
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriCharClass::span (ASCII bitmap + UnicodeSet::spanUTF8)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri__replace_all_charclass_no_vectorize_all(SEXP str, SEXP pattern, SEXP replacement, SEXP merge)
 {
@@ -200,6 +213,7 @@ SEXP stri__replace_all_charclass_no_vectorize_all(SEXP str, SEXP pattern, SEXP r
 
    String8buf buf(0); // @TODO: calculate buf len a priori?
 
+   StriOccurrences occurrences; // reused across strings and patterns
    for (R_len_t i = 0; i<pattern_n; ++i)
    {
       if (pattern_cont.isNA(i)) {
@@ -212,7 +226,8 @@ SEXP stri__replace_all_charclass_no_vectorize_all(SEXP str, SEXP pattern, SEXP r
 
          R_len_t str_cur_n     = str_cont.get(j).length();
          const char* str_cur_s = str_cont.get(j).c_str();
-         deque< pair<R_len_t, R_len_t> > occurrences;
+         StriCharClass::validate(str_cur_s, str_cur_n, str_cont.get(j).isASCII());
+         occurrences.clear();
          R_len_t sumbytes = StriContainerCharClass::locateAll(
             occurrences, &pattern_cont.get(i),
             str_cur_s, str_cur_n, merge_cur,
@@ -256,10 +271,20 @@ SEXP stri__replace_all_charclass_no_vectorize_all(SEXP str, SEXP pattern, SEXP r
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-02)
  *          added `vectorize_all` arg
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_replace_all_charclass(SEXP str, SEXP pattern, SEXP replacement, SEXP merge, SEXP vectorize_all)
 {
-   if (stri__prepare_arg_logical_1_notNA(vectorize_all, "vectorize_all"))
+   // with vectorize_all=FALSE, each string is matched against all the patterns
+   bool vectorize_all_1 = stri__prepare_arg_logical_1_notNA(vectorize_all, "vectorize_all");
+   STRI__FACTOR_BY_LEVELS(str, (vectorize_all_1
+         ? stri__factor_by_levels(str, pattern, replacement)
+         : stri__factor_by_levels(str)),
+      stri_replace_all_charclass(str, pattern, replacement, merge, vectorize_all))
+
+   if (vectorize_all_1)
       return stri__replace_all_charclass_yes_vectorize_all(str, pattern, replacement, merge);
    else
       return stri__replace_all_charclass_no_vectorize_all(str, pattern, replacement, merge);
@@ -291,6 +316,9 @@ SEXP stri_replace_all_charclass(SEXP str, SEXP pattern, SEXP replacement, SEXP m
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriCharClass::span (ASCII bitmap + UnicodeSet::spanUTF8)
  */
 SEXP stri__replace_firstlast_charclass(SEXP str, SEXP pattern, SEXP replacement, bool first)
 {
@@ -320,33 +348,21 @@ SEXP stri__replace_firstlast_charclass(SEXP str, SEXP pattern, SEXP replacement,
          continue;
       }
 
-      const UnicodeSet* pattern_cur = &pattern_cont.get(i);
+      const StriCharClass* pattern_cur = &pattern_cont.get(i);
       R_len_t str_cur_n     = str_cont.get(i).length();
       const char* str_cur_s = str_cont.get(i).c_str();
+      StriCharClass::validate(str_cur_s, str_cur_n, str_cont.get(i).isASCII());
       R_len_t j, jlast;
-      UChar32 chr;
 
       if (first) { // search for first
-         for (jlast=j=0; j<str_cur_n; ) {
-            U8_NEXT(str_cur_s, j, str_cur_n, chr); // "look ahead"
-            if (chr < 0) // invalid utf-8 sequence
-               throw StriException(MSG__INVALID_UTF8);
-            if (pattern_cur->contains(chr)) {
-               break; // break at first occurrence
-            }
-            jlast = j;
-         }
+         jlast = j = pattern_cur->span(str_cur_s, 0, str_cur_n, false);
+         if (j < str_cur_n)
+            U8_FWD_1(str_cur_s, j, str_cur_n);
       }
       else { // search for last
-        for (jlast=j=str_cur_n; jlast>0; ) {
-            U8_PREV(str_cur_s, 0, jlast, chr); // "look behind"
-            if (chr < 0) // invalid utf-8 sequence
-               throw StriException(MSG__INVALID_UTF8);
-            if (pattern_cur->contains(chr)) {
-               break; // break at first occurrence
-            }
-            j = jlast;
-         }
+         jlast = j = pattern_cur->spanBack(str_cur_s, str_cur_n, false);
+         if (jlast > 0)
+            U8_BACK_1((const uint8_t*)str_cur_s, 0, jlast);
       }
 
       // match is at jlast, and ends right before j
@@ -387,9 +403,15 @@ SEXP stri__replace_firstlast_charclass(SEXP str, SEXP pattern, SEXP replacement,
  * @return character vector
  *
  * @version 0.1-?? (Marek Gagolewski, 2013-06-06)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_replace_first_charclass(SEXP str, SEXP pattern, SEXP replacement)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str, pattern, replacement),
+      stri_replace_first_charclass(str, pattern, replacement))
+
    return stri__replace_firstlast_charclass(str, pattern, replacement, true);
 }
 
@@ -404,8 +426,14 @@ SEXP stri_replace_first_charclass(SEXP str, SEXP pattern, SEXP replacement)
  * @return character vector
  *
  * @version 0.1-?? (Marek Gagolewski, 2013-06-06)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_replace_last_charclass(SEXP str, SEXP pattern, SEXP replacement)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str, pattern, replacement),
+      stri_replace_last_charclass(str, pattern, replacement))
+
    return stri__replace_firstlast_charclass(str, pattern, replacement, false);
 }
@@ -35,8 +35,8 @@
 #include "stri_container_charclass.h"
 #include "stri_container_integer.h"
 #include "stri_container_logical.h"
-#include <deque>
 #include <utility>
+#include "stri_tokentable.h"
 using namespace std;
 
 
@@ -81,6 +81,15 @@ using namespace std;
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-04)
  *    allow `simplify=NA`; FR #126: pass n to stri_list2matrix
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriTokenTable: simplify=TRUE writes directly to a matrix
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriCharClass::span (ASCII bitmap + UnicodeSet::spanUTF8)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri_split_charclass(SEXP str, SEXP pattern, SEXP n,
                           SEXP omit_empty, SEXP tokens_only, SEXP simplify)
@@ -100,19 +109,19 @@ SEXP stri_split_charclass(SEXP str, SEXP pattern, SEXP n,
    StriContainerLogical   omit_empty_cont(omit_empty, vectorize_length);
    StriContainerCharClass pattern_cont(pattern, vectorize_length);
 
-   SEXP ret;
-   STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
+   StriTokenTable tokens(vectorize_length);
 
+   StriOccurrences fields; // byte based-indices
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
    {
       if (str_cont.isNA(i) || pattern_cont.isNA(i) || n_cont.isNA(i)) {
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));
+         tokens.addNA(i);
          continue;
       }
 
-      const UnicodeSet* pattern_cur = &pattern_cont.get(i);
+      const StriCharClass* pattern_cur = &pattern_cont.get(i);
       int  n_cur            = n_cont.get(i);
       int  omit_empty_cur   = !omit_empty_cont.isNA(i) && omit_empty_cont.get(i);
 
@@ -120,34 +129,31 @@ SEXP stri_split_charclass(SEXP str, SEXP pattern, SEXP n,
          throw StriException(MSG__EXPECTED_SMALLER, "n");
       else if (n_cur < 0)
          n_cur = INT_MAX;
-      else if (n_cur == 0) {
-         SET_VECTOR_ELT(ret, i, Rf_allocVector(STRSXP, 0));
-         continue;
-      }
+      else if (n_cur == 0)
+         continue; // no tokens at all
       else if (tokens_only1)
          n_cur++; // we need to do one split ahead here
 
       R_len_t     str_cur_n = str_cont.get(i).length();
       const char* str_cur_s = str_cont.get(i).c_str();
+      StriCharClass::validate(str_cur_s, str_cur_n, str_cont.get(i).isASCII());
       R_len_t j, k;
-      UChar32 chr;
-      deque< pair<R_len_t, R_len_t> > fields; // byte based-indices
+      fields.clear();
       fields.push_back(pair<R_len_t, R_len_t>(0,0));
 
       for (j=0, k=1; j<str_cur_n && k < n_cur; ) {
-         U8_NEXT(str_cur_s, j, str_cur_n, chr);
-         if (chr < 0) // invalid utf-8 sequence
-            throw StriException(MSG__INVALID_UTF8);
-         if (pattern_cur->contains(chr)) {
-            if (omit_empty_cur && fields.back().second == fields.back().first)
-               fields.back().first = fields.back().second = j; // don't start any new field
-            else {
-               fields.push_back(pair<R_len_t, R_len_t>(j, j)); // start a new field here
-               ++k; // another field
-            }
-         }
+         // the whole run of non-delimiters belongs to the current field
+         j = pattern_cur->span(str_cur_s, j, str_cur_n, false);
+         fields.back().second = j;
+         if (j >= str_cur_n)
+            break;
+
+         U8_FWD_1(str_cur_s, j, str_cur_n); // skip the delimiter
+         if (omit_empty_cur && fields.back().second == fields.back().first)
+            fields.back().first = fields.back().second = j; // don't start any new field
          else {
-            fields.back().second = j;
+            fields.push_back(pair<R_len_t, R_len_t>(j, j)); // start a new field here
+            ++k; // another field
          }
       }
       if (k == n_cur)
@@ -157,28 +163,22 @@ SEXP stri_split_charclass(SEXP str, SEXP pattern, SEXP n,
 
       if (tokens_only1 && n_cur < INT_MAX) {
          n_cur--; // one split ahead could have been made, see above
-         while (fields.size() > (size_t)n_cur)
+         while (fields.size() > n_cur)
             fields.pop_back(); // get rid of the remainder
       }
 
-      SEXP ans;
-      STRI__PROTECT(ans = Rf_allocVector(STRSXP, fields.size()));
-
-      deque< pair<R_len_t, R_len_t> >::iterator iter = fields.begin();
-      for (k = 0; iter != fields.end(); ++iter, ++k) {
+      StriOccurrences::iterator iter = fields.begin();
+      for (; iter != fields.end(); ++iter) {
          pair<R_len_t, R_len_t> curoccur = *iter;
          if (curoccur.second == curoccur.first && omit_empty_cont.isNA(i))
-            SET_STRING_ELT(ans, k, NA_STRING);
+            tokens.addNA(i);
          else
-            SET_STRING_ELT(ans, k,
-               Rf_mkCharLenCE(str_cur_s+curoccur.first,
-                           curoccur.second-curoccur.first, CE_UTF8));
+            tokens.add(i, str_cur_s+curoccur.first,
+               curoccur.second-curoccur.first);
       }
-
-      SET_VECTOR_ELT(ret, i, ans);
-      STRI__UNPROTECT(1)
    }
 
+   SEXP ret;
    if (LOGICAL(simplify)[0] == NA_LOGICAL || LOGICAL(simplify)[0]) {
       R_len_t n_min = 0;
       R_len_t n_length = LENGTH(n);
@@ -187,11 +187,12 @@ SEXP stri_split_charclass(SEXP str, SEXP pattern, SEXP n,
          if (n_tab[i] != NA_INTEGER && n_min < n_tab[i])
             n_min = n_tab[i];
       }
-      STRI__PROTECT(ret = stri_list2matrix(ret, Rf_ScalarLogical(TRUE),
-         (LOGICAL(simplify)[0] == NA_LOGICAL)?stri__vector_NA_strings(1)
-                                             :stri__vector_empty_strings(1),
-         Rf_ScalarInteger(n_min)))
+      // write directly to a matrix, no intermediate list
+      STRI__PROTECT(ret = tokens.toMatrix(
+         (LOGICAL(simplify)[0] == NA_LOGICAL)?NA_STRING:R_BlankString, n_min))
    }
+   else
+      STRI__PROTECT(ret = tokens.toList())
 
    STRI__UNPROTECT_ALL
    return ret;
@@ -58,9 +58,15 @@
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_count_coll(SEXP str, SEXP pattern, SEXP opts_collator)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str, pattern),
+      stri_count_coll(str, pattern, opts_collator))
+
    PROTECT(str = stri_prepare_arg_string(str, "str"));
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
 
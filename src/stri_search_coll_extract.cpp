@@ -33,7 +33,7 @@
 #include "stri_stringi.h"
 #include "stri_container_utf16.h"
 #include "stri_container_usearch.h"
-#include <deque>
+#include "stri_flat_occurrences.h"
 #include <utility>
 using namespace std;
 
@@ -156,10 +156,13 @@ SEXP stri_extract_last_coll(SEXP str, SEXP pattern, SEXP opts_collator)
  *
  * @param str character vector
  * @param pattern character vector
- * @param opts_collator list
  * @param simplify single logical value
+ * @param omit_no_match single logical value
+ * @param flat single logical value
+ * @param opts_collator list
  *
  * @return list of character vectors  or character matrix
+ *    or a list of 3 columns if \code{flat} is \code{TRUE}
  *
  * @version 0.1-?? (Marek Gagolewski, 2013-06-24)
  *
@@ -180,10 +183,17 @@ SEXP stri_extract_last_coll(SEXP str, SEXP pattern, SEXP opts_collator)
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-04)
  *    allow `simplify=NA`
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    new arg: flat
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
-SEXP stri_extract_all_coll(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_match, SEXP opts_collator)
+SEXP stri_extract_all_coll(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_match, SEXP flat, SEXP opts_collator)
 {
    bool omit_no_match1 = stri__prepare_arg_logical_1_notNA(omit_no_match, "omit_no_match");
+   bool flat1 = stri__prepare_arg_logical_1_notNA(flat, "flat");
    PROTECT(simplify = stri_prepare_arg_logical_1(simplify, "simplify"));
    PROTECT(str = stri_prepare_arg_string(str, "str"));
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
@@ -199,15 +209,19 @@ SEXP stri_extract_all_coll(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_m
    StriContainerUStringSearch pattern_cont(pattern, vectorize_length, collator);  // collator is not owned by pattern_cont
 
    SEXP ret;
-   STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
+   STRI__PROTECT(ret = Rf_allocVector(VECSXP, flat1?0:vectorize_length));
+   StriFlatOccurrences flat_occurrences;
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
    {
       STRI__CONTINUE_ON_EMPTY_OR_NA_STR_PATTERN(str_cont, pattern_cont,
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));,
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(omit_no_match1?0:1));)
+         if (flat1) flat_occurrences.addNA(i);
+         else SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));,
+         if (flat1) { if (!omit_no_match1) flat_occurrences.addNA(i); }
+         else SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(omit_no_match1?0:1));)
 
       UStringSearch *matcher = pattern_cont.getMatcher(i, str_cont.get(i));
       usearch_reset(matcher);
@@ -217,23 +231,31 @@ SEXP stri_extract_all_coll(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_m
       STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
 
       if (start == USEARCH_DONE) {
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(omit_no_match1?0:1));
+         if (!flat1)
+            SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(omit_no_match1?0:1));
+         else if (!omit_no_match1)
+            flat_occurrences.addNA(i);
          continue;
       }
 
-      deque< pair<R_len_t, R_len_t> > occurrences;
+      occurrences.clear();
       while (start != USEARCH_DONE) {
-         occurrences.push_back(pair<R_len_t, R_len_t>(start, usearch_getMatchedLength(matcher)));
+         occurrences.push_back(pair<R_len_t, R_len_t>(start, start+usearch_getMatchedLength(matcher)));
          start = usearch_next(matcher, &status);
          STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
       }
 
+      if (flat1) {
+         flat_occurrences.add(i, occurrences);
+         continue;
+      }
+
       R_len_t noccurrences = (R_len_t)occurrences.size();
       StriContainerUTF16 out_cont(noccurrences);
-      deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+      StriOccurrences::iterator iter = occurrences.begin();
       for (R_len_t j = 0; iter != occurrences.end(); ++iter, ++j) {
          pair<R_len_t, R_len_t> match = *iter;
-         out_cont.getWritable(j).setTo(str_cont.get(i), match.first, match.second);
+         out_cont.getWritable(j).setTo(str_cont.get(i), match.first, match.second-match.first);
       }
 
       SET_VECTOR_ELT(ret, i, out_cont.toR());
@@ -241,7 +263,10 @@ SEXP stri_extract_all_coll(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_m
 
    if (collator) { ucol_close(collator); collator=NULL; }
 
-   if (LOGICAL(simplify)[0] == NA_LOGICAL) {
+   if (flat1) {
+      STRI__PROTECT(ret = flat_occurrences.toR(str_cont));
+   }
+   else if (LOGICAL(simplify)[0] == NA_LOGICAL) {
       STRI__PROTECT(ret = stri_list2matrix(ret, Rf_ScalarLogical(TRUE),
          stri__vector_NA_strings(1), Rf_ScalarInteger(0)))
    }
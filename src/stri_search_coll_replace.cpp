@@ -34,7 +34,6 @@
 #include "stri_container_utf16.h"
 #include "stri_container_usearch.h"
 #include "stri_string8buf.h"
-#include <deque>
 using namespace std;
 
 
@@ -63,6 +62,9 @@ using namespace std;
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-30)
  *    Issue #210: Allow NA replacement
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri__replace_allfirstlast_coll(SEXP str, SEXP pattern, SEXP replacement, SEXP opts_collator, int type)
 {
@@ -79,6 +81,7 @@ SEXP stri__replace_allfirstlast_coll(SEXP str, SEXP pattern, SEXP replacement, S
    StriContainerUStringSearch pattern_cont(pattern, vectorize_length, collator);  // collator is not owned by pattern_cont
    StriContainerUTF16 replacement_cont(replacement, vectorize_length);
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
@@ -92,7 +95,7 @@ SEXP stri__replace_allfirstlast_coll(SEXP str, SEXP pattern, SEXP replacement, S
 
       UErrorCode status = U_ZERO_ERROR;
       R_len_t remUChars = 0;
-      deque< pair<R_len_t, R_len_t> > occurrences;
+      occurrences.clear();
 
       if (type >= 0) { // first or all
          int start = (int)usearch_first(matcher, &status);
@@ -135,7 +138,7 @@ SEXP stri__replace_allfirstlast_coll(SEXP str, SEXP pattern, SEXP replacement, S
       UnicodeString ans(str_cont.get(i).length()-remUChars+noccurrences*replacement_cur_n, (UChar)0xfffd, 0);
       R_len_t jlast = 0;
       R_len_t anslast = 0;
-      deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+      StriOccurrences::iterator iter = occurrences.begin();
       for (; iter != occurrences.end(); ++iter) {
          pair<R_len_t, R_len_t> match = *iter;
          ans.replace(anslast, match.first-jlast, str_cont.get(i), jlast, match.first-jlast);
@@ -176,6 +179,9 @@ SEXP stri__replace_allfirstlast_coll(SEXP str, SEXP pattern, SEXP replacement, S
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-30)
  *    Issue #210: Allow NA replacement
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri__replace_all_coll_no_vectorize_all(SEXP str, SEXP pattern, SEXP replacement, SEXP opts_collator)
 { // version beta
@@ -215,6 +221,7 @@ SEXP stri__replace_all_coll_no_vectorize_all(SEXP str, SEXP pattern, SEXP replac
    StriContainerUStringSearch pattern_cont(pattern, pattern_n, collator);  // collator is not owned by pattern_cont
    StriContainerUTF16 replacement_cont(replacement, pattern_n);
 
+   StriOccurrences occurrences; // reused across strings and patterns
    for (R_len_t i = 0; i<pattern_n; ++i)
    {
       if (pattern_cont.isNA(i)) {
@@ -236,7 +243,7 @@ SEXP stri__replace_all_coll_no_vectorize_all(SEXP str, SEXP pattern, SEXP replac
          usearch_reset(matcher);
          UErrorCode status = U_ZERO_ERROR;
          R_len_t remUChars = 0;
-         deque< pair<R_len_t, R_len_t> > occurrences;
+         occurrences.clear();
 
          int start = (int)usearch_first(matcher, &status);
          STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
@@ -262,7 +269,7 @@ SEXP stri__replace_all_coll_no_vectorize_all(SEXP str, SEXP pattern, SEXP replac
          UnicodeString ans(str_cont.get(j).length()-remUChars+noccurrences*replacement_cur_n, (UChar)0xfffd, 0);
          R_len_t jlast = 0;
          R_len_t anslast = 0;
-         deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+         StriOccurrences::iterator iter = occurrences.begin();
          for (; iter != occurrences.end(); ++iter) {
             pair<R_len_t, R_len_t> match = *iter;
             ans.replace(anslast, match.first-jlast, str_cont.get(j), jlast, match.first-jlast);
@@ -304,10 +311,20 @@ SEXP stri__replace_all_coll_no_vectorize_all(SEXP str, SEXP pattern, SEXP replac
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-04)
  *          vectorize_all arg added
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_replace_all_coll(SEXP str, SEXP pattern, SEXP replacement, SEXP vectorize_all, SEXP opts_collator)
 {
-   if (stri__prepare_arg_logical_1_notNA(vectorize_all, "vectorize_all"))
+   // with vectorize_all=FALSE, each string is matched against all the patterns
+   bool vectorize_all_1 = stri__prepare_arg_logical_1_notNA(vectorize_all, "vectorize_all");
+   STRI__FACTOR_BY_LEVELS(str, (vectorize_all_1
+         ? stri__factor_by_levels(str, pattern, replacement)
+         : stri__factor_by_levels(str)),
+      stri_replace_all_coll(str, pattern, replacement, vectorize_all, opts_collator))
+
+   if (vectorize_all_1)
       return stri__replace_allfirstlast_coll(str, pattern, replacement, opts_collator, 0);
    else
       return stri__replace_all_coll_no_vectorize_all(str, pattern, replacement, opts_collator);
@@ -330,9 +347,15 @@ SEXP stri_replace_all_coll(SEXP str, SEXP pattern, SEXP replacement, SEXP vector
  *
  * @version 0.2-3 (Marek Gagolewski, 2014-05-08)
  *          new fun: stri_replace_last_coll (opts_collator == NA not allowed)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_replace_last_coll(SEXP str, SEXP pattern, SEXP replacement, SEXP opts_collator)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str, pattern, replacement),
+      stri_replace_last_coll(str, pattern, replacement, opts_collator))
+
    return stri__replace_allfirstlast_coll(str, pattern, replacement, opts_collator, -1);
 }
 
@@ -353,8 +376,14 @@ SEXP stri_replace_last_coll(SEXP str, SEXP pattern, SEXP replacement, SEXP opts_
  *
  * @version 0.2-3 (Marek Gagolewski, 2014-05-08)
  *          new fun: stri_replace_first_coll (opts_collator == NA not allowed)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_replace_first_coll(SEXP str, SEXP pattern, SEXP replacement, SEXP opts_collator)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str, pattern, replacement),
+      stri_replace_first_coll(str, pattern, replacement, opts_collator))
+
    return stri__replace_allfirstlast_coll(str, pattern, replacement, opts_collator, 1);
 }
@@ -35,7 +35,6 @@
 #include "stri_container_usearch.h"
 #include "stri_container_integer.h"
 #include "stri_container_logical.h"
-#include <deque>
 #include <utility>
 using namespace std;
 
@@ -83,6 +82,9 @@ using namespace std;
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-04)
  *    allow `simplify=NA`; FR #126: pass n to stri_list2matrix
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri_split_coll(SEXP str, SEXP pattern, SEXP n, SEXP omit_empty,
                      SEXP tokens_only, SEXP simplify, SEXP opts_collator)
@@ -108,6 +110,7 @@ SEXP stri_split_coll(SEXP str, SEXP pattern, SEXP n, SEXP omit_empty,
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
 
+   StriOccurrences fields; // byte based-indices
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
@@ -142,7 +145,7 @@ SEXP stri_split_coll(SEXP str, SEXP pattern, SEXP n, SEXP omit_empty,
          n_cur++; // we need to do one split ahead here
 
       R_len_t k;
-      deque< pair<R_len_t, R_len_t> > fields; // byte based-indices
+      fields.clear();
       fields.push_back(pair<R_len_t, R_len_t>(0,0));
       UErrorCode status = U_ZERO_ERROR;
 
@@ -165,13 +168,13 @@ SEXP stri_split_coll(SEXP str, SEXP pattern, SEXP n, SEXP omit_empty,
 
       if (tokens_only1 && n_cur < INT_MAX) {
          n_cur--; // one split ahead could have been made, see above
-         while (fields.size() > (size_t)n_cur)
+         while (fields.size() > n_cur)
             fields.pop_back(); // get rid of the remainder
       }
 
       R_len_t noccurrences = (R_len_t)fields.size();
       StriContainerUTF16 out_cont(noccurrences);
-      deque< pair<R_len_t, R_len_t> >::iterator iter = fields.begin();
+      StriOccurrences::iterator iter = fields.begin();
       for (k = 0; iter != fields.end(); ++iter, ++k) {
          pair<R_len_t, R_len_t> curoccur = *iter;
          if (curoccur.second == curoccur.first && omit_empty_cont.isNA(i))
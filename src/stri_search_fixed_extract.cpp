@@ -33,7 +33,7 @@
 #include "stri_stringi.h"
 #include "stri_container_utf8.h"
 #include "stri_container_bytesearch.h"
-#include <deque>
+#include "stri_flat_occurrences.h"
 #include <utility>
 using namespace std;
 
@@ -149,7 +149,12 @@ SEXP stri_extract_last_fixed(SEXP str, SEXP pattern, SEXP opts_fixed)
  *
  * @param str character vector
  * @param pattern character vector
- * @return character vector
+ * @param simplify single logical value
+ * @param omit_no_match single logical value
+ * @param flat single logical value
+ * @param opts_fixed list
+ * @return list of character vectors or character matrix
+ *    or a list of 3 columns if \code{flat} is \code{TRUE}
  *
  * @version 0.1-?? (Marek Gagolewski, 2013-06-24)
  *
@@ -161,11 +166,18 @@ SEXP stri_extract_last_fixed(SEXP str, SEXP pattern, SEXP opts_fixed)
  *
  * @version 0.5-1 (Marek Gagolewski, 2015-02-14)
  *    use StriByteSearchMatcher
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    new arg: flat
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
-SEXP stri_extract_all_fixed(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_match, SEXP opts_fixed)
+SEXP stri_extract_all_fixed(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_match, SEXP flat, SEXP opts_fixed)
 {
    uint32_t pattern_flags = StriContainerByteSearch::getByteSearchFlags(opts_fixed, /*allow_overlap*/true);
    bool omit_no_match1 = stri__prepare_arg_logical_1_notNA(omit_no_match, "omit_no_match");
+   bool flat1 = stri__prepare_arg_logical_1_notNA(flat, "flat");
    PROTECT(simplify = stri_prepare_arg_logical_1(simplify, "simplify"));
    PROTECT(str = stri_prepare_arg_string(str, "str")); // prepare string argument
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern")); // prepare string argument
@@ -176,21 +188,25 @@ SEXP stri_extract_all_fixed(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_
    StriContainerByteSearch pattern_cont(pattern, vectorize_length, pattern_flags);
 
    SEXP ret;
-   STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
+   STRI__PROTECT(ret = Rf_allocVector(VECSXP, flat1?0:vectorize_length));
+   StriFlatOccurrences flat_occurrences;
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
    {
       STRI__CONTINUE_ON_EMPTY_OR_NA_STR_PATTERN(str_cont, pattern_cont,
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));,
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(omit_no_match1?0:1));)
+         if (flat1) flat_occurrences.addNA(i);
+         else SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));,
+         if (flat1) { if (!omit_no_match1) flat_occurrences.addNA(i); }
+         else SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(omit_no_match1?0:1));)
 
       StriByteSearchMatcher* matcher = pattern_cont.getMatcher(i);
       matcher->reset(str_cont.get(i).c_str(), str_cont.get(i).length());
 
       int start = matcher->findFirst();
-      deque< pair<R_len_t, R_len_t> > occurrences;
+      occurrences.clear();
       while (start != USEARCH_DONE) {
          occurrences.push_back(pair<R_len_t, R_len_t>(start, start+matcher->getMatchedLength()));
          start = matcher->findNext();
@@ -198,14 +214,22 @@ SEXP stri_extract_all_fixed(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_
 
       R_len_t noccurrences = (R_len_t)occurrences.size();
       if (noccurrences <= 0) {
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(omit_no_match1?0:1));
+         if (!flat1)
+            SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(omit_no_match1?0:1));
+         else if (!omit_no_match1)
+            flat_occurrences.addNA(i);
+         continue;
+      }
+
+      if (flat1) {
+         flat_occurrences.add(i, occurrences);
          continue;
       }
 
       const char* str_cur_s = str_cont.get(i).c_str();
       SEXP cur_res;
       STRI__PROTECT(cur_res = Rf_allocVector(STRSXP, noccurrences));
-      deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+      StriOccurrences::iterator iter = occurrences.begin();
       for (R_len_t j = 0; iter != occurrences.end(); ++iter, ++j) {
          pair<R_len_t, R_len_t> curo = *iter;
          SET_STRING_ELT(cur_res, j,
@@ -215,7 +239,10 @@ SEXP stri_extract_all_fixed(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_
       STRI__UNPROTECT(1);
    }
 
-   if (LOGICAL(simplify)[0] == NA_LOGICAL) {
+   if (flat1) {
+      STRI__PROTECT(ret = flat_occurrences.toR(str_cont, NA_STRING));
+   }
+   else if (LOGICAL(simplify)[0] == NA_LOGICAL) {
       STRI__PROTECT(ret = stri_list2matrix(ret, Rf_ScalarLogical(TRUE),
          stri__vector_NA_strings(1), Rf_ScalarInteger(0)))
    }
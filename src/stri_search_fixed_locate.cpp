@@ -33,7 +33,7 @@
 #include "stri_stringi.h"
 #include "stri_container_utf8_indexable.h"
 #include "stri_container_bytesearch.h"
-#include <deque>
+#include "stri_flat_occurrences.h"
 #include <utility>
 using namespace std;
 
@@ -177,7 +177,11 @@ SEXP stri_locate_last_fixed(SEXP str, SEXP pattern, SEXP opts_fixed)
  *
  * @param str character vector
  * @param pattern character vector
+ * @param omit_no_match single logical value
+ * @param flat single logical value
+ * @param opts_fixed list
  * @return list of integer matrices (2 columns)
+ *    or a list of 4 columns if \code{flat} is \code{TRUE}
  *
  * @version 0.1-?? (Bartek Tartanus)
  *
@@ -201,11 +205,18 @@ SEXP stri_locate_last_fixed(SEXP str, SEXP pattern, SEXP opts_fixed)
  *
  * @version 0.5-1 (Marek Gagolewski, 2015-02-14)
  *    use StriByteSearchMatcher
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    new arg: flat
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
-SEXP stri_locate_all_fixed(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP opts_fixed)
+SEXP stri_locate_all_fixed(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP flat, SEXP opts_fixed)
 {
    uint32_t pattern_flags = StriContainerByteSearch::getByteSearchFlags(opts_fixed, /*allow_overlap*/true);
    bool omit_no_match1 = stri__prepare_arg_logical_1_notNA(omit_no_match, "omit_no_match");
+   bool flat1 = stri__prepare_arg_logical_1_notNA(flat, "flat");
    PROTECT(str = stri_prepare_arg_string(str, "str"));
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
 
@@ -215,36 +226,50 @@ SEXP stri_locate_all_fixed(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP opts
    StriContainerByteSearch pattern_cont(pattern, vectorize_length, pattern_flags);
 
    SEXP ret;
-   STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
+   STRI__PROTECT(ret = Rf_allocVector(VECSXP, flat1?0:vectorize_length));
+   StriFlatOccurrences flat_occurrences;
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = pattern_cont.vectorize_init();
       i != pattern_cont.vectorize_end();
       i = pattern_cont.vectorize_next(i))
    {
       STRI__CONTINUE_ON_EMPTY_OR_NA_STR_PATTERN(str_cont, pattern_cont,
-         SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(1, 2));,
-         SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(omit_no_match1?0:1, 2));)
+         if (flat1) flat_occurrences.addNA(i);
+         else SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(1, 2));,
+         if (flat1) { if (!omit_no_match1) flat_occurrences.addNA(i); }
+         else SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(omit_no_match1?0:1, 2));)
 
       StriByteSearchMatcher* matcher = pattern_cont.getMatcher(i);
       matcher->reset(str_cont.get(i).c_str(), str_cont.get(i).length());
 
       int start = matcher->findFirst();
       if (start == USEARCH_DONE) { // no matches at all
-         SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(omit_no_match1?0:1, 2));
+         if (!flat1)
+            SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(omit_no_match1?0:1, 2));
+         else if (!omit_no_match1)
+            flat_occurrences.addNA(i);
          continue;
       }
 
-      deque< pair<R_len_t, R_len_t> > occurrences;
+      occurrences.clear();
       while (start != USEARCH_DONE) {
          occurrences.push_back(pair<R_len_t, R_len_t>(start, start+matcher->getMatchedLength()));
          start = matcher->findNext();
       }
 
       R_len_t noccurrences = (R_len_t)occurrences.size();
+      if (flat1) {
+         R_len_t k = flat_occurrences.add(i, occurrences);
+         str_cont.UTF8_to_UChar32_index(i, flat_occurrences.getStarts(k),
+            flat_occurrences.getEnds(k), noccurrences, 1, 0);
+         continue;
+      }
+
       SEXP ans;
       STRI__PROTECT(ans = Rf_allocMatrix(INTSXP, noccurrences, 2));
       int* ans_tab = INTEGER(ans);
-      deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+      StriOccurrences::iterator iter = occurrences.begin();
       for (R_len_t j = 0; iter != occurrences.end(); ++iter, ++j) {
          pair<R_len_t, R_len_t> match = *iter;
          ans_tab[j]              = match.first;
@@ -261,7 +286,11 @@ SEXP stri_locate_all_fixed(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP opts
       STRI__UNPROTECT(1);
    }
 
-   stri__locate_set_dimnames_list(ret);
+   if (flat1) {
+      STRI__PROTECT(ret = flat_occurrences.toR());
+   }
+   else
+      stri__locate_set_dimnames_list(ret);
    STRI__UNPROTECT_ALL
    return ret;
    STRI__ERROR_HANDLER_END( ;/* do nothing special on error */ )
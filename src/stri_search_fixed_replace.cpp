@@ -35,7 +35,6 @@
 #include "stri_container_bytesearch.h"
 #include "stri_string8buf.h"
 //#include "stri_interval.h"
-#include <deque>
 //#include <queue>
 //#include <algorithm>
 using namespace std;
@@ -71,6 +70,9 @@ using namespace std;
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-30)
  *    Issue #210: Allow NA replacement
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri__replace_allfirstlast_fixed(SEXP str, SEXP pattern, SEXP replacement, SEXP opts_fixed, int type)
 {
@@ -90,6 +92,7 @@ SEXP stri__replace_allfirstlast_fixed(SEXP str, SEXP pattern, SEXP replacement,
 
    String8buf buf(0);
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
@@ -119,7 +122,7 @@ SEXP stri__replace_allfirstlast_fixed(SEXP str, SEXP pattern, SEXP replacement,
 
       R_len_t len = matcher->getMatchedLength();
       R_len_t sumbytes = len;
-      deque< pair<R_len_t, R_len_t> > occurrences;
+      occurrences.clear();
       occurrences.push_back(pair<R_len_t, R_len_t>(start, start+len));
 
       if (type == 0) {
@@ -246,6 +249,9 @@ SEXP stri__replace_allfirstlast_fixed(SEXP str, SEXP pattern, SEXP replacement,
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-30)
  *    Issue #210: Allow NA replacement
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri__replace_all_fixed_no_vectorize_all(SEXP str, SEXP pattern, SEXP replacement, SEXP opts_fixed)
 { // version gamma:
@@ -284,6 +290,7 @@ SEXP stri__replace_all_fixed_no_vectorize_all(SEXP str, SEXP pattern, SEXP repla
    StriContainerUTF8 replacement_cont(replacement, pattern_n);
    StriContainerByteSearch pattern_cont(pattern, pattern_n, pattern_flags);
 
+   StriOccurrences occurrences; // reused across strings and patterns
    for (R_len_t i = 0; i<pattern_n; ++i)
    {
       if (pattern_cont.isNA(i)) {
@@ -310,7 +317,7 @@ SEXP stri__replace_all_fixed_no_vectorize_all(SEXP str, SEXP pattern, SEXP repla
 
          R_len_t len = matcher->getMatchedLength();
          R_len_t sumbytes = len;
-         deque< pair<R_len_t, R_len_t> > occurrences;
+         occurrences.clear();
          occurrences.push_back(pair<R_len_t, R_len_t>(start, start+len));
 
          while (USEARCH_DONE != matcher->findNext()) { // all
@@ -533,10 +540,20 @@ SEXP stri__replace_all_fixed_no_vectorize_all(SEXP str, SEXP pattern, SEXP repla
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-07)
  *    FR #110, #23: opts_fixed arg added
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_replace_all_fixed(SEXP str, SEXP pattern, SEXP replacement, SEXP vectorize_all, SEXP opts_fixed)
 {
-   if (stri__prepare_arg_logical_1_notNA(vectorize_all, "vectorize_all"))
+   // with vectorize_all=FALSE, each string is matched against all the patterns
+   bool vectorize_all_1 = stri__prepare_arg_logical_1_notNA(vectorize_all, "vectorize_all");
+   STRI__FACTOR_BY_LEVELS(str, (vectorize_all_1
+         ? stri__factor_by_levels(str, pattern, replacement)
+         : stri__factor_by_levels(str)),
+      stri_replace_all_fixed(str, pattern, replacement, vectorize_all, opts_fixed))
+
+   if (vectorize_all_1)
       return stri__replace_allfirstlast_fixed(str, pattern, replacement, opts_fixed, 0);
    else
       return stri__replace_all_fixed_no_vectorize_all(str, pattern, replacement, opts_fixed);
@@ -561,9 +578,15 @@ SEXP stri_replace_all_fixed(SEXP str, SEXP pattern, SEXP replacement, SEXP vecto
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-07)
  *    FR #110, #23: opts_fixed arg added
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_replace_last_fixed(SEXP str, SEXP pattern, SEXP replacement, SEXP opts_fixed)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str, pattern, replacement),
+      stri_replace_last_fixed(str, pattern, replacement, opts_fixed))
+
    return stri__replace_allfirstlast_fixed(str, pattern, replacement, opts_fixed, -1);
 }
 
@@ -586,8 +609,14 @@ SEXP stri_replace_last_fixed(SEXP str, SEXP pattern, SEXP replacement, SEXP opts
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-07)
  *    FR #110, #23: opts_fixed arg added
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_replace_first_fixed(SEXP str, SEXP pattern, SEXP replacement, SEXP opts_fixed)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str, pattern, replacement),
+      stri_replace_first_fixed(str, pattern, replacement, opts_fixed))
+
    return stri__replace_allfirstlast_fixed(str, pattern, replacement, opts_fixed, 1);
 }
@@ -35,8 +35,8 @@
 #include "stri_container_bytesearch.h"
 #include "stri_container_integer.h"
 #include "stri_container_logical.h"
-#include <deque>
 #include <utility>
+#include "stri_tokentable.h"
 using namespace std;
 
 
@@ -86,6 +86,12 @@ using namespace std;
  *
  * @version 0.5-1 (Marek Gagolewski, 2015-02-14)
  *    use StriByteSearchMatcher
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriTokenTable: simplify=TRUE writes directly to a matrix
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri_split_fixed(SEXP str, SEXP pattern, SEXP n,
                       SEXP omit_empty, SEXP tokens_only, SEXP simplify, SEXP opts_fixed)
@@ -106,25 +112,24 @@ SEXP stri_split_fixed(SEXP str, SEXP pattern, SEXP n,
    StriContainerInteger n_cont(n, vectorize_length);
    StriContainerLogical omit_empty_cont(omit_empty, vectorize_length);
 
-   SEXP ret;
-   STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
+   StriTokenTable tokens(vectorize_length);
 
+   StriOccurrences fields; // byte based-indices
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
    {
       if (n_cont.isNA(i)) {
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));
+         tokens.addNA(i);
          continue;
       }
       int  n_cur        = n_cont.get(i);
       int  omit_empty_cur   = !omit_empty_cont.isNA(i) && omit_empty_cont.get(i);
 
       STRI__CONTINUE_ON_EMPTY_OR_NA_STR_PATTERN(str_cont, pattern_cont,
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));,
-         SET_VECTOR_ELT(ret, i,
-            (omit_empty_cont.isNA(i))?stri__vector_NA_strings(1):
-            stri__vector_empty_strings((omit_empty_cur || n_cur == 0)?0:1));)
+         tokens.addNA(i);,
+         if (omit_empty_cont.isNA(i)) tokens.addNA(i);
+         else if (!omit_empty_cur && n_cur != 0) tokens.addEmpty(i);)
 
       R_len_t     str_cur_n = str_cont.get(i).length();
       const char* str_cur_s = str_cont.get(i).c_str();
@@ -133,17 +138,15 @@ SEXP stri_split_fixed(SEXP str, SEXP pattern, SEXP n,
          throw StriException(MSG__EXPECTED_SMALLER, "n");
       else if (n_cur < 0)
          n_cur = INT_MAX;
-      else if (n_cur == 0) {
-         SET_VECTOR_ELT(ret, i, Rf_allocVector(STRSXP, 0));
-         continue;
-      }
+      else if (n_cur == 0)
+         continue; // no tokens at all
       else if (tokens_only1)
          n_cur++; // we need to do one split ahead here
 
       StriByteSearchMatcher* matcher = pattern_cont.getMatcher(i);
       matcher->reset(str_cont.get(i).c_str(), str_cont.get(i).length());
       R_len_t k;
-      deque< pair<R_len_t, R_len_t> > fields; // byte based-indices
+      fields.clear();
       fields.push_back(pair<R_len_t, R_len_t>(0,0));
 
       for (k=1; k < n_cur && USEARCH_DONE != matcher->findNext(); ) {
@@ -164,28 +167,22 @@ SEXP stri_split_fixed(SEXP str, SEXP pattern, SEXP n,
 
       if (tokens_only1 && n_cur < INT_MAX) {
          n_cur--; // one split ahead could have been made, see above
-         while (fields.size() > (size_t)n_cur)
+         while (fields.size() > n_cur)
             fields.pop_back(); // get rid of the remainder
       }
 
-      SEXP ans;
-      STRI__PROTECT(ans = Rf_allocVector(STRSXP, fields.size()));
-
-      deque< pair<R_len_t, R_len_t> >::iterator iter = fields.begin();
-      for (k = 0; iter != fields.end(); ++iter, ++k) {
+      StriOccurrences::iterator iter = fields.begin();
+      for (; iter != fields.end(); ++iter) {
          pair<R_len_t, R_len_t> curoccur = *iter;
          if (curoccur.second == curoccur.first && omit_empty_cont.isNA(i))
-            SET_STRING_ELT(ans, k, NA_STRING);
+            tokens.addNA(i);
          else
-            SET_STRING_ELT(ans, k,
-               Rf_mkCharLenCE(str_cur_s+curoccur.first,
-                  curoccur.second-curoccur.first, CE_UTF8));
+            tokens.add(i, str_cur_s+curoccur.first,
+               curoccur.second-curoccur.first);
       }
-
-      SET_VECTOR_ELT(ret, i, ans);
-      STRI__UNPROTECT(1);
    }
 
+   SEXP ret;
    if (LOGICAL(simplify)[0] == NA_LOGICAL || LOGICAL(simplify)[0]) {
       R_len_t n_min = 0;
       R_len_t n_length = LENGTH(n);
@@ -194,11 +191,12 @@ SEXP stri_split_fixed(SEXP str, SEXP pattern, SEXP n,
          if (n_tab[i] != NA_INTEGER && n_min < n_tab[i])
             n_min = n_tab[i];
       }
-      STRI__PROTECT(ret = stri_list2matrix(ret, Rf_ScalarLogical(TRUE),
-         (LOGICAL(simplify)[0] == NA_LOGICAL)?stri__vector_NA_strings(1)
-                                             :stri__vector_empty_strings(1),
-         Rf_ScalarInteger(n_min)))
+      // write directly to a matrix, no intermediate list
+      STRI__PROTECT(ret = tokens.toMatrix(
+         (LOGICAL(simplify)[0] == NA_LOGICAL)?NA_STRING:R_BlankString, n_min))
    }
+   else
+      STRI__PROTECT(ret = tokens.toList())
 
    STRI__UNPROTECT_ALL
    return ret;
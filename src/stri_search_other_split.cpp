@@ -37,7 +37,6 @@
 #include "stri_container_bytesearch.h"
 #include "stri_container_integer.h"
 #include "stri_container_logical.h"
-#include <deque>
 #include <utility>
 #include <unicode/brkiter.h>
 #include <unicode/rbbi.h>
@@ -55,6 +54,9 @@ using namespace std;
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-05)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences
  */
 SEXP stri_split_lines1(SEXP str)
 {
@@ -74,7 +76,7 @@ SEXP stri_split_lines1(SEXP str)
 
    UChar32 c;
    R_len_t jlast;
-   deque< pair<R_len_t, R_len_t> > occurrences;
+   StriOccurrences occurrences;
    occurrences.push_back(pair<R_len_t, R_len_t>(0, 0));
    for (R_len_t j=0; j < str_cur_n; /* null */) {
       jlast = j;
@@ -119,7 +121,7 @@ SEXP stri_split_lines1(SEXP str)
 
    SEXP ans;
    STRI__PROTECT(ans = Rf_allocVector(STRSXP, (R_len_t)occurrences.size()));
-   deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+   StriOccurrences::iterator iter = occurrences.begin();
    for (R_len_t k = 0; iter != occurrences.end(); ++iter, ++k) {
       pair<R_len_t, R_len_t> curoccur = *iter;
       SET_STRING_ELT(ans, k,
@@ -147,6 +149,9 @@ SEXP stri_split_lines1(SEXP str)
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-05)
  *    Issue #112: str_prepare_arg* retvals were not PROTECTed from gc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri_split_lines(SEXP str, SEXP omit_empty)
 {
@@ -163,6 +168,7 @@ SEXP stri_split_lines(SEXP str, SEXP omit_empty)
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = str_cont.vectorize_init();
          i != str_cont.vectorize_end();
          i = str_cont.vectorize_next(i))
@@ -200,7 +206,7 @@ SEXP stri_split_lines(SEXP str, SEXP omit_empty)
 
       UChar32 c;
       R_len_t jlast, k=1;
-      deque< pair<R_len_t, R_len_t> > occurrences;
+      occurrences.clear();
       occurrences.push_back(pair<R_len_t, R_len_t>(0, 0));
       for (R_len_t j=0; j < str_cur_n /*&& k < n_max_cur*/; /* null */) {
          jlast = j;
@@ -265,7 +271,7 @@ SEXP stri_split_lines(SEXP str, SEXP omit_empty)
       SEXP ans;
       STRI__PROTECT(ans = Rf_allocVector(STRSXP, (R_len_t)occurrences.size()));
 
-      deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+      StriOccurrences::iterator iter = occurrences.begin();
       for (R_len_t l = 0; iter != occurrences.end(); ++iter, ++l) {
          pair<R_len_t, R_len_t> curoccur = *iter;
          SET_STRING_ELT(ans, l,
@@ -31,7 +31,7 @@
 
 
 #include "stri_stringi.h"
-#include "stri_container_utf16.h"
+#include "stri_container_utf8.h"
 #include "stri_container_regex.h"
 
 
@@ -59,18 +59,26 @@
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-29)
  *    Issue #214: allow a regex pattern like `.*`  to match an empty string
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels;
+ *    literal prefilter (StriContainerRegexPattern::mayMatch);
+ *    use StriRegexDFA if possible
  */
 SEXP stri_count_regex(SEXP str, SEXP pattern, SEXP opts_regex)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str, pattern),
+      stri_count_regex(str, pattern, opts_regex))
+
    PROTECT(str = stri_prepare_arg_string(str, "str"));
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
    R_len_t vectorize_length = stri__recycling_rule(true, 2, LENGTH(str), LENGTH(pattern));
 
-   uint32_t pattern_flags = StriContainerRegexPattern::getRegexFlags(opts_regex);
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
 
    STRI__ERROR_HANDLER_BEGIN(2)
-   StriContainerUTF16 str_cont(str, vectorize_length);
-   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_flags);
+   StriContainerUTF8 str_cont(str, vectorize_length); // converted to UTF-16 on demand
+   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_opts);
 
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocVector(INTSXP, vectorize_length));
@@ -83,12 +91,23 @@ SEXP stri_count_regex(SEXP str, SEXP pattern, SEXP opts_regex)
       STRI__CONTINUE_ON_EMPTY_OR_NA_PATTERN(str_cont, pattern_cont,
          ret_tab[i] = NA_INTEGER)
 
-      // see search_regex_detect for UText implementation (often slower)
-      RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
-      matcher->reset(str_cont.get(i));
+      const char* str_cur_s = str_cont.get(i).c_str();
+      R_len_t str_cur_n = str_cont.get(i).length();
+      if (!pattern_cont.mayMatch(i, str_cur_s, str_cur_n)) {
+         ret_tab[i] = 0; // no need to run the regex engine
+         continue;
+      }
+
       int count = 0;
-      while ((bool)matcher->find())
-         ++count;
+      if (StriRegexDFA* dfa = pattern_cont.getDFA(i, str_cur_s, str_cur_n)) {
+         while (dfa->find())
+            ++count;
+      }
+      else {
+         RegexMatcher *matcher = pattern_cont.getMatcher(i, str_cur_s, str_cur_n); // will be deleted automatically
+         while (pattern_cont.find(matcher))
+            ++count;
+      }
       ret_tab[i] = count;
    }
 
@@ -31,7 +31,6 @@
 
 
 #include "stri_stringi.h"
-#include "stri_container_utf16.h"
 #include "stri_container_utf8.h"
 #include "stri_container_regex.h"
 
@@ -61,21 +60,31 @@
  *
  * @version 1.0-3 (Marek Gagolewski, 2016-02-03)
  *    FR #216: `negate` arg added
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels;
+ *    literal prefilter (StriContainerRegexPattern::mayMatch);
+ *    use StriRegexDFA if possible
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    anchored patterns (StriContainerRegexPattern::matchAnchored)
  */
 SEXP stri_detect_regex(SEXP str, SEXP pattern, SEXP negate, SEXP opts_regex)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str, pattern),
+      stri_detect_regex(str, pattern, negate, opts_regex))
+
    bool negate_1 = stri__prepare_arg_logical_1_notNA(negate, "negate");
    PROTECT(str = stri_prepare_arg_string(str, "str"));
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
    R_len_t vectorize_length =
       stri__recycling_rule(true, 2, LENGTH(str), LENGTH(pattern));
 
-   uint32_t pattern_flags = StriContainerRegexPattern::getRegexFlags(opts_regex);
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
 
    STRI__ERROR_HANDLER_BEGIN(2)
-   StriContainerUTF16 str_cont(str, vectorize_length);
-//   StriContainerUTF8 str_cont(str, vectorize_length); // utext_openUTF8, see below
-   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_flags);
+   StriContainerUTF8 str_cont(str, vectorize_length); // converted to UTF-16 on demand
+   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_opts);
 
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocVector(LGLSXP, vectorize_length));
@@ -88,20 +97,22 @@ SEXP stri_detect_regex(SEXP str, SEXP pattern, SEXP negate, SEXP opts_regex)
       STRI__CONTINUE_ON_EMPTY_OR_NA_PATTERN(str_cont,
          pattern_cont, ret_tab[i] = NA_LOGICAL)
 
-      RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
-      matcher->reset(str_cont.get(i));
-      ret_tab[i] = (int)matcher->find(); // returns UBool
+      const char* str_cur_s = str_cont.get(i).c_str();
+      R_len_t str_cur_n = str_cont.get(i).length();
+      int anchored = pattern_cont.matchAnchored(i, str_cur_s, str_cur_n);
+      if (anchored >= 0)
+         ret_tab[i] = anchored; // only a prefix or a suffix was examined
+      else if (!pattern_cont.mayMatch(i, str_cur_s, str_cur_n))
+         ret_tab[i] = FALSE; // no need to run the regex engine
+      else if (StriRegexDFA* dfa = pattern_cont.getDFA(i, str_cur_s, str_cur_n))
+         ret_tab[i] = (int)dfa->findAny(); // stops at the first match end
+      else {
+         // a UTF-16 copy is faster than utext_openUTF8
+         // (mbmark-regex-detect1.R: UTF16 0.07171792 s; UText 0.10531605 s)
+         RegexMatcher *matcher = pattern_cont.getMatcher(i, str_cur_s, str_cur_n); // will be deleted automatically
+         ret_tab[i] = (int)pattern_cont.find(matcher);
+      }
       if (negate_1) ret_tab[i] = !ret_tab[i];
-
-//      // mbmark-regex-detect1.R: UTF16 0.07171792 s; UText 0.10531605 s
-//      UText* str_text = NULL;
-//      UErrorCode status = U_ZERO_ERROR;
-//      RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
-//      str_text = utext_openUTF8(str_text, str_cont.get(i).c_str(), str_cont.get(i).length(), &status);
-//      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-//      matcher->reset(str_text);
-//      ret_tab[i] = (int)matcher->find(); // returns UBool
-//      utext_close(str_text);
    }
 
    STRI__UNPROTECT_ALL
@@ -33,7 +33,7 @@
 #include "stri_stringi.h"
 #include "stri_container_utf8.h"
 #include "stri_container_regex.h"
-#include <deque>
+#include "stri_flat_occurrences.h"
 #include <utility>
 using namespace std;
 
@@ -54,6 +54,12 @@ using namespace std;
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-29)
  *    Issue #214: allow a regex pattern like `.*`  to match an empty string
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriContainerRegexPattern::findLast
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriRegexDFA if possible
  */
 SEXP stri__extract_firstlast_regex(SEXP str, SEXP pattern, SEXP opts_regex, bool first)
 {
@@ -61,12 +67,12 @@ SEXP stri__extract_firstlast_regex(SEXP str, SEXP pattern, SEXP opts_regex, bool
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern")); // prepare string argument
    R_len_t vectorize_length = stri__recycling_rule(true, 2, LENGTH(str), LENGTH(pattern));
 
-   uint32_t pattern_flags = StriContainerRegexPattern::getRegexFlags(opts_regex);
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
 
    UText* str_text = NULL; // may potentially be slower, but definitely is more convenient!
    STRI__ERROR_HANDLER_BEGIN(2)
    StriContainerUTF8 str_cont(str, vectorize_length);
-   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_flags);
+   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_opts);
 
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocVector(STRSXP, vectorize_length));
@@ -78,31 +84,45 @@ SEXP stri__extract_firstlast_regex(SEXP str, SEXP pattern, SEXP opts_regex, bool
       STRI__CONTINUE_ON_EMPTY_OR_NA_PATTERN(str_cont, pattern_cont,
          SET_STRING_ELT(ret, i, NA_STRING);)
 
-      UErrorCode status = U_ZERO_ERROR;
-      RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
-      str_text = utext_openUTF8(str_text, str_cont.get(i).c_str(), str_cont.get(i).length(), &status);
-      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-
-      int m_start = -1;
-      int m_end = -1;
-      matcher->reset(str_text);
-      if ((int)matcher->find()) { // find first match
-         m_start = (int)matcher->start(status); // The **native** position in the input string :-)
-         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-         m_end   = (int)matcher->end(status);
-         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+      int64_t m_start = -1;
+      int64_t m_end = -1;
+      bool found = false;
+      if (StriRegexDFA* dfa = pattern_cont.getDFA(i, str_cont.get(i).c_str(), str_cont.get(i).length())) {
+         if (first)
+            found = dfa->find();
+         else {
+            while (dfa->find()) // the start is determined for the last match only
+               found = true;
+         }
+         if (found) {
+            m_start = dfa->start();
+            m_end = dfa->end();
+         }
       }
       else {
-         SET_STRING_ELT(ret, i, NA_STRING);
-         continue;
-      }
+         UErrorCode status = U_ZERO_ERROR;
+         RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
+         str_text = utext_openUTF8(str_text, str_cont.get(i).c_str(), str_cont.get(i).length(), &status);
+         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
 
-      if (!first) { // continue searching
-         while ((int)matcher->find()) {
-            m_start = (int)matcher->start(status);
-            m_end   = (int)matcher->end(status);
-            STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+         matcher->reset(str_text);
+         if (first) {
+            found = pattern_cont.find(matcher);
+            if (found) {
+               m_start = matcher->start64(status); // The **native** position in the input string :-)
+               STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+               m_end   = matcher->end64(status);
+               STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+            }
          }
+         else
+            found = pattern_cont.findLast(i, str_cont.get(i).c_str(),
+               str_cont.get(i).length(), m_start, m_end);
+      }
+
+      if (!found) {
+         SET_STRING_ELT(ret, i, NA_STRING);
+         continue;
       }
 
       SET_STRING_ELT(ret, i, Rf_mkCharLenCE(str_cont.get(i).c_str()+m_start, m_end-m_start, CE_UTF8));
@@ -155,10 +175,13 @@ SEXP stri_extract_last_regex(SEXP str, SEXP pattern, SEXP opts_regex)
  *
  * @param str character vector
  * @param pattern character vector
- * @param opts_regex list
  * @param simplify single logical value
+ * @param omit_no_match single logical value
+ * @param flat single logical value
+ * @param opts_regex list
  *
  * @return list of character vectors  or character matrix
+ *    or a list of 3 columns if \code{flat} is \code{TRUE}
  *
  * @version 0.1-?? (Marek Gagolewski, 2013-06-20)
  *
@@ -176,11 +199,21 @@ SEXP stri_extract_last_regex(SEXP str, SEXP pattern, SEXP opts_regex)
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-29)
  *    Issue #214: allow a regex pattern like `.*`  to match an empty string
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriRegexDFA if possible
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    new arg: flat
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
-SEXP stri_extract_all_regex(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_match, SEXP opts_regex)
+SEXP stri_extract_all_regex(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_match, SEXP flat, SEXP opts_regex)
 {
-   uint32_t pattern_flags = StriContainerRegexPattern::getRegexFlags(opts_regex);
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
    bool omit_no_match1 = stri__prepare_arg_logical_1_notNA(omit_no_match, "omit_no_match");
+   bool flat1 = stri__prepare_arg_logical_1_notNA(flat, "flat");
    PROTECT(simplify = stri_prepare_arg_logical_1(simplify, "simplify"));
    PROTECT(str = stri_prepare_arg_string(str, "str")); // prepare string argument
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern")); // prepare string argument
@@ -189,43 +222,59 @@ SEXP stri_extract_all_regex(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_
    UText* str_text = NULL; // may potentially be slower, but definitely is more convenient!
    STRI__ERROR_HANDLER_BEGIN(3)
    StriContainerUTF8 str_cont(str, vectorize_length);
-   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_flags);
+   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_opts);
 
    SEXP ret;
-   STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
+   STRI__PROTECT(ret = Rf_allocVector(VECSXP, flat1?0:vectorize_length));
+   StriFlatOccurrences flat_occurrences;
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
    {
       STRI__CONTINUE_ON_EMPTY_OR_NA_PATTERN(str_cont, pattern_cont,
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));)
-
-      UErrorCode status = U_ZERO_ERROR;
-      RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
-      str_text = utext_openUTF8(str_text, str_cont.get(i).c_str(), str_cont.get(i).length(), &status);
-      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+         if (flat1) flat_occurrences.addNA(i);
+         else SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));)
 
-      matcher->reset(str_text);
-
-      deque< pair<R_len_t, R_len_t> > occurrences;
-      while ((int)matcher->find()) {
-         occurrences.push_back(pair<R_len_t, R_len_t>(
-            (R_len_t)matcher->start(status), (R_len_t)matcher->end(status)
-         ));
+      occurrences.clear();
+      if (StriRegexDFA* dfa = pattern_cont.getDFA(i, str_cont.get(i).c_str(), str_cont.get(i).length())) {
+         while (dfa->find())
+            occurrences.push_back(pair<R_len_t, R_len_t>(dfa->start(), dfa->end()));
+      }
+      else {
+         UErrorCode status = U_ZERO_ERROR;
+         RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
+         str_text = utext_openUTF8(str_text, str_cont.get(i).c_str(), str_cont.get(i).length(), &status);
          STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+
+         matcher->reset(str_text);
+         while (pattern_cont.find(matcher)) {
+            occurrences.push_back(pair<R_len_t, R_len_t>(
+               (R_len_t)matcher->start(status), (R_len_t)matcher->end(status)
+            ));
+            STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+         }
       }
 
       R_len_t noccurrences = (R_len_t)occurrences.size();
       if (noccurrences <= 0) {
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(omit_no_match1?0:1));
+         if (!flat1)
+            SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(omit_no_match1?0:1));
+         else if (!omit_no_match1)
+            flat_occurrences.addNA(i);
+         continue;
+      }
+
+      if (flat1) {
+         flat_occurrences.add(i, occurrences);
          continue;
       }
 
       const char* str_cur_s = str_cont.get(i).c_str();
       SEXP cur_res;
       STRI__PROTECT(cur_res = Rf_allocVector(STRSXP, noccurrences));
-      deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+      StriOccurrences::iterator iter = occurrences.begin();
       for (R_len_t j = 0; iter != occurrences.end(); ++iter, ++j) {
          pair<R_len_t, R_len_t> curo = *iter;
          SET_STRING_ELT(cur_res, j,
@@ -240,7 +289,10 @@ SEXP stri_extract_all_regex(SEXP str, SEXP pattern, SEXP simplify, SEXP omit_no_
       str_text = NULL;
    }
 
-   if (LOGICAL(simplify)[0] == NA_LOGICAL) {
+   if (flat1) {
+      STRI__PROTECT(ret = flat_occurrences.toR(str_cont, NA_STRING));
+   }
+   else if (LOGICAL(simplify)[0] == NA_LOGICAL) {
       STRI__PROTECT(ret = stri_list2matrix(ret, Rf_ScalarLogical(TRUE),
          stri__vector_NA_strings(1), Rf_ScalarInteger(0)))
    }
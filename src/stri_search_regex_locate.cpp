@@ -31,19 +31,53 @@
 
 
 #include "stri_stringi.h"
-#include "stri_container_utf16.h"
+#include "stri_container_utf8_indexable.h"
 #include "stri_container_regex.h"
-#include <deque>
+#include "stri_flat_occurrences.h"
 #include <utility>
 using namespace std;
 
 
+/** Convert a UTF-16 index to a UTF-8 byte index
+ *
+ * Consecutive calls must be given nondecreasing indices,
+ * the string is walked through only once.
+ *
+ * @param str UTF-8 string
+ * @param str_n number of bytes in \code{str}
+ * @param i16 UTF-16 index
+ * @param j8 [in/out] current byte index, 0 on the first call
+ * @param j16 [in/out] current UTF-16 index, 0 on the first call
+ * @return byte index
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static R_len_t stri__locate_regex_utf8_index(const char* str, R_len_t str_n,
+   R_len_t i16, R_len_t& j8, R_len_t& j16)
+{
+   if (i16 < j16) { // not expected to happen
+      j8 = 0;
+      j16 = 0;
+   }
+
+   while (j16 < i16 && j8 < str_n) {
+      UChar32 c;
+      U8_NEXT(str, j8, str_n, c);
+      j16 += (c > 0xFFFF) ? 2 : 1; // invalid sequences become U+FFFD
+   }
+   return j8;
+}
+
+
 /** Locate all occurrences of a regex pattern
  *
  * @param str character vector
  * @param pattern character vector
+ * @param omit_no_match single logical value
+ * @param flat single logical value
  * @param opts_regex list
  * @return list of integer matrices (2 columns)
+ *    or a list of 4 columns if \code{flat} is \code{TRUE}
  *
  * @version 0.1-?? (Bartek Tartanus)
  *
@@ -61,63 +95,97 @@ using namespace std;
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-29)
  *    Issue #214: allow a regex pattern like `.*`  to match an empty string
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriRegexDFA if possible (on UTF-8 strings); ICU runs on a UTF-16 copy
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    new arg: flat
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
-SEXP stri_locate_all_regex(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP opts_regex)
+SEXP stri_locate_all_regex(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP flat, SEXP opts_regex)
 {
    // ??? @TODO: capture_group arg (integer vector which capture group to locate) ???
    // ??? OR introduce stri_matchpos_*_regex ???
    bool omit_no_match1 = stri__prepare_arg_logical_1_notNA(omit_no_match, "omit_no_match");
-   uint32_t pattern_flags = StriContainerRegexPattern::getRegexFlags(opts_regex);
+   bool flat1 = stri__prepare_arg_logical_1_notNA(flat, "flat");
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
    PROTECT(str = stri_prepare_arg_string(str, "str")); // prepare string argument
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern")); // prepare string argument
    R_len_t vectorize_length = stri__recycling_rule(true, 2, LENGTH(str), LENGTH(pattern));
 
    STRI__ERROR_HANDLER_BEGIN(2)
-   StriContainerUTF16 str_cont(str, vectorize_length);
-   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_flags);
+   StriContainerUTF8_indexable str_cont(str, vectorize_length);
+   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_opts);
 
    SEXP ret;
-   STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
+   STRI__PROTECT(ret = Rf_allocVector(VECSXP, flat1?0:vectorize_length));
+   StriFlatOccurrences flat_occurrences;
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
    {
       STRI__CONTINUE_ON_EMPTY_OR_NA_PATTERN(str_cont, pattern_cont,
-         SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(1, 2));)
+         if (flat1) flat_occurrences.addNA(i);
+         else SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(1, 2));)
 
-      RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
-      matcher->reset(str_cont.get(i));
-      int found = (int)matcher->find();
-      if (!found) {
-         SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(omit_no_match1?0:1, 2));
-         continue;
+      const char* str_cur_s = str_cont.get(i).c_str();
+      R_len_t str_cur_n = str_cont.get(i).length();
+      occurrences.clear();
+      if (StriRegexDFA* dfa = pattern_cont.getDFA(i, str_cur_s, str_cur_n)) {
+         while (dfa->find())
+            occurrences.push_back(pair<R_len_t, R_len_t>(dfa->start(), dfa->end()));
       }
-
-      deque< pair<R_len_t, R_len_t> > occurrences;
-      do {
+      else {
+         // a UTF-16 copy is faster than utext_openUTF8, see stri_detect_regex
          UErrorCode status = U_ZERO_ERROR;
-         int start = (int)matcher->start(status);
-         int end  =  (int)matcher->end(status);
-         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+         RegexMatcher *matcher = pattern_cont.getMatcher(i, str_cur_s, str_cur_n); // will be deleted automatically
+         while (pattern_cont.find(matcher)) {
+            occurrences.push_back(pair<R_len_t, R_len_t>(
+               (R_len_t)matcher->start(status), (R_len_t)matcher->end(status)
+            )); // UTF-16 indices
+            STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+         }
 
-         occurrences.push_back(pair<R_len_t, R_len_t>(start, end));
-         found = (int)matcher->find();
-      } while (found);
+         R_len_t j8 = 0, j16 = 0; // UTF-16 -> UTF-8 indices
+         for (StriOccurrences::iterator iter = occurrences.begin(); iter != occurrences.end(); ++iter) {
+            iter->first  = stri__locate_regex_utf8_index(str_cur_s, str_cur_n, iter->first, j8, j16);
+            iter->second = stri__locate_regex_utf8_index(str_cur_s, str_cur_n, iter->second, j8, j16);
+         }
+      }
 
       R_len_t noccurrences = (R_len_t)occurrences.size();
+      if (noccurrences <= 0) {
+         if (!flat1)
+            SET_VECTOR_ELT(ret, i, stri__matrix_NA_INTEGER(omit_no_match1?0:1, 2));
+         else if (!omit_no_match1)
+            flat_occurrences.addNA(i);
+         continue;
+      }
+
+      if (flat1) {
+         R_len_t k = flat_occurrences.add(i, occurrences);
+         str_cont.UTF8_to_UChar32_index(i, flat_occurrences.getStarts(k),
+            flat_occurrences.getEnds(k), noccurrences, 1, 0);
+         continue;
+      }
+
       SEXP ans;
       STRI__PROTECT(ans = Rf_allocMatrix(INTSXP, noccurrences, 2));
       int* ans_tab = INTEGER(ans);
-      deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+      StriOccurrences::iterator iter = occurrences.begin();
       for (R_len_t j = 0; iter != occurrences.end(); ++iter, ++j) {
          pair<R_len_t, R_len_t> match = *iter;
          ans_tab[j]             = match.first;
          ans_tab[j+noccurrences] = match.second;
       }
 
-      // Adjust UChar index -> UChar32 index (1-2 byte UTF16 to 1 byte UTF32-code points)
-      str_cont.UChar16_to_UChar32_index(i, ans_tab,
+      // Adjust UTF8 byte index -> UChar32 index
+      str_cont.UTF8_to_UChar32_index(i, ans_tab,
             ans_tab+noccurrences, noccurrences,
             1, // 0-based index -> 1-based
             0  // end returns position of next character after match
@@ -126,7 +194,11 @@ SEXP stri_locate_all_regex(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP opts
       STRI__UNPROTECT(1);
    }
 
-   stri__locate_set_dimnames_list(ret);
+   if (flat1) {
+      STRI__PROTECT(ret = flat_occurrences.toR());
+   }
+   else
+      stri__locate_set_dimnames_list(ret);
    STRI__UNPROTECT_ALL
    return ret;
    STRI__ERROR_HANDLER_END(;/* nothing special to be done on error */)
@@ -154,6 +226,12 @@ SEXP stri_locate_all_regex(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP opts
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-29)
  *    Issue #214: allow a regex pattern like `.*`  to match an empty string
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriContainerRegexPattern::findLast
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriRegexDFA if possible (on UTF-8 strings); ICU runs on a UTF-16 copy
  */
 SEXP stri__locate_firstlast_regex(SEXP str, SEXP pattern, SEXP opts_regex, bool first)
 {
@@ -161,11 +239,11 @@ SEXP stri__locate_firstlast_regex(SEXP str, SEXP pattern, SEXP opts_regex, bool
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern")); // prepare string argument
    R_len_t vectorize_length = stri__recycling_rule(true, 2, LENGTH(str), LENGTH(pattern));
 
-   uint32_t pattern_flags = StriContainerRegexPattern::getRegexFlags(opts_regex);
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
 
    STRI__ERROR_HANDLER_BEGIN(2)
-   StriContainerUTF16 str_cont(str, vectorize_length);
-   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_flags);
+   StriContainerUTF8_indexable str_cont(str, vectorize_length);
+   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_opts);
 
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocMatrix(INTSXP, vectorize_length, 2));
@@ -179,31 +257,56 @@ SEXP stri__locate_firstlast_regex(SEXP str, SEXP pattern, SEXP opts_regex, bool
       ret_tab[i+vectorize_length] = NA_INTEGER;
       STRI__CONTINUE_ON_EMPTY_OR_NA_PATTERN(str_cont, pattern_cont, ;/*nothing*/)
 
-      RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
-      matcher->reset(str_cont.get(i));
-
-      if ((int)matcher->find()) { //find first matches
-         UErrorCode status = U_ZERO_ERROR;
-         ret_tab[i] = (int)matcher->start(status);
-         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-         ret_tab[i+vectorize_length] = (int)matcher->end(status);
-         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+      const char* str_cur_s = str_cont.get(i).c_str();
+      R_len_t str_cur_n = str_cont.get(i).length();
+      int64_t m_start = -1, m_end = -1;
+      bool found = false;
+      if (StriRegexDFA* dfa = pattern_cont.getDFA(i, str_cur_s, str_cur_n)) {
+         if (first)
+            found = dfa->find();
+         else {
+            // the automaton is fast enough to enumerate all the matches;
+            // the start is determined for the last one only
+            while (dfa->find())
+               found = true;
+         }
+         if (found) {
+            m_start = dfa->start();
+            m_end = dfa->end();
+         }
       }
-      else
-         continue; // no match
+      else {
+         // a UTF-16 copy is faster than utext_openUTF8, see stri_detect_regex
+         UErrorCode status = U_ZERO_ERROR;
+         RegexMatcher *matcher = pattern_cont.getMatcher(i, str_cur_s, str_cur_n); // will be deleted automatically
 
-      if (!first) { // continue searching
-         while ((int)matcher->find()) {
-            UErrorCode status = U_ZERO_ERROR;
-            ret_tab[i]                  = (int)matcher->start(status);
-            STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-            ret_tab[i+vectorize_length] = (int)matcher->end(status);
-            STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+         if (first) {
+            found = pattern_cont.find(matcher);
+            if (found) {
+               m_start = matcher->start64(status); // UTF-16 index
+               STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+               m_end = matcher->end64(status);
+               STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+            }
+         }
+         else
+            found = pattern_cont.findLast(i, pattern_cont.getLastInput(), m_start, m_end);
+
+         if (found) { // UTF-16 -> UTF-8 indices
+            R_len_t j8 = 0, j16 = 0;
+            m_start = stri__locate_regex_utf8_index(str_cur_s, str_cur_n, (R_len_t)m_start, j8, j16);
+            m_end = stri__locate_regex_utf8_index(str_cur_s, str_cur_n, (R_len_t)m_end, j8, j16);
          }
       }
 
-      // Adjust UChar index -> UChar32 index (1-2 byte UTF16 to 1 byte UTF32-code points)
-      str_cont.UChar16_to_UChar32_index(i,
+      if (!found)
+         continue; // no match
+
+      ret_tab[i]                  = (int)m_start;
+      ret_tab[i+vectorize_length] = (int)m_end;
+
+      // Adjust UTF8 byte index -> UChar32 index
+      str_cont.UTF8_to_UChar32_index(i,
             ret_tab+i, ret_tab+i+vectorize_length, 1,
             1, // 0-based index -> 1-based
             0  // end returns position of next character after match
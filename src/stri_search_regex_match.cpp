@@ -33,8 +33,8 @@
 #include "stri_stringi.h"
 #include "stri_container_utf8.h"
 #include "stri_container_regex.h"
+#include "stri_flat_occurrences.h"
 #include <vector>
-#include <deque>
 #include <utility>
 using namespace std;
 
@@ -69,12 +69,12 @@ SEXP stri__match_firstlast_regex(SEXP str, SEXP pattern, SEXP cg_missing, SEXP o
    PROTECT(cg_missing = stri_prepare_arg_string_1(cg_missing, "cg_missing"));
    R_len_t vectorize_length = stri__recycling_rule(true, 2, LENGTH(str), LENGTH(pattern));
 
-   uint32_t pattern_flags = StriContainerRegexPattern::getRegexFlags(opts_regex);
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
 
    UText* str_text = NULL; // may potentially be slower, but definitely is more convenient!
    STRI__ERROR_HANDLER_BEGIN(3)
    StriContainerUTF8 str_cont(str, vectorize_length);
-   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_flags);
+   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_opts);
    StriContainerUTF8 cg_missing_cont(cg_missing, 1);
    STRI__PROTECT(cg_missing = STRING_ELT(cg_missing, 0));
 
@@ -99,7 +99,7 @@ SEXP stri__match_firstlast_regex(SEXP str, SEXP pattern, SEXP cg_missing, SEXP o
 
       occurrences[i] = vector< pair<const char*, const char*> >(pattern_cur_groups+1);
       matcher->reset(str_text);
-      while ((int)matcher->find()) {
+      while (pattern_cont.find(matcher)) {
          occurrences[i][0].first  = str_cur_s+(int)matcher->start(status);
          occurrences[i][0].second = str_cur_s+(int)matcher->end(status);
          for (R_len_t j=1; j<=pattern_cur_groups; ++j) {
@@ -188,9 +188,12 @@ SEXP stri_match_last_regex(SEXP str, SEXP pattern, SEXP cg_missing, SEXP opts_re
  *
  * @param str character vector
  * @param pattern character vector
- * @param opts_regex list
+ * @param omit_no_match single logical value
+ * @param flat single logical value
  * @param cg_missing single string
+ * @param opts_regex list
  * @return list of character matrices
+ *    or a list of columns if \code{flat} is \code{TRUE}
  *
  * @version 0.1-?? (Marek Gagolewski, 2013-06-22)
  *
@@ -205,27 +208,45 @@ SEXP stri_match_last_regex(SEXP str, SEXP pattern, SEXP cg_missing, SEXP opts_re
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-29)
  *    Issue #214: allow a regex pattern like `.*`  to match an empty string
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    new arg: flat
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
-SEXP stri_match_all_regex(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP cg_missing, SEXP opts_regex)
+SEXP stri_match_all_regex(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP flat, SEXP cg_missing, SEXP opts_regex)
 {
    bool omit_no_match1 = stri__prepare_arg_logical_1_notNA(omit_no_match, "omit_no_match");
+   bool flat1 = stri__prepare_arg_logical_1_notNA(flat, "flat");
    PROTECT(str = stri_prepare_arg_string(str, "str")); // prepare string argument
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern")); // prepare string argument
    PROTECT(cg_missing = stri_prepare_arg_string_1(cg_missing, "cg_missing"));
    R_len_t vectorize_length = stri__recycling_rule(true, 2, LENGTH(str), LENGTH(pattern));
 
-   uint32_t pattern_flags = StriContainerRegexPattern::getRegexFlags(opts_regex);
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
 
    UText* str_text = NULL; // may potentially be slower, but definitely is more convenient!
    STRI__ERROR_HANDLER_BEGIN(3)
    StriContainerUTF8 str_cont(str, vectorize_length);
-   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_flags);
+   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_opts);
    StriContainerUTF8 cg_missing_cont(cg_missing, 1);
    STRI__PROTECT(cg_missing = STRING_ELT(cg_missing, 0));
 
    SEXP ret;
-   STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
+   STRI__PROTECT(ret = Rf_allocVector(VECSXP, flat1?0:vectorize_length));
+
+   // the flat result has as many columns as the pattern with most capture groups
+   R_len_t flat_nbounds = 1;
+   for (R_len_t j = 0; flat1 && j < LENGTH(pattern) && j < vectorize_length; ++j) {
+      if (!pattern_cont.isNA(j) && pattern_cont.get(j).length() > 0) {
+         R_len_t cur_nbounds = (R_len_t)pattern_cont.getMatcher(j)->groupCount()+1;
+         if (flat_nbounds < cur_nbounds) flat_nbounds = cur_nbounds;
+      }
+   }
+   StriFlatOccurrences flat_occurrences(flat_nbounds);
 
+   StriOccurrences occurrences; // reused across strings
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
@@ -233,7 +254,8 @@ SEXP stri_match_all_regex(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP cg_mi
       if ((pattern_cont).isNA(i) || (pattern_cont).get(i).length() <= 0) {
          if (!(pattern_cont).isNA(i))
             Rf_warning(MSG__EMPTY_SEARCH_PATTERN_UNSUPPORTED);
-         SET_VECTOR_ELT(ret, i, stri__matrix_NA_STRING(1, 1));                                                                                  \
+         if (flat1) flat_occurrences.addNA(i);
+         else SET_VECTOR_ELT(ret, i, stri__matrix_NA_STRING(1, 1));                                                                                  \
          continue;
       }
 
@@ -242,7 +264,8 @@ SEXP stri_match_all_regex(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP cg_mi
       int pattern_cur_groups = matcher->groupCount();
 
       if ((str_cont).isNA(i)) {
-         SET_VECTOR_ELT(ret, i, stri__matrix_NA_STRING(1, pattern_cur_groups+1));
+         if (flat1) flat_occurrences.addNA(i);
+         else SET_VECTOR_ELT(ret, i, stri__matrix_NA_STRING(1, pattern_cur_groups+1));
          continue;
       }
 
@@ -251,8 +274,8 @@ SEXP stri_match_all_regex(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP cg_mi
 
       matcher->reset(str_text);
 
-      deque< pair<R_len_t, R_len_t> > occurrences;
-      while ((int)matcher->find()) {
+      occurrences.clear();
+      while (pattern_cont.find(matcher)) {
          occurrences.push_back(pair<R_len_t, R_len_t>((R_len_t)matcher->start(status), (R_len_t)matcher->end(status)));
          for (R_len_t j=0; j<pattern_cur_groups; ++j)
             occurrences.push_back(pair<R_len_t, R_len_t>((R_len_t)matcher->start(j+1, status), (R_len_t)matcher->end(j+1, status)));
@@ -261,14 +284,22 @@ SEXP stri_match_all_regex(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP cg_mi
 
       R_len_t noccurrences = (R_len_t)occurrences.size()/(pattern_cur_groups+1);
       if (noccurrences <= 0) {
-         SET_VECTOR_ELT(ret, i, stri__matrix_NA_STRING(omit_no_match1?0:1, pattern_cur_groups+1));
+         if (!flat1)
+            SET_VECTOR_ELT(ret, i, stri__matrix_NA_STRING(omit_no_match1?0:1, pattern_cur_groups+1));
+         else if (!omit_no_match1)
+            flat_occurrences.addNA(i);
+         continue;
+      }
+
+      if (flat1) {
+         flat_occurrences.add(i, occurrences, pattern_cur_groups+1);
          continue;
       }
 
       const char* str_cur_s = str_cont.get(i).c_str();
       SEXP cur_res;
       STRI__PROTECT(cur_res = Rf_allocMatrix(STRSXP, noccurrences, pattern_cur_groups+1));
-      deque< pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+      StriOccurrences::iterator iter = occurrences.begin();
       for (R_len_t j = 0; iter != occurrences.end(); ++j) {
          pair<R_len_t, R_len_t> curo = *iter;
          SET_STRING_ELT(cur_res, j, Rf_mkCharLenCE(str_cur_s+curo.first, curo.second-curo.first, CE_UTF8));
@@ -290,6 +321,11 @@ SEXP stri_match_all_regex(SEXP str, SEXP pattern, SEXP omit_no_match, SEXP cg_mi
       utext_close(str_text);
       str_text = NULL;
    }
+
+   if (flat1) {
+      STRI__PROTECT(ret = flat_occurrences.toR(str_cont, cg_missing));
+   }
+
    STRI__UNPROTECT_ALL
    return ret;
    STRI__ERROR_HANDLER_END(if (str_text) utext_close(str_text);)
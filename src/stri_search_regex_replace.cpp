@@ -31,8 +31,325 @@
 
 
 #include "stri_stringi.h"
-#include "stri_container_utf16.h"
+#include "stri_container_utf8.h"
 #include "stri_container_regex.h"
+#include "stri_string8buf.h"
+#include <vector>
+
+
+/**
+ * A replacement string with its capture group references
+ * resolved in advance [internal]
+ *
+ * Follows the syntax of ICU's \code{RegexMatcher::appendReplacement}:
+ * \code{$n} and \code{${name}} refer to capture groups
+ * (the digits are consumed as long as the group number does not exceed
+ * the number of groups in the pattern), a backslash quotes the
+ * character that follows, and \code{\\uhhhh} and \code{\\Uhhhhhhhh}
+ * denote Unicode code points.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriRegexReplacement {
+
+   private:
+
+      std::string literal; ///< literal parts, UTF-8
+      std::vector<int32_t> parts; ///< group numbers or, if < 0, ~(end of a literal part)
+
+
+      /** state of u_unescapeAt() reading from \code{text},
+       * mimics ICU's \code{URegexUTextUnescapeCharContext}
+       */
+      struct UnescapeContext {
+         const UnicodeString* text;
+         int32_t pos;        ///< current code unit index
+         int32_t lastOffset; ///< offset of the recently read code point
+      };
+
+
+      /** move \code{pos} by \code{delta} code points
+       * (like \code{utext_moveIndex32}) */
+      static inline int32_t moveIndex(const UnicodeString& text, int32_t pos, int32_t delta)
+      {
+         return text.moveIndex32(pos, delta);
+      }
+
+
+      /** a callback for u_unescapeAt(); as in ICU, the characters are
+       * consumed as they are read */
+      static UChar U_CALLCONV unescapeCharAt(int32_t offset, void* ctx)
+      {
+         UnescapeContext* context = (UnescapeContext*)ctx;
+         const UnicodeString& text = *(context->text);
+         int32_t n = text.length();
+         UChar32 c;
+         if (offset == context->lastOffset + 1) {
+            c = (context->pos < n)?text.char32At(context->pos):U_SENTINEL;
+            context->pos = moveIndex(text, context->pos, 1);
+            context->lastOffset++;
+         }
+         else if (offset == context->lastOffset) {
+            int32_t prev = moveIndex(text, context->pos, -1);
+            c = (context->pos > 0)?text.char32At(prev):U_SENTINEL;
+         }
+         else {
+            context->pos = moveIndex(text, context->pos, offset - context->lastOffset - 1);
+            c = (context->pos < n)?text.char32At(context->pos):U_SENTINEL;
+            context->pos = moveIndex(text, context->pos, 1);
+            context->lastOffset = offset;
+         }
+         return (UChar)c;
+      }
+
+
+      /** flush the pending literal text */
+      void addLiteral(const UnicodeString& lit)
+      {
+         if (lit.length() <= 0) return;
+         lit.toUTF8String(literal);
+         parts.push_back(~(int32_t)literal.size());
+      }
+
+
+   public:
+
+      /** parse a replacement string
+       *
+       * @param replacement UTF-8 replacement string
+       * @param matcher a matcher, used to resolve group numbers and names
+       */
+      StriRegexReplacement(const String8& replacement, RegexMatcher* matcher)
+      {
+         UnicodeString r = UnicodeString::fromUTF8(
+            StringPiece(replacement.c_str(), replacement.length()));
+         int32_t n = r.length();
+         int32_t ngroups = matcher->groupCount();
+         UErrorCode status = U_ZERO_ERROR;
+         UnicodeString lit;
+
+         int32_t k = 0;
+         while (k < n) {
+            UChar32 c = r.char32At(k);
+            k = r.moveIndex32(k, 1);
+
+            if (c == (UChar32)'\\') {
+               if (k >= n) break;
+               c = r.char32At(k);
+               if (c == (UChar32)'u' || c == (UChar32)'U') {
+                  // exactly as in RegexMatcher::appendReplacement,
+                  // including the handling of malformed escapes
+                  UnescapeContext context = { &r, k, -1 };
+                  int32_t offset = 0;
+                  UChar32 e = u_unescapeAt(unescapeCharAt, &offset, INT32_MAX, &context);
+                  k = context.pos;
+                  if (e != (UChar32)0xFFFFFFFF) {
+                     if (U_IS_BMP(e)) lit.append((UChar)e);
+                     else lit.append(e);
+                     if (context.lastOffset == offset)
+                        k = moveIndex(r, k, -1);
+                     else if (context.lastOffset != offset-1)
+                        k = moveIndex(r, k, offset - context.lastOffset - 1);
+                  }
+               }
+               else {
+                  lit.append(c);
+                  k = r.moveIndex32(k, 1);
+               }
+               continue;
+            }
+            else if (c != (UChar32)'$') {
+               lit.append(c);
+               continue;
+            }
+
+            // $n or ${name}
+            UChar32 next = (k < n)?r.char32At(k):U_SENTINEL;
+            int32_t group = 0;
+#if U_ICU_VERSION_MAJOR_NUM >= 55
+            if (next == (UChar32)'{') {
+               UnicodeString name;
+               for (k = r.moveIndex32(k, 1); U_SUCCESS(status); ) {
+                  if (k >= n) {
+                     status = U_REGEX_INVALID_CAPTURE_GROUP_NAME;
+                     break;
+                  }
+                  next = r.char32At(k);
+                  k = r.moveIndex32(k, 1);
+                  if ((next >= 0x41 && next <= 0x5a) ||  // A..Z
+                      (next >= 0x61 && next <= 0x7a) ||  // a..z
+                      (next >= 0x31 && next <= 0x39)) {  // 1..9, as in ICU
+                     name.append(next);
+                  }
+                  else if (next == (UChar32)'}') {
+                     group = matcher->pattern().groupNumberFromName(name, status);
+                     if (U_SUCCESS(status) && group <= 0)
+                        status = U_REGEX_INVALID_CAPTURE_GROUP_NAME;
+                     break;
+                  }
+                  else
+                     status = U_REGEX_INVALID_CAPTURE_GROUP_NAME;
+               }
+            }
+            else
+#endif
+            if (next != U_SENTINEL && u_isdigit(next)) {
+               int32_t ndigits = 0;
+               while (k < n) {
+                  next = r.char32At(k);
+                  if (!u_isdigit(next)) break;
+                  int32_t digit = u_charDigitValue(next);
+                  if (group*10+digit > ngroups) {
+                     if (ndigits == 0) status = U_INDEX_OUTOFBOUNDS_ERROR;
+                     break;
+                  }
+                  k = r.moveIndex32(k, 1);
+                  group = group*10+digit;
+                  ++ndigits;
+               }
+            }
+            else {
+#if U_ICU_VERSION_MAJOR_NUM >= 55
+               status = U_REGEX_INVALID_CAPTURE_GROUP_NAME;
+#else
+               lit.append(c); // a `$` on its own
+               continue;
+#endif
+            }
+
+            STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+            addLiteral(lit);
+            lit.remove();
+            parts.push_back(group);
+         }
+
+         addLiteral(lit);
+      }
+
+
+      /** append the replacement for the current match to a buffer
+       *
+       * @param buf output buffer
+       * @param buf_used number of bytes already in use
+       * @param matcher a matcher reset with a UTF-8 UText over \code{str}
+       * @param str haystack
+       * @return new number of bytes in use
+       */
+      R_len_t append(String8buf& buf, R_len_t buf_used, RegexMatcher* matcher, const char* str)
+      {
+         R_len_t lastpos = 0;
+         UErrorCode status = U_ZERO_ERROR;
+         for (size_t j = 0; j < parts.size(); ++j) {
+            if (parts[j] < 0) {
+               R_len_t endpos = (R_len_t)~parts[j];
+               buf_used = buf.append(buf_used, literal.data()+lastpos, endpos-lastpos);
+               lastpos = endpos;
+            }
+            else {
+               int64_t start = matcher->start64(parts[j], status);
+               int64_t end = matcher->end64(parts[j], status);
+               STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+               if (start >= 0) // group participated in the match
+                  buf_used = buf.append(buf_used, str+start, (R_len_t)(end-start));
+            }
+         }
+         return buf_used;
+      }
+};
+
+
+/**
+ * Parsed replacement strings, indexed by replacement number [internal]
+ *
+ * A replacement is parsed once and reused as long as it is applied
+ * with the same pattern (group numbers and names depend on the latter).
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriRegexReplacementCache {
+
+   private:
+
+      std::vector<StriRegexReplacement*> parsed;
+      std::vector<R_len_t> parsed_pattern; ///< pattern index used to parse each entry
+
+      StriRegexReplacementCache(const StriRegexReplacementCache&); // no copy
+      StriRegexReplacementCache& operator=(const StriRegexReplacementCache&);
+
+
+   public:
+
+      /** @param n number of distinct replacements */
+      StriRegexReplacementCache(R_len_t n)
+         : parsed(n, (StriRegexReplacement*)NULL), parsed_pattern(n, -1)
+      {
+      }
+
+
+      ~StriRegexReplacementCache()
+      {
+         for (size_t j = 0; j < parsed.size(); ++j)
+            if (parsed[j]) delete parsed[j];
+      }
+
+
+      /** get a parsed replacement, parse it if necessary
+       *
+       * @param replacement_idx index of the replacement, in [0, n)
+       * @param pattern_idx index of the pattern compiled into \code{matcher}
+       * @param replacement replacement string
+       * @param matcher a matcher for the pattern
+       * @return parsed replacement
+       */
+      StriRegexReplacement& get(R_len_t replacement_idx, R_len_t pattern_idx,
+         const String8& replacement, RegexMatcher* matcher)
+      {
+         StriRegexReplacement*& cur = parsed[replacement_idx];
+         if (!cur || parsed_pattern[replacement_idx] != pattern_idx) {
+            if (cur) {
+               delete cur;
+               cur = NULL;
+            }
+            cur = new StriRegexReplacement(replacement, matcher);
+            parsed_pattern[replacement_idx] = pattern_idx;
+         }
+         return *cur;
+      }
+};
+
+
+/**
+ * Replace regex pattern occurrences in a single UTF-8 string [internal]
+ *
+ * The matcher must have found the first match in \code{str} already.
+ *
+ * @param buf output buffer
+ * @param str haystack
+ * @param str_n number of bytes in \code{str}
+ * @param replacement replacement string
+ * @param matcher a matcher reset with a UTF-8 UText over \code{str}
+ * @param type 0 for all, 1 for first
+ * @return number of bytes in \code{buf}
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t stri__replace_regex_utf8(String8buf& buf, const char* str, R_len_t str_n,
+   StriRegexReplacement& replacement, RegexMatcher* matcher, int type)
+{
+   R_len_t buf_used = 0;
+   R_len_t jlast = 0;
+   UErrorCode status = U_ZERO_ERROR;
+   do {
+      R_len_t start = (R_len_t)matcher->start64(status);
+      R_len_t end = (R_len_t)matcher->end64(status);
+      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+      buf_used = buf.append(buf_used, str+jlast, start-jlast);
+      buf_used = replacement.append(buf, buf_used, matcher, str);
+      jlast = end;
+   } while (type == 0 && StriContainerRegexPattern::find(matcher));
+
+   return buf.append(buf_used, str+jlast, str_n-jlast);
+}
 
 
 /**
@@ -63,19 +380,29 @@
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-30)
  *    Issue #210: Allow NA replacement
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    return the original CHARSXP if there is no match;
+ *    use StriContainerRegexPattern::findLast;
+ *    search in UTF-8 directly (via UText), expand group references
+ *    with StriRegexReplacement into a reusable String8buf;
+ *    each distinct replacement is parsed only once
  */
 SEXP stri__replace_allfirstlast_regex(SEXP str, SEXP pattern, SEXP replacement, SEXP opts_regex, int type)
 {
    PROTECT(str = stri_prepare_arg_string(str, "str"));
    PROTECT(replacement = stri_prepare_arg_string(replacement, "replacement"));
    PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
-   uint32_t pattern_flags = StriContainerRegexPattern::getRegexFlags(opts_regex);
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
 
+   UText* str_text = NULL;
    STRI__ERROR_HANDLER_BEGIN(3)
    R_len_t vectorize_length = stri__recycling_rule(true, 3, LENGTH(str), LENGTH(pattern), LENGTH(replacement));
-   StriContainerUTF16 str_cont(str, vectorize_length, false); // writable
-   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_flags);
-   StriContainerUTF16 replacement_cont(replacement, vectorize_length);
+   StriContainerUTF8 str_cont(str, vectorize_length);
+   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_opts);
+   StriContainerUTF8 replacement_cont(replacement, vectorize_length);
+   StriRegexReplacementCache replacement_cache(replacement_cont.get_n());
+   String8buf buf(0); // reused, grows as needed
 
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocVector(STRSXP, vectorize_length));
@@ -87,54 +414,49 @@ SEXP stri__replace_allfirstlast_regex(SEXP str, SEXP pattern, SEXP replacement,
       STRI__CONTINUE_ON_EMPTY_OR_NA_PATTERN(str_cont, pattern_cont,
          SET_STRING_ELT(ret, i, NA_STRING);)
 
+      const char* str_cur_s = str_cont.get(i).c_str();
+      R_len_t str_cur_n = str_cont.get(i).length();
+
+      UErrorCode status = U_ZERO_ERROR;
       RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
-      matcher->reset(str_cont.get(i));
+      str_text = utext_openUTF8(str_text, str_cur_s, str_cur_n, &status);
+      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+      matcher->reset(str_text);
 
-      if (replacement_cont.isNA(i)) {
-         if (matcher->find())
-            str_cont.setNA(i);
+      if (!pattern_cont.find(matcher)) { // no match - the string is left as-is
          SET_STRING_ELT(ret, i, str_cont.toR(i));
          continue;
       }
 
-      UErrorCode status = U_ZERO_ERROR;
-      if (type == 0) { // all
-         str_cont.set(i, matcher->replaceAll(replacement_cont.get(i), status));
-         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+      if (replacement_cont.isNA(i)) {
+         SET_STRING_ELT(ret, i, NA_STRING);
+         continue;
       }
-      else if (type == 1) { // first
-         str_cont.set(i, matcher->replaceFirst(replacement_cont.get(i), status));
+
+      StriRegexReplacement& replacement_cur = replacement_cache.get(
+         i % replacement_cont.get_n(), i % pattern_cont.get_n(),
+         replacement_cont.get(i), matcher);
+      if (type == -1) { // last
+         int64_t start = -1;
+         int64_t end = -1;
+         matcher->reset();
+         pattern_cont.findLast(i, str_cur_s, str_cur_n, start, end);
+         matcher->find(start, status); // go back, restore the groups
          STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
       }
-      else if (type == -1) { // end
-         int start = -1;
-         int end = -1;
-         while (matcher->find()) { // find last match
-            start = matcher->start(status);
-            STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-            end = matcher->end(status);
-            STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-         }
-         if (start >= 0) {
-            matcher->find(start, status); // go back
-            STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-            UnicodeString out;
-            matcher->appendReplacement(out, replacement_cont.get(i), status);
-            STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-            out.append(str_cont.get(i), end, str_cont.get(i).length()-end);
-            str_cont.set(i, out);
-         }
-      }
-      else {
-         throw StriException(MSG__INTERNAL_ERROR);
-      }
 
-      SET_STRING_ELT(ret, i, str_cont.toR(i));
+      R_len_t buf_used = stri__replace_regex_utf8(buf, str_cur_s, str_cur_n,
+         replacement_cur, matcher, (type == 0)?0:1);
+      SET_STRING_ELT(ret, i, Rf_mkCharLenCE(buf.data(), buf_used, CE_UTF8));
    }
 
+   if (str_text) {
+      utext_close(str_text);
+      str_text = NULL;
+   }
    STRI__UNPROTECT_ALL
    return ret;
-   STRI__ERROR_HANDLER_END(;/* nothing special to be done on error */)
+   STRI__ERROR_HANDLER_END(if (str_text) utext_close(str_text);)
 }
 
 
@@ -157,6 +479,10 @@ SEXP stri__replace_allfirstlast_regex(SEXP str, SEXP pattern, SEXP replacement,
  *
  * @version 1.0-2 (Marek Gagolewski, 2016-01-30)
  *    Issue #210: Allow NA replacement
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    return the original CHARSXPs of unaltered strings;
+ *    operate on UTF-8 strings directly
  */
 SEXP stri__replace_all_regex_no_vectorize_all(SEXP str, SEXP pattern, SEXP replacement, SEXP opts_regex)
 { // version beta
@@ -171,7 +497,7 @@ SEXP stri__replace_all_regex_no_vectorize_all(SEXP str, SEXP pattern, SEXP repla
 
    PROTECT(pattern      = stri_prepare_arg_string(pattern, "pattern"));
    PROTECT(replacement  = stri_prepare_arg_string(replacement, "replacement"));
-   uint32_t pattern_flags = StriContainerRegexPattern::getRegexFlags(opts_regex);
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
 
    R_len_t pattern_n = LENGTH(pattern);
    R_len_t replacement_n = LENGTH(replacement);
@@ -189,18 +515,29 @@ SEXP stri__replace_all_regex_no_vectorize_all(SEXP str, SEXP pattern, SEXP repla
       return ret;
    }
 
+   UText* str_text = NULL;
    STRI__ERROR_HANDLER_BEGIN(3)
-   StriContainerUTF16 str_cont(str, str_n, false); // writable
-   StriContainerRegexPattern pattern_cont(pattern, pattern_n, pattern_flags);
-   StriContainerUTF16 replacement_cont(replacement, pattern_n);
+   StriContainerUTF8 str_cont(str, str_n, false); // writable
+   StriContainerRegexPattern pattern_cont(pattern, pattern_n, pattern_opts);
+   StriContainerUTF8 replacement_cont(replacement, pattern_n);
+   StriRegexReplacementCache replacement_cache(replacement_n);
+   String8buf buf(0); // reused, grows as needed
 
    for (R_len_t i = 0; i<pattern_n; ++i)
    {
       if (pattern_cont.isNA(i)) {
+         if (str_text) {
+            utext_close(str_text);
+            str_text = NULL;
+         }
          STRI__UNPROTECT_ALL
          return stri__vector_NA_strings(str_n);
       }
       else if (pattern_cont.get(i).length() <= 0) {
+         if (str_text) {
+            utext_close(str_text);
+            str_text = NULL;
+         }
          Rf_warning(MSG__EMPTY_SEARCH_PATTERN_UNSUPPORTED);
          STRI__UNPROTECT_ALL
          return stri__vector_NA_strings(str_n);
@@ -211,23 +548,37 @@ SEXP stri__replace_all_regex_no_vectorize_all(SEXP str, SEXP pattern, SEXP repla
       for (R_len_t j = 0; j<str_n; ++j) {
          if (str_cont.isNA(j)) continue;
 
-         matcher->reset(str_cont.get(j));
+         UErrorCode status = U_ZERO_ERROR;
+         str_text = utext_openUTF8(str_text, str_cont.get(j).c_str(), str_cont.get(j).length(), &status);
+         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+         matcher->reset(str_text);
+         if (!pattern_cont.find(matcher))
+            continue; // nothing to do
 
          if (replacement_cont.isNA(i)) {
-            if (matcher->find())
-               str_cont.setNA(j);
+            str_cont.setNA(j);
             continue;
          }
 
-         UErrorCode status = U_ZERO_ERROR;
-         str_cont.set(j, matcher->replaceAll(replacement_cont.get(i), status));
-         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+         StriRegexReplacement& replacement_cur = replacement_cache.get(
+            i % replacement_n, i, replacement_cont.get(i), matcher);
+         R_len_t buf_used = stri__replace_regex_utf8(buf,
+            str_cont.get(j).c_str(), str_cont.get(j).length(),
+            replacement_cur, matcher, 0);
+
+         String8& str_cur = str_cont.getWritable(j);
+         str_cur.setNA();
+         str_cur.initialize(buf.data(), buf_used, true/*memalloc*/, false/*killbom*/, false/*isASCII*/);
       }
    }
 
+   if (str_text) {
+      utext_close(str_text);
+      str_text = NULL;
+   }
    STRI__UNPROTECT_ALL
    return str_cont.toR();
-   STRI__ERROR_HANDLER_END(;/* nothing special to be done on error */)
+   STRI__ERROR_HANDLER_END(if (str_text) utext_close(str_text);)
 }
 
 
@@ -275,10 +626,20 @@ SEXP stri__replace_all_regex_no_vectorize_all(SEXP str, SEXP pattern, SEXP repla
  *
  * @version 0.3-1 (Marek Gagolewski, 2014-11-01)
  *          vectorize_all argument added
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_replace_all_regex(SEXP str, SEXP pattern, SEXP replacement, SEXP vectorize_all, SEXP opts_regex)
 {
-   if (stri__prepare_arg_logical_1_notNA(vectorize_all, "vectorize_all"))
+   // with vectorize_all=FALSE, each string is matched against all the patterns
+   bool vectorize_all_1 = stri__prepare_arg_logical_1_notNA(vectorize_all, "vectorize_all");
+   STRI__FACTOR_BY_LEVELS(str, (vectorize_all_1
+         ? stri__factor_by_levels(str, pattern, replacement)
+         : stri__factor_by_levels(str)),
+      stri_replace_all_regex(str, pattern, replacement, vectorize_all, opts_regex))
+
+   if (vectorize_all_1)
       return stri__replace_allfirstlast_regex(str, pattern, replacement, opts_regex, 0);
    else
       return stri__replace_all_regex_no_vectorize_all(str, pattern, replacement, opts_regex);
@@ -295,9 +656,15 @@ SEXP stri_replace_all_regex(SEXP str, SEXP pattern, SEXP replacement, SEXP vecto
  * @return character vector
  *
  * @version 0.1-?? (Marek Gagolewski, 2013-06-21)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_replace_first_regex(SEXP str, SEXP pattern, SEXP replacement, SEXP opts_regex)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str, pattern, replacement),
+      stri_replace_first_regex(str, pattern, replacement, opts_regex))
+
    return stri__replace_allfirstlast_regex(str, pattern, replacement, opts_regex, 1);
 }
 
@@ -312,8 +679,14 @@ SEXP stri_replace_first_regex(SEXP str, SEXP pattern, SEXP replacement, SEXP opt
  * @return character vector
  *
  * @version 0.1-?? (Marek Gagolewski, 2013-06-21)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_replace_last_regex(SEXP str, SEXP pattern, SEXP replacement, SEXP opts_regex)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str, pattern, replacement),
+      stri_replace_last_regex(str, pattern, replacement, opts_regex))
+
    return stri__replace_allfirstlast_regex(str, pattern, replacement, opts_regex, -1);
 }
@@ -0,0 +1,190 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "stri_stringi.h"
+#include "stri_container_utf8.h"
+#include "stri_container_regex.h"
+#include <vector>
+
+
+/**
+ * Detect which of many regex patterns occur in each string
+ *
+ * Patterns supported by StriRegexDFA are matched all at once,
+ * in a single pass over each string (StriRegexDFASet).
+ * The remaining ones are processed one by one (with ICU and the literal
+ * prefilter, see StriContainerRegexPattern::mayMatch),
+ * so that each of them is compiled only once.
+ *
+ * @param str character vector
+ * @param pattern character vector
+ * @param opts_regex list
+ * @param which return a list of integer vectors (indices of matching
+ *    patterns) instead of a logical matrix?
+ * @return logical matrix with \code{length(str)} rows
+ *    and \code{length(pattern)} columns or a list
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri__detect_regex_set(SEXP str, SEXP pattern, SEXP opts_regex, bool which)
+{
+   PROTECT(str = stri_prepare_arg_string(str, "str"));
+   PROTECT(pattern = stri_prepare_arg_string(pattern, "pattern"));
+   R_len_t str_length = LENGTH(str);
+   R_len_t pattern_length = LENGTH(pattern);
+
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
+
+   STRI__ERROR_HANDLER_BEGIN(2)
+   StriContainerUTF8 str_cont(str, str_length);
+   StriContainerRegexPattern pattern_cont(pattern, pattern_length, pattern_opts);
+   pattern_opts = pattern_cont.getOptions(); // compiled patterns have their own
+   StriRegexDFASet pattern_set(pattern_opts.flags);
+
+   SEXP ret;
+   STRI__PROTECT(ret = Rf_allocMatrix(LGLSXP, str_length, pattern_length));
+   int* ret_tab = LOGICAL(ret);
+
+   std::vector<bool> in_set(pattern_length, false);
+   for (R_len_t j=0; j<pattern_length; ++j) {
+      bool na = pattern_cont.isNA(j);
+      if (!na && pattern_cont.get(j).length() <= 0) {
+         Rf_warning(MSG__EMPTY_SEARCH_PATTERN_UNSUPPORTED);
+         na = true;
+      }
+
+      for (R_len_t i=0; i<str_length; ++i)
+         ret_tab[i+j*str_length] = (na || str_cont.isNA(i))?NA_LOGICAL:FALSE;
+
+      if (!na) {
+         pattern_cont.getMatcher(j); // syntax errors are reported by ICU
+         if (!(pattern_opts.flags & STRI__REGEX_NO_DFA))
+            in_set[j] = pattern_set.add(pattern_cont.get(j), j);
+      }
+   }
+
+   // all the patterns in the set - one pass over each string
+   std::vector<bool> str_valid(str_length, false);
+   std::vector<int32_t> ids;
+   for (R_len_t i=0; i<str_length; ++i) {
+      if (str_cont.isNA(i))
+         continue;
+      const char* str_cur_s = str_cont.get(i).c_str();
+      R_len_t str_cur_n = str_cont.get(i).length();
+      str_valid[i] = stri__utf8_is_valid(str_cur_s, str_cur_n);
+      if (!str_valid[i] || pattern_set.size() <= 0)
+         continue;
+
+      pattern_set.find(str_cur_s, str_cur_n, ids);
+      for (size_t k=0; k<ids.size(); ++k)
+         ret_tab[i+ids[k]*str_length] = TRUE;
+   }
+
+   // other patterns (and strings that are not valid UTF-8) - one by one
+   for (R_len_t j=0; j<pattern_length; ++j) {
+      if (pattern_cont.isNA(j) || pattern_cont.get(j).length() <= 0)
+         continue;
+
+      for (R_len_t i=0; i<str_length; ++i) {
+         if (str_cont.isNA(i) || (in_set[j] && str_valid[i]))
+            continue;
+
+         const char* str_cur_s = str_cont.get(i).c_str();
+         R_len_t str_cur_n = str_cont.get(i).length();
+         if (!pattern_cont.mayMatch(j, str_cur_s, str_cur_n))
+            continue; // no need to run the regex engine
+
+         RegexMatcher *matcher = pattern_cont.getMatcher(j, str_cur_s, str_cur_n); // will be deleted automatically
+         ret_tab[i+j*str_length] = (int)pattern_cont.find(matcher);
+      }
+   }
+
+   if (which) {
+      SEXP ret_which;
+      STRI__PROTECT(ret_which = Rf_allocVector(VECSXP, str_length));
+      for (R_len_t i=0; i<str_length; ++i) {
+         if (str_cont.isNA(i)) {
+            SET_VECTOR_ELT(ret_which, i, Rf_ScalarInteger(NA_INTEGER));
+            continue;
+         }
+
+         R_len_t nmatches = 0;
+         for (R_len_t j=0; j<pattern_length; ++j)
+            if (ret_tab[i+j*str_length] == TRUE) ++nmatches;
+
+         SEXP cur;
+         STRI__PROTECT(cur = Rf_allocVector(INTSXP, nmatches));
+         int* cur_tab = INTEGER(cur);
+         for (R_len_t j=0, k=0; j<pattern_length; ++j)
+            if (ret_tab[i+j*str_length] == TRUE) cur_tab[k++] = j+1;
+         SET_VECTOR_ELT(ret_which, i, cur);
+         STRI__UNPROTECT(1);
+      }
+      ret = ret_which;
+   }
+
+   STRI__UNPROTECT_ALL
+   return ret;
+   STRI__ERROR_HANDLER_END(;/* nothing special to be done on error */)
+}
+
+
+/**
+ * Detect which of many regex patterns occur in each string
+ *
+ * @param str character vector
+ * @param pattern character vector
+ * @param opts_regex list
+ * @return logical matrix
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri_detect_regex_set(SEXP str, SEXP pattern, SEXP opts_regex)
+{
+   return stri__detect_regex_set(str, pattern, opts_regex, false);
+}
+
+
+/**
+ * Get the indices of the regex patterns that occur in each string
+ *
+ * @param str character vector
+ * @param pattern character vector
+ * @param opts_regex list
+ * @return list of integer vectors
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri_which_regex(SEXP str, SEXP pattern, SEXP opts_regex)
+{
+   return stri__detect_regex_set(str, pattern, opts_regex, true);
+}
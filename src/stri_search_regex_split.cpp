@@ -35,8 +35,8 @@
 #include "stri_container_integer.h"
 #include "stri_container_logical.h"
 #include "stri_container_regex.h"
-#include <deque>
 #include <utility>
+#include "stri_tokentable.h"
 using namespace std;
 
 
@@ -77,6 +77,13 @@ using namespace std;
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-04)
  *    allow `simplify=NA`; FR #126: pass n to stri_list2matrix
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriTokenTable: simplify=TRUE writes directly to a matrix;
+ *    use StriRegexDFA if possible
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use StriOccurrences (reused across strings)
  */
 SEXP stri_split_regex(SEXP str, SEXP pattern, SEXP n, SEXP omit_empty,
                       SEXP tokens_only, SEXP simplify, SEXP opts_regex)
@@ -90,24 +97,24 @@ SEXP stri_split_regex(SEXP str, SEXP pattern, SEXP n, SEXP omit_empty,
    R_len_t vectorize_length = stri__recycling_rule(true, 4,
       LENGTH(str), LENGTH(pattern), LENGTH(n), LENGTH(omit_empty));
 
-   uint32_t pattern_flags = StriContainerRegexPattern::getRegexFlags(opts_regex);
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
 
    UText* str_text = NULL; // may potentially be slower, but definitely is more convenient!
    STRI__ERROR_HANDLER_BEGIN(5)
    StriContainerUTF8      str_cont(str, vectorize_length);
    StriContainerInteger   n_cont(n, vectorize_length);
    StriContainerLogical   omit_empty_cont(omit_empty, vectorize_length);
-   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_flags);
+   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_opts);
 
-   SEXP ret;
-   STRI__PROTECT(ret = Rf_allocVector(VECSXP, vectorize_length));
+   StriTokenTable tokens(vectorize_length);
 
+   StriOccurrences fields; // byte based-indices
    for (R_len_t i = pattern_cont.vectorize_init();
          i != pattern_cont.vectorize_end();
          i = pattern_cont.vectorize_next(i))
    {
       if (n_cont.isNA(i)) {
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));
+         tokens.addNA(i);
          continue;
       }
 
@@ -115,10 +122,9 @@ SEXP stri_split_regex(SEXP str, SEXP pattern, SEXP n, SEXP omit_empty,
       int  omit_empty_cur   = !omit_empty_cont.isNA(i) && omit_empty_cont.get(i);
 
       STRI__CONTINUE_ON_EMPTY_OR_NA_STR_PATTERN(str_cont, pattern_cont,
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));,
-         SET_VECTOR_ELT(ret, i,
-            (omit_empty_cont.isNA(i))?stri__vector_NA_strings(1):
-            stri__vector_empty_strings((omit_empty_cur || n_cur == 0)?0:1));)
+         tokens.addNA(i);,
+         if (omit_empty_cont.isNA(i)) tokens.addNA(i);
+         else if (!omit_empty_cur && n_cur != 0) tokens.addEmpty(i);)
 
       R_len_t     str_cur_n = str_cont.get(i).length();
       const char* str_cur_s = str_cont.get(i).c_str();
@@ -127,29 +133,39 @@ SEXP stri_split_regex(SEXP str, SEXP pattern, SEXP n, SEXP omit_empty,
          throw StriException(MSG__EXPECTED_SMALLER, "n");
       else if (n_cur < 0)
          n_cur = INT_MAX;
-      else if (n_cur == 0) {
-         SET_VECTOR_ELT(ret, i, Rf_allocVector(STRSXP, 0));
-         continue;
-      }
+      else if (n_cur == 0)
+         continue; // no tokens at all
       else if (tokens_only1)
          n_cur++; // we need to do one split ahead here
 
-      UErrorCode status = U_ZERO_ERROR;
-      RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
-      str_text = utext_openUTF8(str_text, str_cont.get(i).c_str(), str_cont.get(i).length(), &status);
-      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+      StriRegexDFA* dfa = pattern_cont.getDFA(i, str_cur_s, str_cur_n);
+      RegexMatcher *matcher = NULL;
+      if (!dfa) {
+         UErrorCode status = U_ZERO_ERROR;
+         matcher = pattern_cont.getMatcher(i); // will be deleted automatically
+         str_text = utext_openUTF8(str_text, str_cont.get(i).c_str(), str_cont.get(i).length(), &status);
+         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
 
-      matcher->reset(str_text);
+         matcher->reset(str_text);
+      }
 
 
       R_len_t k;
-      deque< pair<R_len_t, R_len_t> > fields; // byte based-indices
+      fields.clear();
       fields.push_back(pair<R_len_t, R_len_t>(0,0));
 
-      for (k=1; k < n_cur && (int)matcher->find(); ) {
-         R_len_t s1 = (R_len_t)matcher->start(status);
-         R_len_t s2 = (R_len_t)matcher->end(status);
-         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+      for (k=1; k < n_cur && (dfa?dfa->find():pattern_cont.find(matcher)); ) {
+         R_len_t s1, s2;
+         if (dfa) {
+            s1 = dfa->start();
+            s2 = dfa->end();
+         }
+         else {
+            UErrorCode status = U_ZERO_ERROR;
+            s1 = (R_len_t)matcher->start(status);
+            s2 = (R_len_t)matcher->end(status);
+            STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+         }
 
          if (omit_empty_cur && fields.back().first == s1)
             fields.back().first = s2; // don't start any new field
@@ -165,25 +181,19 @@ SEXP stri_split_regex(SEXP str, SEXP pattern, SEXP n, SEXP omit_empty,
 
       if (tokens_only1 && n_cur < INT_MAX) {
          n_cur--; // one split ahead could have been made, see above
-         while (fields.size() > (size_t)n_cur)
+         while (fields.size() > n_cur)
             fields.pop_back(); // get rid of the remainder
       }
 
-      SEXP ans;
-      STRI__PROTECT(ans = Rf_allocVector(STRSXP, fields.size()));
-
-      deque< pair<R_len_t, R_len_t> >::iterator iter = fields.begin();
-      for (k = 0; iter != fields.end(); ++iter, ++k) {
+      StriOccurrences::iterator iter = fields.begin();
+      for (; iter != fields.end(); ++iter) {
          pair<R_len_t, R_len_t> curoccur = *iter;
          if (curoccur.second == curoccur.first && omit_empty_cont.isNA(i))
-            SET_STRING_ELT(ans, k, NA_STRING);
+            tokens.addNA(i);
          else
-            SET_STRING_ELT(ans, k,
-            Rf_mkCharLenCE(str_cur_s+curoccur.first, curoccur.second-curoccur.first, CE_UTF8));
+            tokens.add(i, str_cur_s+curoccur.first,
+               curoccur.second-curoccur.first);
       }
-
-      SET_VECTOR_ELT(ret, i, ans);
-      STRI__UNPROTECT(1);
    }
 
    if (str_text) {
@@ -191,6 +201,7 @@ SEXP stri_split_regex(SEXP str, SEXP pattern, SEXP n, SEXP omit_empty,
       str_text = NULL;
    }
 
+   SEXP ret;
    if (LOGICAL(simplify)[0] == NA_LOGICAL || LOGICAL(simplify)[0]) {
       R_len_t n_min = 0;
       R_len_t n_length = LENGTH(n);
@@ -199,11 +210,12 @@ SEXP stri_split_regex(SEXP str, SEXP pattern, SEXP n, SEXP omit_empty,
          if (n_tab[i] != NA_INTEGER && n_min < n_tab[i])
             n_min = n_tab[i];
       }
-      STRI__PROTECT(ret = stri_list2matrix(ret, Rf_ScalarLogical(TRUE),
-         (LOGICAL(simplify)[0] == NA_LOGICAL)?stri__vector_NA_strings(1)
-                                             :stri__vector_empty_strings(1),
-         Rf_ScalarInteger(n_min)))
+      // write directly to a matrix, no intermediate list
+      STRI__PROTECT(ret = tokens.toMatrix(
+         (LOGICAL(simplify)[0] == NA_LOGICAL)?NA_STRING:R_BlankString, n_min))
    }
+   else
+      STRI__PROTECT(ret = tokens.toList())
 
    STRI__UNPROTECT_ALL
    return ret;
@@ -30,7 +30,6 @@
  */
 
 #include "stri_stringi.h"
-#include "stri_container_utf16.h"
 #include "stri_container_utf8.h"
 #include "stri_container_regex.h"
 
@@ -60,6 +59,13 @@
  *
  * @version 1.0-3 (Marek Gagolewski, 2016-02-03)
  *    FR #216: `negate` arg added
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    literal prefilter (StriContainerRegexPattern::mayMatch);
+ *    use StriRegexDFA if possible
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    anchored patterns (StriContainerRegexPattern::matchAnchored)
  */
 SEXP stri_subset_regex(SEXP str, SEXP pattern, SEXP omit_na, SEXP negate, SEXP opts_regex)
 {
@@ -70,11 +76,11 @@ SEXP stri_subset_regex(SEXP str, SEXP pattern, SEXP omit_na, SEXP negate, SEXP o
    R_len_t vectorize_length =
       stri__recycling_rule(true, 2, LENGTH(str), LENGTH(pattern));
 
-   uint32_t pattern_flags = StriContainerRegexPattern::getRegexFlags(opts_regex);
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
 
    STRI__ERROR_HANDLER_BEGIN(2)
-   StriContainerUTF16 str_cont(str, vectorize_length);
-   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_flags);
+   StriContainerUTF8 str_cont(str, vectorize_length); // converted to UTF-16 on demand
+   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_opts);
 
    // BT: this cannot be done with deque, because pattern is reused so i does not
    // go like 0,1,2...n but 0,pat_len,2*pat_len,1,pat_len+1 and so on
@@ -89,9 +95,19 @@ SEXP stri_subset_regex(SEXP str, SEXP pattern, SEXP omit_na, SEXP negate, SEXP o
       STRI__CONTINUE_ON_EMPTY_OR_NA_PATTERN(str_cont, pattern_cont,
          {if (omit_na1) which[i] = FALSE; else {which[i] = NA_LOGICAL; result_counter++;} })
 
-      RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
-      matcher->reset(str_cont.get(i));
-      which[i] = (int)matcher->find();
+      const char* str_cur_s = str_cont.get(i).c_str();
+      R_len_t str_cur_n = str_cont.get(i).length();
+      int anchored = pattern_cont.matchAnchored(i, str_cur_s, str_cur_n);
+      if (anchored >= 0)
+         which[i] = anchored; // only a prefix or a suffix was examined
+      else if (!pattern_cont.mayMatch(i, str_cur_s, str_cur_n))
+         which[i] = FALSE; // no need to run the regex engine
+      else if (StriRegexDFA* dfa = pattern_cont.getDFA(i, str_cur_s, str_cur_n))
+         which[i] = (int)dfa->findAny();
+      else {
+         RegexMatcher *matcher = pattern_cont.getMatcher(i, str_cur_s, str_cur_n); // will be deleted automatically
+         which[i] = (int)pattern_cont.find(matcher);
+      }
       if (negate_1) which[i] = !which[i];
       if (which[i]) result_counter++;
    }
@@ -118,6 +134,13 @@ SEXP stri_subset_regex(SEXP str, SEXP pattern, SEXP omit_na, SEXP negate, SEXP o
  *
  * @version 1.0-3 (Marek Gagolewski, 2016-02-03)
  *    FR #216: `negate` arg added
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    literal prefilter (StriContainerRegexPattern::mayMatch);
+ *    use StriRegexDFA if possible
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    anchored patterns (StriContainerRegexPattern::matchAnchored)
  */
 SEXP stri_subset_regex_replacement(SEXP str, SEXP pattern, SEXP negate, SEXP opts_regex, SEXP value)
 {
@@ -131,13 +154,13 @@ SEXP stri_subset_regex_replacement(SEXP str, SEXP pattern, SEXP negate, SEXP opt
    if (value_length == 0)
       Rf_error(MSG__REPLACEMENT_ZERO);
 
-   uint32_t pattern_flags = StriContainerRegexPattern::getRegexFlags(opts_regex);
+   StriRegexMatcherOptions pattern_opts = StriContainerRegexPattern::getRegexOptions(opts_regex);
    UText* str_text = NULL; // may potentially be slower, but definitely is more convenient!
 
    STRI__ERROR_HANDLER_BEGIN(3)
    StriContainerUTF8 str_cont(str, vectorize_length);
    StriContainerUTF8 value_cont(value, value_length);
-   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_flags);
+   StriContainerRegexPattern pattern_cont(pattern, vectorize_length, pattern_opts);
 
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocVector(STRSXP, vectorize_length));
@@ -150,13 +173,23 @@ SEXP stri_subset_regex_replacement(SEXP str, SEXP pattern, SEXP negate, SEXP opt
       STRI__CONTINUE_ON_EMPTY_OR_NA_PATTERN(str_cont, pattern_cont,
       {SET_STRING_ELT(ret, i, NA_STRING);})
 
-      UErrorCode status = U_ZERO_ERROR;
-      RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
-      str_text = utext_openUTF8(str_text, str_cont.get(i).c_str(), str_cont.get(i).length(), &status);
-      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-      matcher->reset(str_text);
-
-      bool found = matcher->find();
+      bool found = false;
+      StriRegexDFA* dfa;
+      int anchored = pattern_cont.matchAnchored(i, str_cont.get(i).c_str(), str_cont.get(i).length());
+      if (anchored >= 0)
+         found = (anchored != 0); // only a prefix or a suffix was examined
+      else if (!pattern_cont.mayMatch(i, str_cont.get(i).c_str(), str_cont.get(i).length()))
+         ; // no need to run the regex engine
+      else if ((dfa = pattern_cont.getDFA(i, str_cont.get(i).c_str(), str_cont.get(i).length())))
+         found = dfa->findAny();
+      else {
+         UErrorCode status = U_ZERO_ERROR;
+         RegexMatcher *matcher = pattern_cont.getMatcher(i); // will be deleted automatically
+         str_text = utext_openUTF8(str_text, str_cont.get(i).c_str(), str_cont.get(i).length(), &status);
+         STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+         matcher->reset(str_text);
+         found = pattern_cont.find(matcher);
+      }
       if ((found && !negate_1) || (!found && negate_1))
          SET_STRING_ELT(ret, i, value_cont.toR((k++)%value_length));
       else
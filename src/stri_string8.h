@@ -262,6 +262,10 @@ class String8  {
          if (m_isASCII)
             return m_n;
 
+         R_len_t ncodepoints = stri__utf8_count_codepoints_valid(m_str, m_n);
+         if (ncodepoints >= 0)
+            return ncodepoints;
+
          UChar32 c = 0;
          R_len_t j = 0;
          R_len_t i = 0;
@@ -283,6 +287,9 @@ class String8  {
        *
        * @version 0.5-1 (Marek Gagolewski, 2015-02-14)
        *    moved from StriContainerByteSearch to String8
+       *
+       * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+       *    simple case folding, see stri__utf8_fold_case
        */
       bool endsWith(R_len_t byteindex, const char* patternStr, R_len_t patternLen, bool caseInsensitive) const
       {
@@ -294,7 +301,7 @@ class String8  {
                if (byteindex <= 0) return false;
                U8_PREV(m_str, 0, byteindex, c1);
                U8_PREV(patternStr, 0, k, c2);
-               if (u_toupper(c1) != u_toupper(c2))
+               if (stri__utf8_fold_case(c1) != stri__utf8_fold_case(c2))
                   return false;
             }
             return true;
@@ -317,6 +324,9 @@ class String8  {
        *
        * @version 0.5-1 (Marek Gagolewski, 2015-02-14)
        * moved from StriContainerByteSearch to String8
+       *
+       * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+       *    simple case folding, see stri__utf8_fold_case
        */
       bool startsWith(R_len_t byteindex, const char* patternStr, R_len_t patternLen, bool caseInsensitive) const
       {
@@ -329,7 +339,7 @@ class String8  {
                if (byteindex >= m_n) return false;
                U8_NEXT(m_str,      byteindex, m_n,        c1);
                U8_NEXT(patternStr, k,         patternLen, c2);
-               if (u_toupper(c1) != u_toupper(c2))
+               if (stri__utf8_fold_case(c1) != stri__utf8_fold_case(c2))
                   return false;
             }
             return true;
@@ -350,10 +360,16 @@ class String8  {
        *
        *
        * @version 0.3-1 (Marek Gagolewski, 2014-11-02)
+       *
+       * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+       *    set m_isASCII correctly
+       *
+       * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+       *    use StriOccurrences
        */
       void replaceAllAtPos(R_len_t buf_size,
          const char* replacement_cur_s, R_len_t replacement_cur_n,
-         std::deque< std::pair<R_len_t, R_len_t> >& occurrences)
+         const StriOccurrences& occurrences)
       {
 #ifndef NDEBUG
          if (isNA()) throw StriException("String8::isNA() in replaceAllAtPos()");
@@ -364,12 +380,13 @@ class String8  {
          this->m_str = new char[buf_size+1];
          this->m_n = buf_size;
          this->m_memalloc = true;
-         this->m_isASCII = true; /* TO DO */
+         this->m_isASCII = (this->m_isASCII &&
+            stri__utf8_is_ascii(replacement_cur_s, replacement_cur_n));
 
          R_len_t buf_used = 0;
          R_len_t jlast = 0;
 
-         std::deque< std::pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+         StriOccurrences::const_iterator iter = occurrences.begin();
          for (; iter != occurrences.end(); ++iter) {
             pair<R_len_t, R_len_t> match = *iter;
             memcpy(m_str+buf_used, old_str+jlast, (size_t)(match.first-jlast));
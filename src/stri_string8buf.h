@@ -44,6 +44,9 @@
  *
  * @version 0.5-1 (Marek Gagolewski, 2015-02-14)
  *          Use malloc+realloc
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *          new method: append
  */
 class String8buf  {
 
@@ -134,20 +137,40 @@ class String8buf  {
          }
       }
 
+      /** append bytes, increasing the buffer size if needed
+       *
+       * @param buf_used number of bytes already in use
+       * @param str data to append
+       * @param n number of bytes to append
+       * @return new number of bytes in use
+       *
+       * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+       */
+      inline R_len_t append(R_len_t buf_used, const char* str, R_len_t n)
+      {
+         if (buf_used+n >= this->m_size) // grow geometrically
+            resize((buf_used+n > 2*this->m_size)?(buf_used+n):(2*this->m_size), true);
+         memcpy(this->m_str+buf_used, str, (size_t)n);
+         return buf_used+n;
+      }
+
       /** Replace substrings with a given replacement string
        *
        * @return number of bytes written
        *
        * @version 0.3-1 (Marek Gagolewski, 2014-11-02)
+       *
+       * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+       *    use StriOccurrences
        */
       int replaceAllAtPos(const char* str_cur_s, R_len_t str_cur_n,
          const char* replacement_cur_s, R_len_t replacement_cur_n,
-         std::deque< std::pair<R_len_t, R_len_t> >& occurrences)
+         const StriOccurrences& occurrences)
       {
          R_len_t buf_used = 0;
          R_len_t jlast = 0;
 
-         std::deque< std::pair<R_len_t, R_len_t> >::iterator iter = occurrences.begin();
+         StriOccurrences::const_iterator iter = occurrences.begin();
          for (; iter != occurrences.end(); ++iter) {
             pair<R_len_t, R_len_t> match = *iter;
             memcpy(m_str+buf_used, str_cur_s+jlast, (size_t)(match.first-jlast));
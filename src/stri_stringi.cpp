@@ -31,6 +31,7 @@
 
 
 #include "stri_stringi.h"
+#include "stri_brkiter.h"
 #include <cstring>
 #include <cstdlib>
 #include <unicode/uclean.h>
@@ -65,6 +66,7 @@ const R_CallMethodDef cCallMethods[] = {
    STRI__MK_CALL("C_stri_cmp_ge",                       stri_cmp_ge,                     3),
    STRI__MK_CALL("C_stri_cmp_equiv",                    stri_cmp_equiv,                  3),
    STRI__MK_CALL("C_stri_cmp_nequiv",                   stri_cmp_nequiv,                 3),
+   STRI__MK_CALL("C_stri_coll_compile",                 stri_coll_compile,               2),
    STRI__MK_CALL("C_stri_count_boundaries",             stri_count_boundaries,           2),
    STRI__MK_CALL("C_stri_count_charclass",              stri_count_charclass,            2),
    STRI__MK_CALL("C_stri_count_fixed",                  stri_count_fixed,                3),
@@ -81,10 +83,11 @@ const R_CallMethodDef cCallMethods[] = {
    STRI__MK_CALL("C_stri_detect_coll",                  stri_detect_coll,                4),
    STRI__MK_CALL("C_stri_detect_fixed",                 stri_detect_fixed,               4),
    STRI__MK_CALL("C_stri_detect_regex",                 stri_detect_regex,               4),
+   STRI__MK_CALL("C_stri_detect_regex_set",             stri_detect_regex_set,           3),
    STRI__MK_CALL("C_stri_dup",                          stri_dup,                        2),
    STRI__MK_CALL("C_stri_duplicated",                   stri_duplicated,                 3),
    STRI__MK_CALL("C_stri_duplicated_any",               stri_duplicated_any,             3),
-   STRI__MK_CALL("C_stri_enc_detect",                   stri_enc_detect,                 2),
+   STRI__MK_CALL("C_stri_enc_detect",                   stri_enc_detect,                 3),
    STRI__MK_CALL("C_stri_enc_detect2",                  stri_enc_detect2,                2),
    STRI__MK_CALL("C_stri_enc_isutf8",                   stri_enc_isutf8,                 1),
    STRI__MK_CALL("C_stri_enc_isutf16le",                stri_enc_isutf16le,              1),
@@ -101,6 +104,7 @@ const R_CallMethodDef cCallMethods[] = {
    STRI__MK_CALL("C_stri_enc_toutf8",                   stri_enc_toutf8,                 3),
    STRI__MK_CALL("C_stri_enc_toutf32",                  stri_enc_toutf32,                1),
    STRI__MK_CALL("C_stri_encode",                       stri_encode,                     4),
+   STRI__MK_CALL("C_stri_encode_file",                  stri_encode_file,                5),
 // STRI__MK_CALL("C_stri_encode_from_marked",           stri_encode_from_marked,         3), // internal
    STRI__MK_CALL("C_stri_endswith_charclass",           stri_endswith_charclass,         3),
    STRI__MK_CALL("C_stri_endswith_coll",                stri_endswith_coll,              4),
@@ -111,16 +115,17 @@ const R_CallMethodDef cCallMethods[] = {
    STRI__MK_CALL("C_stri_extract_all_boundaries",       stri_extract_all_boundaries,     4),
    STRI__MK_CALL("C_stri_extract_first_charclass",      stri_extract_first_charclass,    2),
    STRI__MK_CALL("C_stri_extract_last_charclass",       stri_extract_last_charclass,     2),
-   STRI__MK_CALL("C_stri_extract_all_charclass",        stri_extract_all_charclass,      5),
+   STRI__MK_CALL("C_stri_extract_all_charclass",        stri_extract_all_charclass,      6),
    STRI__MK_CALL("C_stri_extract_first_coll",           stri_extract_first_coll,         3),
    STRI__MK_CALL("C_stri_extract_last_coll",            stri_extract_last_coll,          3),
-   STRI__MK_CALL("C_stri_extract_all_coll",             stri_extract_all_coll,           5),
+   STRI__MK_CALL("C_stri_extract_all_coll",             stri_extract_all_coll,           6),
    STRI__MK_CALL("C_stri_extract_first_fixed",          stri_extract_first_fixed,        3),
    STRI__MK_CALL("C_stri_extract_last_fixed",           stri_extract_last_fixed,         3),
-   STRI__MK_CALL("C_stri_extract_all_fixed",            stri_extract_all_fixed,          5),
+   STRI__MK_CALL("C_stri_extract_all_fixed",            stri_extract_all_fixed,          6),
    STRI__MK_CALL("C_stri_extract_first_regex",          stri_extract_first_regex,        3),
    STRI__MK_CALL("C_stri_extract_last_regex",           stri_extract_last_regex,         3),
-   STRI__MK_CALL("C_stri_extract_all_regex",            stri_extract_all_regex,          5),
+   STRI__MK_CALL("C_stri_extract_all_regex",            stri_extract_all_regex,          6),
+   STRI__MK_CALL("C_stri_fixed_compile",                stri_fixed_compile,              2),
    STRI__MK_CALL("C_stri_flatten",                      stri_flatten,                    2),
 //   STRI__MK_CALL("C_stri_in_fixed",                   stri_in_fixed,                   3),  // TODO: version >= 0.6
    STRI__MK_CALL("C_stri_info",                         stri_info,                       0),
@@ -129,7 +134,8 @@ const R_CallMethodDef cCallMethods[] = {
    STRI__MK_CALL("C_stri_join_list",                    stri_join_list,                  3),
    STRI__MK_CALL("C_stri_join2",                        stri_join2,                      2),
 //   STRI__MK_CALL("C_stri_justify",                    stri_justify,                    2),  // TODO: version >= 0.6
-   STRI__MK_CALL("C_stri_length",                       stri_length,                     1),
+   STRI__MK_CALL("C_stri_length",                       stri_length,                     2),
+   STRI__MK_CALL("C_stri_list2columns",                 stri_list2columns,               3),
    STRI__MK_CALL("C_stri_list2matrix",                  stri_list2matrix,                4),
    STRI__MK_CALL("C_stri_locale_info",                  stri_locale_info,                1),
    STRI__MK_CALL("C_stri_locale_list",                  stri_locale_list,                0),
@@ -139,19 +145,20 @@ const R_CallMethodDef cCallMethods[] = {
    STRI__MK_CALL("C_stri_locate_last_boundaries",       stri_locate_last_boundaries,     2),
    STRI__MK_CALL("C_stri_locate_first_charclass",       stri_locate_first_charclass,     2),
    STRI__MK_CALL("C_stri_locate_last_charclass",        stri_locate_last_charclass,      2),
-   STRI__MK_CALL("C_stri_locate_all_charclass",         stri_locate_all_charclass,       4),
+   STRI__MK_CALL("C_stri_locate_all_charclass",         stri_locate_all_charclass,       5),
    STRI__MK_CALL("C_stri_locate_last_fixed",            stri_locate_last_fixed,          3),
    STRI__MK_CALL("C_stri_locate_first_fixed",           stri_locate_first_fixed,         3),
-   STRI__MK_CALL("C_stri_locate_all_fixed",             stri_locate_all_fixed,           4),
+   STRI__MK_CALL("C_stri_locate_all_fixed",             stri_locate_all_fixed,           5),
    STRI__MK_CALL("C_stri_locate_last_coll",             stri_locate_last_coll,           3),
    STRI__MK_CALL("C_stri_locate_first_coll",            stri_locate_first_coll,          3),
-   STRI__MK_CALL("C_stri_locate_all_coll",              stri_locate_all_coll,            4),
-   STRI__MK_CALL("C_stri_locate_all_regex",             stri_locate_all_regex,           4),
+   STRI__MK_CALL("C_stri_locate_all_coll",              stri_locate_all_coll,            5),
+   STRI__MK_CALL("C_stri_locate_all_regex",             stri_locate_all_regex,           5),
    STRI__MK_CALL("C_stri_locate_first_regex",           stri_locate_first_regex,         3),
    STRI__MK_CALL("C_stri_locate_last_regex",            stri_locate_last_regex,          3),
    STRI__MK_CALL("C_stri_match_first_regex",            stri_match_first_regex,          4),
    STRI__MK_CALL("C_stri_match_last_regex",             stri_match_last_regex,           4),
-   STRI__MK_CALL("C_stri_match_all_regex",              stri_match_all_regex,            5),
+   STRI__MK_CALL("C_stri_match_all_regex",              stri_match_all_regex,            6),
+   STRI__MK_CALL("C_stri_metadata",                     stri_metadata,                   2),
    STRI__MK_CALL("C_stri_numbytes",                     stri_numbytes,                   1),
    STRI__MK_CALL("C_stri_order",                        stri_order,                      4),
    STRI__MK_CALL("C_stri_sort",                         stri_sort,                       4),
@@ -168,6 +175,7 @@ const R_CallMethodDef cCallMethods[] = {
    STRI__MK_CALL("C_stri_prepare_arg_logical_1",        stri_prepare_arg_logical_1,      2),
    STRI__MK_CALL("C_stri_rand_shuffle",                 stri_rand_shuffle,               1),
    STRI__MK_CALL("C_stri_rand_strings",                 stri_rand_strings,               3),
+   STRI__MK_CALL("C_stri_regex_compile",                stri_regex_compile,              2),
    STRI__MK_CALL("C_stri_replace_na",                   stri_replace_na,                 2),
    STRI__MK_CALL("C_stri_replace_all_fixed",            stri_replace_all_fixed,          5),
    STRI__MK_CALL("C_stri_replace_first_fixed",          stri_replace_first_fixed,        4),
@@ -181,8 +189,9 @@ const R_CallMethodDef cCallMethods[] = {
    STRI__MK_CALL("C_stri_replace_all_charclass",        stri_replace_all_charclass,      5),
    STRI__MK_CALL("C_stri_replace_first_charclass",      stri_replace_first_charclass,    3),
    STRI__MK_CALL("C_stri_replace_last_charclass",       stri_replace_last_charclass,     3),
-   STRI__MK_CALL("C_stri_reverse",                      stri_reverse,                    1),
+   STRI__MK_CALL("C_stri_reverse",                      stri_reverse,                    2),
    STRI__MK_CALL("C_stri_split_boundaries",             stri_split_boundaries,           5),
+   STRI__MK_CALL("C_stri_split_boundaries_ids",         stri_split_boundaries_ids,       4),
    STRI__MK_CALL("C_stri_split_charclass",              stri_split_charclass,            6),
    STRI__MK_CALL("C_stri_split_coll",                   stri_split_coll,                 7),
    STRI__MK_CALL("C_stri_split_fixed",                  stri_split_fixed,                7),
@@ -194,8 +203,8 @@ const R_CallMethodDef cCallMethods[] = {
    STRI__MK_CALL("C_stri_startswith_fixed",             stri_startswith_fixed,           4),
    STRI__MK_CALL("C_stri_stats_general",                stri_stats_general,              1),
    STRI__MK_CALL("C_stri_stats_latex",                  stri_stats_latex,                1),
-   STRI__MK_CALL("C_stri_sub",                          stri_sub,                        4),
-   STRI__MK_CALL("C_stri_sub_replacement",              stri_sub_replacement,            6),
+   STRI__MK_CALL("C_stri_sub",                          stri_sub,                        5),
+   STRI__MK_CALL("C_stri_sub_replacement",              stri_sub_replacement,            7),
    STRI__MK_CALL("C_stri_subset_charclass",             stri_subset_charclass,           4),
    STRI__MK_CALL("C_stri_subset_coll",                  stri_subset_coll,                5),
    STRI__MK_CALL("C_stri_subset_fixed",                 stri_subset_fixed,               5),
@@ -233,6 +242,7 @@ const R_CallMethodDef cCallMethods[] = {
    STRI__MK_CALL("C_stri_trim_right",                   stri_trim_right,                 2),
    STRI__MK_CALL("C_stri_unescape_unicode",             stri_unescape_unicode,           1),
    STRI__MK_CALL("C_stri_unique",                       stri_unique,                     2),
+   STRI__MK_CALL("C_stri_which_regex",                  stri_which_regex,                3),
    STRI__MK_CALL("C_stri_width",                        stri_width,                      1),
    STRI__MK_CALL("C_stri_wrap",                         stri_wrap,                      10),
 //   STRI__MK_CALL("C_stri_trim_double",                stri_trim_double,                3), // TODO: version >= 0.6
@@ -318,6 +328,10 @@ extern "C" void R_init_stringi(DllInfo* dll)
       Rf_error("R does not support UTF-8 encoding.");
    }
 
+   // read-only afterwards, so that no synchronization is needed
+   stri__brkiter_ascii_calibrate();
+   stri__width_table_init();
+
 
 #ifndef NDEBUG
 //    fprintf(stdout, "!NDEBUG: ************************************************\n");
@@ -37,6 +37,8 @@
 #include "stri_messages.h"
 #include "stri_macros.h"
 #include "stri_exception.h"
+#include "stri_utf8.h"
+#include "stri_occurrences.h"
 #include "stri_string8.h"
 #include "stri_container_utf8.h"
 #include "stri_container_utf16.h"
@@ -60,11 +62,24 @@ int     stri__match_arg(const char* option, const char** set);
 struct UCollator;
 UCollator* stri__ucol_open(SEXP opts_collator);
 
+// factor.cpp:
+SEXP    stri__factor_expand(SEXP f);
+bool    stri__factor_by_levels(SEXP f, SEXP arg1=NULL, SEXP arg2=NULL);
+SEXP    stri__factor_used_levels(SEXP f);
+SEXP    stri__factor_gather(SEXP res, SEXP f);
+bool    stri__factor_output_enabled(SEXP f);
+SEXP    stri__factor_output(SEXP res, SEXP f);
+
 // length.cpp
 R_len_t stri__numbytes_max(SEXP str);
 int     stri__width_char(UChar32 c);
+void    stri__width_table_init();
 int     stri__width_string(const char* str_cur_s, int str_cur_n);
 
+// metadata.cpp:
+SEXP    stri__metadata_get(SEXP x, const char* name, SEXPTYPE type);
+bool    stri__metadata_unchanged(SEXP x, R_len_t i);
+
 // prepare_arg.cpp:
 const char* stri__prepare_arg_string_1_notNA(SEXP x,  const char* argname);
 double      stri__prepare_arg_double_1_notNA(SEXP x,  const char* argname);
@@ -33,6 +33,7 @@
 #include "stri_stringi.h"
 #include "stri_container_utf8_indexable.h"
 #include "stri_string8buf.h"
+#include "stri_brkiter.h"
 
 
 #define STRI__SUB_PREPARE_FROM_TO_LENGTH                                     \
@@ -96,6 +97,37 @@
    }
 
 
+/* grapheme cluster-based indices; `bounds` is filled by
+   stri__brkiter_clusters(), which returned `nclusters` */
+#define STRI__SUB_GET_GRAPHEME_INDICES(cur_from, cur_to, cur_from2, cur_to2) \
+                                                                             \
+   if (cur_from >= 0) {                                                      \
+      cur_from--; /* 1-based -> 0-based index */                             \
+      if (cur_from < 0) cur_from = 0;                                        \
+      if (cur_from > nclusters) cur_from = nclusters;                        \
+   }                                                                         \
+   else {                                                                    \
+      cur_from  = nclusters+cur_from;                                        \
+      if (cur_from < 0) cur_from = 0;                                        \
+   }                                                                         \
+   cur_from2 = bounds[cur_from];                                             \
+   if (cur_to >= 0) {                                                        \
+      if (cur_to > nclusters) cur_to = nclusters;                            \
+   }                                                                         \
+   else {                                                                    \
+      cur_to  = nclusters+cur_to+1;                                          \
+      if (cur_to < 0) cur_to = 0;                                            \
+   }                                                                         \
+   cur_to2 = bounds[cur_to];
+
+
+/* does a string need to be segmented into grapheme clusters?
+   otherwise, each code point is a separate cluster */
+#define STRI__SUB_NEEDS_GRAPHEME(str_cur_s, str_cur_n)                      \
+   (grapheme && (!str_cont.get(i).isASCII() ||                               \
+      memchr(str_cur_s, '\r', (size_t)str_cur_n)))
+
+
 /**
  * Get substring
  *
@@ -129,9 +161,17 @@
  *
  * @version 0.5-9003 (Marek Gagolewski, 2015-08-05)
  *    Bugfix #183: floating point exception when to or length is an empty vector
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    use code point checkpoints if str is a stri_metadata object
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    new arg: `type`
  */
-SEXP stri_sub(SEXP str, SEXP from, SEXP to, SEXP length)
+SEXP stri_sub(SEXP str, SEXP from, SEXP to, SEXP length, SEXP type)
 {
+   bool grapheme = stri__prepare_arg_grapheme(type, "type");
+   SEXP metadata = str;
    PROTECT(str = stri_prepare_arg_string(str, "str"));
 
    R_len_t str_len       = LENGTH(str);
@@ -154,6 +194,9 @@ SEXP stri_sub(SEXP str, SEXP from, SEXP to, SEXP length)
 
    STRI__ERROR_HANDLER_BEGIN(4)
    StriContainerUTF8_indexable str_cont(str, vectorize_len);
+   str_cont.setMetadata(metadata);
+   StriRuleBasedBreakIterator brkiter(StriBrkIterOptions(R_NilValue, "character"));
+   std::vector<R_len_t> bounds;
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocVector(STRSXP, vectorize_len));
 
@@ -178,11 +221,19 @@ SEXP stri_sub(SEXP str, SEXP from, SEXP to, SEXP length)
       }
 
       const char* str_cur_s = str_cont.get(i).c_str();
+      R_len_t str_cur_n     = str_cont.get(i).length();
 
       R_len_t cur_from2; // UTF-8 byte incices
       R_len_t cur_to2;   // UTF-8 byte incices
 
-      STRI__SUB_GET_INDICES(cur_from, cur_to, cur_from2, cur_to2)
+      if (STRI__SUB_NEEDS_GRAPHEME(str_cur_s, str_cur_n)) {
+         R_len_t nclusters = stri__brkiter_clusters(brkiter,
+            str_cur_s, str_cur_n, bounds);
+         STRI__SUB_GET_GRAPHEME_INDICES(cur_from, cur_to, cur_from2, cur_to2)
+      }
+      else {
+         STRI__SUB_GET_INDICES(cur_from, cur_to, cur_from2, cur_to2)
+      }
 
       if (cur_to2 > cur_from2) { // just copy
          SET_STRING_ELT(ret, i, Rf_mkCharLenCE(str_cur_s+cur_from2, cur_to2-cur_from2, CE_UTF8));
@@ -236,9 +287,13 @@ SEXP stri_sub(SEXP str, SEXP from, SEXP to, SEXP length)
  * @version 1.0-2 (Marek Gagolewski, 2016-01-31)
  *    FR #199: new arg: `omit_na`
  *    FR #207: allow insertions
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    new arg: `type`
  */
-SEXP stri_sub_replacement(SEXP str, SEXP from, SEXP to, SEXP length, SEXP omit_na, SEXP value)
+SEXP stri_sub_replacement(SEXP str, SEXP from, SEXP to, SEXP length, SEXP omit_na, SEXP value, SEXP type)
 {
+   bool grapheme = stri__prepare_arg_grapheme(type, "type");
    PROTECT(str   = stri_prepare_arg_string(str, "str"));
    PROTECT(value = stri_prepare_arg_string(value, "value"));
    bool omit_na_1 = stri__prepare_arg_logical_1_notNA(omit_na, "omit_na");
@@ -265,6 +320,8 @@ SEXP stri_sub_replacement(SEXP str, SEXP from, SEXP to, SEXP length, SEXP omit_n
    STRI__ERROR_HANDLER_BEGIN(5)
    StriContainerUTF8_indexable str_cont(str, vectorize_len);
    StriContainerUTF8 value_cont(value, vectorize_len);
+   StriRuleBasedBreakIterator brkiter(StriBrkIterOptions(R_NilValue, "character"));
+   std::vector<R_len_t> bounds;
    SEXP ret;
    STRI__PROTECT(ret = Rf_allocVector(STRSXP, vectorize_len));
    String8buf buf(0); // @TODO: estimate bufsize a priori
@@ -310,7 +367,14 @@ SEXP stri_sub_replacement(SEXP str, SEXP from, SEXP to, SEXP length, SEXP omit_n
       R_len_t cur_from2; // UTF-8 byte incices
       R_len_t cur_to2;   // UTF-8 byte incices
 
-      STRI__SUB_GET_INDICES(cur_from, cur_to, cur_from2, cur_to2)
+      if (STRI__SUB_NEEDS_GRAPHEME(str_cur_s, str_cur_n)) {
+         R_len_t nclusters = stri__brkiter_clusters(brkiter,
+            str_cur_s, str_cur_n, bounds);
+         STRI__SUB_GET_GRAPHEME_INDICES(cur_from, cur_to, cur_from2, cur_to2)
+      }
+      else {
+         STRI__SUB_GET_INDICES(cur_from, cur_to, cur_from2, cur_to2)
+      }
       if (cur_to2 < cur_from2) cur_to2 = cur_from2;
 
       R_len_t buflen = str_cur_n-(cur_to2-cur_from2)+value_cur_n;
@@ -0,0 +1,114 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "stri_stringi.h"
+#include "stri_tokentable.h"
+
+
+/** Get the maximal number of tokens in a row
+ *
+ * @return integer
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t StriTokenTable::getMaxCount() const
+{
+   R_len_t m = 0;
+   for (R_len_t i=0; i<m_nrow; ++i)
+      if (m_count[i] > m) m = m_count[i];
+   return m;
+}
+
+
+/** Convert the table to a list of character vectors
+ *
+ * @return list of character vectors, one for each row
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP StriTokenTable::toList() const
+{
+   SEXP ret, ans;
+   PROTECT(ret = Rf_allocVector(VECSXP, m_nrow));
+   for (R_len_t i=0; i<m_nrow; ++i) {
+      PROTECT(ans = Rf_allocVector(STRSXP, m_count[i]));
+      for (R_len_t j=0, k=m_first[i]; j<m_count[i]; ++j, ++k) {
+         if (!m_str[k])
+            SET_STRING_ELT(ans, j, NA_STRING);
+         else
+            SET_STRING_ELT(ans, j, Rf_mkCharLenCE(m_str[k], m_len[k], CE_UTF8));
+      }
+      SET_VECTOR_ELT(ret, i, ans);
+      UNPROTECT(1);
+   }
+   UNPROTECT(1);
+   return ret;
+}
+
+
+/** Write the table into a character matrix
+ *
+ * The result is the same as the one returned by
+ * \code{stri_list2matrix(toList(), byrow=TRUE, fill, n_min)},
+ * but no intermediate list is created. The matrix
+ * is filled column by column, i.e., sequentially.
+ *
+ * @param fill a CHARSXP
+ * @param n_min minimal number of columns
+ * @return character matrix with \code{m_nrow} rows
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP StriTokenTable::toMatrix(SEXP fill, R_len_t n_min) const
+{
+   R_len_t m = getMaxCount();
+   if (m < n_min) m = n_min;
+
+   SEXP ret;
+   PROTECT(ret = Rf_allocMatrix(STRSXP, m_nrow, m));
+   R_len_t ret_idx = 0;
+   for (R_len_t j=0; j<m; ++j) {
+      for (R_len_t i=0; i<m_nrow; ++i, ++ret_idx) {
+         if (j >= m_count[i])
+            SET_STRING_ELT(ret, ret_idx, fill);
+         else {
+            R_len_t k = m_first[i]+j;
+            if (!m_str[k])
+               SET_STRING_ELT(ret, ret_idx, NA_STRING);
+            else
+               SET_STRING_ELT(ret, ret_idx, Rf_mkCharLenCE(m_str[k], m_len[k], CE_UTF8));
+         }
+      }
+   }
+   UNPROTECT(1);
+   return ret;
+}
@@ -0,0 +1,121 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __stri_tokentable_h
+#define __stri_tokentable_h
+
+#include <vector>
+
+
+/**
+ * A table of UTF-8 tokens extracted from a vectorized input,
+ * e.g., by the stri_split_* family
+ *
+ * Tokens are stored as (pointer, length) pairs referring to
+ * some other container's data (which must outlive the table),
+ * so no R objects are created until the very end.
+ * The table may then be converted to a list of character vectors
+ * or written directly into a character matrix, which
+ * allows for omitting the intermediate list
+ * (and a call to \code{stri_list2matrix}) completely.
+ *
+ * All tokens of a given row must be added one after another,
+ * rows may be visited in any order (each row at most once).
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriTokenTable {
+
+   private:
+
+      R_len_t m_nrow;
+      std::vector<R_len_t> m_first;    ///< index of a row's first token
+      std::vector<R_len_t> m_count;    ///< number of tokens in a row
+      std::vector<const char*> m_str;  ///< token data, NULL denotes NA
+      std::vector<R_len_t> m_len;      ///< token lengths, in bytes
+
+      StriTokenTable(const StriTokenTable&); // no copy
+      StriTokenTable& operator=(const StriTokenTable&); // no copy
+
+   public:
+
+      StriTokenTable(R_len_t nrow)
+         : m_nrow(nrow), m_first(nrow, 0), m_count(nrow, 0)
+      {
+      }
+
+      /** add a token to the i-th row
+       *
+       * @param i row index
+       * @param s UTF-8 string, not necessarily NUL-terminated
+       * @param n number of bytes in s
+       */
+      inline void add(R_len_t i, const char* s, R_len_t n)
+      {
+         if (m_count[i] == 0) m_first[i] = (R_len_t)m_str.size();
+#ifndef NDEBUG
+         else if (m_first[i]+m_count[i] != (R_len_t)m_str.size())
+            throw StriException("StriTokenTable: rows must be filled contiguously");
+#endif
+         m_str.push_back(s);
+         m_len.push_back(n);
+         m_count[i]++;
+      }
+
+      /** add a missing value to the i-th row
+       *
+       * @param i row index
+       */
+      inline void addNA(R_len_t i)
+      {
+         add(i, NULL, 0);
+      }
+
+      /** add k empty strings to the i-th row
+       *
+       * @param i row index
+       * @param k number of empty tokens
+       */
+      inline void addEmpty(R_len_t i, R_len_t k=1)
+      {
+         for (R_len_t j=0; j<k; ++j)
+            add(i, "", 0);
+      }
+
+      /** number of tokens in the longest row */
+      R_len_t getMaxCount() const;
+
+      SEXP toList() const;
+      SEXP toMatrix(SEXP fill, R_len_t n_min) const;
+};
+
+#endif
@@ -37,6 +37,77 @@
 #include <unicode/ucasemap.h>
 
 
+/** Can ASCII strings be title-cased by stri__totitle_ascii()
+ *  in a given locale?
+ *
+ * Turkish, Azerbaijani (dotted capital I), Lithuanian
+ * and Dutch (IJ) have language-specific casing rules.
+ *
+ * @param locale locale ID or NULL for the default one
+ * @return logical value
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+bool stri__totitle_ascii_supported(const char* locale)
+{
+   char lang[ULOC_LANG_CAPACITY];
+   UErrorCode status = U_ZERO_ERROR;
+   uloc_getLanguage(locale?locale:uloc_getDefault(), lang, ULOC_LANG_CAPACITY, &status);
+   if (U_FAILURE(status)) return false;
+   const char* special[] = {"tr", "tur", "az", "aze", "lt", "lit", "nl", "nld", NULL};
+   for (int i=0; special[i]; ++i)
+      if (!strcmp(lang, special[i])) return false;
+   return true;
+}
+
+
+/** Convert an ASCII string to title case
+ *
+ * Gives the same results as \code{ucasemap_utf8ToTitle};
+ * word (or character) boundaries are determined by
+ * stri__brkiter_ascii_next().
+ *
+ * @param type break iterator type
+ * @param buf [out] buffer of at least \code{str_n} bytes
+ * @param str ASCII string
+ * @param str_n number of bytes in \code{str}
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+void stri__totitle_ascii(UBreakIteratorType type, char* buf, const char* str, R_len_t str_n)
+{
+   R_len_t pos = 0;
+   R_len_t next;
+   int32_t rule;
+   while ((next = stri__brkiter_ascii_next(type, str, str_n, pos, rule)) != BreakIterator::DONE) {
+      // copy the characters preceding the one to be title-cased,
+      // i.e., the first cased character (ICU < 60) or the first
+      // letter, digit or symbol (ICU >= 60)
+      R_len_t j = pos;
+      for (; j < next; ++j) {
+         char c = str[j];
+         if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+            break;
+#if U_ICU_VERSION_MAJOR_NUM >= 60
+         if ((c >= '0' && c <= '9') || strchr("$+<=>^`|~", c))
+            break;
+#endif
+         buf[j] = c;
+      }
+
+      if (j < next) {
+         buf[j] = (str[j] >= 'a' && str[j] <= 'z')?(char)(str[j]-'a'+'A'):str[j];
+         ++j;
+      }
+
+      for (; j < next; ++j)
+         buf[j] = (str[j] >= 'A' && str[j] <= 'Z')?(char)(str[j]-'A'+'a'):str[j];
+
+      pos = next;
+   }
+}
+
+
 /**
  *  Convert case (TitleCase)
  *
@@ -48,8 +119,18 @@
  * @version 0.4-1 (Marek Gagolewski, 2014-12-03)
  *    separated from stri_trans_casemap;
  *    use StriUBreakIterator
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    return the original CHARSXPs of unaltered strings;
+ *    ASCII fast path (stri__totitle_ascii)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_trans_totitle(SEXP str, SEXP opts_brkiter) {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str),
+      stri_trans_totitle(str, opts_brkiter))
+
    StriBrkIterOptions opts_brkiter2(opts_brkiter, "word");
    PROTECT(str = stri_prepare_arg_string(str, "str")); // prepare string argument
 
@@ -63,6 +144,10 @@ SEXP stri_trans_totitle(SEXP str, SEXP opts_brkiter) {
    ucasemap = ucasemap_open(brkiter.getLocale(), U_FOLD_CASE_DEFAULT, &status);
    STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
 
+   bool ascii_supported = stri__totitle_ascii_supported(brkiter.getLocale()) &&
+      stri__brkiter_ascii_supported(reinterpret_cast<BreakIterator*>(brkiter.getIterator()),
+         brkiter.getType());
+
    status = U_ZERO_ERROR;
    ucasemap_setBreakIterator(ucasemap, brkiter.getIterator(), &status);
    STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
@@ -100,6 +185,16 @@ SEXP stri_trans_totitle(SEXP str, SEXP opts_brkiter) {
       R_len_t str_cur_n     = str_cont.get(i).length();
       const char* str_cur_s = str_cont.get(i).c_str();
 
+      if (ascii_supported && str_cont.get(i).isASCII()) {
+         buf.resize(str_cur_n, false/*destroy contents*/);
+         stri__totitle_ascii(brkiter.getType(), buf.data(), str_cur_s, str_cur_n);
+         if (!memcmp(buf.data(), str_cur_s, (size_t)str_cur_n))
+            SET_STRING_ELT(ret, i, str_cont.toR(i)); // unchanged, reuse if possible
+         else
+            SET_STRING_ELT(ret, i, Rf_mkCharLenCE(buf.data(), str_cur_n, CE_UTF8));
+         continue;
+      }
+
       status = U_ZERO_ERROR;
       int buf_need = ucasemap_utf8ToTitle(ucasemap, buf.data(), buf.size(),
                (const char*)str_cur_s, str_cur_n, &status);
@@ -114,7 +209,10 @@ SEXP stri_trans_totitle(SEXP str, SEXP opts_brkiter) {
                                              // we do have the buffer size required to complete this op
       }
 
-      SET_STRING_ELT(ret, i, Rf_mkCharLenCE(buf.data(), buf_need, CE_UTF8));
+      if (buf_need == str_cur_n && !memcmp(buf.data(), str_cur_s, (size_t)str_cur_n))
+         SET_STRING_ELT(ret, i, str_cont.toR(i)); // unchanged, reuse if possible
+      else
+         SET_STRING_ELT(ret, i, Rf_mkCharLenCE(buf.data(), buf_need, CE_UTF8));
    }
 
    if (ucasemap) { ucasemap_close(ucasemap); ucasemap = NULL;}
@@ -166,6 +264,9 @@ SEXP stri_trans_totitle(SEXP str, SEXP opts_brkiter) {
  *
  * @version 0.6-1 (Marek Gagolewski, 2015-07-11)
  *    now this is an internal function
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    return the original CHARSXPs of unaltered strings
 */
 SEXP stri_trans_casemap(SEXP str, int _type, SEXP locale)
 {
@@ -228,7 +329,10 @@ SEXP stri_trans_casemap(SEXP str, int _type, SEXP locale)
                                              // we do have the buffer size required to complete this op
       }
 
-      SET_STRING_ELT(ret, i, Rf_mkCharLenCE(buf.data(), buf_need, CE_UTF8));
+      if (buf_need == str_cur_n && !memcmp(buf.data(), str_cur_s, (size_t)str_cur_n))
+         SET_STRING_ELT(ret, i, str_cont.toR(i)); // unchanged, reuse if possible
+      else
+         SET_STRING_ELT(ret, i, Rf_mkCharLenCE(buf.data(), buf_need, CE_UTF8));
    }
 
    if (ucasemap) { ucasemap_close(ucasemap); ucasemap = NULL;}
@@ -252,8 +356,14 @@ SEXP stri_trans_casemap(SEXP str, int _type, SEXP locale)
  *
  * @version 0.6-1 (Marek Gagolewski, 2015-07-11)
  *    call stri_trans_casemap
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
 */
 SEXP stri_trans_tolower(SEXP str, SEXP locale) {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str),
+      stri_trans_tolower(str, locale))
+
    return stri_trans_casemap(str, 1, locale);
 }
 
@@ -269,8 +379,14 @@ SEXP stri_trans_tolower(SEXP str, SEXP locale) {
  *
  * @version 0.6-1 (Marek Gagolewski, 2015-07-11)
  *    call stri_trans_casemap
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
 */
 SEXP stri_trans_toupper(SEXP str, SEXP locale) {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str),
+      stri_trans_toupper(str, locale))
+
    return stri_trans_casemap(str, 2, locale);
 }
 
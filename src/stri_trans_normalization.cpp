@@ -117,9 +117,19 @@ const Normalizer2* stri__normalizer_get(int _type)
  *
  * @version 0.6-1 (Marek Gagolewski, 2015-07-11)
  *    This is now an internal function
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    normalize only the part following the quick-check-YES prefix;
+ *    return the original CHARSXPs of already normalized strings
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_trans_nf(SEXP str, int type)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str),
+      stri_trans_nf(str, type))
+
    // As of ICU 52.1 (Unicode 6.3.0), the "most expansive" decomposition
    // is 1 UChar -> 18 UChars (data/unidata/norm2/nfkc.txt)
    // FDFA>0635 0644 0649 0020 0627 0644 0644 0647 0020
@@ -138,16 +148,36 @@ SEXP stri_trans_nf(SEXP str, int type)
    STRI__ERROR_HANDLER_BEGIN(1)
    StriContainerUTF16 str_cont(str, str_length, false); // writable, no recycle
 
+   SEXP ret;
+   STRI__PROTECT(ret = Rf_allocVector(STRSXP, str_length));
+
    for (R_len_t i=0; i<str_length; ++i) {
-      if (str_cont.isNA(i)) continue;
+      if (str_cont.isNA(i)) {
+         SET_STRING_ELT(ret, i, NA_STRING);
+         continue;
+      }
+
+      const UnicodeString& str_cur = str_cont.get(i);
       UErrorCode status = U_ZERO_ERROR;
-      str_cont.set(i, normalizer->normalize(str_cont.get(i), status));
+      int32_t span = normalizer->spanQuickCheckYes(str_cur, status);
       STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+
+      if (span >= str_cur.length()) { // already normalized
+         SET_STRING_ELT(ret, i, str_cont.toRUnchanged(i));
+         continue;
+      }
+
+      UnicodeString out(str_cur, 0, span);
+      normalizer->normalizeSecondAndAppend(out,
+         str_cur.tempSubString(span), status);
+      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+      str_cont.set(i, out);
+      SET_STRING_ELT(ret, i, str_cont.toR(i));
    }
 
    // normalizer shall not be deleted at all
    STRI__UNPROTECT_ALL
-   return str_cont.toR();
+   return ret;
    STRI__ERROR_HANDLER_END(;/* nothing special to be done on error */)
 }
 
@@ -173,9 +203,15 @@ SEXP stri_trans_nf(SEXP str, int type)
  *
  * @version 0.6-1 (Marek Gagolewski, 2015-07-11)
  *    This is now an internal function
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_trans_isnf(SEXP str, int type)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str),
+      stri_trans_isnf(str, type))
+
    const Normalizer2* normalizer =
       stri__normalizer_get(type); // auto `type` check here, call before ERROR_HANDLER
 
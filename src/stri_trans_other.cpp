@@ -66,8 +66,14 @@ void stri__split_codepoints(deque<SEXP>& out, const char* s, int n) {
  * @version 0.5-1 (Marek Gagolewski, 2015-04-06)
  *
  *
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_trans_char(SEXP str, SEXP pattern, SEXP replacement) {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str),
+      stri_trans_char(str, pattern, replacement))
+
    PROTECT(str          = stri_prepare_arg_string(str, "str"));
    PROTECT(pattern      = stri_prepare_arg_string_1(pattern, "pattern"));
    PROTECT(replacement  = stri_prepare_arg_string_1(replacement, "replacement"));
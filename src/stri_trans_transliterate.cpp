@@ -93,9 +93,18 @@ SEXP stri_trans_list()
  * @return character vector
  *
  * @version 0.2-2 (Marek Gagolewski, 2014-04-19)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    return the original CHARSXPs of unaltered strings
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    process factors by levels
  */
 SEXP stri_trans_general(SEXP str, SEXP id)
 {
+   STRI__FACTOR_BY_LEVELS(str, stri__factor_by_levels(str),
+      stri_trans_general(str, id))
+
    PROTECT(str = stri_prepare_arg_string(str, "str"));
    PROTECT(id  = stri_prepare_arg_string_1(id, "id"));
    R_len_t str_length = LENGTH(str);
@@ -114,14 +123,27 @@ SEXP stri_trans_general(SEXP str, SEXP id)
 
    StriContainerUTF16 str_cont(str, str_length, false); // writable, no recycle
 
+   SEXP ret;
+   STRI__PROTECT(ret = Rf_allocVector(STRSXP, str_length));
+
    for (R_len_t i=0; i<str_length; ++i) {
-      if (str_cont.isNA(i)) continue;
+      if (str_cont.isNA(i)) {
+         SET_STRING_ELT(ret, i, NA_STRING);
+         continue;
+      }
+
+      // copying is cheap: the buffer is shared until it is written to
+      UnicodeString str_cur(str_cont.get(i));
       trans->transliterate(str_cont.getWritable(i));
+      if (str_cont.get(i) == str_cur)
+         SET_STRING_ELT(ret, i, str_cont.toRUnchanged(i));
+      else
+         SET_STRING_ELT(ret, i, str_cont.toR(i));
    }
 
    if (trans) { delete trans; trans = NULL; }
    STRI__UNPROTECT_ALL
-   return str_cont.toR();
+   return ret;
    STRI__ERROR_HANDLER_END(
       if (trans) { delete trans; trans = NULL; }
    )
@@ -416,3 +416,222 @@ bool StriUcnv::is1to1Unicode()
 
    return true;
 }
+
+
+/** Process-wide cache of single-byte conversion tables,
+ *  keyed by canonical converter names; the tables are never released
+ *  (there is only a handful of 8-bit encodings anyway)
+ */
+static std::vector< std::pair<std::string, StriUcnv8bitTables*> > stri__ucnv_8bit_cache;
+
+
+/**
+ * Get (and build on first use) lookup tables for direct
+ * conversion between a single-byte encoding and UTF-8
+ *
+ * Only stateless single-byte converters (SBCS, ISO-8859-1, US-ASCII)
+ * are supported. A byte is included in the to-UTF-8 table iff
+ * it converts to exactly one code point without invoking any error
+ * callback; a code point is included in the from-UTF-8 table
+ * iff it round-trips to the very same byte. Everything else should
+ * be handled by ICU (so that its substitution and warning
+ * behavior is retained).
+ *
+ * @return tables or NULL if this is not a supported 8-bit converter
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+const StriUcnv8bitTables* StriUcnv::get8bitTables()
+{
+   if (m_8bit_tables_checked)
+      return m_8bit_tables;
+
+   m_8bit_tables_checked = true;
+   m_8bit_tables = NULL;
+
+   openConverter(false);
+   UConverterType type = ucnv_getType(m_ucnv);
+   if (type != UCNV_SBCS && type != UCNV_LATIN_1 && type != UCNV_US_ASCII)
+      return NULL;
+
+   UErrorCode status = U_ZERO_ERROR;
+   const char* canname = ucnv_getName(m_ucnv, &status);
+   if (U_FAILURE(status) || !canname)
+      return NULL;
+
+   for (size_t k=0; k<stri__ucnv_8bit_cache.size(); ++k) {
+      if (stri__ucnv_8bit_cache[k].first == canname) {
+         m_8bit_tables = stri__ucnv_8bit_cache[k].second;
+         return m_8bit_tables;
+      }
+   }
+
+   // use a separate converter that stops on each unmapped char
+   status = U_ZERO_ERROR;
+   UConverter* conv = ucnv_open(canname, &status);
+   if (U_FAILURE(status)) {
+      if (conv) ucnv_close(conv);
+      return NULL;
+   }
+   status = U_ZERO_ERROR;
+   ucnv_setToUCallBack(conv, UCNV_TO_U_CALLBACK_STOP, NULL, NULL, NULL, &status);
+   ucnv_setFromUCallBack(conv, UCNV_FROM_U_CALLBACK_STOP, NULL, NULL, NULL, &status);
+   if (U_FAILURE(status)) {
+      ucnv_close(conv);
+      return NULL;
+   }
+
+   StriUcnv8bitTables* tab = new StriUcnv8bitTables;
+   tab->from_n = 0;
+   tab->ascii_identity = true;
+   for (int c=0; c<128; ++c)
+      tab->fromascii[c] = -1;
+
+   for (int b=0; b<256; ++b) {
+      tab->toutf8_len[b] = 0;
+      char src = (char)(unsigned char)b;
+      UChar dest[4];
+      status = U_ZERO_ERROR;
+      ucnv_resetToUnicode(conv);
+      int32_t destlen = ucnv_toUChars(conv, dest, 4, &src, 1, &status);
+      if (U_FAILURE(status) || destlen <= 0 || destlen > 2) {
+         if (b < 128) tab->ascii_identity = false;
+         continue;
+      }
+
+      UChar32 c;
+      int32_t j = 0;
+      U16_NEXT(dest, j, destlen, c);
+      if (j != destlen || U_IS_SURROGATE(c)) {
+         // more than one code point
+         if (b < 128) tab->ascii_identity = false;
+         continue;
+      }
+      if (b < 128 && c != b)
+         tab->ascii_identity = false;
+
+      int32_t len = 0;
+      U8_APPEND_UNSAFE(tab->toutf8[b], len, c);
+      tab->toutf8_len[b] = (uint8_t)len;
+
+      // does it round-trip?
+      char back[8];
+      status = U_ZERO_ERROR;
+      ucnv_resetFromUnicode(conv);
+      int32_t backlen = ucnv_fromUChars(conv, back, 8, dest, destlen, &status);
+      if (U_FAILURE(status) || backlen != 1 || back[0] != src)
+         continue;
+
+      if (c < 128)
+         tab->fromascii[c] = (int16_t)b;
+      else {
+         // insertion sort (256 elems at most)
+         int k = tab->from_n++;
+         while (k > 0 && tab->from_cp[k-1] > c) {
+            tab->from_cp[k]   = tab->from_cp[k-1];
+            tab->from_byte[k] = tab->from_byte[k-1];
+            --k;
+         }
+         tab->from_cp[k]   = c;
+         tab->from_byte[k] = (uint8_t)b;
+      }
+   }
+
+   ucnv_close(conv);
+
+   stri__ucnv_8bit_cache.push_back(
+      std::pair<std::string, StriUcnv8bitTables*>(std::string(canname), tab));
+   m_8bit_tables = tab;
+   return m_8bit_tables;
+}
+
+
+/**
+ * Convert a string in a single-byte encoding to UTF-8
+ *
+ * @param tab tables, see get8bitTables()
+ * @param src input string
+ * @param n number of bytes in \code{src}
+ * @param dest output buffer
+ * @param dest_size size of \code{dest}; \code{3*n} always suffices,
+ *    as single-byte encodings map to the BMP
+ * @return number of bytes written or -1 if \code{src} contains
+ *    a byte that has no direct mapping or \code{dest} is too small
+ *    (then ICU should be used instead)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t StriUcnv::convert8bitToUTF8(const StriUcnv8bitTables* tab,
+   const char* src, R_len_t n, char* dest, R_len_t dest_size)
+{
+   R_len_t i = 0, k = 0;
+   if (tab->ascii_identity) {
+      i = stri__utf8_ascii_prefix(src, n);
+      if (i > dest_size)
+         return -1;
+      memcpy(dest, src, (size_t)i);
+      k = i;
+   }
+
+   for (; i<n; ++i) {
+      uint8_t b = (uint8_t)src[i];
+      uint8_t len = tab->toutf8_len[b];
+      if (len == 0 || k > dest_size-len)
+         return -1;
+      else if (len == 1)
+         dest[k++] = tab->toutf8[b][0];
+      else {
+         for (uint8_t j=0; j<len; ++j)
+            dest[k++] = tab->toutf8[b][j];
+      }
+   }
+   return k;
+}
+
+
+/**
+ * Convert a UTF-8 string to a single-byte encoding
+ *
+ * @param tab tables, see get8bitTables()
+ * @param src input string
+ * @param n number of bytes in \code{src}
+ * @param dest output buffer of size at least \code{n}
+ * @return number of bytes written or -1 if \code{src} is not valid UTF-8
+ *    or contains a code point that has no round-trip mapping
+ *    (then ICU should be used instead)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t StriUcnv::convertUTF8To8bit(const StriUcnv8bitTables* tab,
+   const char* src, R_len_t n, char* dest)
+{
+   R_len_t i = 0, k = 0;
+   if (tab->ascii_identity) {
+      i = stri__utf8_ascii_prefix(src, n);
+      memcpy(dest, src, (size_t)i);
+      k = i;
+   }
+
+   while (i < n) {
+      UChar32 c;
+      U8_NEXT(src, i, n, c);
+      if (c < 0)
+         return -1;
+      else if (c < 128) {
+         if (tab->fromascii[c] < 0) return -1;
+         dest[k++] = (char)tab->fromascii[c];
+      }
+      else {
+         int lo = 0, hi = tab->from_n;
+         while (lo < hi) {
+            int mid = (lo+hi)/2;
+            if (tab->from_cp[mid] < c) lo = mid+1;
+            else hi = mid;
+         }
+         if (lo >= tab->from_n || tab->from_cp[lo] != c)
+            return -1;
+         dest[k++] = (char)tab->from_byte[lo];
+      }
+   }
+   return k;
+}
@@ -38,6 +38,25 @@
 #include <string>
 #include <vector>
 
+
+/**
+ * Lookup tables for direct single-byte <-> UTF-8 conversion
+ *
+ * Built from ICU's converter data on first use, see StriUcnv::get8bitTables()
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+struct StriUcnv8bitTables {
+   char    toutf8[256][4];    ///< UTF-8 representation of each byte
+   uint8_t toutf8_len[256];   ///< 0 for bytes that have no mapping
+   int16_t fromascii[128];    ///< byte for each ASCII code point, -1 if none
+   UChar32 from_cp[256];      ///< non-ASCII round-trip code points, sorted
+   uint8_t from_byte[256];    ///< corresponding bytes
+   int     from_n;            ///< number of entries in from_cp
+   bool    ascii_identity;    ///< are bytes 0..127 mapped onto ASCII?
+};
+
+
 /**
  * A class to manage an encoding converter
  *
@@ -51,6 +70,8 @@ class StriUcnv  {
       const char* m_name; // encoding, owned by caller
       int m_isutf8;
       int m_is8bit;
+      const StriUcnv8bitTables* m_8bit_tables; // owned by the global cache
+      bool m_8bit_tables_checked;
 
       static void STRI__UCNV_FROM_U_CALLBACK_SUBSTITUTE_WARN (
                   const void* context,
@@ -79,6 +100,8 @@ class StriUcnv  {
          m_ucnv = NULL; // lazy
          m_isutf8 = NA_LOGICAL;
          m_is8bit = NA_LOGICAL;
+         m_8bit_tables = NULL;
+         m_8bit_tables_checked = false;
       }
 
       ~StriUcnv()
@@ -94,6 +117,8 @@ class StriUcnv  {
          m_ucnv = NULL;
          m_isutf8 = NA_LOGICAL;
          m_is8bit = NA_LOGICAL;
+         m_8bit_tables = NULL;
+         m_8bit_tables_checked = false;
       }
 
 
@@ -103,6 +128,8 @@ class StriUcnv  {
          m_ucnv = NULL;
          m_isutf8 = NA_LOGICAL;
          m_is8bit = NA_LOGICAL;
+         m_8bit_tables = NULL;
+         m_8bit_tables_checked = false;
          return *this;
       }
 
@@ -134,6 +161,12 @@ class StriUcnv  {
       bool hasASCIIsubset();
       bool is1to1Unicode();
 
+      const StriUcnv8bitTables* get8bitTables();
+      static R_len_t convert8bitToUTF8(const StriUcnv8bitTables* tab,
+         const char* src, R_len_t n, char* dest, R_len_t dest_size);
+      static R_len_t convertUTF8To8bit(const StriUcnv8bitTables* tab,
+         const char* src, R_len_t n, char* dest);
+
       static vector<const char*> getStandards();
       static const char* getFriendlyName(const char* canname);
 
@@ -0,0 +1,393 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "stri_stringi.h"
+#include "stri_utf8.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define STRI__UTF8_SSE2 1
+#endif
+
+/* AVX2 version is compiled with a function-level target attribute
+   and selected at runtime, so that the package itself may be built
+   for a generic CPU */
+#if defined(STRI__UTF8_SSE2) && (defined(__x86_64__) || defined(__i386__)) && \
+   ((defined(__GNUC__) && __GNUC__ >= 5) || defined(__clang__))
+#include <immintrin.h>
+#define STRI__UTF8_AVX2 1
+#endif
+
+
+/** Length of the ASCII prefix, portable version
+ *
+ * Processes 8 bytes at a time.
+ *
+ * @param s byte sequence
+ * @param n number of bytes
+ * @return index of the first byte >= 0x80 or n
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static R_len_t stri__utf8_ascii_prefix_word(const char* s, R_len_t n)
+{
+   R_len_t i = 0;
+   for (; i+8 <= n; i += 8) {
+      uint64_t w;
+      memcpy(&w, s+i, 8); // no aliasing/alignment issues
+      if (w & (uint64_t)0x8080808080808080ULL)
+         break;
+   }
+   while (i < n && (uint8_t)s[i] < 0x80)
+      ++i;
+   return i;
+}
+
+
+#ifdef STRI__UTF8_SSE2
+/** Length of the ASCII prefix, SSE2 version (16 bytes at a time)
+ *
+ * @param s byte sequence
+ * @param n number of bytes
+ * @return index of the first byte >= 0x80 or n
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static R_len_t stri__utf8_ascii_prefix_sse2(const char* s, R_len_t n)
+{
+   R_len_t i = 0;
+   for (; i+16 <= n; i += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i*)(s+i));
+      if (_mm_movemask_epi8(v) != 0)
+         break;
+   }
+   while (i < n && (uint8_t)s[i] < 0x80)
+      ++i;
+   return i;
+}
+#endif
+
+
+#ifdef STRI__UTF8_AVX2
+/** Length of the ASCII prefix, AVX2 version (32 bytes at a time)
+ *
+ * @param s byte sequence
+ * @param n number of bytes
+ * @return index of the first byte >= 0x80 or n
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+__attribute__((target("avx2")))
+static R_len_t stri__utf8_ascii_prefix_avx2(const char* s, R_len_t n)
+{
+   R_len_t i = 0;
+   for (; i+32 <= n; i += 32) {
+      __m256i v = _mm256_loadu_si256((const __m256i*)(s+i));
+      if (_mm256_movemask_epi8(v) != 0)
+         break;
+   }
+   while (i < n && (uint8_t)s[i] < 0x80)
+      ++i;
+   return i;
+}
+#endif
+
+
+typedef R_len_t (*stri__utf8_ascii_prefix_fun)(const char*, R_len_t);
+
+
+/** Select the fastest available ASCII scanner (once)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static stri__utf8_ascii_prefix_fun stri__utf8_ascii_prefix_select()
+{
+#ifdef STRI__UTF8_AVX2
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx2"))
+      return stri__utf8_ascii_prefix_avx2;
+#endif
+#ifdef STRI__UTF8_SSE2
+   return stri__utf8_ascii_prefix_sse2;
+#else
+   return stri__utf8_ascii_prefix_word;
+#endif
+}
+
+
+static stri__utf8_ascii_prefix_fun stri__utf8_ascii_prefix_impl = NULL;
+
+
+/** Get the length of the longest ASCII-only prefix of a byte sequence
+ *
+ * Short sequences are processed byte-by-byte, longer ones
+ * with the fastest kernel available on the current CPU.
+ *
+ * @param s byte sequence
+ * @param n number of bytes
+ * @return index of the first byte >= 0x80 or n
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t stri__utf8_ascii_prefix(const char* s, R_len_t n)
+{
+   if (n < 16) {
+      R_len_t i = 0;
+      while (i < n && (uint8_t)s[i] < 0x80)
+         ++i;
+      return i;
+   }
+
+   if (!stri__utf8_ascii_prefix_impl)
+      stri__utf8_ascii_prefix_impl = stri__utf8_ascii_prefix_select();
+   return stri__utf8_ascii_prefix_impl(s, n);
+}
+
+
+/** Find the first ill-formed UTF-8 sequence, count continuation bytes
+ *
+ * See stri__utf8_invalid_pos.
+ *
+ * @param s byte sequence
+ * @param n number of bytes
+ * @param ntrail [out] incremented by the number of continuation bytes
+ *    of the valid sequences before the returned position
+ * @return byte index of the beginning of the first invalid sequence or n
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static inline R_len_t stri__utf8_scan(const char* s, R_len_t n, R_len_t& ntrail)
+{
+   const uint8_t* u = (const uint8_t*)s;
+   R_len_t i = 0;
+   while (i < n) {
+      if (u[i] < 0x80) {
+         i += stri__utf8_ascii_prefix(s+i, n-i);
+         continue;
+      }
+
+      uint8_t c = u[i];
+      uint8_t lo = 0x80, hi = 0xBF; // allowed range for the 2nd byte
+      R_len_t len;
+      if (c < 0xC2) return i; // trail byte or overlong 2-byte form
+      else if (c < 0xE0) len = 2;
+      else if (c < 0xF0) {
+         len = 3;
+         if (c == 0xE0) lo = 0xA0;      // overlong
+         else if (c == 0xED) hi = 0x9F; // surrogates
+      }
+      else if (c < 0xF5) {
+         len = 4;
+         if (c == 0xF0) lo = 0x90;      // overlong
+         else if (c == 0xF4) hi = 0x8F; // > U+10FFFF
+      }
+      else return i;
+
+      if (i+len > n) return i;
+      if (u[i+1] < lo || u[i+1] > hi) return i;
+      for (R_len_t k=2; k<len; ++k)
+         if ((u[i+k] & 0xC0) != 0x80) return i;
+      ntrail += len-1;
+      i += len;
+   }
+   return n;
+}
+
+
+/** Find the first ill-formed UTF-8 sequence
+ *
+ * ASCII runs are skipped in bulk, see stri__utf8_ascii_prefix.
+ * Multibyte sequences are validated according to
+ * Table 3-7 of the Unicode Standard (no overlong forms,
+ * no surrogates, nothing above U+10FFFF), i.e.,
+ * a byte sequence is valid iff U8_NEXT never returns
+ * a negative value on it.
+ *
+ * Note that NUL bytes are considered valid here.
+ *
+ * @param s byte sequence
+ * @param n number of bytes
+ * @return byte index of the beginning of the first invalid sequence or n
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t stri__utf8_invalid_pos(const char* s, R_len_t n)
+{
+   R_len_t ntrail = 0;
+   return stri__utf8_scan(s, n, ntrail);
+}
+
+
+/** Validate a UTF-8 string and count its code points in a single pass
+ *
+ * @param s byte sequence
+ * @param n number of bytes
+ * @return number of code points or -1 if s is not valid UTF-8,
+ *    see stri__utf8_invalid_pos
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t stri__utf8_count_codepoints_valid(const char* s, R_len_t n)
+{
+   R_len_t ntrail = 0;
+   if (stri__utf8_scan(s, n, ntrail) < n)
+      return -1;
+   return n-ntrail;
+}
+
+
+/** Count code points in a valid UTF-8 string
+ *
+ * As each code point has exactly one non-continuation byte,
+ * no decoding is necessary. ASCII runs are skipped in bulk.
+ *
+ * @param s byte sequence, assumed to be valid UTF-8,
+ *    see stri__utf8_invalid_pos
+ * @param n number of bytes
+ * @return number of code points
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t stri__utf8_count_codepoints(const char* s, R_len_t n)
+{
+   R_len_t i = 0;
+   R_len_t ntrail = 0; // number of continuation bytes
+   while (i < n) {
+      if ((uint8_t)s[i] < 0x80) {
+         i += stri__utf8_ascii_prefix(s+i, n-i);
+         continue;
+      }
+      for (; i < n && (uint8_t)s[i] >= 0x80; ++i)
+         if (((uint8_t)s[i] & 0xC0) == 0x80) ++ntrail;
+   }
+   return n-ntrail;
+}
+
+
+/** Find the first occurrence of any of 3 bytes, portable version
+ *
+ * Processes 8 bytes at a time; a word contains byte b iff
+ * (w^bbb...b) has a zero byte.
+ *
+ * @param s byte sequence
+ * @param n number of bytes
+ * @param b1 byte to look for
+ * @param b2 byte to look for
+ * @param b3 byte to look for
+ * @return index of the first byte equal to b1, b2 or b3, or n
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static R_len_t stri__utf8_find_byte3_word(const char* s, R_len_t n,
+   uint8_t b1, uint8_t b2, uint8_t b3)
+{
+   const uint64_t ones  = (uint64_t)0x0101010101010101ULL;
+   const uint64_t highs = (uint64_t)0x8080808080808080ULL;
+   const uint64_t w1 = ones*b1, w2 = ones*b2, w3 = ones*b3;
+   R_len_t i = 0;
+   for (; i+8 <= n; i += 8) {
+      uint64_t w;
+      memcpy(&w, s+i, 8);
+      uint64_t x1 = w^w1, x2 = w^w2, x3 = w^w3;
+      if ((((x1-ones)&~x1) | ((x2-ones)&~x2) | ((x3-ones)&~x3)) & highs)
+         break;
+   }
+   for (; i < n; ++i) {
+      uint8_t c = (uint8_t)s[i];
+      if (c == b1 || c == b2 || c == b3)
+         return i;
+   }
+   return n;
+}
+
+
+#ifdef STRI__UTF8_SSE2
+/** Find the first occurrence of any of 3 bytes, SSE2 version
+ *
+ * @param s byte sequence
+ * @param n number of bytes
+ * @param b1 byte to look for
+ * @param b2 byte to look for
+ * @param b3 byte to look for
+ * @return index of the first byte equal to b1, b2 or b3, or n
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static R_len_t stri__utf8_find_byte3_sse2(const char* s, R_len_t n,
+   uint8_t b1, uint8_t b2, uint8_t b3)
+{
+   const __m128i v1 = _mm_set1_epi8((char)b1);
+   const __m128i v2 = _mm_set1_epi8((char)b2);
+   const __m128i v3 = _mm_set1_epi8((char)b3);
+   R_len_t i = 0;
+   for (; i+16 <= n; i += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i*)(s+i));
+      int mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(
+         _mm_cmpeq_epi8(v, v1), _mm_cmpeq_epi8(v, v2)), _mm_cmpeq_epi8(v, v3)));
+      if (mask != 0)
+         break; // the remaining bytes of the block are examined below
+   }
+   for (; i < n; ++i) {
+      uint8_t c = (uint8_t)s[i];
+      if (c == b1 || c == b2 || c == b3)
+         return i;
+   }
+   return n;
+}
+#endif
+
+
+/** Find the first occurrence of any of 3 bytes
+ *
+ * Used to skip to the possible starts of a match,
+ * e.g., of \code{'a'} or \code{'A'}; pass the same byte
+ * several times to look for fewer bytes.
+ *
+ * @param s byte sequence
+ * @param n number of bytes
+ * @param b1 byte to look for
+ * @param b2 byte to look for
+ * @param b3 byte to look for
+ * @return index of the first byte equal to b1, b2 or b3, or n
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+R_len_t stri__utf8_find_byte3(const char* s, R_len_t n,
+   uint8_t b1, uint8_t b2, uint8_t b3)
+{
+#ifdef STRI__UTF8_SSE2
+   return stri__utf8_find_byte3_sse2(s, n, b1, b2, b3);
+#else
+   return stri__utf8_find_byte3_word(s, n, b1, b2, b3);
+#endif
+}
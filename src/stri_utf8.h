@@ -0,0 +1,101 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __stri_utf8_h
+#define __stri_utf8_h
+
+
+/* Bulk UTF-8 scanning kernels (see stri_utf8.cpp)
+ *
+ * The ASCII-skipping part is vectorized (SSE2/AVX2 with runtime
+ * dispatch on x86 platforms, 8-byte words otherwise),
+ * multibyte sequences are checked with a table-driven scalar
+ * automaton (Unicode Standard, Table 3-7, Well-Formed UTF-8 Byte Sequences),
+ * which gives exactly the same results as ICU's U8_NEXT.
+ */
+
+R_len_t stri__utf8_ascii_prefix(const char* s, R_len_t n);
+R_len_t stri__utf8_invalid_pos(const char* s, R_len_t n);
+R_len_t stri__utf8_count_codepoints(const char* s, R_len_t n);
+R_len_t stri__utf8_count_codepoints_valid(const char* s, R_len_t n);
+R_len_t stri__utf8_find_byte3(const char* s, R_len_t n,
+   uint8_t b1, uint8_t b2, uint8_t b3);
+
+
+/** Check whether a byte sequence is a valid UTF-8 string
+ *
+ * @param s byte sequence
+ * @param n number of bytes
+ * @return true if s consists of well-formed UTF-8 sequences only
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+inline bool stri__utf8_is_valid(const char* s, R_len_t n)
+{
+   return stri__utf8_invalid_pos(s, n) >= n;
+}
+
+
+/** Check whether a byte sequence consists of ASCII characters only
+ *
+ * @param s byte sequence
+ * @param n number of bytes
+ * @return true if all bytes are < 0x80
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+inline bool stri__utf8_is_ascii(const char* s, R_len_t n)
+{
+   return stri__utf8_ascii_prefix(s, n) >= n;
+}
+
+
+/** Simple case folding of a code point
+ *
+ * ASCII letters are folded with the \code{|0x20} trick,
+ * other code points with ICU's \code{u_foldCase}
+ * (CaseFolding.txt, mappings of status C and S).
+ * Each code point is mapped to a single code point.
+ *
+ * @param c code point (negative values are returned as-is)
+ * @return folded code point
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+inline UChar32 stri__utf8_fold_case(UChar32 c)
+{
+   if (c < 0x80)
+      return (c >= 'A' && c <= 'Z') ? (c|0x20) : c;
+   return u_foldCase(c, U_FOLD_CASE_DEFAULT);
+}
+
+#endif
@@ -29,10 +29,61 @@
  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-
 #include "stri_stringi.h"
 #include "stri_container_utf8.h"
 #include "stri_container_listutf8.h"
+#include <vector>
+
+
+/** Number of list elements (rows) processed at a time
+ *  in the blocked transposition in stri__list2matrix_byrow
+ */
+#define STRI__LIST2MATRIX_BLOCK 256
+
+
+/**
+ * Fill a row-wise character matrix or a list of character columns
+ *
+ * Elements of \code{x} are processed in blocks of
+ * STRI__LIST2MATRIX_BLOCK consecutive rows: for each block,
+ * the output is filled column by column, so that writes are
+ * sequential and the block's input vectors stay in cache
+ * (instead of jumping by \code{n} cells on each write).
+ *
+ * @param x a list of character vectors
+ * @param fill2 a CHARSXP
+ * @param n number of rows (length of \code{x})
+ * @param m number of columns
+ * @param ret output, either an n*m STRSXP matrix or a VECSXP
+ * of m STRSXPs of length n
+ * @param as_columns is ret a list of columns?
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+static void stri__list2matrix_byrow(SEXP x, SEXP fill2, R_len_t n, R_len_t m,
+   SEXP ret, bool as_columns)
+{
+   SEXP    cur_str[STRI__LIST2MATRIX_BLOCK];
+   R_len_t cur_len[STRI__LIST2MATRIX_BLOCK];
+
+   for (R_len_t i0=0; i0<n; i0 += STRI__LIST2MATRIX_BLOCK) {
+      R_len_t bn = n-i0;
+      if (bn > STRI__LIST2MATRIX_BLOCK) bn = STRI__LIST2MATRIX_BLOCK;
+
+      for (R_len_t b=0; b<bn; ++b) {
+         cur_str[b] = VECTOR_ELT(x, i0+b);
+         cur_len[b] = LENGTH(cur_str[b]);
+      }
+
+      for (R_len_t j=0; j<m; ++j) {
+         SEXP    out     = (as_columns)?VECTOR_ELT(ret, j):ret;
+         R_len_t out_idx = (as_columns)?i0:(i0+j*n);
+         for (R_len_t b=0; b<bn; ++b, ++out_idx)
+            SET_STRING_ELT(out, out_idx,
+               (j < cur_len[b])?STRING_ELT(cur_str[b], j):fill2);
+      }
+   }
+}
 
 
 /**
@@ -48,6 +99,9 @@
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-04)
  *    new arg: n_min
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    byrow=TRUE: blocked transposition, see stri__list2matrix_byrow
  */
 SEXP stri_list2matrix(SEXP x, SEXP byrow, SEXP fill, SEXP n_min)
 {
@@ -83,15 +137,7 @@ SEXP stri_list2matrix(SEXP x, SEXP byrow, SEXP fill, SEXP n_min)
    }
    else {
       STRI__PROTECT(ret = Rf_allocMatrix(STRSXP, n, m));
-      for (int i=0; i<n; ++i) {
-         SEXP cur_str = VECTOR_ELT(x, i);
-         R_len_t cur_len = LENGTH(cur_str);
-         int j;
-         for (j=0; j<cur_len; ++j)
-            SET_STRING_ELT(ret, i+j*n, STRING_ELT(cur_str, j));
-         for (; j<m; ++j)
-            SET_STRING_ELT(ret, i+j*n, fill2);
-      }
+      stri__list2matrix_byrow(x, fill2, n, m, ret, false);
    }
 
    STRI__UNPROTECT_ALL
@@ -99,3 +145,47 @@ SEXP stri_list2matrix(SEXP x, SEXP byrow, SEXP fill, SEXP n_min)
 
    STRI__ERROR_HANDLER_END({/* no-op on err */})
 }
+
+
+/**
+ * Convert list to a list of character columns
+ *
+ * The result is the same as a list of the columns of
+ * \code{stri_list2matrix(x, byrow=TRUE, fill, n_min)}.
+ *
+ * @param x a list
+ * @param fill single string
+ * @param n_min single integer
+ * @return list of character vectors, each of length \code{length(x)}
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+SEXP stri_list2columns(SEXP x, SEXP fill, SEXP n_min)
+{
+   R_len_t n_min2 = stri__prepare_arg_integer_1_notNA(n_min, "n_min");
+   if (n_min2 < 0) Rf_error(MSG__EXPECTED_NONNEGATIVE, "n_min");
+   PROTECT(x = stri_prepare_arg_list_string(x, "x"));
+   PROTECT(fill = stri_prepare_arg_string_1(fill, "fill")); // enc2utf8 called in R
+
+   STRI__ERROR_HANDLER_BEGIN(2)
+   R_len_t n = LENGTH(x);
+   SEXP fill2 = STRING_ELT(fill, 0);
+
+   R_len_t m = n_min2; // maximal vector length
+   for (int i=0; i<n; ++i) {
+      R_len_t k = LENGTH(VECTOR_ELT(x, i));
+      if (k > m) m = k;
+   }
+
+   SEXP ret;
+   STRI__PROTECT(ret = Rf_allocVector(VECSXP, m));
+   for (R_len_t j=0; j<m; ++j)
+      SET_VECTOR_ELT(ret, j, Rf_allocVector(STRSXP, n));
+
+   stri__list2matrix_byrow(x, fill2, n, m, ret, true);
+
+   STRI__UNPROTECT_ALL
+   return ret;
+
+   STRI__ERROR_HANDLER_END({/* no-op on err */})
+}
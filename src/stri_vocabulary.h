@@ -0,0 +1,141 @@
+/* This file is part of the 'stringi' package for R.
+ * Copyright (C) 2013-2016, Marek Gagolewski and Bartek Tartanus
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __stri_vocabulary_h
+#define __stri_vocabulary_h
+
+#include "stri_stringi.h"
+#include <vector>
+#include <cstring>
+
+
+/**
+ * A vocabulary mapping UTF-8 tokens to consecutive integer ids,
+ * based on an open addressing hash table (linear probing)
+ *
+ * Tokens are stored as (pointer, length) pairs referring to
+ * some other container's data (which must outlive the vocabulary),
+ * so no R objects are created when a token is looked up or added.
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+class StriVocabulary {
+
+   private:
+
+      std::vector<const char*> m_str;  ///< token data
+      std::vector<R_len_t> m_len;      ///< token lengths, in bytes
+      std::vector<R_len_t> m_slots;    ///< hash table: token ids, -1 for empty
+      R_len_t m_mask;                  ///< number of slots minus 1
+
+      StriVocabulary(const StriVocabulary&); // no copy
+      StriVocabulary& operator=(const StriVocabulary&); // no copy
+
+      /** FNV-1a hash of a byte sequence */
+      static inline uint32_t hash(const char* s, R_len_t n)
+      {
+         uint32_t h = 2166136261u;
+         for (R_len_t j=0; j<n; ++j) {
+            h ^= (uint32_t)(unsigned char)s[j];
+            h *= 16777619u;
+         }
+         return h;
+      }
+
+      /** index of the slot containing a given token or of the first empty one */
+      inline R_len_t findSlot(const char* s, R_len_t n, uint32_t h) const
+      {
+         R_len_t k = (R_len_t)(h & (uint32_t)m_mask);
+         while (true) {
+            R_len_t id = m_slots[k];
+            if (id < 0 || (m_len[id] == n && memcmp(m_str[id], s, n) == 0))
+               return k;
+            k = (k+1) & m_mask;
+         }
+      }
+
+      /** double the number of slots and rehash all the tokens */
+      void grow()
+      {
+         R_len_t nslots = 2*(m_mask+1);
+         m_slots.assign(nslots, -1);
+         m_mask = nslots-1;
+         R_len_t ntokens = (R_len_t)m_str.size();
+         for (R_len_t id=0; id<ntokens; ++id)
+            m_slots[findSlot(m_str[id], m_len[id], hash(m_str[id], m_len[id]))] = id;
+      }
+
+   public:
+
+      StriVocabulary(R_len_t size_hint=0)
+      {
+         R_len_t nslots = 16;
+         while (nslots < 2*size_hint && nslots < (1<<30)) nslots *= 2;
+         m_slots.assign(nslots, -1);
+         m_mask = nslots-1;
+         m_str.reserve(size_hint);
+         m_len.reserve(size_hint);
+      }
+
+      /** number of distinct tokens */
+      inline R_len_t size() const { return (R_len_t)m_str.size(); }
+
+      /** get the i-th token's data */
+      inline const char* getStr(R_len_t i) const { return m_str[i]; }
+
+      /** get the i-th token's length, in bytes */
+      inline R_len_t getLen(R_len_t i) const { return m_len[i]; }
+
+      /** find a token
+       *
+       * @param s UTF-8 string, not necessarily NUL-terminated
+       * @param n number of bytes in s
+       * @param add whether a token not yet in the vocabulary should be added
+       * @return 0-based id or -1 if not found and add==false
+       */
+      inline R_len_t lookup(const char* s, R_len_t n, bool add=false)
+      {
+         uint32_t h = hash(s, n);
+         R_len_t k = findSlot(s, n, h);
+         if (m_slots[k] >= 0 || !add) return m_slots[k];
+
+         R_len_t id = (R_len_t)m_str.size();
+         m_str.push_back(s);
+         m_len.push_back(n);
+         m_slots[k] = id;
+         if (2*(R_len_t)m_str.size() > m_mask+1) // keep the load factor <= 0.5
+            grow();
+         return id;
+      }
+};
+
+#endif
@@ -32,11 +32,15 @@
 
 #include "stri_stringi.h"
 #include "stri_container_utf8_indexable.h"
-#include <deque>
+#include <algorithm>
 #include <vector>
 #include <utility>
+#include <new>
 #include <unicode/brkiter.h>
 #include <unicode/uniset.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 /** Greedy word wrap algorithm
@@ -57,8 +61,11 @@
  *
  * @version 0.4-1 (Marek Gagolewski, 2014-12-06)
  *    new args: add_para_1, add_para_n
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    wrap_after is a vector
  */
-void stri__wrap_greedy(std::deque<R_len_t>& wrap_after,
+void stri__wrap_greedy(std::vector<R_len_t>& wrap_after,
    R_len_t nwords, int width_val,
    const std::vector<R_len_t>& widths_orig,
    const std::vector<R_len_t>& widths_trim,
@@ -88,6 +95,9 @@ void stri__wrap_greedy(std::deque<R_len_t>& wrap_after,
  * @param widths_trim ith word width trimmed
  * @param add_para_1
  * @param add_para_a
+ * @param cost [tmp] reusable buffer
+ * @param f [tmp] reusable buffer
+ * @param where [tmp] reusable buffer
  *
  * @version 0.1-?? (Bartek Tartanus)
  *          original implementation
@@ -98,15 +108,22 @@ void stri__wrap_greedy(std::deque<R_len_t>& wrap_after,
  * @version 0.4-1 (Marek Gagolewski, 2014-12-06)
  *    new args: add_para_1, add_para_n,
  *    cost of the last line is zero
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    wrap_after is a vector; reuse the temporary buffers;
+ *    nwords*nwords is computed in size_t, std::bad_alloc if it overflows
  */
-void stri__wrap_dynamic(std::deque<R_len_t>& wrap_after,
+void stri__wrap_dynamic(std::vector<R_len_t>& wrap_after,
    R_len_t nwords, int width_val, double exponent_val,
    const std::vector<R_len_t>& widths_orig,
    const std::vector<R_len_t>& widths_trim,
-   int add_para_1, int add_para_n)
+   int add_para_1, int add_para_n,
+   std::vector<double>& cost, std::vector<double>& f, std::vector<bool>& where)
 {
-#define IDX(i,j) (i)*nwords+(j)
-   vector<double> cost(nwords*nwords);
+#define IDX(i,j) ((size_t)(i)*(size_t)nwords+(size_t)(j))
+   if ((size_t)nwords > ((size_t)-1)/sizeof(double)/(size_t)nwords)
+      throw std::bad_alloc();
+   cost.resize((size_t)nwords*(size_t)nwords);
    // where cost[IDX(i,j)] == cost of printing words i..j in a single line, i<=j
 
    // calculate costs:
@@ -144,10 +161,10 @@ void stri__wrap_dynamic(std::deque<R_len_t>& wrap_after,
       }
    }
 
-   vector<double> f(nwords); // f[j] == total cost of  (optimally) printing words 0..j
-   vector<bool> where(nwords*nwords, false); // where[IDX(i,j)] == false iff
-                                             // we don't wrap after i-th word, i<=j
-                                             // when (optimally) printing words 0..j
+   f.resize(nwords); // f[j] == total cost of  (optimally) printing words 0..j
+   where.assign((size_t)nwords*(size_t)nwords, false); // where[IDX(i,j)] == false iff
+                                       // we don't wrap after i-th word, i<=j
+                                       // when (optimally) printing words 0..j
 
    for (int j=0; j<nwords; ++j) {
       if (cost[IDX(0,j)] >= 0.0) {
@@ -201,6 +218,193 @@ struct StriWrapLineStart {
 };
 
 
+/* codes returned by stri__wrap_one */
+#define STRI__WRAP_NA           -1
+#define STRI__WRAP_INVALID_UTF8 -2
+#define STRI__WRAP_NEWLINE      -3
+#define STRI__WRAP_ICU_ERROR    -4
+#define STRI__WRAP_ALLOC_ERROR  -5
+
+
+/**
+ * Temporary buffers used by stri__wrap_one,
+ * reused across the elements of the input vector (one per thread)
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ */
+struct StriWrapBuffers {
+   std::vector<R_len_t> occurrences;  ///< possible line break positions
+   std::vector<R_len_t> end_pos_orig; ///< end positions of "words"
+   std::vector<R_len_t> end_pos_trim; ///< ...without trailing whitespaces
+   std::vector<R_len_t> widths_orig;  ///< widths/numbers of code points of "words"
+   std::vector<R_len_t> widths_trim;  ///< ...without trailing whitespaces
+   std::vector<R_len_t> wrap_after;   ///< wrap line after which word?
+   std::vector<double> cost;          ///< used by stri__wrap_dynamic
+   std::vector<double> f;             ///< used by stri__wrap_dynamic
+   std::vector<bool> where;           ///< used by stri__wrap_dynamic
+   std::vector< pair<R_len_t, R_len_t> > lines; ///< output: [start, end) byte ranges
+};
+
+
+/** Word wrap a single string
+ *
+ * Makes no R API calls (may be run in parallel).
+ *
+ * @param str_cur_s UTF-8 string
+ * @param str_cur_n number of bytes in str_cur_s
+ * @param briter line break iterator
+ * @param str_text [in/out] UText reused across calls
+ * @param buf [in/out] temporary buffers; byte ranges of the lines
+ *    are appended to buf.lines
+ * @param status [out] ICU error code
+ * @return number of lines added to buf.lines; 0 if the string
+ *    is to be returned as-is; STRI__WRAP_* on error
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    separated from stri_wrap
+ */
+static R_len_t stri__wrap_one(const char* str_cur_s, R_len_t str_cur_n,
+   BreakIterator* briter, UText*& str_text, StriWrapBuffers& buf,
+   const UnicodeSet& uset_linebreaks, const UnicodeSet& uset_whitespaces,
+   bool whitespace_only_val, bool use_length_val, int width_val, double exponent_val,
+   int add_para_1, int add_para_n, UErrorCode& status)
+{
+   status = U_ZERO_ERROR;
+   str_text = utext_openUTF8(str_text, str_cur_s, str_cur_n, &status);
+   if (U_FAILURE(status)) return STRI__WRAP_ICU_ERROR;
+
+   briter->setText(str_text, status);
+   if (U_FAILURE(status)) return STRI__WRAP_ICU_ERROR;
+
+   // all right, first let's generate a list of places at which we may do line breaks
+   std::vector<R_len_t>& occurrences_list = buf.occurrences;
+   occurrences_list.clear();
+   R_len_t match = briter->first();
+   while (match != BreakIterator::DONE) {
+
+      if (!whitespace_only_val)
+         occurrences_list.push_back(match);
+      else {
+         if (match > 0 && match < str_cur_n) {
+            UChar32 c;
+            U8_GET((const uint8_t*)str_cur_s, 0, match-1, str_cur_n, c);
+            if (uset_whitespaces.contains(c))
+               occurrences_list.push_back(match);
+         }
+         else
+            occurrences_list.push_back(match);
+      }
+
+      match = briter->next();
+   }
+
+   R_len_t noccurrences = (R_len_t)occurrences_list.size(); // number of boundaries
+   if (noccurrences <= 1) // no match (1 boundary == 0)
+      return 0;
+
+   // the number of "words" is:
+   R_len_t nwords = noccurrences - 1;
+
+   // end positions (in a string) of each "words",
+   // noting that occurrences_list[0] == 0
+   std::vector<R_len_t>& end_pos_orig = buf.end_pos_orig;
+   end_pos_orig.assign(occurrences_list.begin()+1, occurrences_list.end());
+
+   // now:
+   // we'll get the total widths/number of code points in each "word"
+   std::vector<R_len_t>& widths_orig = buf.widths_orig;
+   widths_orig.resize(nwords);
+   // we'll get the total widths/number of code points without trailing whitespaces
+   std::vector<R_len_t>& widths_trim = buf.widths_trim;
+   widths_trim.resize(nwords);
+   // we'll get the end positions without trailing whitespaces
+   std::vector<R_len_t>& end_pos_trim = buf.end_pos_trim;
+   end_pos_trim.resize(nwords);
+   // detect line endings (fail on a match)
+
+   UChar32 c = 0;
+   R_len_t j = 0;
+   R_len_t cur_block = 0;
+   R_len_t cur_width_orig = 0;
+   R_len_t cur_width_trim = 0;
+   R_len_t cur_count_orig = 0;
+   R_len_t cur_count_trim = 0;
+   R_len_t cur_end_pos_trim = 0;
+   while (j < str_cur_n) {
+      R_len_t jlast = j;
+      U8_NEXT(str_cur_s, j, str_cur_n, c);
+      if (c < 0) // invalid utf-8 sequence
+         return STRI__WRAP_INVALID_UTF8;
+
+      if (uset_linebreaks.contains(c))
+         return STRI__WRAP_NEWLINE;
+
+      cur_width_orig += stri__width_char(c);
+      ++cur_count_orig;
+      if (uset_whitespaces.contains(c)) {
+// OLD: trim all white spaces from the end:
+//            ++cur_count_trim;
+//           [we have the normalize arg for that]
+
+// NEW: trim just one white space at the end:
+         cur_width_trim = stri__width_char(c);
+         cur_count_trim = 1;
+         cur_end_pos_trim = jlast;
+      }
+      else {
+         cur_width_trim = 0;
+         cur_count_trim = 0;
+         cur_end_pos_trim = j;
+      }
+
+      if (j >= str_cur_n || end_pos_orig[cur_block] <= j) {
+         // we'll start a new block in a moment
+         if (use_length_val) {
+            widths_orig[cur_block] = cur_count_orig;
+            widths_trim[cur_block] = cur_count_orig-cur_count_trim;
+         }
+         else {
+            widths_orig[cur_block] = cur_width_orig;
+            widths_trim[cur_block] = cur_width_orig-cur_width_trim;
+         }
+         end_pos_trim[cur_block] = cur_end_pos_trim;
+         cur_block++;
+         cur_width_orig = 0;
+         cur_width_trim = 0;
+         cur_count_orig = 0;
+         cur_count_trim = 0;
+         cur_end_pos_trim = j;
+      }
+   }
+
+   // do wrap
+   std::vector<R_len_t>& wrap_after = buf.wrap_after; // wrap line after which word in {0..nwords-1}?
+   wrap_after.clear();
+   if (exponent_val <= 0.0) {
+      stri__wrap_greedy(wrap_after, nwords, width_val,
+         widths_orig, widths_trim, add_para_1, add_para_n);
+   }
+   else {
+      stri__wrap_dynamic(wrap_after, nwords, width_val, exponent_val,
+         widths_orig, widths_trim, add_para_1, add_para_n,
+         buf.cost, buf.f, buf.where);
+   }
+
+   // wrap_after.size() line breaks => wrap_after.size()+1 lines
+   R_len_t nlines = (R_len_t)wrap_after.size()+1;
+   R_len_t last_pos = 0;
+   for (R_len_t u = 0; u < nlines-1; ++u) {
+      R_len_t wrap_after_cur = wrap_after[u];
+      buf.lines.push_back(pair<R_len_t, R_len_t>(last_pos, end_pos_trim[wrap_after_cur]));
+      last_pos = end_pos_orig[wrap_after_cur];
+   }
+
+   // last line goes here:
+   buf.lines.push_back(pair<R_len_t, R_len_t>(last_pos, end_pos_trim[nwords-1]));
+   return nlines;
+}
+
+
 /** Word wrap text
  *
  * @param str character vector
@@ -241,6 +445,11 @@ struct StriWrapLineStart {
  *
  * @version 0.5-1 (Marek Gagolewski, 2015-06-09)
  *    BIGSKIP: no more CHARSXP on out on "" input
+ *
+ * @version 1.1.2 (Marek Gagolewski, 2026-10-16)
+ *    strings are wrapped in parallel (OpenMP, one BreakIterator
+ *    and one set of temporary buffers per thread),
+ *    R objects are created afterwards
  */
 SEXP stri_wrap(SEXP str, SEXP width, SEXP cost_exponent,
    SEXP indent, SEXP exdent, SEXP prefix, SEXP initial, SEXP whitespace_only,
@@ -266,15 +475,23 @@ SEXP stri_wrap(SEXP str, SEXP width, SEXP cost_exponent,
    PROTECT(prefix  = stri_prepare_arg_string_1(prefix, "prefix"));
    PROTECT(initial = stri_prepare_arg_string_1(initial, "initial"));
 
-   BreakIterator* briter = NULL;
-   UText* str_text = NULL;
+   R_len_t str_length = LENGTH(str);
+#ifdef _OPENMP
+   int nthreads = std::max(1, std::min(omp_get_max_threads(), (int)str_length));
+#else
+   int nthreads = 1;
+#endif
+   std::vector<BreakIterator*> briters(nthreads, (BreakIterator*)NULL);
 
    STRI__ERROR_HANDLER_BEGIN(3)
    UErrorCode status = U_ZERO_ERROR;
-   briter = BreakIterator::createLineInstance(loc, status);
+   briters[0] = BreakIterator::createLineInstance(loc, status);
    STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
+   for (int t = 1; t < nthreads; ++t) {
+      briters[t] = briters[0]->clone(); // one per thread
+      if (!briters[t]) throw StriException(MSG__INTERNAL_ERROR);
+   }
 
-   R_len_t str_length = LENGTH(str);
    StriContainerUTF8_indexable str_cont(str, str_length);
    StriContainerUTF8 prefix_cont(prefix, 1);
    StriContainerUTF8 initial_cont(initial, 1);
@@ -301,187 +518,107 @@ SEXP stri_wrap(SEXP str, SEXP width, SEXP cost_exponent,
    STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
    uset_whitespaces.freeze();
 
-   SEXP ret;
-   STRI__PROTECT(ret = Rf_allocVector(VECSXP, str_length));
-   for (R_len_t i = 0; i < str_length; ++i)
+   // wrap all the strings first, the phase below makes no R API calls;
+   // the lines of the i-th string are
+   // buf[line_thread[i]].lines[line_first[i]..line_first[i]+line_count[i]-1]
+   std::vector<StriWrapBuffers> buf(nthreads);
+   std::vector<int> line_thread(str_length, 0);
+   std::vector<R_len_t> line_first(str_length, 0);
+   std::vector<R_len_t> line_count(str_length, STRI__WRAP_NA);
+   std::vector<UErrorCode> elem_status(str_length, U_ZERO_ERROR);
+   bool any_na = (prefix_cont.isNA(0) || initial_cont.isNA(0));
+
+#ifdef _OPENMP
+   #pragma omp parallel num_threads(nthreads) if(nthreads > 1)
+#endif
    {
-      if (str_cont.isNA(i) || prefix_cont.isNA(0) || initial_cont.isNA(0)) {
-         SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));
-         continue;
-      }
-
-      status = U_ZERO_ERROR;
-      const char* str_cur_s = str_cont.get(i).c_str();
-      R_len_t str_cur_n = str_cont.get(i).length();
-      str_text = utext_openUTF8(str_text, str_cur_s, str_cont.get(i).length(), &status);
-      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-
-      status = U_ZERO_ERROR;
-      briter->setText(str_text, status);
-      STRI__CHECKICUSTATUS_THROW(status, {/* do nothing special on err */})
-
-      // all right, first let's generate a list of places at which we may do line breaks
-      deque< R_len_t > occurrences_list; // this could be an R_len_t queue
-      R_len_t match = briter->first();
-      while (match != BreakIterator::DONE) {
+#ifdef _OPENMP
+      int t = omp_get_thread_num();
+#else
+      int t = 0;
+#endif
+      UText* str_text = NULL;
 
-         if (!whitespace_only_val)
-            occurrences_list.push_back(match);
-         else {
-            if (match > 0 && match < str_cur_n) {
-               UChar32 c;
-               U8_GET((const uint8_t*)str_cur_s, 0, match-1, str_cur_n, c);
-               if (uset_whitespaces.contains(c))
-                  occurrences_list.push_back(match);
-            }
-            else
-               occurrences_list.push_back(match);
+#ifdef _OPENMP
+      #pragma omp for schedule(dynamic, 64)
+#endif
+      for (R_len_t i = 0; i < str_length; ++i) {
+         if (any_na || str_cont.isNA(i))
+            continue;
+
+         line_thread[i] = t;
+         line_first[i]  = (R_len_t)buf[t].lines.size();
+         // exceptions (bad_alloc from the buffers) must not leave the region
+         try {
+            line_count[i] = stri__wrap_one(
+               str_cont.get(i).c_str(), str_cont.get(i).length(),
+               briters[t], str_text, buf[t],
+               uset_linebreaks, uset_whitespaces,
+               whitespace_only_val, use_length_val, width_val, exponent_val,
+               (use_length_val)?((i==0)?ii.count:pi.count):((i==0)?ii.width:pi.width),
+               (use_length_val)?pe.count:pe.width, elem_status[i]);
+         }
+         catch (...) {
+            line_count[i] = STRI__WRAP_ALLOC_ERROR;
          }
-
-         match = briter->next();
-      }
-
-      R_len_t noccurrences = (R_len_t)occurrences_list.size(); // number of boundaries
-      if (noccurrences <= 1) { // no match (1 boundary == 0)
-         SET_VECTOR_ELT(ret, i, Rf_ScalarString(str_cont.toR(i)));
-         continue;
       }
 
-      // the number of "words" is:
-      R_len_t nwords = noccurrences - 1;
-
-      // convert occurrences_list to a vector
-      // in order to obtain end positions (in a string) of each "words",
-      // noting that occurrences_list.at(0) == 0
-#ifndef NDEBUG
-      if (occurrences_list.at(0) != 0)
-         throw StriException("NDEBUG: stri_wrap: (occurrences_list.at(0) != 0)");
-#endif
+      if (str_text) { utext_close(str_text); str_text = NULL; }
+   }
 
-      std::vector<R_len_t> end_pos_orig(nwords);
-      deque<R_len_t>::iterator iter = ++(occurrences_list.begin());
-      for (R_len_t j = 0; iter != occurrences_list.end(); ++iter, ++j) {
-         end_pos_orig[j] = (*iter); // this is a UTF-8 index
-      }
+   for (int t = 0; t < nthreads; ++t) {
+      if (briters[t]) { delete briters[t]; briters[t] = NULL; }
+   }
 
+   SEXP ret;
+   STRI__PROTECT(ret = Rf_allocVector(VECSXP, str_length));
+   std::string cs;
+   for (R_len_t i = 0; i < str_length; ++i)
+   {
+      R_len_t nlines = line_count[i];
+      switch (nlines) {
+         case STRI__WRAP_NA:
+            SET_VECTOR_ELT(ret, i, stri__vector_NA_strings(1));
+            continue;
 
-      // now:
-      // we'll get the total widths/number of code points in each "word"
-      std::vector<R_len_t> widths_orig(nwords);
-      // we'll get the total widths/number of code points without trailing whitespaces
-      std::vector<R_len_t> widths_trim(nwords);
-      // we'll get the end positions without trailing whitespaces
-      std::vector<R_len_t> end_pos_trim(nwords);
-      // detect line endings (fail on a match)
-
-      UChar32 c = 0;
-      R_len_t j = 0;
-      R_len_t cur_block = 0;
-      R_len_t cur_width_orig = 0;
-      R_len_t cur_width_trim = 0;
-      R_len_t cur_count_orig = 0;
-      R_len_t cur_count_trim = 0;
-      R_len_t cur_end_pos_trim = 0;
-      while (j < str_cur_n) {
-         R_len_t jlast = j;
-         U8_NEXT(str_cur_s, j, str_cur_n, c);
-         if (c < 0) // invalid utf-8 sequence
+         case STRI__WRAP_INVALID_UTF8:
             throw StriException(MSG__INVALID_UTF8);
 
-         if (uset_linebreaks.contains(c))
+         case STRI__WRAP_NEWLINE:
             throw StriException(MSG__NEWLINE_FOUND);
 
-         cur_width_orig += stri__width_char(c);
-         ++cur_count_orig;
-         if (uset_whitespaces.contains(c)) {
-// OLD: trim all white spaces from the end:
-//            ++cur_count_trim;
-//           [we have the normalize arg for that]
-
-// NEW: trim just one white space at the end:
-            cur_width_trim = stri__width_char(c);
-            cur_count_trim = 1;
-            cur_end_pos_trim = jlast;
-         }
-         else {
-            cur_width_trim = 0;
-            cur_count_trim = 0;
-            cur_end_pos_trim = j;
-         }
+         case STRI__WRAP_ICU_ERROR:
+            throw StriException(elem_status[i]);
 
-         if (j >= str_cur_n || end_pos_orig[cur_block] <= j) {
-            // we'll start a new block in a moment
-            if (use_length_val) {
-               widths_orig[cur_block] = cur_count_orig;
-               widths_trim[cur_block] = cur_count_orig-cur_count_trim;
-            }
-            else {
-               widths_orig[cur_block] = cur_width_orig;
-               widths_trim[cur_block] = cur_width_orig-cur_width_trim;
-            }
-            end_pos_trim[cur_block] = cur_end_pos_trim;
-            cur_block++;
-            cur_width_orig = 0;
-            cur_width_trim = 0;
-            cur_count_orig = 0;
-            cur_count_trim = 0;
-            cur_end_pos_trim = j;
-         }
-      }
+         case STRI__WRAP_ALLOC_ERROR:
+            throw StriException(MSG__MEM_ALLOC_ERROR);
 
-      // do wrap
-      std::deque<R_len_t> wrap_after; // wrap line after which word in {0..nwords-1}?
-      if (exponent_val <= 0.0) {
-         stri__wrap_greedy(wrap_after, nwords, width_val,
-            widths_orig, widths_trim,
-               (use_length_val)?((i==0)?ii.count:pi.count):((i==0)?ii.width:pi.width),
-               (use_length_val)?pe.count:pe.width);
-      }
-      else {
-         stri__wrap_dynamic(wrap_after, nwords, width_val, exponent_val,
-            widths_orig, widths_trim,
-               (use_length_val)?((i==0)?ii.count:pi.count):((i==0)?ii.width:pi.width),
-               (use_length_val)?pe.count:pe.width);
+         case 0:
+            SET_VECTOR_ELT(ret, i, Rf_ScalarString(str_cont.toR(i)));
+            continue;
       }
 
-      // wrap_after.size() line breaks => wrap_after.size()+1 lines
-      R_len_t nlines = (R_len_t)wrap_after.size()+1;
-      R_len_t last_pos = 0;
+      const char* str_cur_s = str_cont.get(i).c_str();
+      const pair<R_len_t, R_len_t>* lines = &buf[line_thread[i]].lines[line_first[i]];
       SEXP ans;
       STRI__PROTECT(ans = Rf_allocVector(STRSXP, nlines));
-      deque<R_len_t>::iterator iter_wrap = wrap_after.begin();
-      for (R_len_t u = 0; iter_wrap != wrap_after.end(); ++iter_wrap, ++u) {
-         R_len_t wrap_after_cur = *iter_wrap;
-         R_len_t cur_pos = end_pos_trim[wrap_after_cur];
-
-         std::string cs;
+      for (R_len_t u = 0; u < nlines; ++u) {
          if (i == 0 && u == 0)     cs = ii.str;
          else if (i > 0 && u == 0) cs = pi.str;
          else                      cs = pe.str;
-         cs.append(str_cur_s+last_pos, cur_pos-last_pos);
+         cs.append(str_cur_s+lines[u].first, lines[u].second-lines[u].first);
          SET_STRING_ELT(ans, u, Rf_mkCharLenCE(cs.c_str(), cs.size(), CE_UTF8));
-
-         last_pos = end_pos_orig[wrap_after_cur];
       }
 
-      // last line goes here:
-      std::string cs;
-      if (i == 0 && nlines-1 == 0)     cs = ii.str;
-      else if (i > 0 && nlines-1 == 0) cs = pi.str;
-      else                             cs = pe.str;
-      cs.append(str_cur_s+last_pos, end_pos_trim[nwords-1]-last_pos);
-      SET_STRING_ELT(ans, nlines-1, Rf_mkCharLenCE(cs.c_str(), cs.size(), CE_UTF8));
-
       SET_VECTOR_ELT(ret, i, ans);
       STRI__UNPROTECT(1);
    }
 
-   if (briter) { delete briter; briter = NULL; }
-   if (str_text) { utext_close(str_text); str_text = NULL; }
    STRI__UNPROTECT_ALL
    return ret;
    STRI__ERROR_HANDLER_END({
-      if (briter) { delete briter; briter = NULL; }
-      if (str_text) { utext_close(str_text); str_text = NULL; }
+      for (int t = 0; t < nthreads; ++t) {
+         if (briters[t]) { delete briters[t]; briters[t] = NULL; }
+      }
    })
 }